@@ -0,0 +1,705 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+/*
+ * pmemkv_bench.cc -- benchmark of pmemkv engines with YCSB-style workloads.
+ *
+ * It opens any engine registered in libpmemkv, runs the given benchmarks for
+ * each of the given thread counts and reports their throughput and latency
+ * percentiles. See benchmarks/README.md for the list of options.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <libpmemkv.hpp>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+using namespace pmem::kv;
+
+namespace
+{
+
+using clock_type = std::chrono::steady_clock;
+
+/* keys are formatted as zero-padded decimal numbers of this length */
+const size_t KEY_DIGITS = 16;
+
+enum class distribution { uniform, zipfian, latest };
+
+enum class workload_kind { mix, fill_seq, fill_random, tx_batch };
+
+struct workload {
+	const char *name;
+	workload_kind kind;
+	/* proportions of gets, updates, inserts and scans; the rest are
+	 * read-modify-writes */
+	double read, update, insert, scan;
+	distribution dist;
+	const char *description;
+};
+
+const workload workloads[] = {
+	{"fillseq", workload_kind::fill_seq, 0, 0, 0, 0, distribution::uniform,
+	 "puts of --num records, in key order"},
+	{"fillrandom", workload_kind::fill_random, 0, 0, 0, 0, distribution::uniform,
+	 "puts of --num records with random keys"},
+	{"readrandom", workload_kind::mix, 1, 0, 0, 0, distribution::uniform, "gets"},
+	{"scan", workload_kind::mix, 0, 0, 0, 1, distribution::uniform,
+	 "scans of up to --scan_length records"},
+	{"txbatch", workload_kind::tx_batch, 0, 0, 0, 0, distribution::uniform,
+	 "transactions of --batch puts"},
+	{"ycsb_a", workload_kind::mix, 0.5, 0.5, 0, 0, distribution::zipfian,
+	 "50% gets, 50% updates"},
+	{"ycsb_b", workload_kind::mix, 0.95, 0.05, 0, 0, distribution::zipfian,
+	 "95% gets, 5% updates"},
+	{"ycsb_c", workload_kind::mix, 1, 0, 0, 0, distribution::zipfian, "gets"},
+	{"ycsb_d", workload_kind::mix, 0.95, 0, 0.05, 0, distribution::latest,
+	 "95% gets of the latest records, 5% inserts"},
+	{"ycsb_e", workload_kind::mix, 0, 0, 0.05, 0.95, distribution::zipfian,
+	 "95% scans, 5% inserts"},
+	{"ycsb_f", workload_kind::mix, 0.5, 0, 0, 0, distribution::zipfian,
+	 "50% gets, 50% read-modify-writes"},
+};
+
+/* size of keys or values, uniformly distributed in [min, max] */
+struct size_range {
+	size_t min;
+	size_t max;
+};
+
+struct options {
+	std::string engine = "cmap";
+	std::string path = "/dev/shm/pmemkv_bench";
+	uint64_t size = 1ULL << 30;
+	std::vector<std::pair<std::string, std::string>> config;
+	std::vector<const workload *> benchmarks;
+	std::vector<size_t> threads = {1};
+	uint64_t num = 100000;
+	uint64_t ops = 0;
+	uint64_t warmup = 0;
+	bool dist_set = false;
+	distribution dist = distribution::uniform;
+	double zipf_theta = 0.99;
+	size_range key_size = {KEY_DIGITS, KEY_DIGITS};
+	size_range value_size = {100, 100};
+	size_t scan_length = 100;
+	size_t batch = 16;
+	uint64_t seed = 1;
+	bool use_existing = false;
+};
+
+void usage(const char *name)
+{
+	std::cerr
+		<< "Usage: " << name << " [--option=value ...]\n\n"
+		<< "Options (default values in brackets):\n"
+		<< "  --engine=NAME         engine to benchmark [cmap]\n"
+		<< "  --path=PATH           pool file or directory [/dev/shm/pmemkv_bench]\n"
+		<< "  --size=BYTES          size of the pool [1073741824]\n"
+		<< "  --config=KEY=VALUE    additional config item (numbers are put as\n"
+		<< "                        uint64, other values as strings), may repeat\n"
+		<< "  --benchmarks=LIST     comma-separated benchmarks [fillseq,readrandom,\n"
+		<< "                        ycsb_a,ycsb_b,ycsb_c,ycsb_d,ycsb_e,ycsb_f]\n"
+		<< "  --threads=LIST        comma-separated thread counts, every benchmark\n"
+		<< "                        runs with each of them [1]\n"
+		<< "  --num=N               number of records loaded [100000]\n"
+		<< "  --ops=N               operations of a run, 0 - --num [0]\n"
+		<< "  --warmup=N            unmeasured operations of every thread [0]\n"
+		<< "  --distribution=NAME   uniform, zipfian or latest [per benchmark]\n"
+		<< "  --zipf_theta=X        skew of zipfian distributions [0.99]\n"
+		<< "  --key_size=N[-M]      key size, at least " << KEY_DIGITS
+		<< " [" << KEY_DIGITS << "]\n"
+		<< "  --value_size=N[-M]    value size [100]\n"
+		<< "  --scan_length=N       maximum number of records of a scan [100]\n"
+		<< "  --batch=N             puts in a transaction of txbatch [16]\n"
+		<< "  --seed=N              seed of random generators [1]\n"
+		<< "  --use_existing=0|1    don't remove the pool file before opening [0]\n\n"
+		<< "Benchmarks:\n";
+
+	for (auto &w : workloads)
+		fprintf(stderr, "  %-21s %s\n", w.name, w.description);
+}
+
+std::vector<std::string> split(const std::string &s, char sep)
+{
+	std::vector<std::string> parts;
+	size_t pos = 0;
+	while (true) {
+		auto next = s.find(sep, pos);
+		parts.push_back(s.substr(pos, next - pos));
+		if (next == std::string::npos)
+			return parts;
+		pos = next + 1;
+	}
+}
+
+/* Parses a number, throws std::invalid_argument if it's not a valid one */
+uint64_t to_uint64(const std::string &s)
+{
+	if (s.empty() || s.find_first_not_of("0123456789") != std::string::npos)
+		throw std::invalid_argument("not a number: " + s);
+
+	return std::stoull(s);
+}
+
+size_range to_size_range(const std::string &s)
+{
+	auto parts = split(s, '-');
+	if (parts.size() > 2)
+		throw std::invalid_argument("not a size range: " + s);
+
+	size_range r;
+	r.min = to_uint64(parts[0]);
+	r.max = parts.size() == 2 ? to_uint64(parts[1]) : r.min;
+	if (r.max < r.min)
+		throw std::invalid_argument("not a size range: " + s);
+
+	return r;
+}
+
+const workload *find_workload(const std::string &name)
+{
+	for (auto &w : workloads)
+		if (name == w.name)
+			return &w;
+
+	throw std::invalid_argument("unknown benchmark: " + name);
+}
+
+/* Parses command line, throws std::invalid_argument on errors */
+options parse_options(int argc, char *argv[])
+{
+	options opts;
+	std::string benchmarks =
+		"fillseq,readrandom,ycsb_a,ycsb_b,ycsb_c,ycsb_d,ycsb_e,ycsb_f";
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		auto eq = arg.find('=');
+		if (arg.compare(0, 2, "--") != 0 || eq == std::string::npos)
+			throw std::invalid_argument("invalid option: " + arg);
+
+		auto name = arg.substr(2, eq - 2);
+		auto value = arg.substr(eq + 1);
+
+		if (name == "engine") {
+			opts.engine = value;
+		} else if (name == "path") {
+			opts.path = value;
+		} else if (name == "size") {
+			opts.size = to_uint64(value);
+		} else if (name == "config") {
+			auto sep = value.find('=');
+			if (sep == std::string::npos)
+				throw std::invalid_argument("invalid config item: " +
+							    value);
+			opts.config.emplace_back(value.substr(0, sep),
+						 value.substr(sep + 1));
+		} else if (name == "benchmarks") {
+			benchmarks = value;
+		} else if (name == "threads") {
+			opts.threads.clear();
+			for (auto &t : split(value, ','))
+				opts.threads.push_back(to_uint64(t));
+		} else if (name == "num") {
+			opts.num = to_uint64(value);
+		} else if (name == "ops") {
+			opts.ops = to_uint64(value);
+		} else if (name == "warmup") {
+			opts.warmup = to_uint64(value);
+		} else if (name == "distribution") {
+			opts.dist_set = true;
+			if (value == "uniform")
+				opts.dist = distribution::uniform;
+			else if (value == "zipfian")
+				opts.dist = distribution::zipfian;
+			else if (value == "latest")
+				opts.dist = distribution::latest;
+			else
+				throw std::invalid_argument("unknown distribution: " +
+							    value);
+		} else if (name == "zipf_theta") {
+			opts.zipf_theta = std::stod(value);
+		} else if (name == "key_size") {
+			opts.key_size = to_size_range(value);
+		} else if (name == "value_size") {
+			opts.value_size = to_size_range(value);
+		} else if (name == "scan_length") {
+			opts.scan_length = to_uint64(value);
+		} else if (name == "batch") {
+			opts.batch = to_uint64(value);
+		} else if (name == "seed") {
+			opts.seed = to_uint64(value);
+		} else if (name == "use_existing") {
+			opts.use_existing = to_uint64(value) != 0;
+		} else {
+			throw std::invalid_argument("unknown option: " + name);
+		}
+	}
+
+	for (auto &b : split(benchmarks, ','))
+		opts.benchmarks.push_back(find_workload(b));
+
+	if (opts.key_size.min < KEY_DIGITS)
+		throw std::invalid_argument("key size must be at least " +
+					    std::to_string(KEY_DIGITS));
+	if (opts.num == 0 || opts.scan_length == 0 || opts.batch == 0)
+		throw std::invalid_argument("num, scan_length and batch must be > 0");
+	if (std::find(opts.threads.begin(), opts.threads.end(), 0) !=
+	    opts.threads.end())
+		throw std::invalid_argument("thread count must be > 0");
+	if (!(opts.zipf_theta > 0 && opts.zipf_theta < 1))
+		throw std::invalid_argument("zipf_theta must be in (0, 1)");
+
+	return opts;
+}
+
+/* FNV-1a hash of a number, scatters popular zipfian items over the key space */
+uint64_t fnv_hash(uint64_t v)
+{
+	uint64_t h = 14695981039346656037ULL;
+	for (int i = 0; i < 8; i++) {
+		h ^= v & 0xff;
+		h *= 1099511628211ULL;
+		v >>= 8;
+	}
+
+	return h;
+}
+
+/**
+ * Zipfian distribution of numbers in [0, n), 0 being the most popular, as
+ * generated by YCSB ("Quickly Generating Billion-Record Synthetic Databases",
+ * Gray et al.).
+ */
+class zipfian_generator {
+public:
+	zipfian_generator(uint64_t n, double theta)
+	    : n(n),
+	      theta(theta),
+	      alpha(1.0 / (1.0 - theta)),
+	      zetan(zeta(n, theta)),
+	      eta((1 - std::pow(2.0 / static_cast<double>(n), 1 - theta)) /
+		  (1 - zeta(2, theta) / zetan))
+	{
+	}
+
+	uint64_t next(std::mt19937_64 &rng) const
+	{
+		double u = std::uniform_real_distribution<double>(0, 1)(rng);
+		double uz = u * zetan;
+
+		if (uz < 1.0)
+			return 0;
+		if (uz < 1.0 + std::pow(0.5, theta))
+			return 1;
+
+		auto v = static_cast<uint64_t>(static_cast<double>(n) *
+					       std::pow(eta * u - eta + 1, alpha));
+		return std::min(v, n - 1);
+	}
+
+private:
+	static double zeta(uint64_t n, double theta)
+	{
+		double sum = 0;
+		for (uint64_t i = 1; i <= n; i++)
+			sum += 1 / std::pow(static_cast<double>(i), theta);
+
+		return sum;
+	}
+
+	const uint64_t n;
+	const double theta;
+	const double alpha;
+	const double zetan;
+	const double eta;
+};
+
+struct thread_result {
+	std::vector<uint64_t> latencies;
+	uint64_t not_found = 0;
+	uint64_t errors = 0;
+	status first_error = status::OK;
+	std::string first_error_msg;
+	clock_type::time_point start;
+	clock_type::time_point end;
+};
+
+/* State of a single benchmark thread */
+struct thread_state {
+	thread_state(uint64_t seed, size_t max_value_size) : rng(seed)
+	{
+		std::uniform_int_distribution<int> letter('a', 'z');
+		value.resize(max_value_size);
+		for (auto &c : value)
+			c = static_cast<char>(letter(rng));
+	}
+
+	std::mt19937_64 rng;
+	std::string key;
+	std::string value;
+	std::string read_buffer;
+};
+
+void get_nothing(const char *, size_t, void *)
+{
+}
+
+int count_records(const char *, size_t, const char *, size_t, void *arg)
+{
+	++*static_cast<size_t *>(arg);
+	return 0;
+}
+
+class benchmark {
+public:
+	benchmark(db &kv, const options &opts)
+	    : kv(kv), opts(opts), zipf(opts.num, opts.zipf_theta), records(0)
+	{
+	}
+
+	/* Runs the workload, prints its results if report is true; returns false
+	 * if any operation failed */
+	bool run(const workload &w, size_t threads, bool report);
+
+	bool is_loaded() const
+	{
+		return loaded;
+	}
+
+private:
+	void worker(const workload &w, size_t tid, size_t threads, uint64_t first,
+		    uint64_t ops, thread_result &res, std::atomic<size_t> &ready);
+	status execute(const workload &w, thread_state &ts, uint64_t i);
+
+	string_view make_key(thread_state &ts, uint64_t n) const;
+	string_view make_value(thread_state &ts);
+	uint64_t next_key(const workload &w, thread_state &ts);
+
+	db &kv;
+	const options &opts;
+	const zipfian_generator zipf;
+
+	/* number of keys put by fillseq or inserted by workloads */
+	std::atomic<uint64_t> records;
+	bool loaded = false;
+	uint64_t runs = 0;
+};
+
+/* Keys of the same number are equal, of the same size (if sizes vary) too */
+string_view benchmark::make_key(thread_state &ts, uint64_t n) const
+{
+	auto &r = opts.key_size;
+	auto size = r.min + fnv_hash(n) % (r.max - r.min + 1);
+
+	char digits[KEY_DIGITS + 1];
+	snprintf(digits, sizeof(digits), "%016llu", static_cast<unsigned long long>(n));
+
+	ts.key.assign(digits, KEY_DIGITS);
+	ts.key.resize(size, 'k');
+
+	return string_view(ts.key.data(), ts.key.size());
+}
+
+string_view benchmark::make_value(thread_state &ts)
+{
+	auto &r = opts.value_size;
+	auto size = std::uniform_int_distribution<size_t>(r.min, r.max)(ts.rng);
+
+	return string_view(ts.value.data(), size);
+}
+
+uint64_t benchmark::next_key(const workload &w, thread_state &ts)
+{
+	auto n = std::max<uint64_t>(records.load(std::memory_order_relaxed), 1);
+
+	switch (opts.dist_set ? opts.dist : w.dist) {
+		case distribution::zipfian:
+			return fnv_hash(zipf.next(ts.rng)) % n;
+		case distribution::latest: {
+			auto z = zipf.next(ts.rng);
+			return z < n ? n - 1 - z : 0;
+		}
+		default:
+			return std::uniform_int_distribution<uint64_t>(0, n - 1)(
+				ts.rng);
+	}
+}
+
+/* Executes i-th operation of the thread */
+status benchmark::execute(const workload &w, thread_state &ts, uint64_t i)
+{
+	switch (w.kind) {
+		case workload_kind::fill_seq:
+			return kv.put(make_key(ts, i), make_value(ts));
+		case workload_kind::fill_random: {
+			auto n = std::uniform_int_distribution<uint64_t>(
+				0, opts.num - 1)(ts.rng);
+			return kv.put(make_key(ts, n), make_value(ts));
+		}
+		case workload_kind::tx_batch: {
+			auto t = kv.tx_begin();
+			if (!t.is_ok())
+				return t.get_status();
+
+			auto &tx = t.get_value();
+			for (size_t j = 0; j < opts.batch; j++) {
+				auto s = tx.put(make_key(ts, next_key(w, ts)),
+						make_value(ts));
+				if (s != status::OK)
+					return s;
+			}
+
+			return tx.commit();
+		}
+		default:
+			break;
+	}
+
+	double p = std::uniform_real_distribution<double>(0, 1)(ts.rng);
+
+	if (p < w.read)
+		return kv.get(make_key(ts, next_key(w, ts)), get_nothing, nullptr);
+
+	if (p < w.read + w.update)
+		return kv.put(make_key(ts, next_key(w, ts)), make_value(ts));
+
+	if (p < w.read + w.update + w.insert) {
+		auto n = records.fetch_add(1, std::memory_order_relaxed);
+		return kv.put(make_key(ts, n), make_value(ts));
+	}
+
+	if (p < w.read + w.update + w.insert + w.scan) {
+		auto length = std::uniform_int_distribution<size_t>(
+			1, opts.scan_length)(ts.rng);
+		scan_cursor cursor(length);
+		size_t count = 0;
+
+		return kv.get_above_page(make_key(ts, next_key(w, ts)), cursor,
+					 count_records, &count);
+	}
+
+	/* read-modify-write */
+	auto key = make_key(ts, next_key(w, ts));
+	auto s = kv.get(key, &ts.read_buffer);
+	if (s != status::OK)
+		return s;
+
+	return kv.put(key, make_value(ts));
+}
+
+/* Executes operations [first, first + ops) of the workload */
+void benchmark::worker(const workload &w, size_t tid, size_t threads, uint64_t first,
+		       uint64_t ops, thread_result &res, std::atomic<size_t> &ready)
+{
+	thread_state ts(opts.seed * 1000003 + runs * 1009 + tid, opts.value_size.max);
+
+	if (w.kind == workload_kind::mix) {
+		for (uint64_t i = 0; i < opts.warmup; i++)
+			execute(w, ts, i);
+	}
+
+	ready.fetch_add(1);
+	while (ready.load() < threads)
+		std::this_thread::yield();
+
+	res.latencies.reserve(ops);
+	res.start = clock_type::now();
+
+	for (uint64_t i = first; i < first + ops; i++) {
+		auto start = clock_type::now();
+		auto s = execute(w, ts, i);
+		auto end = clock_type::now();
+
+		res.latencies.push_back(static_cast<uint64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+				.count()));
+
+		if (s == status::NOT_FOUND) {
+			res.not_found++;
+		} else if (s != status::OK && s != status::STOPPED_BY_CB) {
+			if (res.errors++ == 0) {
+				res.first_error = s;
+				res.first_error_msg = errormsg();
+			}
+		}
+	}
+
+	res.end = clock_type::now();
+}
+
+bool benchmark::run(const workload &w, size_t threads, bool report)
+{
+	uint64_t total;
+	if (w.kind == workload_kind::fill_seq || w.kind == workload_kind::fill_random)
+		total = opts.num;
+	else if (w.kind == workload_kind::tx_batch)
+		total = std::max<uint64_t>((opts.ops ? opts.ops : opts.num) / opts.batch,
+					   1);
+	else
+		total = opts.ops ? opts.ops : opts.num;
+
+	std::vector<thread_result> results(threads);
+	std::vector<std::thread> workers;
+	std::atomic<size_t> ready(0);
+
+	/* fillseq threads put consecutive ranges of keys */
+	uint64_t first = 0;
+	for (size_t t = 0; t < threads; t++) {
+		uint64_t ops = total / threads + (t < total % threads ? 1 : 0);
+		workers.emplace_back(&benchmark::worker, this, std::cref(w), t, threads,
+				     first, ops, std::ref(results[t]), std::ref(ready));
+		first += ops;
+	}
+	for (auto &t : workers)
+		t.join();
+	runs++;
+
+	if (w.kind == workload_kind::fill_seq) {
+		loaded = true;
+		auto r = records.load();
+		while (r < opts.num && !records.compare_exchange_weak(r, opts.num))
+			;
+	}
+
+	std::vector<uint64_t> latencies;
+	latencies.reserve(total);
+	uint64_t not_found = 0, errors = 0;
+	auto start = results[0].start, end = results[0].end;
+	const thread_result *failed = nullptr;
+
+	for (auto &r : results) {
+		latencies.insert(latencies.end(), r.latencies.begin(), r.latencies.end());
+		not_found += r.not_found;
+		errors += r.errors;
+		start = std::min(start, r.start);
+		end = std::max(end, r.end);
+		if (r.errors && !failed)
+			failed = &r;
+	}
+
+	if (failed && failed->first_error == status::NOT_SUPPORTED) {
+		if (report)
+			printf("%-12s %7zu  not supported: %s\n", w.name, threads,
+			       failed->first_error_msg.c_str());
+		return true;
+	}
+
+	if (!report)
+		return errors == 0;
+
+	std::sort(latencies.begin(), latencies.end());
+	auto percentile = [&](double p) {
+		if (latencies.empty())
+			return 0.0;
+		auto i = std::min(latencies.size() - 1,
+				  static_cast<size_t>(p * static_cast<double>(
+							      latencies.size())));
+		return static_cast<double>(latencies[i]) / 1000;
+	};
+
+	auto seconds = std::chrono::duration<double>(end - start).count();
+	printf("%-12s %7zu %12.0f %10.2f %10.2f %10.2f %10llu %8llu\n", w.name, threads,
+	       seconds > 0 ? static_cast<double>(latencies.size()) / seconds : 0.0,
+	       percentile(0.5), percentile(0.99), percentile(0.999),
+	       static_cast<unsigned long long>(not_found),
+	       static_cast<unsigned long long>(errors));
+
+	if (failed)
+		printf("%-12s %7zu  first error: %s %s\n", w.name, threads,
+		       std::to_string(static_cast<int>(failed->first_error)).c_str(),
+		       failed->first_error_msg.c_str());
+	fflush(stdout);
+
+	return errors == 0;
+}
+
+/* Numbers are put as uint64, other values as strings */
+status put_config_item(config &cfg, const std::string &key, const std::string &value)
+{
+	try {
+		return cfg.put_uint64(key, to_uint64(value));
+	} catch (std::invalid_argument &) {
+		return cfg.put_string(key, value);
+	}
+}
+
+} /* namespace */
+
+int main(int argc, char *argv[])
+{
+	options opts;
+	try {
+		opts = parse_options(argc, argv);
+	} catch (std::exception &e) {
+		std::cerr << e.what() << std::endl << std::endl;
+		usage(argv[0]);
+		return 1;
+	}
+
+	/* start from an empty pool, unless asked otherwise */
+	struct stat st;
+	if (!opts.use_existing && stat(opts.path.c_str(), &st) == 0 &&
+	    S_ISREG(st.st_mode))
+		std::remove(opts.path.c_str());
+
+	config cfg;
+	auto s = cfg.put_path(opts.path);
+	if (s == status::OK)
+		s = cfg.put_size(opts.size);
+	if (s == status::OK)
+		s = cfg.put_create_if_missing(true);
+	for (auto &item : opts.config)
+		if (s == status::OK)
+			s = put_config_item(cfg, item.first, item.second);
+
+	db kv;
+	if (s == status::OK)
+		s = kv.open(opts.engine, std::move(cfg));
+	if (s != status::OK) {
+		std::cerr << "Cannot open " << opts.engine << " engine (" << s
+			  << "): " << errormsg() << std::endl;
+		return 1;
+	}
+
+	printf("pmemkv_bench: engine %s, path %s, %llu records, keys %zu-%zu B, "
+	       "values %zu-%zu B\n",
+	       opts.engine.c_str(), opts.path.c_str(),
+	       static_cast<unsigned long long>(opts.num), opts.key_size.min,
+	       opts.key_size.max, opts.value_size.min, opts.value_size.max);
+	printf("%-12s %7s %12s %10s %10s %10s %10s %8s\n", "benchmark", "threads",
+	       "ops/s", "p50 [us]", "p99 [us]", "p99.9 [us]", "not found", "errors");
+
+	benchmark bench(kv, opts);
+	bool ok = true;
+
+	for (auto w : opts.benchmarks) {
+		for (auto threads : opts.threads) {
+			/* other workloads read and update records loaded by fillseq */
+			if (w->kind != workload_kind::fill_seq && !bench.is_loaded() &&
+			    !bench.run(*find_workload("fillseq"), 1, false)) {
+				std::cerr << "Loading of records failed: " << errormsg()
+					  << std::endl;
+				return 1;
+			}
+
+			ok = bench.run(*w, threads, true) && ok;
+		}
+	}
+
+	kv.close();
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "async_executor.h"
+#include "engine.h"
+#include "exceptions.h"
+#include "write_batch.h"
+
+#include <functional>
+
+namespace pmem
+{
+namespace kv
+{
+namespace internal
+{
+
+/*
+ * Requests are executed outside of the C API layer, so exceptions thrown by
+ * an engine have to be translated into status here.
+ */
+template <typename Function>
+static status catch_status(Function &&f)
+{
+	try {
+		return f();
+	} catch (internal::error &e) {
+		return static_cast<status>(e.status_code);
+	} catch (std::bad_alloc &e) {
+		return status::OUT_OF_MEMORY;
+	} catch (...) {
+		return status::UNKNOWN_ERROR;
+	}
+}
+
+async_executor::async_executor(engine_base &engine, std::size_t workers_number,
+			       std::size_t queue_size, std::size_t max_batch)
+    : engine(engine), queue_size(queue_size), max_batch(max_batch)
+{
+	if (queue_size == 0 || max_batch == 0)
+		throw internal::invalid_argument(
+			"Async queue size and async max batch must be greater than 0");
+
+	workers.reserve(workers_number);
+	for (std::size_t i = 0; i < workers_number; i++)
+		workers.emplace_back(new worker);
+
+	try {
+		for (auto &w : workers) {
+			auto ptr = w.get();
+			w->thread = std::thread([this, ptr] { run(*ptr); });
+		}
+	} catch (...) {
+		stop();
+		throw;
+	}
+}
+
+async_executor::~async_executor()
+{
+	stop();
+}
+
+void async_executor::stop()
+{
+	for (auto &w : workers) {
+		std::unique_lock<std::mutex> lock(w->mtx);
+		w->stop = true;
+		w->not_empty.notify_all();
+	}
+
+	for (auto &w : workers) {
+		if (w->thread.joinable())
+			w->thread.join();
+	}
+}
+
+void async_executor::put(string_view key, string_view value,
+			 completion_callback *callback, void *arg)
+{
+	submit({request::type::put, std::string(key.data(), key.size()),
+		std::string(value.data(), value.size()), callback, arg});
+}
+
+void async_executor::get(string_view key, completion_callback *callback, void *arg)
+{
+	submit({request::type::get, std::string(key.data(), key.size()), std::string(),
+		callback, arg});
+}
+
+void async_executor::submit(request &&req)
+{
+	/* without workers, requests are executed in the caller's thread */
+	if (workers.empty()) {
+		if (req.op == request::type::put) {
+			std::vector<request> reqs;
+			reqs.emplace_back(std::move(req));
+			execute_puts(reqs);
+		} else {
+			execute_get(req);
+		}
+
+		return;
+	}
+
+	auto &w = *workers[std::hash<std::string>{}(req.key) % workers.size()];
+
+	std::unique_lock<std::mutex> lock(w.mtx);
+	w.not_full.wait(lock, [&] { return w.queue.size() < queue_size; });
+
+	w.queue.emplace_back(std::move(req));
+	w.not_empty.notify_one();
+}
+
+void async_executor::run(worker &w)
+{
+	std::vector<request> reqs;
+	reqs.reserve(max_batch);
+
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(w.mtx);
+			w.not_empty.wait(lock, [&] { return w.stop || !w.queue.empty(); });
+
+			/* pending requests are executed even if stop was requested */
+			if (w.queue.empty())
+				return;
+
+			/* take one get or as many adjacent puts as allowed */
+			do {
+				reqs.emplace_back(std::move(w.queue.front()));
+				w.queue.pop_front();
+			} while (reqs.back().op == request::type::put &&
+				 reqs.size() < max_batch && !w.queue.empty() &&
+				 w.queue.front().op == request::type::put);
+
+			w.not_full.notify_all();
+		}
+
+		if (reqs.front().op == request::type::put)
+			execute_puts(reqs);
+		else
+			execute_get(reqs.front());
+
+		reqs.clear();
+	}
+}
+
+void async_executor::execute_puts(std::vector<request> &reqs)
+{
+	status s;
+	if (reqs.size() == 1) {
+		s = catch_status([&] { return engine.put(reqs[0].key, reqs[0].value); });
+	} else {
+		s = catch_status([&] {
+			write_batch batch;
+			for (auto &r : reqs)
+				batch.put(r.key, r.value);
+
+			return engine.apply_batch(batch);
+		});
+	}
+
+	for (auto &r : reqs)
+		r.callback(static_cast<int>(s), nullptr, 0, r.arg);
+}
+
+struct get_context {
+	completion_callback *callback;
+	void *arg;
+};
+
+static void get_value_callback(const char *value, size_t valuebytes, void *arg)
+{
+	auto c = static_cast<get_context *>(arg);
+	c->callback(PMEMKV_STATUS_OK, value, valuebytes, c->arg);
+}
+
+void async_executor::execute_get(request &req)
+{
+	get_context ctx = {req.callback, req.arg};
+
+	auto s = catch_status([&] { return engine.get(req.key, get_value_callback, &ctx); });
+
+	if (s != status::OK)
+		req.callback(static_cast<int>(s), nullptr, 0, req.arg);
+}
+
+} /* namespace internal */
+} /* namespace kv */
+} /* namespace pmem */
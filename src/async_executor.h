@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#ifndef LIBPMEMKV_ASYNC_EXECUTOR_H
+#define LIBPMEMKV_ASYNC_EXECUTOR_H
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "libpmemkv.hpp"
+
+namespace pmem
+{
+namespace kv
+{
+
+class engine_base;
+
+namespace internal
+{
+
+/**
+ * async_executor is a pool of worker threads serving asynchronous put and get
+ * requests of a single engine instance. If it has no workers, requests are
+ * executed synchronously, in the caller's thread.
+ *
+ * Every worker has its own bounded queue. Requests are assigned to workers by
+ * hash of the key, so requests for the same key are always executed in the
+ * order of submission. Adjacent puts in a queue are coalesced (up to max_batch
+ * of them) and applied with a single engine_base::apply_batch() call.
+ */
+class async_executor {
+public:
+	async_executor(engine_base &engine, std::size_t workers, std::size_t queue_size,
+		       std::size_t max_batch);
+
+	/* Executes all pending requests and joins worker threads */
+	~async_executor();
+
+	async_executor(const async_executor &) = delete;
+	async_executor &operator=(const async_executor &) = delete;
+
+	void put(string_view key, string_view value, completion_callback *callback,
+		 void *arg);
+	void get(string_view key, completion_callback *callback, void *arg);
+
+private:
+	struct request {
+		enum class type { put, get };
+
+		type op;
+		std::string key;
+		std::string value;
+		completion_callback *callback;
+		void *arg;
+	};
+
+	struct worker {
+		std::mutex mtx;
+		std::condition_variable not_empty;
+		std::condition_variable not_full;
+		std::deque<request> queue;
+		bool stop = false;
+		std::thread thread;
+	};
+
+	void stop();
+	void submit(request &&req);
+	void run(worker &w);
+	void execute_puts(std::vector<request> &reqs);
+	void execute_get(request &req);
+
+	engine_base &engine;
+	std::size_t queue_size;
+	std::size_t max_batch;
+	std::vector<std::unique_ptr<worker>> workers;
+};
+
+} /* namespace internal */
+} /* namespace kv */
+} /* namespace pmem */
+
+#endif /* LIBPMEMKV_ASYNC_EXECUTOR_H */
@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "bulk_load.h"
+#include "exceptions.h"
+
+namespace pmem
+{
+namespace kv
+{
+namespace internal
+{
+
+file_source::file_source(const std::string &path)
+    : path(path), file(path, std::ios::in | std::ios::binary)
+{
+	if (!file.is_open())
+		throw internal::invalid_argument("Cannot open bulk load file: " + path);
+}
+
+bool file_source::next(string_view &key, string_view &value)
+{
+	uint64_t sizes[2];
+
+	file.read(reinterpret_cast<char *>(sizes), sizeof(sizes));
+	if (file.gcount() == 0 && file.eof())
+		return false;
+
+	if (!file)
+		throw internal::invalid_argument("Bulk load file is truncated: " + path);
+
+	buffer.resize(sizes[0] + sizes[1]);
+	if (!file.read(&buffer[0], static_cast<std::streamsize>(buffer.size())))
+		throw internal::invalid_argument("Bulk load file is truncated: " + path);
+
+	key = string_view(buffer.data(), sizes[0]);
+	value = string_view(buffer.data() + sizes[0], sizes[1]);
+	return true;
+}
+
+} /* namespace internal */
+} /* namespace kv */
+} /* namespace pmem */
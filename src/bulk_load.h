@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#ifndef LIBPMEMKV_BULK_LOAD_H
+#define LIBPMEMKV_BULK_LOAD_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "libpmemkv.h"
+#include "libpmemkv.hpp"
+
+namespace pmem
+{
+namespace kv
+{
+namespace internal
+{
+
+/**
+ * bulk_load_source is a stream of records consumed by
+ * engine_base::bulk_load(). Records are expected to be sorted by key, in
+ * ascending order (according to the comparator of the engine).
+ */
+class bulk_load_source {
+public:
+	virtual ~bulk_load_source() = default;
+
+	/*
+	 * Sets key and value to the next record. They stay valid until the next
+	 * call. Returns false at the end of the stream.
+	 */
+	virtual bool next(string_view &key, string_view &value) = 0;
+};
+
+/**
+ * Reads records from a user's callback (see pmemkv_bulk_load()).
+ */
+class callback_source : public bulk_load_source {
+public:
+	callback_source(pmemkv_bulk_load_callback *callback, void *arg)
+	    : callback(callback), arg(arg)
+	{
+	}
+
+	bool next(string_view &key, string_view &value) override
+	{
+		const char *k = nullptr, *v = nullptr;
+		size_t kb = 0, vb = 0;
+
+		if (callback(&k, &kb, &v, &vb, arg) != 0)
+			return false;
+
+		key = string_view(k, kb);
+		value = string_view(v, vb);
+		return true;
+	}
+
+private:
+	pmemkv_bulk_load_callback *callback;
+	void *arg;
+};
+
+/**
+ * Reads records from a file (see pmemkv_bulk_load_file()). Each record is
+ * stored as the key size and the value size (both as 8-byte integers in
+ * native byte order), followed by the key and the value.
+ */
+class file_source : public bulk_load_source {
+public:
+	explicit file_source(const std::string &path);
+
+	bool next(string_view &key, string_view &value) override;
+
+private:
+	std::string path;
+	std::ifstream file;
+	std::string buffer;
+};
+
+} /* namespace internal */
+} /* namespace kv */
+} /* namespace pmem */
+
+#endif /* LIBPMEMKV_BULK_LOAD_H */
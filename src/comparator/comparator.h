@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2020, Intel Corporation */
+/* Copyright 2020-2021, Intel Corporation */
 
 #ifndef LIBPMEMKV_COMPARATOR_H
 #define LIBPMEMKV_COMPARATOR_H
@@ -77,6 +77,15 @@ static inline const comparator *extract_comparator(internal::config &cfg)
 		return cmp;
 }
 
+/*
+ * Checks if keys are ordered by their binary representation (so keys with
+ * a common prefix are adjacent).
+ */
+static inline bool has_binary_order(internal::config &cfg)
+{
+	return extract_comparator(cfg) == &internal::binary_comparator();
+}
+
 } /* namespace internal */
 } /* namespace kv */
 } /* namespace pmem */
@@ -2,6 +2,10 @@
 /* Copyright 2017-2021, Intel Corporation */
 
 #include "engine.h"
+#include "async_executor.h"
+#include "parallel_scan.h"
+
+#include <atomic>
 
 namespace pmem
 {
@@ -58,6 +62,15 @@ void check_config_null(const std::string &engine_name,
 	}
 }
 
+/* source of unique ids of engine instances */
+static std::atomic<uint64_t> engine_ids(0);
+
+engine_base::engine_base() : engine_id(++engine_ids)
+{
+}
+
+engine_base::~engine_base() = default;
+
 status engine_base::count_all(std::size_t &cnt)
 {
 	return status::NOT_SUPPORTED;
@@ -118,16 +131,451 @@ status engine_base::get_between(string_view key1, string_view key2,
 	return status::NOT_SUPPORTED;
 }
 
+status engine_base::get_all_desc(get_kv_callback *callback, void *arg)
+{
+	return status::NOT_SUPPORTED;
+}
+
+status engine_base::get_above_desc(string_view key, get_kv_callback *callback, void *arg)
+{
+	return status::NOT_SUPPORTED;
+}
+
+status engine_base::get_equal_above_desc(string_view key, get_kv_callback *callback,
+					 void *arg)
+{
+	return status::NOT_SUPPORTED;
+}
+
+status engine_base::get_equal_below_desc(string_view key, get_kv_callback *callback,
+					 void *arg)
+{
+	return status::NOT_SUPPORTED;
+}
+
+status engine_base::get_below_desc(string_view key, get_kv_callback *callback, void *arg)
+{
+	return status::NOT_SUPPORTED;
+}
+
+status engine_base::get_between_desc(string_view key1, string_view key2,
+				     get_kv_callback *callback, void *arg)
+{
+	return status::NOT_SUPPORTED;
+}
+
+struct prefix_context {
+	string_view prefix;
+	get_kv_callback *callback;
+	void *arg;
+};
+
+static int prefix_callback(const char *k, size_t kb, const char *v, size_t vb, void *arg)
+{
+	auto c = static_cast<prefix_context *>(arg);
+
+	if (!internal::has_prefix(string_view(k, kb), c->prefix))
+		return 0;
+
+	return c->callback(k, kb, v, vb, c->arg);
+}
+
+/*
+ * Generic implementation, for engines which cannot find the range of keys with
+ * given prefix (unsorted engines or custom comparators) - filters all records.
+ */
+status engine_base::get_prefix(string_view prefix, get_kv_callback *callback, void *arg)
+{
+	prefix_context ctx = {prefix, callback, arg};
+
+	return get_all(prefix_callback, &ctx);
+}
+
+static int count_callback(const char *, size_t, const char *, size_t, void *arg)
+{
+	++(*static_cast<std::size_t *>(arg));
+
+	return 0;
+}
+
+status engine_base::count_prefix(string_view prefix, std::size_t &cnt)
+{
+	cnt = 0;
+
+	return get_prefix(prefix, count_callback, &cnt);
+}
+
+struct keys_context {
+	get_k_callback *callback;
+	void *arg;
+};
+
+static int keys_callback(const char *k, size_t kb, const char *, size_t, void *arg)
+{
+	auto c = static_cast<keys_context *>(arg);
+
+	return c->callback(k, kb, c->arg);
+}
+
+/*
+ * Generic implementations of key-only scans, for engines which do not store
+ * keys apart from values - values are accessed anyway, just not passed on.
+ */
+status engine_base::get_keys(get_k_callback *callback, void *arg)
+{
+	keys_context ctx = {callback, arg};
+
+	return get_all(keys_callback, &ctx);
+}
+
+status engine_base::get_keys_above(string_view key, get_k_callback *callback, void *arg)
+{
+	keys_context ctx = {callback, arg};
+
+	return get_above(key, keys_callback, &ctx);
+}
+
+status engine_base::get_keys_below(string_view key, get_k_callback *callback, void *arg)
+{
+	keys_context ctx = {callback, arg};
+
+	return get_below(key, keys_callback, &ctx);
+}
+
+status engine_base::get_keys_between(string_view key1, string_view key2,
+				     get_k_callback *callback, void *arg)
+{
+	keys_context ctx = {callback, arg};
+
+	return get_between(key1, key2, keys_callback, &ctx);
+}
+
+status engine_base::get_split_points(std::size_t partitions, std::vector<std::string> &keys)
+{
+	return status::NOT_SUPPORTED;
+}
+
+struct split_key_context {
+	string_view key;
+	get_kv_callback *callback;
+	void *arg;
+	int ret;
+};
+
+static void split_key_callback(const char *v, size_t vb, void *arg)
+{
+	auto c = static_cast<split_key_context *>(arg);
+	c->ret = c->callback(c->key.data(), c->key.size(), v, vb, c->arg);
+}
+
+/*
+ * Scans keys from split key (inclusive) up to the next one (exclusive).
+ * Split keys don't have to exist, so the first one is read separately.
+ */
+static status scan_partition(engine_base &engine, const std::vector<std::string> &keys,
+			     std::size_t i, internal::parallel_scan &scan)
+{
+	auto callback = internal::parallel_scan::callback;
+
+	if (keys.empty())
+		return engine.get_all(callback, &scan);
+	if (i == 0)
+		return engine.get_below(keys.front(), callback, &scan);
+
+	split_key_context ctx = {keys[i - 1], callback, &scan, 0};
+	auto s = engine.get(keys[i - 1], split_key_callback, &ctx);
+	if (s != status::OK && s != status::NOT_FOUND)
+		return s;
+	if (ctx.ret != 0)
+		return status::STOPPED_BY_CB;
+
+	if (i == keys.size())
+		return engine.get_above(keys.back(), callback, &scan);
+
+	return engine.get_between(keys[i - 1], keys[i], callback, &scan);
+}
+
+/*
+ * Generic implementation, for sorted engines: keyspace is split at keys
+ * returned by get_split_points() and every range is scanned by a separate
+ * thread. Engines which can't split the keyspace scan it in the caller's
+ * thread (as get_all()).
+ */
+status engine_base::get_all_parallel(std::size_t partitions, get_kv_callback *callback,
+				     void *arg)
+{
+	std::vector<std::string> keys;
+	auto s = get_split_points(partitions, keys);
+	if (s == status::NOT_SUPPORTED)
+		return get_all(callback, arg);
+	if (s != status::OK)
+		return s;
+
+	internal::parallel_scan scan(callback, arg);
+
+	return scan.run(keys.size() + 1, [&](std::size_t i) {
+		return scan_partition(*this, keys, i, scan);
+	});
+}
+
+struct page_context {
+	internal::scan_cursor *cursor;
+	get_kv_callback *callback;
+	void *arg;
+	std::size_t count;
+	std::size_t bytes;
+	std::string last_key;
+	bool full;
+	bool stopped;
+};
+
+static int page_callback(const char *key, size_t keybytes, const char *value,
+			 size_t valuebytes, void *arg)
+{
+	auto c = static_cast<page_context *>(arg);
+
+	if (c->count > 0 && !c->cursor->fits(c->count, c->bytes, keybytes + valuebytes)) {
+		c->full = true;
+		return 1;
+	}
+
+	c->count++;
+	c->bytes += keybytes + valuebytes;
+	c->last_key.assign(key, keybytes);
+
+	if (c->callback(key, keybytes, value, valuebytes, c->arg) != 0) {
+		c->stopped = true;
+		return 1;
+	}
+
+	return 0;
+}
+
+/*
+ * Translates result of a regular scan, stopped by page_callback() when the page
+ * is full, into the result of a paginated scan.
+ */
+static status finish_page(page_context &ctx, status s)
+{
+	if (s == status::STOPPED_BY_CB && !ctx.stopped)
+		s = status::OK;
+
+	if (s != status::OK && s != status::STOPPED_BY_CB)
+		return s;
+
+	if (ctx.full || ctx.stopped)
+		ctx.cursor->set_next_key(std::move(ctx.last_key));
+	else
+		ctx.cursor->reset();
+
+	return s;
+}
+
+status engine_base::get_by_rank(std::size_t n, get_kv_callback *callback, void *arg)
+{
+	return status::NOT_SUPPORTED;
+}
+
+status engine_base::rank_of(string_view key, std::size_t &rank)
+{
+	return status::NOT_SUPPORTED;
+}
+
+/*
+ * Default implementations of paginated scans are built on top of regular
+ * scans, stopped when the page is full. Every page starts with a seek.
+ */
+status engine_base::get_above_page(string_view key, internal::scan_cursor &cursor,
+				   get_kv_callback *callback, void *arg)
+{
+	page_context ctx = {&cursor, callback, arg, 0, 0, std::string(), false, false};
+
+	return finish_page(ctx, get_above(key, page_callback, &ctx));
+}
+
+status engine_base::get_between_page(string_view key1, string_view key2,
+				     internal::scan_cursor &cursor,
+				     get_kv_callback *callback, void *arg)
+{
+	page_context ctx = {&cursor, callback, arg, 0, 0, std::string(), false, false};
+
+	return finish_page(ctx, get_between(key1, key2, page_callback, &ctx));
+}
+
 status engine_base::exists(string_view key)
 {
 	return status::NOT_SUPPORTED;
 }
 
+struct get_many_context {
+	get_many_callback *callback;
+	void *arg;
+	std::size_t idx;
+};
+
+static void get_many_value_callback(const char *value, size_t valuebytes, void *arg)
+{
+	auto c = static_cast<get_many_context *>(arg);
+	c->callback(c->idx, PMEMKV_STATUS_OK, value, valuebytes, c->arg);
+}
+
+/*
+ * Default implementation simply looks up keys one by one. Engines which can
+ * resolve multiple keys at once (and overlap memory accesses) should override it.
+ */
+status engine_base::get_many(const std::vector<string_view> &keys,
+			     get_many_callback *callback, void *arg)
+{
+	for (std::size_t i = 0; i < keys.size(); ++i) {
+		get_many_context ctx = {callback, arg, i};
+		auto s = get(keys[i], get_many_value_callback, &ctx);
+		if (s != status::OK)
+			callback(i, static_cast<int>(s), nullptr, 0, arg);
+	}
+
+	return status::OK;
+}
+
+static void get_pinned_copy_callback(const char *value, size_t valuebytes, void *arg)
+{
+	static_cast<std::string *>(arg)->assign(value, valuebytes);
+}
+
+/*
+ * Default implementation copies the value, so it works for every engine.
+ * Engines which can keep the record protected (and its memory valid) outside
+ * of the get() callback should override it and avoid the copy.
+ */
+status engine_base::get_pinned(string_view key,
+			       std::unique_ptr<internal::pinned_value> &pinned)
+{
+	std::string value;
+	auto s = get(key, get_pinned_copy_callback, &value);
+	if (s != status::OK)
+		return s;
+
+	pinned.reset(new internal::copied_pinned_value(std::move(value)));
+
+	return status::OK;
+}
+
+static void value_size_callback(const char *value, size_t valuebytes, void *arg)
+{
+	*static_cast<std::size_t *>(arg) = valuebytes;
+}
+
+/*
+ * Default implementation takes the size from get(), without copying the
+ * value. Engines which keep the length apart from the value's data should
+ * override it and read only the length.
+ */
+status engine_base::value_size(string_view key, std::size_t &size)
+{
+	return get(key, value_size_callback, &size);
+}
+
+status engine_base::put_with_ttl(string_view key, string_view value,
+				 std::chrono::milliseconds ttl)
+{
+	return status::NOT_SUPPORTED;
+}
+
+status engine_base::merge(string_view key, string_view operand)
+{
+	return status::NOT_SUPPORTED;
+}
+
+status engine_base::put_if_absent(string_view key, string_view value)
+{
+	return status::NOT_SUPPORTED;
+}
+
+status engine_base::compare_and_swap(string_view key, string_view expected,
+				     string_view desired)
+{
+	return status::NOT_SUPPORTED;
+}
+
+status engine_base::remove_if(string_view key, string_view expected)
+{
+	return status::NOT_SUPPORTED;
+}
+
+status engine_base::remove_range(string_view key1, string_view key2)
+{
+	return status::NOT_SUPPORTED;
+}
+
+static int collect_key_callback(const char *k, size_t kb, const char *, size_t,
+				void *arg)
+{
+	static_cast<std::vector<std::string> *>(arg)->emplace_back(k, kb);
+
+	return 0;
+}
+
+/*
+ * Generic implementation, for engines which cannot remove the range of keys
+ * with given prefix at once - keys are collected first (as they can't be
+ * removed in the middle of a scan) and then removed one by one.
+ */
+status engine_base::remove_prefix(string_view prefix)
+{
+	std::vector<std::string> keys;
+	auto s = get_prefix(prefix, collect_key_callback, &keys);
+	if (s != status::OK)
+		return s;
+
+	for (auto &key : keys) {
+		s = remove(key);
+		if (s != status::OK && s != status::NOT_FOUND)
+			return s;
+	}
+
+	return status::OK;
+}
+
+/*
+ * Default implementation applies operations one by one, using put() and
+ * remove(). Removing a non-existing key is not treated as an error.
+ */
+status engine_base::apply_batch(const internal::write_batch &batch)
+{
+	return batch.foreach ([&](const internal::write_batch::entry &e) -> status {
+		if (e.op == internal::write_batch::operation::put)
+			return put(e.key, e.value);
+
+		auto s = remove(e.key);
+		return s == status::NOT_FOUND ? status::OK : s;
+	});
+}
+
+/*
+ * Default implementation inserts records one by one, using put(), so it
+ * works for engines which are not empty or do not keep records sorted.
+ */
+status engine_base::bulk_load(internal::bulk_load_source &source)
+{
+	string_view key, value;
+	while (source.next(key, value)) {
+		auto s = put(key, value);
+		if (s != status::OK)
+			return s;
+	}
+
+	return status::OK;
+}
+
 status engine_base::defrag(double start_percent, double amount_percent)
 {
 	return status::NOT_SUPPORTED;
 }
 
+status engine_base::memory_usage(pmemkv_memory_usage &usage)
+{
+	return status::NOT_SUPPORTED;
+}
+
 internal::transaction *engine_base::begin_tx()
 {
 	throw internal::not_supported("Transactions are not supported in this engine");
@@ -143,5 +591,129 @@ engine_base::iterator *engine_base::new_const_iterator()
 	throw internal::not_supported("Iterators are not supported in this engine");
 }
 
+internal::snapshot *engine_base::new_snapshot()
+{
+	throw internal::not_supported("Snapshots are not supported in this engine");
+}
+
+status engine_base::put_async(string_view key, string_view value,
+			      completion_callback *callback, void *arg)
+{
+	if (!executor)
+		return status::NOT_SUPPORTED;
+
+	executor->put(key, value, callback, arg);
+
+	return status::OK;
+}
+
+status engine_base::get_async(string_view key, completion_callback *callback, void *arg)
+{
+	if (!executor)
+		return status::NOT_SUPPORTED;
+
+	executor->get(key, callback, arg);
+
+	return status::OK;
+}
+
+void engine_base::start_async(std::size_t workers, std::size_t queue_size,
+			      std::size_t max_batch)
+{
+	executor.reset(new internal::async_executor(*this, workers, queue_size, max_batch));
+}
+
+/*
+ * Engines call it with the same synchronization as the modification itself,
+ * e.g. concurrent engines under an exclusive lock.
+ */
+void engine_base::invalidate_scan_positions()
+{
+	scan_positions_version++;
+}
+
+internal::scan_cursor::version_type engine_base::scan_version() const
+{
+	return {engine_id, scan_positions_version};
+}
+
+void engine_base::enable_stats()
+{
+	statistics.reset(new internal::stats());
+}
+
+internal::stats *engine_base::op_stats()
+{
+	return statistics.get();
+}
+
+status engine_base::get_stats(std::string &json)
+{
+	if (!statistics)
+		throw internal::not_supported(
+			"Statistics are not enabled, set \"stats\" in config");
+
+	internal::engine_counters counters;
+	get_engine_counters(counters);
+
+	json = statistics->to_json(name(), counters);
+
+	return status::OK;
+}
+
+void engine_base::get_engine_counters(internal::engine_counters &counters)
+{
+}
+
+void engine_base::enable_flight_recorder(std::size_t entries,
+					 const std::string &fatal_dump_path)
+{
+	recorder.reset(new internal::flight_recorder(entries, fatal_dump_path));
+}
+
+internal::flight_recorder *engine_base::op_recorder()
+{
+	return recorder.get();
+}
+
+status engine_base::flight_recorder_dump(const std::string &path)
+{
+	if (!recorder)
+		throw internal::not_supported(
+			"Flight recorder is not enabled, set \"flight_recorder\" in config");
+
+	recorder->dump(path);
+
+	return status::OK;
+}
+
+void engine_base::enable_slow_op_log(std::chrono::microseconds threshold)
+{
+	slow_operations.reset(new internal::slow_op_log(threshold));
+}
+
+internal::slow_op_log *engine_base::slow_ops()
+{
+	return slow_operations.get();
+}
+
+status engine_base::get_slow_ops(pmemkv_slow_op_callback *callback, void *arg)
+{
+	if (!slow_operations)
+		throw internal::not_supported(
+			"Slow operation log is not enabled, set \"slow_op_threshold_us\" in config");
+
+	return slow_operations->get_all(callback, arg);
+}
+
+/*
+ * Must be called before the engine is destroyed, because workers still
+ * executing pending requests use (virtual) methods of the engine.
+ */
+void engine_base::stop_async()
+{
+	executor.reset();
+}
+
 } // namespace kv
 } // namespace pmem
@@ -4,20 +4,35 @@
 #ifndef LIBPMEMKV_ENGINE_H
 #define LIBPMEMKV_ENGINE_H
 
+#include <chrono>
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "bulk_load.h"
 #include "config.h"
+#include "flight_recorder.h"
 #include "iterator.h"
 #include "libpmemkv.hpp"
+#include "pinned_value.h"
+#include "scan_cursor.h"
+#include "slow_op_log.h"
+#include "snapshot.h"
+#include "stats.h"
 #include "transaction.h"
+#include "write_batch.h"
 
 namespace pmem
 {
 namespace kv
 {
 
+namespace internal
+{
+class async_executor;
+}
+
 void check_config_null(const std::string &engine_name,
 		       std::unique_ptr<internal::config> &cfg);
 
@@ -33,8 +48,8 @@ class engine_base {
 	using iterator = internal::iterator_base;
 
 public:
-	engine_base() = default;
-	virtual ~engine_base() = default;
+	engine_base();
+	virtual ~engine_base();
 
 	virtual std::string name() = 0;
 
@@ -56,18 +71,105 @@ public:
 	virtual status get_between(string_view key1, string_view key2,
 				   get_kv_callback *callback, void *arg);
 
+	virtual status get_all_desc(get_kv_callback *callback, void *arg);
+	virtual status get_above_desc(string_view key, get_kv_callback *callback,
+				      void *arg);
+	virtual status get_equal_above_desc(string_view key, get_kv_callback *callback,
+					    void *arg);
+	virtual status get_equal_below_desc(string_view key, get_kv_callback *callback,
+					    void *arg);
+	virtual status get_below_desc(string_view key, get_kv_callback *callback,
+				      void *arg);
+	virtual status get_between_desc(string_view key1, string_view key2,
+					get_kv_callback *callback, void *arg);
+
+	virtual status count_prefix(string_view prefix, std::size_t &cnt);
+	virtual status get_prefix(string_view prefix, get_kv_callback *callback,
+				  void *arg);
+
+	virtual status get_keys(get_k_callback *callback, void *arg);
+	virtual status get_keys_above(string_view key, get_k_callback *callback,
+				      void *arg);
+	virtual status get_keys_below(string_view key, get_k_callback *callback,
+				      void *arg);
+	virtual status get_keys_between(string_view key1, string_view key2,
+					get_k_callback *callback, void *arg);
+
+	virtual status get_split_points(std::size_t partitions,
+					std::vector<std::string> &keys);
+	virtual status get_all_parallel(std::size_t partitions, get_kv_callback *callback,
+					void *arg);
+
+	virtual status get_by_rank(std::size_t n, get_kv_callback *callback, void *arg);
+	virtual status rank_of(string_view key, std::size_t &rank);
+
+	virtual status get_above_page(string_view key, internal::scan_cursor &cursor,
+				      get_kv_callback *callback, void *arg);
+	virtual status get_between_page(string_view key1, string_view key2,
+					internal::scan_cursor &cursor,
+					get_kv_callback *callback, void *arg);
+
 	virtual status exists(string_view key);
 
 	virtual status get(string_view key, get_v_callback *callback, void *arg) = 0;
+	virtual status get_many(const std::vector<string_view> &keys,
+				get_many_callback *callback, void *arg);
+	virtual status get_pinned(string_view key,
+				  std::unique_ptr<internal::pinned_value> &pinned);
+	virtual status value_size(string_view key, std::size_t &size);
 	virtual status put(string_view key, string_view value) = 0;
+	virtual status put_with_ttl(string_view key, string_view value,
+				    std::chrono::milliseconds ttl);
+	virtual status merge(string_view key, string_view operand);
+	virtual status put_if_absent(string_view key, string_view value);
+	virtual status compare_and_swap(string_view key, string_view expected,
+					string_view desired);
+	virtual status remove_if(string_view key, string_view expected);
 	virtual status remove(string_view key) = 0;
+	virtual status remove_range(string_view key1, string_view key2);
+	virtual status remove_prefix(string_view prefix);
+	virtual status apply_batch(const internal::write_batch &batch);
+	virtual status bulk_load(internal::bulk_load_source &source);
 	virtual status defrag(double start_percent, double amount_percent);
+	virtual status memory_usage(pmemkv_memory_usage &usage);
 
 	virtual internal::transaction *begin_tx();
 
 	virtual iterator *new_iterator();
 	virtual iterator *new_const_iterator();
 
+	virtual internal::snapshot *new_snapshot();
+
+	status put_async(string_view key, string_view value, completion_callback *callback,
+			 void *arg);
+	status get_async(string_view key, completion_callback *callback, void *arg);
+
+	void start_async(std::size_t workers, std::size_t queue_size,
+			 std::size_t max_batch);
+	void stop_async();
+
+	/* Positions cached in scan cursors by previous pages can't be used anymore */
+	void invalidate_scan_positions();
+
+	void enable_stats();
+	/* Returns nullptr if stats are not enabled */
+	internal::stats *op_stats();
+	status get_stats(std::string &json);
+
+	/* Adds engine-specific counters to the output of get_stats() */
+	virtual void get_engine_counters(internal::engine_counters &counters);
+
+	void enable_flight_recorder(std::size_t entries,
+				    const std::string &fatal_dump_path);
+	/* Returns nullptr if flight recorder is not enabled */
+	internal::flight_recorder *op_recorder();
+	status flight_recorder_dump(const std::string &path);
+
+	void enable_slow_op_log(std::chrono::microseconds threshold);
+	/* Returns nullptr if slow operation log is not enabled */
+	internal::slow_op_log *slow_ops();
+	status get_slow_ops(pmemkv_slow_op_callback *callback, void *arg);
+
 	/**
 	 * factory_base is an interface for engine factory.
 	 * Should be implemented for registration purposes.
@@ -80,6 +182,26 @@ public:
 			create(std::unique_ptr<internal::config>) = 0;
 		virtual std::string get_name() = 0;
 	};
+
+protected:
+	internal::scan_cursor::version_type scan_version() const;
+
+private:
+	/* serves put_async() and get_async(), created by pmemkv_open() */
+	std::unique_ptr<internal::async_executor> executor;
+
+	/* created by pmemkv_open() if "stats" config flag is set */
+	std::unique_ptr<internal::stats> statistics;
+
+	/* created by pmemkv_open() if "flight_recorder" config item is set */
+	std::unique_ptr<internal::flight_recorder> recorder;
+
+	/* created by pmemkv_open() if "slow_op_threshold_us" config item is set */
+	std::unique_ptr<internal::slow_op_log> slow_operations;
+
+	/* see internal::scan_cursor */
+	const uint64_t engine_id;
+	uint64_t scan_positions_version = 0;
 };
 
 /**
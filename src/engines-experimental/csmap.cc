@@ -12,7 +12,9 @@ namespace kv
 {
 
 csmap::csmap(std::unique_ptr<internal::config> cfg)
-    : pmemobj_engine_base(cfg, "pmemkv_csmap"), config(std::move(cfg))
+    : pmemobj_engine_base(cfg, "pmemkv_csmap"),
+      config(std::move(cfg)),
+      versions(internal::extract_comparator(*config))
 {
 	Recover();
 	LOG("Started ok");
@@ -215,6 +217,340 @@ status csmap::get_between(string_view key1, string_view key2, get_kv_callback *c
 	return status::OK;
 }
 
+/*
+ * Visits elements in [first, last) in descending order. The skip list has no
+ * backward links, so every element is found with find_lower() of the previous
+ * one. If the range is not bounded by an element (last is end()), there is no
+ * direct way to reach the tail - its last element is found in a single forward
+ * pass, keeping only the most recent iterator.
+ */
+status csmap::iterate_desc(typename container_type::iterator first,
+			   typename container_type::iterator last,
+			   get_kv_callback *callback, void *arg)
+{
+	auto call = [&](const container_type::iterator &it) {
+		shared_node_lock_type lock(it->second.mtx);
+
+		return callback(it->first.c_str(), it->first.size(),
+				it->second.val.c_str(), it->second.val.size(), arg);
+	};
+
+	if (first == last)
+		return status::OK;
+
+	auto it = last;
+	if (last == container->end()) {
+		it = first;
+		for (auto next = std::next(first); next != last; ++next)
+			it = next;
+
+		if (call(it) != 0)
+			return status::STOPPED_BY_CB;
+	}
+
+	while (it != first) {
+		it = container->find_lower(it->first);
+		assert(it != container->end());
+
+		if (call(it) != 0)
+			return status::STOPPED_BY_CB;
+	}
+
+	return status::OK;
+}
+
+status csmap::get_all_desc(get_kv_callback *callback, void *arg)
+{
+	LOG("get_all_desc");
+	check_outside_tx();
+
+	shared_global_lock_type lock(mtx);
+
+	return iterate_desc(container->begin(), container->end(), callback, arg);
+}
+
+status csmap::get_above_desc(string_view key, get_kv_callback *callback, void *arg)
+{
+	LOG("get_above_desc for key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	shared_global_lock_type lock(mtx);
+
+	auto first = container->upper_bound(key);
+	auto last = container->end();
+
+	return iterate_desc(first, last, callback, arg);
+}
+
+status csmap::get_equal_above_desc(string_view key, get_kv_callback *callback, void *arg)
+{
+	LOG("get_equal_above_desc for key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	shared_global_lock_type lock(mtx);
+
+	auto first = container->lower_bound(key);
+	auto last = container->end();
+
+	return iterate_desc(first, last, callback, arg);
+}
+
+status csmap::get_equal_below_desc(string_view key, get_kv_callback *callback, void *arg)
+{
+	LOG("get_equal_below_desc for key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	shared_global_lock_type lock(mtx);
+
+	auto first = container->begin();
+	auto last = container->upper_bound(key);
+
+	return iterate_desc(first, last, callback, arg);
+}
+
+status csmap::get_below_desc(string_view key, get_kv_callback *callback, void *arg)
+{
+	LOG("get_below_desc for key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	shared_global_lock_type lock(mtx);
+
+	auto first = container->begin();
+	auto last = container->lower_bound(key);
+
+	return iterate_desc(first, last, callback, arg);
+}
+
+status csmap::get_between_desc(string_view key1, string_view key2,
+			       get_kv_callback *callback, void *arg)
+{
+	LOG("get_between_desc for key1=" << std::string(key1.data(), key1.size())
+					 << ", key2="
+					 << std::string(key2.data(), key2.size()));
+	check_outside_tx();
+
+	if (container->key_comp()(key1, key2)) {
+		shared_global_lock_type lock(mtx);
+
+		auto first = container->upper_bound(key1);
+		auto last = container->lower_bound(key2);
+		return iterate_desc(first, last, callback, arg);
+	}
+
+	return status::OK;
+}
+
+status csmap::count_prefix(string_view prefix, std::size_t &cnt)
+{
+	LOG("count_prefix for prefix=" << std::string(prefix.data(), prefix.size()));
+	check_outside_tx();
+
+	if (!internal::has_binary_order(*config))
+		return engine_base::count_prefix(prefix, cnt);
+
+	shared_global_lock_type lock(mtx);
+
+	cnt = 0;
+	for (auto it = container->lower_bound(prefix); it != container->end(); ++it) {
+		string_view key(it->first.c_str(), it->first.size());
+		if (!internal::has_prefix(key, prefix))
+			break;
+		cnt++;
+	}
+
+	return status::OK;
+}
+
+/*
+ * Keys starting with prefix are adjacent, if they are ordered by binary
+ * representation - the scan starts at the first key not less than the prefix
+ * and ends at the first key which does not start with it. With a custom
+ * comparator all records are checked.
+ */
+status csmap::get_prefix(string_view prefix, get_kv_callback *callback, void *arg)
+{
+	LOG("get_prefix for prefix=" << std::string(prefix.data(), prefix.size()));
+	check_outside_tx();
+
+	if (!internal::has_binary_order(*config))
+		return engine_base::get_prefix(prefix, callback, arg);
+
+	shared_global_lock_type lock(mtx);
+
+	for (auto it = container->lower_bound(prefix); it != container->end(); ++it) {
+		string_view key(it->first.c_str(), it->first.size());
+		if (!internal::has_prefix(key, prefix))
+			break;
+
+		shared_node_lock_type node_lock(it->second.mtx);
+
+		auto ret = callback(it->first.c_str(), it->first.size(),
+				    it->second.val.c_str(), it->second.val.size(), arg);
+
+		if (ret != 0)
+			return status::STOPPED_BY_CB;
+	}
+
+	return status::OK;
+}
+
+/*
+ * Key-only scans - keys are never modified after insertion, so (unlike
+ * iterate()) node locks are not taken and values are not accessed.
+ */
+status csmap::get_keys(get_k_callback *callback, void *arg)
+{
+	LOG("get_keys");
+	check_outside_tx();
+
+	shared_global_lock_type lock(mtx);
+
+	return internal::iterate_through_keys(container->begin(), container->end(),
+					      callback, arg);
+}
+
+status csmap::get_keys_above(string_view key, get_k_callback *callback, void *arg)
+{
+	LOG("get_keys_above for key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	shared_global_lock_type lock(mtx);
+
+	return internal::iterate_through_keys(container->upper_bound(key),
+					      container->end(), callback, arg);
+}
+
+status csmap::get_keys_below(string_view key, get_k_callback *callback, void *arg)
+{
+	LOG("get_keys_below for key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	shared_global_lock_type lock(mtx);
+
+	return internal::iterate_through_keys(container->begin(),
+					      container->lower_bound(key), callback, arg);
+}
+
+status csmap::get_keys_between(string_view key1, string_view key2,
+			       get_k_callback *callback, void *arg)
+{
+	LOG("get_keys_between for key1=" << key1.data() << ", key2=" << key2.data());
+	check_outside_tx();
+
+	if (container->key_comp()(key1, key2)) {
+		shared_global_lock_type lock(mtx);
+
+		auto first = container->upper_bound(key1);
+		auto last = container->lower_bound(key2);
+		return internal::iterate_through_keys(first, last, callback, arg);
+	}
+
+	return status::OK;
+}
+
+/*
+ * The skip list does not expose its upper levels, so split points are found
+ * by walking the keys (values are not read).
+ */
+status csmap::get_split_points(std::size_t partitions, std::vector<std::string> &keys)
+{
+	LOG("get_split_points partitions=" << partitions);
+	check_outside_tx();
+
+	shared_global_lock_type lock(mtx);
+
+	auto bounds = internal::split_range(container->begin(), container->end(),
+					    container->size(), partitions);
+
+	keys.clear();
+	for (std::size_t i = 1; i + 1 < bounds.size(); i++)
+		keys.emplace_back(bounds[i]->first.c_str(), bounds[i]->first.size());
+
+	return status::OK;
+}
+
+csmap::locked_key_value csmap::key_value(const container_type::iterator &it)
+{
+	shared_node_lock_type lock(it->second.mtx);
+
+	return {string_view(it->first.c_str(), it->first.size()),
+		string_view(it->second.val.c_str(), it->second.val.size()), std::move(lock)};
+}
+
+void csmap::preserve(const container_type::iterator &it)
+{
+	string_view value(it->second.val.c_str(), it->second.val.size());
+
+	versions.preserve(string_view(it->first.c_str(), it->first.size()), &value);
+}
+
+/*
+ * try_emplace() which, if any snapshot is open, first preserves absence of
+ * the key. If another thread inserts the same key in the meantime, it does
+ * the same (in the same epoch, as the global lock is held).
+ */
+std::pair<csmap::container_type::iterator, bool> csmap::insert(string_view key,
+								string_view value)
+{
+	if (versions.active() && !container->contains(key))
+		versions.preserve(key, nullptr);
+
+	return container->try_emplace(key, value);
+}
+
+/*
+ * Pages are continued from the cached node of the last returned element,
+ * unless any element was erased since (erase requires the exclusive lock).
+ * Elements inserted concurrently after that node are visible, as with
+ * a regular seek.
+ */
+status csmap::get_above_page(string_view key, internal::scan_cursor &cursor,
+			     get_kv_callback *callback, void *arg)
+{
+	LOG("get_above_page for key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	shared_global_lock_type lock(mtx);
+
+	auto first = container->end();
+	if (!cursor.resume(key, scan_version(), first))
+		first = container->upper_bound(key);
+	auto last = container->end();
+
+	return cursor.fill(
+		first, [&](const container_type::iterator &it) { return it == last; },
+		key_value, scan_version(), callback, arg);
+}
+
+status csmap::get_between_page(string_view key1, string_view key2,
+			       internal::scan_cursor &cursor, get_kv_callback *callback,
+			       void *arg)
+{
+	LOG("get_between_page for key1=" << std::string(key1.data(), key1.size())
+					 << ", key2="
+					 << std::string(key2.data(), key2.size()));
+	check_outside_tx();
+
+	if (!container->key_comp()(key1, key2)) {
+		cursor.reset();
+		return status::OK;
+	}
+
+	shared_global_lock_type lock(mtx);
+
+	auto first = container->end();
+	if (!cursor.resume(key1, scan_version(), first))
+		first = container->upper_bound(key1);
+	auto last = container->end();
+
+	return cursor.fill(
+		first,
+		[&](const container_type::iterator &it) {
+			return it == last || !container->key_comp()(it->first, key2);
+		},
+		key_value, scan_version(), callback, arg);
+}
+
 status csmap::exists(string_view key)
 {
 	LOG("exists for key=" << std::string(key.data(), key.size()));
@@ -241,6 +577,50 @@ status csmap::get(string_view key, get_v_callback *callback, void *arg)
 	return status::NOT_FOUND;
 }
 
+status csmap::value_size(string_view key, std::size_t &size)
+{
+	LOG("value_size key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	shared_global_lock_type lock(mtx);
+	auto it = container->find(key);
+	if (it != container->end()) {
+		shared_node_lock_type lock(it->second.mtx);
+		size = it->second.val.size();
+		return status::OK;
+	}
+
+	LOG("  key not found");
+	return status::NOT_FOUND;
+}
+
+/*
+ * Global lock (which prevents erase) and node lock (which prevents updates
+ * of the value) are both held in shared mode as long as the value is pinned.
+ */
+status csmap::get_pinned(string_view key, std::unique_ptr<internal::pinned_value> &pinned)
+{
+	LOG("get_pinned key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	shared_global_lock_type lock(mtx);
+	auto it = container->find(key);
+	if (it == container->end()) {
+		LOG("  key not found");
+		return status::NOT_FOUND;
+	}
+
+	using locks_type = std::pair<shared_global_lock_type, shared_node_lock_type>;
+
+	shared_node_lock_type node_lock(it->second.mtx);
+	auto value = string_view(it->second.val.c_str(), it->second.val.size());
+
+	pinned.reset(new internal::guarded_pinned_value<locks_type>(
+		locks_type(std::move(lock), std::move(node_lock)), value));
+
+	return status::OK;
+}
+
 status csmap::put(string_view key, string_view value)
 {
 	LOG("put key=" << std::string(key.data(), key.size())
@@ -249,11 +629,12 @@ status csmap::put(string_view key, string_view value)
 
 	shared_global_lock_type lock(mtx);
 
-	auto result = container->try_emplace(key, value);
+	auto result = insert(key, value);
 
 	if (result.second == false) {
 		auto &it = result.first;
 		unique_node_lock_type lock(it->second.mtx);
+		preserve(it);
 		pmem::obj::transaction::run(pmpool, [&] {
 			it->second.val.assign(value.data(), value.size());
 		});
@@ -262,12 +643,284 @@ status csmap::put(string_view key, string_view value)
 	return status::OK;
 }
 
+/*
+ * Takes the global lock in shared mode, as put() does. An existing record is
+ * modified under its node lock; if there is no record, the new value is
+ * inserted with try_emplace() and the merge is repeated (under the node lock)
+ * only if another thread inserted the key in the meantime.
+ */
+status csmap::merge(string_view key, string_view operand)
+{
+	LOG("merge key=" << std::string(key.data(), key.size())
+			 << ", operand.size=" << std::to_string(operand.size()));
+	check_outside_tx();
+
+	auto op = internal::extract_merge_operator(*config);
+	if (!op) {
+		out_err_stream("merge") << "merge operator not set in the config";
+		return status::INVALID_ARGUMENT;
+	}
+
+	auto merge_failed = [&]() {
+		out_err_stream("merge")
+			<< "merge operator \"" << op->name() << "\" failed";
+		return status::INVALID_ARGUMENT;
+	};
+
+	std::string new_value;
+
+	shared_global_lock_type lock(mtx);
+
+	auto it = container->find(key);
+	if (it == container->end()) {
+		if (!op->merge(key, nullptr, operand, new_value))
+			return merge_failed();
+
+		versions.preserve(key, nullptr);
+
+		auto result = container->try_emplace(
+			key, string_view(new_value.data(), new_value.size()));
+		if (result.second)
+			return status::OK;
+
+		it = result.first;
+	}
+
+	unique_node_lock_type node_lock(it->second.mtx);
+
+	string_view existing(it->second.val.c_str(), it->second.val.size());
+	if (!op->merge(key, &existing, operand, new_value))
+		return merge_failed();
+
+	preserve(it);
+
+	pmem::obj::transaction::run(pmpool, [&] {
+		it->second.val.assign(new_value.data(), new_value.size());
+	});
+
+	return status::OK;
+}
+
 status csmap::remove(string_view key)
 {
 	LOG("remove key=" << std::string(key.data(), key.size()));
 	check_outside_tx();
 	unique_global_lock_type lock(mtx);
-	return container->unsafe_erase(key) > 0 ? status::OK : status::NOT_FOUND;
+	invalidate_scan_positions();
+
+	auto it = container->find(key);
+	if (it == container->end())
+		return status::NOT_FOUND;
+
+	preserve(it);
+	container->unsafe_erase(it);
+
+	return status::OK;
+}
+
+/* The whole range is removed in a single pass, with the global lock taken once */
+status csmap::remove_range(string_view key1, string_view key2)
+{
+	LOG("remove_range for key1=" << std::string(key1.data(), key1.size())
+				     << ", key2=" << std::string(key2.data(), key2.size()));
+	check_outside_tx();
+
+	if (!container->key_comp()(key1, key2))
+		return status::OK;
+
+	unique_global_lock_type lock(mtx);
+	invalidate_scan_positions();
+
+	erase_range(container->lower_bound(key1), container->lower_bound(key2));
+
+	return status::OK;
+}
+
+status csmap::remove_prefix(string_view prefix)
+{
+	LOG("remove_prefix for prefix=" << std::string(prefix.data(), prefix.size()));
+	check_outside_tx();
+
+	if (!internal::has_binary_order(*config))
+		return engine_base::remove_prefix(prefix);
+
+	std::string bound;
+	bool bounded = internal::prefix_upper_bound(prefix, bound);
+
+	unique_global_lock_type lock(mtx);
+	invalidate_scan_positions();
+
+	erase_range(container->lower_bound(prefix),
+		    bounded ? container->lower_bound(bound) : container->end());
+
+	return status::OK;
+}
+
+void csmap::erase_range(container_type::iterator first, container_type::iterator last)
+{
+	while (first != last) {
+		preserve(first);
+		first = container->unsafe_erase(first);
+	}
+}
+
+status csmap::put_if_absent(string_view key, string_view value)
+{
+	LOG("put_if_absent key=" << std::string(key.data(), key.size())
+				 << ", value.size=" << std::to_string(value.size()));
+	check_outside_tx();
+
+	shared_global_lock_type lock(mtx);
+
+	auto result = insert(key, value);
+
+	return result.second ? status::OK : status::CONDITION_NOT_MET;
+}
+
+status csmap::compare_and_swap(string_view key, string_view expected,
+			       string_view desired)
+{
+	LOG("compare_and_swap key=" << std::string(key.data(), key.size())
+				    << ", desired.size="
+				    << std::to_string(desired.size()));
+	check_outside_tx();
+
+	shared_global_lock_type lock(mtx);
+
+	auto it = container->find(key);
+	if (it == container->end())
+		return status::NOT_FOUND;
+
+	unique_node_lock_type node_lock(it->second.mtx);
+
+	auto &val = it->second.val;
+	if (string_view(val.c_str(), val.size()).compare(expected) != 0)
+		return status::CONDITION_NOT_MET;
+
+	preserve(it);
+
+	pmem::obj::transaction::run(pmpool,
+				    [&] { val.assign(desired.data(), desired.size()); });
+
+	return status::OK;
+}
+
+/*
+ * As in remove(), the global lock has to be exclusive, so the value can be
+ * compared without taking the node lock.
+ */
+status csmap::remove_if(string_view key, string_view expected)
+{
+	LOG("remove_if key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	unique_global_lock_type lock(mtx);
+
+	auto it = container->find(key);
+	if (it == container->end())
+		return status::NOT_FOUND;
+
+	auto &val = it->second.val;
+	if (string_view(val.c_str(), val.size()).compare(expected) != 0)
+		return status::CONDITION_NOT_MET;
+
+	invalidate_scan_positions();
+	preserve(it);
+	container->unsafe_erase(it);
+
+	return status::OK;
+}
+
+/*
+ * The global lock is taken only once for the whole batch. If the batch
+ * contains any remove, the lock has to be exclusive (unsafe_erase() is not
+ * thread-safe) and then node locks are not needed. Otherwise the global lock
+ * is shared and updated nodes are locked one by one, as in put().
+ */
+status csmap::apply_batch(const internal::write_batch &batch)
+{
+	LOG("apply_batch of " << batch.size() << " operations");
+	check_outside_tx();
+
+	bool exclusive = false;
+	for (std::size_t i = 0; i < batch.size() && !exclusive; i++)
+		exclusive = batch[i].op == internal::write_batch::operation::remove;
+
+	unique_global_lock_type unique_lock(mtx, std::defer_lock);
+	shared_global_lock_type shared_lock(mtx, std::defer_lock);
+	if (exclusive) {
+		unique_lock.lock();
+		invalidate_scan_positions();
+	} else {
+		shared_lock.lock();
+	}
+
+	return batch.foreach ([&](const internal::write_batch::entry &e) -> status {
+		if (e.op == internal::write_batch::operation::remove) {
+			auto it = container->find(e.key);
+			if (it != container->end()) {
+				preserve(it);
+				container->unsafe_erase(it);
+			}
+			return status::OK;
+		}
+
+		auto result = insert(e.key, e.value);
+		if (result.second == false) {
+			auto &it = result.first;
+			unique_node_lock_type node_lock(it->second.mtx, std::defer_lock);
+			if (!exclusive)
+				node_lock.lock();
+
+			preserve(it);
+
+			pmem::obj::transaction::run(pmpool, [&] {
+				it->second.val.assign(e.value.data(), e.value.size());
+			});
+		}
+
+		return status::OK;
+	});
+}
+
+/*
+ * The global lock is taken (exclusively) only once for the whole load. The
+ * skip list itself is managed by libpmemobj++ and cannot be built bottom-up,
+ * so records are inserted one by one, checking the order of keys on the way.
+ * If the load fails (e.g. keys are not sorted), inserted records are removed
+ * before the lock is released, so the map is left empty.
+ */
+status csmap::bulk_load(internal::bulk_load_source &source)
+{
+	LOG("bulk_load");
+	check_outside_tx();
+
+	unique_global_lock_type lock(mtx);
+	if (container->size() != 0 || versions.active()) {
+		lock.unlock();
+		return engine_base::bulk_load(source);
+	}
+
+	invalidate_scan_positions();
+
+	try {
+		container_type::iterator last = container->end();
+		string_view key, value;
+		while (source.next(key, value)) {
+			if (last != container->end() &&
+			    !container->key_comp()(last->first, key))
+				throw internal::invalid_argument(
+					"Keys are not sorted in ascending order");
+
+			last = container->try_emplace(key, value).first;
+		}
+	} catch (...) {
+		erase_range(container->begin(), container->end());
+
+		throw;
+	}
+
+	return status::OK;
 }
 
 void csmap::Recover()
@@ -298,27 +951,88 @@ void csmap::Recover()
 
 internal::iterator_base *csmap::new_iterator()
 {
-	return new csmap_iterator<false>{container, mtx};
+	return new csmap_iterator<false>{container, mtx,
+					 internal::has_binary_order(*config), versions};
 }
 
 internal::iterator_base *csmap::new_const_iterator()
 {
-	return new csmap_iterator<true>{container, mtx};
+	return new csmap_iterator<true>{container, mtx,
+					internal::has_binary_order(*config)};
 }
 
-csmap::csmap_iterator<true>::csmap_iterator(container_type *c, global_mutex_type &mtx)
-    : container(c), lock(mtx), pop(pmem::obj::pool_by_vptr(c))
+/*
+ * The global lock is taken exclusively only to open the snapshot, so no
+ * modification is in progress at that moment. Reads from the snapshot take
+ * it in shared mode, separately for every chunk of a scan.
+ */
+internal::snapshot *csmap::new_snapshot()
 {
+	check_outside_tx();
+
+	unique_global_lock_type lock(mtx);
+
+	return new csmap_snapshot(container, mtx, versions);
 }
 
-csmap::csmap_iterator<false>::csmap_iterator(container_type *c, global_mutex_type &mtx)
-    : csmap::csmap_iterator<true>(c, mtx)
+csmap::csmap_snapshot::csmap_snapshot(container_type *c, global_mutex_type &mtx,
+				      internal::version_store &versions)
+    : internal::sorted_snapshot(versions), container(c), mtx(mtx)
+{
+}
+
+bool csmap::csmap_snapshot::read(string_view key, std::string &value)
+{
+	csmap::shared_global_lock_type lock(mtx);
+
+	auto it = container->find(key);
+	if (it == container->end())
+		return resolve(key, false, value);
+
+	csmap::shared_node_lock_type node_lock(it->second.mtx);
+	value.assign(it->second.val.c_str(), it->second.val.size());
+
+	return resolve(key, true, value);
+}
+
+bool csmap::csmap_snapshot::read_chunk(const std::string *after, std::size_t max,
+				       std::vector<internal::version_store::record> &records)
+{
+	csmap::shared_global_lock_type lock(mtx);
+
+	auto it = after ? container->upper_bound(string_view(after->data(), after->size()))
+			: container->begin();
+	for (; it != container->end(); ++it) {
+		if (records.size() == max)
+			return true;
+
+		csmap::shared_node_lock_type node_lock(it->second.mtx);
+		records.push_back(
+			{std::string(it->first.c_str(), it->first.size()),
+			 std::string(it->second.val.c_str(), it->second.val.size())});
+	}
+
+	return false;
+}
+
+csmap::csmap_iterator<true>::csmap_iterator(container_type *c, global_mutex_type &mtx,
+					    bool binary_order)
+    : container(c), it_(c->end()), lock(mtx), pop(pmem::obj::pool_by_vptr(c)),
+      binary_order(binary_order)
+{
+}
+
+csmap::csmap_iterator<false>::csmap_iterator(container_type *c, global_mutex_type &mtx,
+					     bool binary_order,
+					     internal::version_store &versions)
+    : csmap::csmap_iterator<true>(c, mtx, binary_order), versions(versions)
 {
 }
 
 status csmap::csmap_iterator<true>::seek(string_view key)
 {
 	init_seek();
+	prefix_bound.clear();
 
 	it_ = container->find(key);
 	if (it_ == container->end()) {
@@ -333,6 +1047,7 @@ status csmap::csmap_iterator<true>::seek(string_view key)
 status csmap::csmap_iterator<true>::seek_lower(string_view key)
 {
 	init_seek();
+	prefix_bound.clear();
 
 	it_ = container->find_lower(key);
 	if (it_ == container->end())
@@ -346,6 +1061,7 @@ status csmap::csmap_iterator<true>::seek_lower(string_view key)
 status csmap::csmap_iterator<true>::seek_lower_eq(string_view key)
 {
 	init_seek();
+	prefix_bound.clear();
 
 	it_ = container->find_lower_eq(key);
 	if (it_ == container->end())
@@ -359,6 +1075,7 @@ status csmap::csmap_iterator<true>::seek_lower_eq(string_view key)
 status csmap::csmap_iterator<true>::seek_higher(string_view key)
 {
 	init_seek();
+	prefix_bound.clear();
 
 	it_ = container->find_higher(key);
 	if (it_ == container->end())
@@ -372,6 +1089,7 @@ status csmap::csmap_iterator<true>::seek_higher(string_view key)
 status csmap::csmap_iterator<true>::seek_higher_eq(string_view key)
 {
 	init_seek();
+	prefix_bound.clear();
 
 	it_ = container->find_higher_eq(key);
 	if (it_ == container->end())
@@ -382,9 +1100,32 @@ status csmap::csmap_iterator<true>::seek_higher_eq(string_view key)
 	return status::OK;
 }
 
+status csmap::csmap_iterator<true>::seek_prefix(string_view prefix)
+{
+	init_seek();
+
+	if (!binary_order) {
+		it_ = container->end();
+		return status::NOT_SUPPORTED;
+	}
+
+	prefix_bound.assign(prefix.data(), prefix.size());
+
+	it_ = container->lower_bound(prefix);
+	if (it_ == container->end() || !within_prefix_bound(it_)) {
+		it_ = container->end();
+		return status::NOT_FOUND;
+	}
+
+	node_lock = csmap::unique_node_lock_type(it_->second.mtx);
+
+	return status::OK;
+}
+
 status csmap::csmap_iterator<true>::seek_to_first()
 {
 	init_seek();
+	prefix_bound.clear();
 
 	if (container->empty())
 		return status::NOT_FOUND;
@@ -399,7 +1140,8 @@ status csmap::csmap_iterator<true>::seek_to_first()
 status csmap::csmap_iterator<true>::is_next()
 {
 	auto tmp = it_;
-	if (tmp == container->end() || ++tmp == container->end())
+	if (tmp == container->end() || ++tmp == container->end() ||
+	    !within_prefix_bound(tmp))
 		return status::NOT_FOUND;
 
 	return status::OK;
@@ -412,6 +1154,11 @@ status csmap::csmap_iterator<true>::next()
 	if (it_ == container->end() || ++it_ == container->end())
 		return status::NOT_FOUND;
 
+	if (!within_prefix_bound(it_)) {
+		it_ = container->end();
+		return status::NOT_FOUND;
+	}
+
 	node_lock = csmap::unique_node_lock_type(it_->second.mtx);
 
 	return status::OK;
@@ -435,6 +1182,36 @@ result<pmem::obj::slice<const char *>> csmap::csmap_iterator<true>::read_range(s
 	return {it_->second.val.crange(pos, n)};
 }
 
+/*
+ * Values are copied (under the node lock) into the iterator, as they can be
+ * modified concurrently once the iterator moves to the next record. Keys are
+ * not modified while the iterator holds the global lock.
+ */
+status csmap::csmap_iterator<true>::read_batch(pmemkv_iterator_entry *entries, size_t n,
+					       size_t &count)
+{
+	if (batch_values.size() < n)
+		batch_values.resize(n);
+
+	count = 0;
+	/* iterator is not positioned (or already past the last record) */
+	if (it_ == container->end())
+		return status::NOT_FOUND;
+
+	while (count < n) {
+		auto &value = batch_values[count];
+		value.assign(it_->second.val.cdata(), it_->second.val.size());
+		entries[count++] = {it_->first.data(), it_->first.length(), value.data(),
+				    value.size()};
+
+		auto s = next();
+		if (s != status::OK)
+			return s;
+	}
+
+	return status::OK;
+}
+
 result<pmem::obj::slice<char *>> csmap::csmap_iterator<false>::write_range(size_t pos,
 									   size_t n)
 {
@@ -451,6 +1228,12 @@ result<pmem::obj::slice<char *>> csmap::csmap_iterator<false>::write_range(size_
 
 status csmap::csmap_iterator<false>::commit()
 {
+	if (!log.empty()) {
+		string_view value(it_->second.val.c_str(), it_->second.val.size());
+		versions.preserve(string_view(it_->first.c_str(), it_->first.size()),
+				  &value);
+	}
+
 	pmem::obj::transaction::run(pop, [&] {
 		for (auto &p : log) {
 			auto dest = it_->second.val.range(p.second, p.first.size());
@@ -473,6 +1256,13 @@ void csmap::csmap_iterator<true>::init_seek()
 		node_lock.unlock();
 }
 
+bool csmap::csmap_iterator<true>::within_prefix_bound(
+	const container_type::iterator &it) const
+{
+	return internal::has_prefix(string_view(it->first.data(), it->first.length()),
+				    prefix_bound);
+}
+
 void csmap::csmap_iterator<false>::init_seek()
 {
 	csmap::csmap_iterator<true>::init_seek();
@@ -5,7 +5,10 @@
 #define LIBPMEMKV_CSMAP_H
 
 #include "../comparator/pmemobj_comparator.h"
+#include "../merge_operator.h"
+#include "../parallel_scan.h"
 #include "../pmemobj_engine.h"
+#include "../snapshot.h"
 
 #include <libpmemobj++/container/string.hpp>
 #include <libpmemobj++/experimental/concurrent_map.hpp>
@@ -14,6 +17,7 @@
 
 #include <mutex>
 #include <shared_mutex>
+#include <vector>
 
 namespace pmem
 {
@@ -74,6 +78,7 @@ static_assert(sizeof(pmem_type) == sizeof(map_type) + 64, "");
 class csmap : public pmemobj_engine_base<internal::csmap::pmem_type> {
 	template <bool IsConst>
 	class csmap_iterator;
+	class csmap_snapshot;
 
 public:
 	csmap(std::unique_ptr<internal::config> cfg);
@@ -101,17 +106,64 @@ public:
 	status get_between(string_view key1, string_view key2, get_kv_callback *callback,
 			   void *arg) final;
 
+	status get_all_desc(get_kv_callback *callback, void *arg) final;
+	status get_above_desc(string_view key, get_kv_callback *callback,
+			      void *arg) final;
+	status get_equal_above_desc(string_view key, get_kv_callback *callback,
+				    void *arg) final;
+	status get_equal_below_desc(string_view key, get_kv_callback *callback,
+				    void *arg) final;
+	status get_below_desc(string_view key, get_kv_callback *callback,
+			      void *arg) final;
+	status get_between_desc(string_view key1, string_view key2,
+				get_kv_callback *callback, void *arg) final;
+
+	status count_prefix(string_view prefix, std::size_t &cnt) final;
+	status get_prefix(string_view prefix, get_kv_callback *callback, void *arg) final;
+
+	status get_keys(get_k_callback *callback, void *arg) final;
+	status get_keys_above(string_view key, get_k_callback *callback, void *arg) final;
+	status get_keys_below(string_view key, get_k_callback *callback, void *arg) final;
+	status get_keys_between(string_view key1, string_view key2,
+				get_k_callback *callback, void *arg) final;
+
+	status get_split_points(std::size_t partitions,
+				std::vector<std::string> &keys) final;
+
+	status get_above_page(string_view key, internal::scan_cursor &cursor,
+			      get_kv_callback *callback, void *arg) final;
+	status get_between_page(string_view key1, string_view key2,
+				internal::scan_cursor &cursor, get_kv_callback *callback,
+				void *arg) final;
+
 	status exists(string_view key) final;
 
 	status get(string_view key, get_v_callback *callback, void *arg) final;
+	status value_size(string_view key, std::size_t &size) final;
+	status get_pinned(string_view key,
+			  std::unique_ptr<internal::pinned_value> &pinned) final;
 
 	status put(string_view key, string_view value) final;
 
+	status merge(string_view key, string_view operand) final;
+
+	status put_if_absent(string_view key, string_view value) final;
+	status compare_and_swap(string_view key, string_view expected,
+				string_view desired) final;
+	status remove_if(string_view key, string_view expected) final;
+
 	status remove(string_view key) final;
+	status remove_range(string_view key1, string_view key2) final;
+	status remove_prefix(string_view prefix) final;
+
+	status apply_batch(const internal::write_batch &batch) final;
+	status bulk_load(internal::bulk_load_source &source) final;
 
 	internal::iterator_base *new_iterator() final;
 	internal::iterator_base *new_const_iterator() final;
 
+	internal::snapshot *new_snapshot() final;
+
 private:
 	using node_mutex_type = pmem::obj::shared_mutex;
 	using global_mutex_type = std::shared_timed_mutex;
@@ -125,6 +177,26 @@ private:
 	status iterate(typename container_type::iterator first,
 		       typename container_type::iterator last, get_kv_callback *callback,
 		       void *arg);
+	status iterate_desc(typename container_type::iterator first,
+			    typename container_type::iterator last,
+			    get_kv_callback *callback, void *arg);
+
+	/* key and value of a node, which is locked as long as this object lives */
+	struct locked_key_value {
+		string_view first;
+		string_view second;
+		shared_node_lock_type lock;
+	};
+
+	static locked_key_value key_value(const container_type::iterator &it);
+
+	/* see internal::version_store::preserve(), the node has to be locked */
+	void preserve(const container_type::iterator &it);
+	std::pair<container_type::iterator, bool> insert(string_view key,
+							 string_view value);
+
+	/* removes [first, last), the global lock has to be taken exclusively */
+	void erase_range(container_type::iterator first, container_type::iterator last);
 
 	/*
 	 * We take read lock for thread-safe methods (like get/insert/get_all) to
@@ -133,6 +205,9 @@ private:
 	global_mutex_type mtx;
 	container_type *container;
 	std::unique_ptr<internal::config> config;
+
+	/* previous versions of records, kept for open snapshots */
+	internal::version_store versions;
 };
 
 template <>
@@ -140,13 +215,15 @@ class csmap::csmap_iterator<true> : public internal::iterator_base {
 	using container_type = csmap::container_type;
 
 public:
-	csmap_iterator(container_type *container, global_mutex_type &mtx);
+	csmap_iterator(container_type *container, global_mutex_type &mtx,
+		       bool binary_order);
 
 	status seek(string_view key) final;
 	status seek_lower(string_view key) final;
 	status seek_lower_eq(string_view key) final;
 	status seek_higher(string_view key) final;
 	status seek_higher_eq(string_view key) final;
+	status seek_prefix(string_view prefix) final;
 
 	status seek_to_first() final;
 
@@ -156,6 +233,7 @@ public:
 	result<string_view> key() final;
 
 	result<pmem::obj::slice<const char *>> read_range(size_t pos, size_t n) final;
+	status read_batch(pmemkv_iterator_entry *entries, size_t n, size_t &count) final;
 
 protected:
 	container_type *container;
@@ -164,7 +242,15 @@ protected:
 	csmap::unique_node_lock_type node_lock;
 	pmem::obj::pool_base pop;
 
+	/* copies of values returned by read_batch() */
+	std::vector<std::string> batch_values;
+
+	/* set by seek_prefix(), is_next() and next() do not cross it */
+	std::string prefix_bound;
+	bool binary_order;
+
 	void init_seek();
+	bool within_prefix_bound(const container_type::iterator &it) const;
 };
 
 template <>
@@ -172,7 +258,8 @@ class csmap::csmap_iterator<false> : public csmap::csmap_iterator<true> {
 	using container_type = csmap::container_type;
 
 public:
-	csmap_iterator(container_type *container, global_mutex_type &mtx);
+	csmap_iterator(container_type *container, global_mutex_type &mtx,
+		       bool binary_order, internal::version_store &versions);
 
 	result<pmem::obj::slice<char *>> write_range(size_t pos, size_t n) final;
 
@@ -181,10 +268,28 @@ public:
 
 private:
 	std::vector<std::pair<std::string, size_t>> log;
+	internal::version_store &versions;
 
 	void init_seek() final;
 };
 
+class csmap::csmap_snapshot : public internal::sorted_snapshot {
+	using container_type = csmap::container_type;
+
+public:
+	csmap_snapshot(container_type *container, global_mutex_type &mtx,
+		       internal::version_store &versions);
+
+protected:
+	bool read(string_view key, std::string &value) final;
+	bool read_chunk(const std::string *after, std::size_t max,
+			std::vector<internal::version_store::record> &records) final;
+
+private:
+	container_type *container;
+	global_mutex_type &mtx;
+};
+
 class csmap_factory : public engine_base::factory_base {
 public:
 	std::unique_ptr<engine_base>
@@ -2,7 +2,14 @@
 /* Copyright 2020-2021, Intel Corporation */
 
 #include "radix.h"
+#include "../op_phases.h"
 #include "../out.h"
+#include "../probes.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <numeric>
 
 namespace pmem
 {
@@ -12,8 +19,9 @@ namespace internal
 {
 namespace radix
 {
-transaction::transaction(pmem::obj::pool_base &pop, map_type *container)
-    : pop(pop), container(container)
+transaction::transaction(pmem::obj::pool_base &pop, map_type *container,
+			 map_type *deadlines, engine_base &engine, expiry_index &expiry)
+    : pop(pop), container(container), deadlines(deadlines), engine(engine), expiry(expiry)
 {
 }
 
@@ -42,7 +50,20 @@ status transaction::commit()
 		container->erase(e.first);
 	};
 
-	pmem::obj::transaction::run(pop, [&] { log.foreach (insert_cb, remove_cb); });
+	auto clear_cb = [&](const dram_log::element_type &e) {
+		auto lock = expiry.lock(e.first);
+		if (expiry.clear(e.first))
+			deadlines->erase(e.first);
+	};
+
+	engine.invalidate_scan_positions();
+
+	pmem::obj::transaction::run(pop, [&] {
+		log.foreach (insert_cb, remove_cb);
+
+		if (expiry.active())
+			log.foreach (clear_cb, clear_cb);
+	});
 
 	log.clear();
 
@@ -60,6 +81,20 @@ radix::radix(std::unique_ptr<internal::config> cfg)
     : pmemobj_engine_base(cfg, "pmemkv_radix"), config(std::move(cfg))
 {
 	Recover();
+
+	uint64_t reap_rate = TTL_REAP_RATE_DEFAULT;
+	config->get_uint64("ttl_reap_rate", &reap_rate);
+
+	/* radix is single-threaded - expired records are removed by write operations */
+	auto remove = [this](string_view key) {
+		invalidate_scan_positions();
+		pmem::obj::transaction::run(pmpool, [&] {
+			container->erase(key);
+			deadlines->erase(key);
+		});
+	};
+	reaper.reset(new internal::expiry_reaper(expiry, reap_rate, remove));
+
 	LOG("Started ok");
 }
 
@@ -254,11 +289,260 @@ status radix::get_between(string_view key1, string_view key2, get_kv_callback *c
 	return status::OK;
 }
 
+/* Visits elements in [first, last) starting with the one preceding last */
+status radix::iterate_desc(container_type::iterator first, container_type::iterator last,
+			   get_kv_callback *callback, void *arg)
+{
+	while (last != first) {
+		--last;
+		if (iterate_callback(last, callback, arg) != 0)
+			return status::STOPPED_BY_CB;
+	}
+
+	return status::OK;
+}
+
+status radix::get_all_desc(get_kv_callback *callback, void *arg)
+{
+	LOG("get_all_desc");
+	check_outside_tx();
+
+	auto first = container->begin();
+	auto last = container->end();
+
+	return iterate_desc(first, last, callback, arg);
+}
+
+status radix::get_above_desc(string_view key, get_kv_callback *callback, void *arg)
+{
+	LOG("get_above_desc for key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	auto first = container->upper_bound(key);
+	auto last = container->end();
+
+	return iterate_desc(first, last, callback, arg);
+}
+
+status radix::get_equal_above_desc(string_view key, get_kv_callback *callback, void *arg)
+{
+	LOG("get_equal_above_desc for key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	auto first = container->lower_bound(key);
+	auto last = container->end();
+
+	return iterate_desc(first, last, callback, arg);
+}
+
+status radix::get_equal_below_desc(string_view key, get_kv_callback *callback, void *arg)
+{
+	LOG("get_equal_below_desc for key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	auto first = container->begin();
+	auto last = container->upper_bound(key);
+
+	return iterate_desc(first, last, callback, arg);
+}
+
+status radix::get_below_desc(string_view key, get_kv_callback *callback, void *arg)
+{
+	LOG("get_below_desc for key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	auto first = container->begin();
+	auto last = container->lower_bound(key);
+
+	return iterate_desc(first, last, callback, arg);
+}
+
+status radix::get_between_desc(string_view key1, string_view key2,
+			       get_kv_callback *callback, void *arg)
+{
+	LOG("get_between_desc for key1=" << std::string(key1.data(), key1.size())
+					 << ", key2="
+					 << std::string(key2.data(), key2.size()));
+	check_outside_tx();
+
+	if (key1.compare(key2) < 0) {
+		auto first = container->upper_bound(key1);
+		auto last = container->lower_bound(key2);
+		return iterate_desc(first, last, callback, arg);
+	}
+
+	return status::OK;
+}
+
+status radix::count_prefix(string_view prefix, std::size_t &cnt)
+{
+	LOG("count_prefix for prefix=" << std::string(prefix.data(), prefix.size()));
+	check_outside_tx();
+
+	cnt = 0;
+	for (auto it = container->lower_bound(prefix); it != container->end(); ++it) {
+		if (!internal::has_prefix(string_view(it->key()), prefix))
+			break;
+		cnt++;
+	}
+
+	return status::OK;
+}
+
+/*
+ * Keys with the given prefix form a subtree, whose leftmost leaf is found by
+ * lower_bound() - the rest of the subtree is visited by following the leaves.
+ */
+status radix::get_prefix(string_view prefix, get_kv_callback *callback, void *arg)
+{
+	LOG("get_prefix for prefix=" << std::string(prefix.data(), prefix.size()));
+	check_outside_tx();
+
+	return iterate_generic(
+		container->lower_bound(prefix),
+		[&](const container_type::iterator &it) {
+			return iterate_callback(it, callback, arg);
+		},
+		[&](const container_type::iterator &it) {
+			return it != container->end() &&
+				internal::has_prefix(string_view(it->key()), prefix);
+		});
+}
+
+/* Key-only scans - keys are read from the leaves, values are not accessed */
+status radix::iterate_keys(container_type::iterator first, container_type::iterator last,
+			   get_k_callback *callback, void *arg)
+{
+	return iterate_generic(
+		first,
+		[&](const container_type::iterator &it) {
+			const auto &key = it->key();
+			return callback(key.data(), key.size(), arg);
+		},
+		[&](const container_type::iterator &it) { return it != last; });
+}
+
+status radix::get_keys(get_k_callback *callback, void *arg)
+{
+	LOG("get_keys");
+	check_outside_tx();
+
+	return iterate_keys(container->begin(), container->end(), callback, arg);
+}
+
+status radix::get_keys_above(string_view key, get_k_callback *callback, void *arg)
+{
+	LOG("get_keys_above for key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	return iterate_keys(container->upper_bound(key), container->end(), callback, arg);
+}
+
+status radix::get_keys_below(string_view key, get_k_callback *callback, void *arg)
+{
+	LOG("get_keys_below for key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	return iterate_keys(container->begin(), container->lower_bound(key), callback,
+			    arg);
+}
+
+status radix::get_keys_between(string_view key1, string_view key2,
+			       get_k_callback *callback, void *arg)
+{
+	LOG("get_keys_between for key1=" << key1.data() << ", key2=" << key2.data());
+	check_outside_tx();
+
+	if (key1.compare(key2) < 0) {
+		auto first = container->upper_bound(key1);
+		auto last = container->lower_bound(key2);
+		return iterate_keys(first, last, callback, arg);
+	}
+
+	return status::OK;
+}
+
+/*
+ * radix_tree does not expose its internal nodes, so split points are found
+ * by walking the leaves (values are not read).
+ */
+status radix::get_split_points(std::size_t partitions, std::vector<std::string> &keys)
+{
+	LOG("get_split_points partitions=" << partitions);
+	check_outside_tx();
+
+	auto bounds = internal::split_range(container->begin(), container->end(),
+					    container->size(), partitions);
+
+	keys.clear();
+	for (std::size_t i = 1; i + 1 < bounds.size(); i++) {
+		string_view key(bounds[i]->key());
+		keys.emplace_back(key.data(), key.size());
+	}
+
+	return status::OK;
+}
+
+std::pair<string_view, string_view> radix::key_value(const container_type::iterator &it)
+{
+	return {string_view(it->key()), string_view(it->value())};
+}
+
+/*
+ * Pages are continued from the cached leaf of the last returned element
+ * (if the tree was not modified since), without descending from the root.
+ */
+status radix::get_above_page(string_view key, internal::scan_cursor &cursor,
+			     get_kv_callback *callback, void *arg)
+{
+	LOG("get_above_page for key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	auto first = container->end();
+	if (!cursor.resume(key, scan_version(), first))
+		first = container->upper_bound(key);
+	auto last = container->end();
+
+	return cursor.fill(
+		first, [&](const container_type::iterator &it) { return it == last; },
+		key_value, scan_version(), callback, arg);
+}
+
+status radix::get_between_page(string_view key1, string_view key2,
+			       internal::scan_cursor &cursor, get_kv_callback *callback,
+			       void *arg)
+{
+	LOG("get_between_page for key1=" << std::string(key1.data(), key1.size())
+					 << ", key2="
+					 << std::string(key2.data(), key2.size()));
+	check_outside_tx();
+
+	if (key1.compare(key2) >= 0) {
+		cursor.reset();
+		return status::OK;
+	}
+
+	auto first = container->end();
+	if (!cursor.resume(key1, scan_version(), first))
+		first = container->upper_bound(key1);
+	auto last = container->end();
+
+	return cursor.fill(
+		first,
+		[&](const container_type::iterator &it) {
+			return it == last || string_view(it->key()).compare(key2) >= 0;
+		},
+		key_value, scan_version(), callback, arg);
+}
+
 status radix::exists(string_view key)
 {
 	LOG("exists for key=" << std::string(key.data(), key.size()));
 	check_outside_tx();
 
+	if (expiry.is_expired(key))
+		return status::NOT_FOUND;
+
 	return container->find(key) != container->end() ? status::OK : status::NOT_FOUND;
 }
 
@@ -267,6 +551,11 @@ status radix::get(string_view key, get_v_callback *callback, void *arg)
 	LOG("get key=" << std::string(key.data(), key.size()));
 	check_outside_tx();
 
+	if (expiry.is_expired(key)) {
+		LOG("  key expired");
+		return status::NOT_FOUND;
+	}
+
 	auto it = container->find(key);
 	if (it != container->end()) {
 		auto value = string_view(it->value());
@@ -278,57 +567,328 @@ status radix::get(string_view key, get_v_callback *callback, void *arg)
 	return status::NOT_FOUND;
 }
 
+/* The size is read from the header of the value (inline_string) */
+status radix::value_size(string_view key, std::size_t &size)
+{
+	LOG("value_size key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	if (expiry.is_expired(key)) {
+		LOG("  key expired");
+		return status::NOT_FOUND;
+	}
+
+	auto it = container->find(key);
+	if (it != container->end()) {
+		size = it->value().size();
+		return status::OK;
+	}
+
+	LOG("  key not found");
+	return status::NOT_FOUND;
+}
+
+/*
+ * All keys are looked up before any value is read. Lookups are done in the key
+ * order so consecutive descents share (already cached) upper levels of the tree
+ * and values of found elements are prefetched before callbacks are executed.
+ */
+status radix::get_many(const std::vector<string_view> &keys, get_many_callback *callback,
+		       void *arg)
+{
+	LOG("get_many for " << keys.size() << " keys");
+	check_outside_tx();
+
+	std::vector<std::size_t> order(keys.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&](std::size_t lhs, std::size_t rhs) {
+		return keys[lhs].compare(keys[rhs]) < 0;
+	});
+
+	std::vector<container_type::iterator> its(keys.size(), container->end());
+	for (auto i : order) {
+		if (expiry.is_expired(keys[i]))
+			continue;
+
+		its[i] = container->find(keys[i]);
+		if (its[i] != container->end())
+			__builtin_prefetch(its[i]->value().data());
+	}
+
+	for (std::size_t i = 0; i < its.size(); ++i) {
+		if (its[i] == container->end()) {
+			callback(i, PMEMKV_STATUS_NOT_FOUND, nullptr, 0, arg);
+			continue;
+		}
+
+		auto value = string_view(its[i]->value());
+		callback(i, PMEMKV_STATUS_OK, value.data(), value.size(), arg);
+	}
+
+	return status::OK;
+}
+
 status radix::put(string_view key, string_view value)
 {
 	LOG("put key=" << std::string(key.data(), key.size())
 		       << ", value.size=" << std::to_string(value.size()));
 	check_outside_tx();
 
-	auto result = container->try_emplace(key, value);
+	reaper->step();
+	invalidate_scan_positions();
 
-	if (result.second == false) {
-		pmem::obj::transaction::run(pmpool,
-					    [&] { result.first.assign_val(value); });
-	}
+	auto lock = expiry.lock_if_active(key);
+
+	/* a crash must not leave the new value with the previous deadline */
+	pmem::obj::transaction::run(pmpool, [&] {
+		auto result = container->try_emplace(key, value);
+
+		if (result.second == false)
+			result.first.assign_val(value);
+
+		if (lock.owns_lock())
+			clear_deadline(key);
+	});
+
+	return status::OK;
+}
+
+status radix::put_with_ttl(string_view key, string_view value,
+			   std::chrono::milliseconds ttl)
+{
+	LOG("put_with_ttl key=" << std::string(key.data(), key.size())
+				<< ", value.size=" << std::to_string(value.size())
+				<< ", ttl=" << std::to_string(ttl.count()));
+	check_outside_tx();
+
+	reaper->step();
+	invalidate_scan_positions();
+
+	auto deadline = internal::expiry_index::clock_type::now() + ttl;
+	auto lock = expiry.lock(key);
+
+	pmem::obj::transaction::run(pmpool, [&] {
+		auto result = container->try_emplace(key, value);
+
+		if (result.second == false)
+			result.first.assign_val(value);
+
+		set_deadline(key, deadline);
+	});
 
 	return status::OK;
 }
 
+/* The deadline is set in DRAM last, so it is not set if the transaction aborts */
+void radix::set_deadline(string_view key, internal::expiry_index::time_point deadline)
+{
+	auto d = internal::expiry_index::to_persistent(deadline);
+	string_view value(reinterpret_cast<const char *>(&d), sizeof(d));
+
+	auto result = deadlines->try_emplace(key, value);
+
+	if (result.second == false)
+		result.first.assign_val(value);
+
+	expiry.set(key, deadline);
+}
+
+void radix::clear_deadline(string_view key)
+{
+	if (expiry.clear(key))
+		deadlines->erase(key);
+}
+
 status radix::remove(string_view key)
 {
 	LOG("remove key=" << std::string(key.data(), key.size()));
 	check_outside_tx();
 
+	reaper->step();
+	invalidate_scan_positions();
+
+	auto lock = expiry.lock_if_active(key);
+	bool expired = lock.owns_lock() &&
+		expiry.expired(key, internal::expiry_index::clock_type::now());
+
 	auto it = container->find(key);
 
-	if (it == container->end())
+	if (it == container->end()) {
+		if (lock.owns_lock())
+			clear_deadline(key);
+
 		return status::NOT_FOUND;
+	}
 
-	container->erase(it);
+	pmem::obj::transaction::run(pmpool, [&] {
+		container->erase(it);
+
+		if (lock.owns_lock())
+			clear_deadline(key);
+	});
+
+	return expired ? status::NOT_FOUND : status::OK;
+}
+
+status radix::remove_range(string_view key1, string_view key2)
+{
+	LOG("remove_range for key1=" << std::string(key1.data(), key1.size())
+				     << ", key2=" << std::string(key2.data(), key2.size()));
+	check_outside_tx();
+
+	if (key1.compare(key2) >= 0)
+		return status::OK;
+
+	return erase_range(key1, &key2);
+}
+
+status radix::remove_prefix(string_view prefix)
+{
+	LOG("remove_prefix for prefix=" << std::string(prefix.data(), prefix.size()));
+	check_outside_tx();
+
+	std::string bound;
+	if (!internal::prefix_upper_bound(prefix, bound))
+		return erase_range(prefix, nullptr);
+
+	string_view upper(bound);
+	return erase_range(prefix, &upper);
+}
+
+/*
+ * Records are removed in chunks, each in a single transaction (instead of
+ * a transaction per record). Keys of a chunk are collected with a single pass
+ * over the leaves, as iterators are not valid after erase().
+ */
+status radix::erase_range(string_view key1, const string_view *key2)
+{
+	reaper->step();
+	invalidate_scan_positions();
+
+	std::vector<std::string> keys;
+	do {
+		keys.clear();
+
+		auto last = key2 ? container->lower_bound(*key2) : container->end();
+		for (auto it = container->lower_bound(key1);
+		     it != last && keys.size() < internal::radix::REMOVE_CHUNK_SIZE; ++it) {
+			string_view key(it->key());
+			keys.emplace_back(key.data(), key.size());
+		}
+
+		if (keys.empty())
+			break;
+
+		pmem::obj::transaction::run(pmpool, [&] {
+			for (auto &key : keys) {
+				container->erase(string_view(key));
+
+				if (expiry.active()) {
+					auto lock = expiry.lock(key);
+					clear_deadline(key);
+				}
+			}
+		});
+	} while (keys.size() == internal::radix::REMOVE_CHUNK_SIZE);
+
+	return status::OK;
+}
+
+/*
+ * Records are inserted in chunks, each in a single transaction (instead of
+ * a transaction per record). The tree itself is managed by libpmemobj++ and
+ * cannot be built bottom-up, so every record is still inserted from the root.
+ * If the load fails (e.g. keys are not sorted), already committed chunks are
+ * removed, so the tree is left empty.
+ */
+status radix::bulk_load(internal::bulk_load_source &source)
+{
+	LOG("bulk_load");
+	check_outside_tx();
+
+	if (!container->empty())
+		return engine_base::bulk_load(source);
+
+	invalidate_scan_positions();
+
+	std::string last_key;
+	size_t loaded = 0;
+	try {
+		string_view key, value;
+		bool more = source.next(key, value);
+		while (more) {
+			pmem::obj::transaction::run(pmpool, [&] {
+				for (size_t n = 0;
+				     more && n < internal::radix::BULK_LOAD_CHUNK_SIZE;
+				     n++) {
+					if (loaded > 0 &&
+					    key.compare(string_view(last_key)) <= 0)
+						throw internal::invalid_argument(
+							"Keys are not sorted in ascending order");
+
+					container->try_emplace(key, value);
+					last_key.assign(key.data(), key.size());
+					loaded++;
+
+					more = source.next(key, value);
+				}
+			});
+		}
+	} catch (...) {
+		/* the empty key is the lowest one */
+		erase_range(string_view(), nullptr);
+
+		throw;
+	}
 
 	return status::OK;
 }
 
 internal::transaction *radix::begin_tx()
 {
-	return new internal::radix::transaction(pmpool, container);
+	return new internal::radix::transaction(pmpool, container, deadlines, *this,
+						expiry);
 }
 
 void radix::Recover()
 {
+	pmem_type *pmem_ptr;
+
 	if (!OID_IS_NULL(*root_oid)) {
-		auto pmem_ptr = static_cast<pmem_type *>(pmemobj_direct(*root_oid));
+		pmem_ptr = static_cast<pmem_type *>(pmemobj_direct(*root_oid));
 
 		container = &pmem_ptr->map;
 	} else {
 		pmem::obj::transaction::run(pmpool, [&] {
 			pmem::obj::transaction::snapshot(root_oid);
 			*root_oid = pmem::obj::make_persistent<pmem_type>().raw();
-			auto pmem_ptr =
-				static_cast<pmem_type *>(pmemobj_direct(*root_oid));
+			pmem_ptr = static_cast<pmem_type *>(pmemobj_direct(*root_oid));
 			container = &pmem_ptr->map;
 		});
 	}
+
+	/* pools created before deadlines were persisted have it zeroed (reserved) */
+	if (pmem_ptr->deadlines == nullptr) {
+		pmem::obj::transaction::run(pmpool, [&] {
+			pmem_ptr->deadlines =
+				pmem::obj::make_persistent<container_type>();
+		});
+	}
+
+	deadlines = pmem_ptr->deadlines.get();
+
+	for (auto it = deadlines->begin(); it != deadlines->end(); ++it) {
+		string_view key(it->key());
+		string_view value(it->value());
+		internal::expiry_index::persistent_deadline d;
+		if (value.size() != sizeof(d))
+			continue;
+
+		std::memcpy(&d, value.data(), sizeof(d));
+
+		auto lock = expiry.lock(key);
+		expiry.set(key, internal::expiry_index::from_persistent(d));
+	}
 }
 
 /* HETEROGENEOUS_RADIX */
@@ -539,14 +1099,20 @@ heterogeneous_radix::cache_put_with_evict(string_view key, const uvalue_type *va
 
 			/* Only element which has already been process by background
 			 * thread (is not in the log) can be evicted. */
-			if (!log_contains(t) && t != tombstone_volatile())
+			if (!log_contains(t) && t != tombstone_volatile()) {
+				metrics.cache_evictions.fetch_add(1, std::memory_order_relaxed);
 				return std::next(rit).base();
+			}
 		}
 
 		return list.end();
 	};
 
-	return cache->put(key, value, evict_cb);
+	auto cache_val = cache->put(key, value, evict_cb);
+	if (!cache_val)
+		metrics.cache_eviction_failures.fetch_add(1, std::memory_order_relaxed);
+
+	return cache_val;
 }
 
 void heterogeneous_radix::handle_oom_from_bg()
@@ -586,23 +1152,34 @@ status heterogeneous_radix::put(string_view key, string_view value)
 		alignof(queue_entry<dram_uvalue_type>)>::type;
 	auto alloc_size = (req_size + sizeof(queue_entry<dram_uvalue_type>) - 1) /
 		sizeof(queue_entry<dram_uvalue_type>);
+	internal::phase_timer alloc_timer(internal::op_phase::allocation);
 	auto data = std::unique_ptr<alloc_type[]>(new alloc_type[alloc_size]);
+	alloc_timer.stop();
 
 	assert(reinterpret_cast<uintptr_t>(data.get()) %
 		       alignof(queue_entry<dram_uvalue_type>) ==
 	       0);
 
+	internal::phase_timer lookup_timer(internal::op_phase::lookup);
+	cache_type::value_type *cache_val = cache_put_with_evict(key, nullptr);
+	lookup_timer.stop();
+
 	/* XXX: implement blocking cache_put_with_evict */
-	cache_type::value_type *cache_val = nullptr;
-	while (cache_val == nullptr) {
-		cache_val = cache_put_with_evict(key, nullptr);
-		handle_oom_from_bg();
+	if (cache_val == nullptr) {
+		/* all entries of the cache are still in the log - wait for bg thread */
+		metrics.put_cache_waits.fetch_add(1, std::memory_order_relaxed);
+		internal::phase_timer wait_timer(internal::op_phase::lock_wait);
+		while (cache_val == nullptr) {
+			handle_oom_from_bg();
+			cache_val = cache_put_with_evict(key, nullptr);
+		}
 	}
+	handle_oom_from_bg();
 
 	new (data.get()) queue_entry<dram_uvalue_type>(cache_val, key, value);
 
-	while (true) {
-		auto produced = queue_worker->try_produce(
+	auto produce = [&] {
+		return queue_worker->try_produce(
 			pmem::obj::string_view(reinterpret_cast<const char *>(data.get()),
 					       req_size),
 			[&](pmem::obj::string_view target) {
@@ -616,11 +1193,22 @@ status heterogeneous_radix::put(string_view key, string_view value)
 
 				cache_val->store(val, std::memory_order_release);
 			});
-		if (produced)
-			break;
-		else
+	};
+
+	internal::phase_timer flush_timer(internal::op_phase::flush);
+	bool produced = produce();
+	flush_timer.stop();
+
+	if (!produced) {
+		/* the log is full - wait for bg thread to consume it */
+		metrics.put_log_waits.fetch_add(1, std::memory_order_relaxed);
+		internal::phase_timer wait_timer(internal::op_phase::lock_wait);
+		do {
 			handle_oom_from_bg();
+		} while (!produce());
 	}
+	metrics.produced_entries.fetch_add(1, std::memory_order_relaxed);
+	metrics.produced_bytes.fetch_add(req_size, std::memory_order_relaxed);
 
 	// XXX - if try_produce == false, we can just allocate new radix node to
 	// TLS and the publish pointer to this node
@@ -670,6 +1258,7 @@ status heterogeneous_radix::remove(string_view k)
 		container->garbage_collect_force();
 
 		delete bg_exception_ptr.load(std::memory_order_relaxed);
+		metrics.oom_recoveries.fetch_add(1, std::memory_order_relaxed);
 
 		{
 			std::unique_lock<std::mutex> lock(bg_lock);
@@ -744,6 +1333,10 @@ status heterogeneous_radix::get(string_view key, get_v_callback *callback, void
 	status s = status::OK;
 
 	auto v = cache->get(key, true);
+	if (v)
+		metrics.cache_hits.fetch_add(1, std::memory_order_relaxed);
+	else
+		metrics.cache_misses.fetch_add(1, std::memory_order_relaxed);
 
 	container_worker->critical([&] {
 		if (!v) {
@@ -788,6 +1381,48 @@ std::string heterogeneous_radix::name()
 	return "radix";
 }
 
+void heterogeneous_radix::get_engine_counters(internal::engine_counters &counters)
+{
+	auto load = [](const std::atomic<uint64_t> &c) {
+		return c.load(std::memory_order_relaxed);
+	};
+
+	/* entry can be consumed before put() counts it as produced */
+	auto consumed = load(metrics.consumed_entries);
+	auto produced = load(metrics.produced_entries);
+	auto consumed_bytes = load(metrics.consumed_bytes);
+	auto produced_bytes = load(metrics.produced_bytes);
+	auto queue_bytes =
+		produced_bytes > consumed_bytes ? produced_bytes - consumed_bytes : 0;
+	uint64_t log_capacity = log->data().size();
+
+	counters.emplace_back("cache_size", cache_size);
+	counters.emplace_back("cache_hits", load(metrics.cache_hits));
+	counters.emplace_back("cache_misses", load(metrics.cache_misses));
+	counters.emplace_back("cache_evictions", load(metrics.cache_evictions));
+	counters.emplace_back("cache_eviction_failures",
+			      load(metrics.cache_eviction_failures));
+	counters.emplace_back("put_cache_waits", load(metrics.put_cache_waits));
+	counters.emplace_back("put_log_waits", load(metrics.put_log_waits));
+
+	counters.emplace_back("queue_depth", produced > consumed ? produced - consumed : 0);
+	counters.emplace_back("queue_produced", produced);
+	counters.emplace_back("queue_consumed", consumed);
+	counters.emplace_back("queue_bytes", queue_bytes);
+	counters.emplace_back("log_size", log_capacity);
+	counters.emplace_back("log_fill_percent",
+			      log_capacity ? std::min<uint64_t>(
+						     queue_bytes * 100 / log_capacity, 100)
+					   : 0);
+
+	counters.emplace_back("bg_batches", load(metrics.bg_batches));
+	counters.emplace_back("bg_batches_per_sec", load(metrics.bg_batches_per_sec));
+	counters.emplace_back("gc_runs", load(metrics.gc_runs));
+	counters.emplace_back("gc_force_runs", load(metrics.gc_force_runs));
+	counters.emplace_back("bg_oom_errors", load(metrics.bg_oom_errors));
+	counters.emplace_back("oom_recoveries", load(metrics.oom_recoveries));
+}
+
 heterogeneous_radix::merged_iterator heterogeneous_radix::merged_begin()
 {
 	return merged_iterator(*this, cache->begin(), container->begin());
@@ -976,6 +1611,29 @@ status heterogeneous_radix::get_between(string_view key1, string_view key2,
 	return status::OK;
 }
 
+status heterogeneous_radix::get_prefix(string_view prefix, get_kv_callback *callback,
+				       void *arg)
+{
+	check_outside_tx();
+
+	status s;
+	container_worker->critical([&] {
+		auto first = merged_lower_bound(prefix);
+
+		s = iterate_generic(
+			first,
+			[&](const merged_iterator &it) {
+				return iterate_callback(it, callback, arg);
+			},
+			[&](const merged_iterator &it) {
+				return it.dereferenceable() &&
+					internal::has_prefix(it.key(), prefix);
+			});
+	});
+
+	return s;
+}
+
 /* Used as a callback for get_* methods, increments a counter passed through @param arg on
  * each call. */
 static int count_elements(const char *, size_t, const char *, size_t, void *arg)
@@ -1035,6 +1693,14 @@ status heterogeneous_radix::count_between(string_view key1, string_view key2,
 	return get_between(key1, key2, count_elements, (void *)&cnt);
 }
 
+status heterogeneous_radix::count_prefix(string_view prefix, std::size_t &cnt)
+{
+	check_outside_tx();
+
+	cnt = 0;
+	return get_prefix(prefix, count_elements, (void *)&cnt);
+}
+
 status heterogeneous_radix::exists(string_view key)
 {
 	return get(
@@ -1080,17 +1746,52 @@ void heterogeneous_radix::consume_queue_entry(pmem::obj::string_view entry,
 
 void heterogeneous_radix::bg_work()
 {
+	using clock_type = std::chrono::steady_clock;
+
+	/* bg_batches_per_sec is computed over windows of (at least) a second */
+	auto window_start = clock_type::now();
+	uint64_t window_batches = 0;
+
 	bool should_report_oom = false;
 	while (true) {
 		/* XXX: only stop if all elements are consumed ? */
 		if (stopped.load())
 			return;
 
+		auto now = clock_type::now();
+		if (now - window_start >= std::chrono::seconds(1)) {
+			auto batches = metrics.bg_batches.load(std::memory_order_relaxed);
+			auto ns = static_cast<uint64_t>(
+				std::chrono::duration_cast<std::chrono::nanoseconds>(
+					now - window_start)
+					.count());
+			metrics.bg_batches_per_sec.store(
+				(batches - window_batches) * 1000000000 / ns,
+				std::memory_order_relaxed);
+
+			window_start = now;
+			window_batches = batches;
+		}
+
 		try {
 			auto consumed = queue->try_consume_batch(
 				[&](pmem_queue_type::batch_type batch) {
-					for (auto entry : batch)
+					PMEMKV_PROBE(radix_bg_batch);
+
+					uint64_t n = 0, bytes = 0;
+					for (auto entry : batch) {
 						consume_queue_entry(entry, true);
+						n++;
+						bytes += entry.size();
+					}
+					metrics.consumed_entries.fetch_add(
+						n, std::memory_order_relaxed);
+					metrics.consumed_bytes.fetch_add(
+						bytes, std::memory_order_relaxed);
+					metrics.bg_batches.fetch_add(
+						1, std::memory_order_relaxed);
+
+					PMEMKV_PROBE1(radix_bg_batch_done, n);
 				});
 
 			if (consumed) {
@@ -1098,6 +1799,7 @@ void heterogeneous_radix::bg_work()
 			} else {
 				/* Nothing else to do, try to collect some
 				 * garbage. */
+				metrics.gc_runs.fetch_add(1, std::memory_order_relaxed);
 				container->garbage_collect();
 			}
 		} catch (...) {
@@ -1106,12 +1808,15 @@ void heterogeneous_radix::bg_work()
 				 * report oom for the user in next iteration. */
 				try {
 					should_report_oom = true;
+					metrics.gc_force_runs.fetch_add(
+						1, std::memory_order_relaxed);
 					container->garbage_collect_force();
 					continue;
 				} catch (...) {
 				}
 			}
 
+			metrics.bg_oom_errors.fetch_add(1, std::memory_order_relaxed);
 			auto ex = new std::exception_ptr(std::current_exception());
 			bg_exception_ptr.store(ex);
 
@@ -1144,7 +1849,7 @@ internal::iterator_base *radix::new_const_iterator()
 }
 
 radix::radix_iterator<true>::radix_iterator(container_type *c)
-    : container(c), pop(pmem::obj::pool_by_vptr(c))
+    : container(c), it_(c->end()), pop(pmem::obj::pool_by_vptr(c))
 {
 }
 
@@ -1156,6 +1861,7 @@ radix::radix_iterator<false>::radix_iterator(container_type *c)
 status radix::radix_iterator<true>::seek(string_view key)
 {
 	init_seek();
+	prefix_bound.clear();
 
 	it_ = container->find(key);
 	if (it_ != container->end())
@@ -1167,6 +1873,7 @@ status radix::radix_iterator<true>::seek(string_view key)
 status radix::radix_iterator<true>::seek_lower(string_view key)
 {
 	init_seek();
+	prefix_bound.clear();
 
 	it_ = container->lower_bound(key);
 	if (it_ == container->begin()) {
@@ -1182,6 +1889,7 @@ status radix::radix_iterator<true>::seek_lower(string_view key)
 status radix::radix_iterator<true>::seek_lower_eq(string_view key)
 {
 	init_seek();
+	prefix_bound.clear();
 
 	it_ = container->upper_bound(key);
 	if (it_ == container->begin()) {
@@ -1197,6 +1905,7 @@ status radix::radix_iterator<true>::seek_lower_eq(string_view key)
 status radix::radix_iterator<true>::seek_higher(string_view key)
 {
 	init_seek();
+	prefix_bound.clear();
 
 	it_ = container->upper_bound(key);
 	if (it_ == container->end())
@@ -1208,6 +1917,7 @@ status radix::radix_iterator<true>::seek_higher(string_view key)
 status radix::radix_iterator<true>::seek_higher_eq(string_view key)
 {
 	init_seek();
+	prefix_bound.clear();
 
 	it_ = container->lower_bound(key);
 	if (it_ == container->end())
@@ -1216,9 +1926,24 @@ status radix::radix_iterator<true>::seek_higher_eq(string_view key)
 	return status::OK;
 }
 
+status radix::radix_iterator<true>::seek_prefix(string_view prefix)
+{
+	init_seek();
+	prefix_bound.assign(prefix.data(), prefix.size());
+
+	it_ = container->lower_bound(prefix);
+	if (it_ == container->end() || !within_prefix_bound(it_)) {
+		it_ = container->end();
+		return status::NOT_FOUND;
+	}
+
+	return status::OK;
+}
+
 status radix::radix_iterator<true>::seek_to_first()
 {
 	init_seek();
+	prefix_bound.clear();
 
 	if (container->empty())
 		return status::NOT_FOUND;
@@ -1231,6 +1956,7 @@ status radix::radix_iterator<true>::seek_to_first()
 status radix::radix_iterator<true>::seek_to_last()
 {
 	init_seek();
+	prefix_bound.clear();
 
 	if (container->empty())
 		return status::NOT_FOUND;
@@ -1244,7 +1970,8 @@ status radix::radix_iterator<true>::seek_to_last()
 status radix::radix_iterator<true>::is_next()
 {
 	auto tmp = it_;
-	if (tmp == container->end() || ++tmp == container->end())
+	if (tmp == container->end() || ++tmp == container->end() ||
+	    !within_prefix_bound(tmp))
 		return status::NOT_FOUND;
 
 	return status::OK;
@@ -1257,6 +1984,11 @@ status radix::radix_iterator<true>::next()
 	if (it_ == container->end() || ++it_ == container->end())
 		return status::NOT_FOUND;
 
+	if (!within_prefix_bound(it_)) {
+		it_ = container->end();
+		return status::NOT_FOUND;
+	}
+
 	return status::OK;
 }
 
@@ -1267,11 +1999,22 @@ status radix::radix_iterator<true>::prev()
 	if (it_ == container->begin())
 		return status::NOT_FOUND;
 
-	--it_;
+	auto tmp = it_;
+	if (!within_prefix_bound(--tmp))
+		return status::NOT_FOUND;
+
+	it_ = tmp;
 
 	return status::OK;
 }
 
+bool radix::radix_iterator<true>::within_prefix_bound(
+	const container_type::iterator &it) const
+{
+	return internal::has_prefix(string_view(it->key().cdata(), it->key().size()),
+				    prefix_bound);
+}
+
 result<string_view> radix::radix_iterator<true>::key()
 {
 	assert(it_ != container->end());
@@ -1290,6 +2033,30 @@ result<pmem::obj::slice<const char *>> radix::radix_iterator<true>::read_range(s
 	return {{it_->value().cdata() + pos, it_->value().cdata() + pos + n}};
 }
 
+/* records are read directly from the tree, without virtual calls per record */
+status radix::radix_iterator<true>::read_batch(pmemkv_iterator_entry *entries, size_t n,
+					       size_t &count)
+{
+	init_seek();
+
+	count = 0;
+	/* iterator is not positioned (or already past the last record) */
+	if (it_ == container->end())
+		return status::NOT_FOUND;
+
+	while (count < n) {
+		entries[count++] = {it_->key().cdata(), it_->key().size(),
+				    it_->value().cdata(), it_->value().size()};
+
+		if (++it_ == container->end() || !within_prefix_bound(it_)) {
+			it_ = container->end();
+			return status::NOT_FOUND;
+		}
+	}
+
+	return status::OK;
+}
+
 result<pmem::obj::slice<char *>> radix::radix_iterator<false>::write_range(size_t pos,
 									   size_t n)
 {
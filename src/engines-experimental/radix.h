@@ -5,7 +5,9 @@
 #define LIBPMEMKV_RADIX_H
 
 #include "../comparator/pmemobj_comparator.h"
+#include "../expiry.h"
 #include "../iterator.h"
+#include "../parallel_scan.h"
 #include "../pmemobj_engine.h"
 
 #include <libpmemobj++/experimental/inline_string.hpp>
@@ -40,6 +42,16 @@ using map_mt_type = map_type_generic<true>;
 
 using log_type = pmem::obj::experimental::mpsc_queue::pmem_log_type;
 
+/**
+ * Maximum number of records removed by remove_range() in a single transaction.
+ */
+const size_t REMOVE_CHUNK_SIZE = 1024;
+
+/**
+ * Maximum number of records inserted by bulk_load() in a single transaction.
+ */
+const size_t BULK_LOAD_CHUNK_SIZE = 1024;
+
 template <typename MapType = map_type>
 struct pmem_type {
 	pmem_type() : map()
@@ -49,14 +61,17 @@ struct pmem_type {
 
 	MapType map;
 	pmem::obj::persistent_ptr<log_type> log;
-	uint64_t reserved[6];
+	/* key -> expiry_index::persistent_deadline, used by radix only */
+	pmem::obj::persistent_ptr<MapType> deadlines;
+	uint64_t reserved[4];
 };
 
 static_assert(sizeof(pmem_type<map_type>) == sizeof(map_type) + 64, "");
 
 class transaction : public ::pmem::kv::internal::transaction {
 public:
-	transaction(pmem::obj::pool_base &pop, map_type *container);
+	transaction(pmem::obj::pool_base &pop, map_type *container, map_type *deadlines,
+		    engine_base &engine, expiry_index &expiry);
 	status put(string_view key, string_view value) final;
 	status remove(string_view key) final;
 	status commit() final;
@@ -66,6 +81,9 @@ private:
 	pmem::obj::pool_base &pop;
 	dram_log log;
 	map_type *container;
+	map_type *deadlines;
+	engine_base &engine;
+	expiry_index &expiry;
 };
 
 template <typename Value>
@@ -236,13 +254,52 @@ public:
 	status get_between(string_view key1, string_view key2, get_kv_callback *callback,
 			   void *arg) final;
 
+	status get_all_desc(get_kv_callback *callback, void *arg) final;
+	status get_above_desc(string_view key, get_kv_callback *callback,
+			      void *arg) final;
+	status get_equal_above_desc(string_view key, get_kv_callback *callback,
+				    void *arg) final;
+	status get_equal_below_desc(string_view key, get_kv_callback *callback,
+				    void *arg) final;
+	status get_below_desc(string_view key, get_kv_callback *callback,
+			      void *arg) final;
+	status get_between_desc(string_view key1, string_view key2,
+				get_kv_callback *callback, void *arg) final;
+
+	status count_prefix(string_view prefix, std::size_t &cnt) final;
+	status get_prefix(string_view prefix, get_kv_callback *callback, void *arg) final;
+
+	status get_keys(get_k_callback *callback, void *arg) final;
+	status get_keys_above(string_view key, get_k_callback *callback, void *arg) final;
+	status get_keys_below(string_view key, get_k_callback *callback, void *arg) final;
+	status get_keys_between(string_view key1, string_view key2,
+				get_k_callback *callback, void *arg) final;
+
+	status get_split_points(std::size_t partitions,
+				std::vector<std::string> &keys) final;
+
+	status get_above_page(string_view key, internal::scan_cursor &cursor,
+			      get_kv_callback *callback, void *arg) final;
+	status get_between_page(string_view key1, string_view key2,
+				internal::scan_cursor &cursor, get_kv_callback *callback,
+				void *arg) final;
+
 	status exists(string_view key) final;
 
 	status get(string_view key, get_v_callback *callback, void *arg) final;
+	status value_size(string_view key, std::size_t &size) final;
+	status get_many(const std::vector<string_view> &keys, get_many_callback *callback,
+			void *arg) final;
 
 	status put(string_view key, string_view value) final;
+	status put_with_ttl(string_view key, string_view value,
+			    std::chrono::milliseconds ttl) final;
 
 	status remove(string_view key) final;
+	status remove_range(string_view key1, string_view key2) final;
+	status remove_prefix(string_view prefix) final;
+
+	status bulk_load(internal::bulk_load_source &source) final;
 
 	internal::transaction *begin_tx() final;
 
@@ -258,9 +315,27 @@ private:
 			     get_kv_callback *callback, void *arg);
 	status iterate(container_type::iterator begin, container_type::iterator last,
 		       get_kv_callback *callback, void *arg);
+	status iterate_keys(container_type::iterator first, container_type::iterator last,
+			    get_k_callback *callback, void *arg);
+	status iterate_desc(container_type::iterator first, container_type::iterator last,
+			    get_kv_callback *callback, void *arg);
+	static std::pair<string_view, string_view>
+	key_value(const container_type::iterator &it);
+
+	/* removes keys from key1 (inclusive) to key2 (exclusive, nullptr - no bound) */
+	status erase_range(string_view key1, const string_view *key2);
+
+	/* Below two methods must be called with the key's shard locked */
+	void set_deadline(string_view key, internal::expiry_index::time_point deadline);
+	void clear_deadline(string_view key);
 
 	container_type *container;
+	/* persistent deadlines of records put with TTL */
+	container_type *deadlines;
 	std::unique_ptr<internal::config> config;
+
+	internal::expiry_index expiry;
+	std::unique_ptr<internal::expiry_reaper> reaper;
 };
 
 /**
@@ -303,6 +378,9 @@ public:
 	status get_between(string_view key1, string_view key2, get_kv_callback *callback,
 			   void *arg) final;
 
+	status count_prefix(string_view prefix, std::size_t &cnt) final;
+	status get_prefix(string_view prefix, get_kv_callback *callback, void *arg) final;
+
 	status exists(string_view key) final;
 
 	status put(string_view key, string_view value) final;
@@ -311,6 +389,8 @@ public:
 
 	status get(string_view key, get_v_callback *callback, void *arg) final;
 
+	void get_engine_counters(internal::engine_counters &counters) final;
+
 private:
 	using container_type = internal::radix::map_mt_type;
 	using pmem_type = internal::radix::pmem_type<container_type>;
@@ -415,6 +495,37 @@ private:
 
 	std::unique_ptr<pmem_queue_type> queue;
 	std::unique_ptr<pmem_queue_type::worker> queue_worker;
+
+	/*
+	 * Counters of this run, reported by get_engine_counters(). Cache and
+	 * put() counters are updated only by the (single) user thread, the
+	 * others only by bg_work(), so they are updated with relaxed atomics.
+	 */
+	struct metrics_type {
+		/* entries (and their bytes) produced by put(), consumed by bg_work() */
+		std::atomic<uint64_t> produced_entries{0};
+		std::atomic<uint64_t> consumed_entries{0};
+		std::atomic<uint64_t> produced_bytes{0};
+		std::atomic<uint64_t> consumed_bytes{0};
+
+		std::atomic<uint64_t> cache_hits{0};
+		std::atomic<uint64_t> cache_misses{0};
+		std::atomic<uint64_t> cache_evictions{0};
+		/* cache_put_with_evict() returned nullptr: all entries are in the log */
+		std::atomic<uint64_t> cache_eviction_failures{0};
+		/* puts which waited for a free cache entry or for space in the log */
+		std::atomic<uint64_t> put_cache_waits{0};
+		std::atomic<uint64_t> put_log_waits{0};
+
+		std::atomic<uint64_t> bg_batches{0};
+		/* measured by bg_work() over the last second */
+		std::atomic<uint64_t> bg_batches_per_sec{0};
+		std::atomic<uint64_t> gc_runs{0};
+		std::atomic<uint64_t> gc_force_runs{0};
+		/* OOM errors of bg_work() passed to the user and recoveries by remove() */
+		std::atomic<uint64_t> bg_oom_errors{0};
+		std::atomic<uint64_t> oom_recoveries{0};
+	} metrics;
 };
 
 static inline constexpr size_t align_up(size_t size, size_t align)
@@ -486,6 +597,7 @@ public:
 	status seek_lower_eq(string_view key) final;
 	status seek_higher(string_view key) final;
 	status seek_higher_eq(string_view key) final;
+	status seek_prefix(string_view prefix) final;
 
 	status seek_to_first() final;
 	status seek_to_last() final;
@@ -497,11 +609,17 @@ public:
 	result<string_view> key() final;
 
 	result<pmem::obj::slice<const char *>> read_range(size_t pos, size_t n) final;
+	status read_batch(pmemkv_iterator_entry *entries, size_t n, size_t &count) final;
 
 protected:
+	bool within_prefix_bound(const container_type::iterator &it) const;
+
 	container_type *container;
 	container_type::iterator it_;
 	pmem::obj::pool_base pop;
+
+	/* set by seek_prefix(), is_next(), next() and prev() do not cross it */
+	std::string prefix_bound;
 };
 
 template <>
@@ -6,6 +6,7 @@
 #include "../fast_hash.h"
 #include "../out.h"
 
+#include <algorithm>
 #include <unistd.h>
 
 namespace pmem
@@ -561,6 +562,33 @@ status robinhood::get_all(get_kv_callback *callback, void *arg)
 	return status::OK;
 }
 
+/* Every partition scans a contiguous range of shards */
+status robinhood::get_all_parallel(std::size_t partitions, get_kv_callback *callback,
+				   void *arg)
+{
+	LOG("get_all_parallel partitions=" << partitions);
+	check_outside_tx();
+
+	if (partitions > shards_number)
+		partitions = shards_number;
+
+	internal::parallel_scan scan(callback, arg);
+
+	return scan.run(partitions, [&](std::size_t p) {
+		for (size_t i = p * shards_number / partitions;
+		     i < (p + 1) * shards_number / partitions; ++i) {
+			shared_lock_type lock(mtxs[i]);
+			auto ret = hm_rp_foreach(pmpool.handle(), container[i],
+						 internal::parallel_scan::callback, &scan);
+
+			if (ret)
+				return status::STOPPED_BY_CB;
+		}
+
+		return status::OK;
+	});
+}
+
 status robinhood::exists(string_view key)
 {
 	LOG("exists for key=" << std::string(key.data(), key.size()));
@@ -605,6 +633,29 @@ status robinhood::get(string_view key, get_v_callback *callback, void *arg)
 	return status::OK;
 }
 
+/* All values have the same size, so only presence of the key is checked */
+status robinhood::value_size(string_view key, std::size_t &size)
+{
+	LOG("value_size key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	if (key.size() != ENTRY_SIZE)
+		return status::INVALID_ARGUMENT;
+
+	auto k = *reinterpret_cast<const uint64_t *>(key.data());
+
+	auto shard = shard_hash(k);
+	shared_lock_type lock(mtxs[shard]);
+
+	if (hm_rp_lookup(pmpool.handle(), container[shard], k) == 0) {
+		LOG("  key not found");
+		return status::NOT_FOUND;
+	}
+
+	size = ENTRY_SIZE;
+	return status::OK;
+}
+
 status robinhood::put(string_view key, string_view value)
 {
 	LOG("put key=" << std::string(key.data(), key.size())
@@ -629,6 +680,62 @@ status robinhood::put(string_view key, string_view value)
 	return status::OK;
 }
 
+status robinhood::put_if_absent(string_view key, string_view value)
+{
+	LOG("put_if_absent key=" << std::string(key.data(), key.size())
+				 << ", value.size=" << std::to_string(value.size()));
+	check_outside_tx();
+
+	if (key.size() != ENTRY_SIZE || value.size() != ENTRY_SIZE)
+		return status::INVALID_ARGUMENT;
+
+	auto k = *reinterpret_cast<const uint64_t *>(key.data());
+	auto v = *reinterpret_cast<const uint64_t *>(value.data());
+
+	auto shard = shard_hash(k);
+	unique_lock_type lock(mtxs[shard]);
+
+	if (hm_rp_lookup(pmpool.handle(), container[shard], k) != 0)
+		return status::CONDITION_NOT_MET;
+
+	if (hm_rp_insert(pmpool.handle(), container[shard], k, v) != 0)
+		return status::UNKNOWN_ERROR;
+
+	return status::OK;
+}
+
+status robinhood::compare_and_swap(string_view key, string_view expected,
+				   string_view desired)
+{
+	LOG("compare_and_swap key=" << std::string(key.data(), key.size())
+				    << ", desired.size="
+				    << std::to_string(desired.size()));
+	check_outside_tx();
+
+	if (key.size() != ENTRY_SIZE || expected.size() != ENTRY_SIZE ||
+	    desired.size() != ENTRY_SIZE)
+		return status::INVALID_ARGUMENT;
+
+	auto k = *reinterpret_cast<const uint64_t *>(key.data());
+	auto e = *reinterpret_cast<const uint64_t *>(expected.data());
+	auto d = *reinterpret_cast<const uint64_t *>(desired.data());
+
+	auto shard = shard_hash(k);
+	unique_lock_type lock(mtxs[shard]);
+
+	auto result = hm_rp_get(pmpool.handle(), container[shard], k);
+	if (!result.second)
+		return status::NOT_FOUND;
+
+	if (result.first != e)
+		return status::CONDITION_NOT_MET;
+
+	if (hm_rp_insert(pmpool.handle(), container[shard], k, d) != 0)
+		return status::UNKNOWN_ERROR;
+
+	return status::OK;
+}
+
 status robinhood::remove(string_view key)
 {
 	LOG("remove key=" << std::string(key.data(), key.size()));
@@ -650,6 +757,84 @@ status robinhood::remove(string_view key)
 	return status::OK;
 }
 
+status robinhood::remove_if(string_view key, string_view expected)
+{
+	LOG("remove_if key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	if (key.size() != ENTRY_SIZE || expected.size() != ENTRY_SIZE)
+		return status::INVALID_ARGUMENT;
+
+	auto k = *reinterpret_cast<const uint64_t *>(key.data());
+	auto e = *reinterpret_cast<const uint64_t *>(expected.data());
+
+	auto shard = shard_hash(k);
+	unique_lock_type lock(mtxs[shard]);
+
+	auto result = hm_rp_get(pmpool.handle(), container[shard], k);
+	if (!result.second)
+		return status::NOT_FOUND;
+
+	if (result.first != e)
+		return status::CONDITION_NOT_MET;
+
+	hm_rp_remove(pmpool.handle(), container[shard], k);
+
+	return status::OK;
+}
+
+/*
+ * Operations are grouped by shard (stable, so operations on the same key are
+ * still applied in order) and every shard is locked only once per batch.
+ */
+status robinhood::apply_batch(const internal::write_batch &batch)
+{
+	LOG("apply_batch of " << batch.size() << " operations");
+	check_outside_tx();
+
+	/* pairs of (shard, index of operation in the batch) */
+	std::vector<std::pair<size_t, size_t>> ops;
+	ops.reserve(batch.size());
+
+	for (size_t i = 0; i < batch.size(); ++i) {
+		auto e = batch[i];
+		if (e.key.size() != ENTRY_SIZE ||
+		    (e.op == internal::write_batch::operation::put &&
+		     e.value.size() != ENTRY_SIZE))
+			return status::INVALID_ARGUMENT;
+
+		auto k = *reinterpret_cast<const uint64_t *>(e.key.data());
+		ops.emplace_back(shard_hash(k), i);
+	}
+
+	std::stable_sort(ops.begin(), ops.end(),
+			 [](const std::pair<size_t, size_t> &lhs,
+			    const std::pair<size_t, size_t> &rhs) {
+				 return lhs.first < rhs.first;
+			 });
+
+	for (size_t n = 0; n < ops.size();) {
+		auto shard = ops[n].first;
+		unique_lock_type lock(mtxs[shard]);
+
+		for (; n < ops.size() && ops[n].first == shard; ++n) {
+			auto e = batch[ops[n].second];
+			auto k = *reinterpret_cast<const uint64_t *>(e.key.data());
+
+			if (e.op == internal::write_batch::operation::remove) {
+				hm_rp_remove(pmpool.handle(), container[shard], k);
+				continue;
+			}
+
+			auto v = *reinterpret_cast<const uint64_t *>(e.value.data());
+			if (hm_rp_insert(pmpool.handle(), container[shard], k, v) != 0)
+				return status::UNKNOWN_ERROR;
+		}
+	}
+
+	return status::OK;
+}
+
 void robinhood::Recover()
 {
 	auto sn = std::getenv("PMEMKV_ROBINHOOD_SHARDS_NUMBER");
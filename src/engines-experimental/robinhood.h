@@ -14,6 +14,7 @@
 #include <libpmemobj++/persistent_ptr.hpp>
 
 #include "../comparator/pmemobj_comparator.h"
+#include "../parallel_scan.h"
 #include "../pmemobj_engine.h"
 
 namespace pmem
@@ -114,14 +115,24 @@ public:
 	status count_all(std::size_t &cnt) final;
 
 	status get_all(get_kv_callback *callback, void *arg) final;
+	status get_all_parallel(std::size_t partitions, get_kv_callback *callback,
+				void *arg) final;
 
 	status exists(string_view key) final;
 
 	status get(string_view key, get_v_callback *callback, void *arg) final;
+	status value_size(string_view key, std::size_t &size) final;
 
 	status put(string_view key, string_view value) final;
 
+	status put_if_absent(string_view key, string_view value) final;
+	status compare_and_swap(string_view key, string_view expected,
+				string_view desired) final;
+
 	status remove(string_view key) final;
+	status remove_if(string_view key, string_view expected) final;
+
+	status apply_batch(const internal::write_batch &batch) final;
 
 private:
 	using container_type = internal::robinhood::map_type;
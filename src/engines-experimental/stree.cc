@@ -2,11 +2,13 @@
 /* Copyright 2017-2021, Intel Corporation */
 
 #include <iostream>
+#include <iterator>
 #include <unistd.h>
 
 #include <libpmemobj++/make_persistent_atomic.hpp>
 #include <libpmemobj++/transaction.hpp>
 
+#include "../op_phases.h"
 #include "../out.h"
 #include "stree.h"
 
@@ -20,7 +22,9 @@ namespace kv
 {
 
 stree::stree(std::unique_ptr<internal::config> cfg)
-    : pmemobj_engine_base(cfg, "pmemkv_stree"), config(std::move(cfg))
+    : pmemobj_engine_base(cfg, "pmemkv_stree"),
+      config(std::move(cfg)),
+      versions(internal::extract_comparator(*config))
 {
 	Recover();
 	LOG("Started ok");
@@ -46,14 +50,11 @@ status stree::count_all(std::size_t &cnt)
 	return status::OK;
 }
 
-template <typename It>
-static std::size_t size(It first, It last)
-{
-	auto dist = std::distance(first, last);
-	assert(dist >= 0);
-
-	return static_cast<std::size_t>(dist);
-}
+/*
+ * Counts are computed from ranks of the bounds - if the tree was created with
+ * "subtree_counts", inner nodes keep the number of entries in subtrees of their
+ * children, so no leaves are traversed.
+ */
 
 /* above key, key exclusive */
 status stree::count_above(string_view key, std::size_t &cnt)
@@ -61,10 +62,7 @@ status stree::count_above(string_view key, std::size_t &cnt)
 	LOG("count_above key>=" << std::string(key.data(), key.size()));
 	check_outside_tx();
 
-	auto first = my_btree->upper_bound(key);
-	auto last = my_btree->end();
-
-	cnt = size(first, last);
+	cnt = my_btree->size() - my_btree->rank(key, true);
 
 	return status::OK;
 }
@@ -75,10 +73,7 @@ status stree::count_equal_above(string_view key, std::size_t &cnt)
 	LOG("count_equal_above key>=" << std::string(key.data(), key.size()));
 	check_outside_tx();
 
-	auto first = my_btree->lower_bound(key);
-	auto last = my_btree->end();
-
-	cnt = size(first, last);
+	cnt = my_btree->size() - my_btree->rank(key, false);
 
 	return status::OK;
 }
@@ -89,10 +84,7 @@ status stree::count_below(string_view key, std::size_t &cnt)
 	LOG("count_below key<" << std::string(key.data(), key.size()));
 	check_outside_tx();
 
-	auto first = my_btree->begin();
-	auto last = my_btree->lower_bound(key);
-
-	cnt = size(first, last);
+	cnt = my_btree->rank(key, false);
 
 	return status::OK;
 }
@@ -103,10 +95,7 @@ status stree::count_equal_below(string_view key, std::size_t &cnt)
 	LOG("count_equal_below key>=" << std::string(key.data(), key.size()));
 	check_outside_tx();
 
-	auto first = my_btree->begin();
-	auto last = my_btree->upper_bound(key);
-
-	cnt = size(first, last);
+	cnt = my_btree->rank(key, true);
 
 	return status::OK;
 }
@@ -118,10 +107,7 @@ status stree::count_between(string_view key1, string_view key2, std::size_t &cnt
 	check_outside_tx();
 
 	if (my_btree->key_comp()(key1, key2)) {
-		auto first = my_btree->upper_bound(key1);
-		auto last = my_btree->lower_bound(key2);
-
-		cnt = size(first, last);
+		cnt = my_btree->rank(key2, false) - my_btree->rank(key1, true);
 	} else {
 		cnt = 0;
 	}
@@ -206,6 +192,273 @@ status stree::get_between(string_view key1, string_view key2, get_kv_callback *c
 	return status::OK;
 }
 
+/*
+ * Descending variants of get_* methods - leaves are linked in both directions,
+ * so the range is visited backwards at the same cost.
+ */
+status stree::get_all_desc(get_kv_callback *callback, void *arg)
+{
+	LOG("get_all_desc");
+	check_outside_tx();
+
+	auto first = my_btree->begin();
+	auto last = my_btree->end();
+
+	return internal::iterate_through_pairs_desc(first, last, callback, arg);
+}
+
+/* (key, end), above key, in descending order */
+status stree::get_above_desc(string_view key, get_kv_callback *callback, void *arg)
+{
+	LOG("get_above_desc start key>" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	auto first = my_btree->upper_bound(key);
+	auto last = my_btree->end();
+
+	return internal::iterate_through_pairs_desc(first, last, callback, arg);
+}
+
+/* [key, end), above or equal to key, in descending order */
+status stree::get_equal_above_desc(string_view key, get_kv_callback *callback, void *arg)
+{
+	LOG("get_equal_above_desc start key>=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	auto first = my_btree->lower_bound(key);
+	auto last = my_btree->end();
+
+	return internal::iterate_through_pairs_desc(first, last, callback, arg);
+}
+
+/* [start, key], below or equal to key, in descending order */
+status stree::get_equal_below_desc(string_view key, get_kv_callback *callback, void *arg)
+{
+	LOG("get_equal_below_desc key<=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	auto first = my_btree->begin();
+	auto last = my_btree->upper_bound(key);
+
+	return internal::iterate_through_pairs_desc(first, last, callback, arg);
+}
+
+/* [start, key), less than key, in descending order */
+status stree::get_below_desc(string_view key, get_kv_callback *callback, void *arg)
+{
+	LOG("get_below_desc key<" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	auto first = my_btree->begin();
+	auto last = my_btree->lower_bound(key);
+
+	return internal::iterate_through_pairs_desc(first, last, callback, arg);
+}
+
+/* (key1, key2), key1 exclusive, key2 exclusive, in descending order */
+status stree::get_between_desc(string_view key1, string_view key2,
+			       get_kv_callback *callback, void *arg)
+{
+	LOG("get_between_desc key range=(" << std::string(key1.data(), key1.size())
+					   << "," << std::string(key2.data(), key2.size())
+					   << ")");
+	check_outside_tx();
+
+	if (my_btree->key_comp()(key1, key2)) {
+		auto first = my_btree->upper_bound(key1);
+		auto last = my_btree->lower_bound(key2);
+
+		return internal::iterate_through_pairs_desc(first, last, callback, arg);
+	}
+
+	return status::OK;
+}
+
+/* keys starting with prefix */
+status stree::count_prefix(string_view prefix, std::size_t &cnt)
+{
+	LOG("count_prefix prefix=" << std::string(prefix.data(), prefix.size()));
+	check_outside_tx();
+
+	if (!internal::has_binary_order(*config))
+		return engine_base::count_prefix(prefix, cnt);
+
+	cnt = 0;
+	for (auto it = my_btree->lower_bound(prefix);
+	     it != my_btree->end() && internal::has_prefix(key_value(it).first, prefix);
+	     ++it)
+		cnt++;
+
+	return status::OK;
+}
+
+/*
+ * Keys starting with prefix, found with a single descent: they are adjacent
+ * and the first one is not less than the prefix itself. With a custom
+ * comparator they can be spread across the tree, so all records are checked.
+ */
+status stree::get_prefix(string_view prefix, get_kv_callback *callback, void *arg)
+{
+	LOG("get_prefix prefix=" << std::string(prefix.data(), prefix.size()));
+	check_outside_tx();
+
+	if (!internal::has_binary_order(*config))
+		return engine_base::get_prefix(prefix, callback, arg);
+
+	for (auto it = my_btree->lower_bound(prefix);
+	     it != my_btree->end() && internal::has_prefix(key_value(it).first, prefix);
+	     ++it) {
+		auto ret = callback(it->first.c_str(), it->first.size(),
+				    it->second.c_str(), it->second.size(), arg);
+		if (ret != 0)
+			return status::STOPPED_BY_CB;
+	}
+
+	return status::OK;
+}
+
+/* Key-only scans - keys are read from the leaves, values are not accessed */
+status stree::get_keys(get_k_callback *callback, void *arg)
+{
+	LOG("get_keys");
+	check_outside_tx();
+
+	return internal::iterate_through_keys(my_btree->begin(), my_btree->end(),
+					      callback, arg);
+}
+
+/* (key, end), above key */
+status stree::get_keys_above(string_view key, get_k_callback *callback, void *arg)
+{
+	LOG("get_keys_above start key>=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	return internal::iterate_through_keys(my_btree->upper_bound(key),
+					      my_btree->end(), callback, arg);
+}
+
+/* [start, key), less than key, key exclusive */
+status stree::get_keys_below(string_view key, get_k_callback *callback, void *arg)
+{
+	LOG("get_keys_below key<" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	return internal::iterate_through_keys(my_btree->begin(),
+					      my_btree->lower_bound(key), callback, arg);
+}
+
+/* (key1, key2), key1 exclusive, key2 exclusive */
+status stree::get_keys_between(string_view key1, string_view key2,
+			       get_k_callback *callback, void *arg)
+{
+	LOG("get_keys_between key range=[" << std::string(key1.data(), key1.size())
+					   << "," << std::string(key2.data(), key2.size())
+					   << ")");
+	check_outside_tx();
+
+	if (my_btree->key_comp()(key1, key2)) {
+		auto first = my_btree->upper_bound(key1);
+		auto last = my_btree->lower_bound(key2);
+
+		return internal::iterate_through_keys(first, last, callback, arg);
+	}
+
+	return status::OK;
+}
+
+/* Split points are separators from inner nodes of the tree */
+status stree::get_split_points(std::size_t partitions, std::vector<std::string> &keys)
+{
+	LOG("get_split_points partitions=" << partitions);
+	check_outside_tx();
+
+	std::vector<const internal::stree::key_type *> split;
+	my_btree->split_keys(partitions, std::back_inserter(split));
+
+	keys.clear();
+	for (auto key : split)
+		keys.emplace_back(key->c_str(), key->size());
+
+	return status::OK;
+}
+
+/* records starting from the n-th one (in sorted order), see b_tree_base::nth() */
+status stree::get_by_rank(std::size_t n, get_kv_callback *callback, void *arg)
+{
+	LOG("get_by_rank n=" << n);
+	check_outside_tx();
+
+	return internal::iterate_through_pairs(my_btree->nth(n), my_btree->end(),
+					       callback, arg);
+}
+
+/* number of keys less than the given key, if it exists */
+status stree::rank_of(string_view key, std::size_t &rank)
+{
+	LOG("rank_of key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	if (my_btree->find(key) == my_btree->end())
+		return status::NOT_FOUND;
+
+	rank = my_btree->rank(key, false);
+
+	return status::OK;
+}
+
+std::pair<string_view, string_view> stree::key_value(const container_iterator &it)
+{
+	return {string_view(it->first.c_str(), it->first.size()),
+		string_view(it->second.c_str(), it->second.size())};
+}
+
+/*
+ * Pages are continued from the cached position of the last returned element
+ * (if the tree was not modified since), without descending from the root.
+ */
+status stree::get_above_page(string_view key, internal::scan_cursor &cursor,
+			     get_kv_callback *callback, void *arg)
+{
+	LOG("get_above_page start key>" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	auto first = my_btree->end();
+	if (!cursor.resume(key, scan_version(), first))
+		first = my_btree->upper_bound(key);
+	auto last = my_btree->end();
+
+	return cursor.fill(
+		first, [&](const container_iterator &it) { return it == last; }, key_value,
+		scan_version(), callback, arg);
+}
+
+status stree::get_between_page(string_view key1, string_view key2,
+			       internal::scan_cursor &cursor, get_kv_callback *callback,
+			       void *arg)
+{
+	LOG("get_between_page key range=(" << std::string(key1.data(), key1.size())
+					   << "," << std::string(key2.data(), key2.size())
+					   << ")");
+	check_outside_tx();
+
+	if (!my_btree->key_comp()(key1, key2)) {
+		cursor.reset();
+		return status::OK;
+	}
+
+	auto first = my_btree->end();
+	if (!cursor.resume(key1, scan_version(), first))
+		first = my_btree->upper_bound(key1);
+	auto last = my_btree->end();
+
+	return cursor.fill(
+		first,
+		[&](const container_iterator &it) {
+			return it == last || !my_btree->key_comp()(it->first, key2);
+		},
+		key_value, scan_version(), callback, arg);
+}
+
 status stree::exists(string_view key)
 {
 	LOG("exists for key=" << std::string(key.data(), key.size()));
@@ -234,15 +487,62 @@ status stree::get(string_view key, get_v_callback *callback, void *arg)
 	return status::OK;
 }
 
+status stree::value_size(string_view key, std::size_t &size)
+{
+	LOG("value_size for key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	internal::stree::btree_type::iterator it = my_btree->find(key);
+	if (it == my_btree->end()) {
+		LOG("  key not found");
+		return status::NOT_FOUND;
+	}
+
+	size = it->second.size();
+	return status::OK;
+}
+
+status stree::get_many(const std::vector<string_view> &keys, get_many_callback *callback,
+		       void *arg)
+{
+	LOG("get_many for " << keys.size() << " keys");
+	check_outside_tx();
+
+	std::vector<container_iterator> its;
+	its.reserve(keys.size());
+	my_btree->find_many(keys.begin(), keys.end(), std::back_inserter(its));
+
+	for (auto &it : its) {
+		if (it != my_btree->end())
+			__builtin_prefetch(it->second.c_str());
+	}
+
+	for (std::size_t i = 0; i < its.size(); ++i) {
+		if (its[i] == my_btree->end()) {
+			callback(i, PMEMKV_STATUS_NOT_FOUND, nullptr, 0, arg);
+			continue;
+		}
+
+		callback(i, PMEMKV_STATUS_OK, its[i]->second.c_str(),
+			 its[i]->second.size(), arg);
+	}
+
+	return status::OK;
+}
+
 status stree::put(string_view key, string_view value)
 {
 	LOG("put key=" << std::string(key.data(), key.size())
 		       << ", value.size=" << std::to_string(value.size()));
 	check_outside_tx();
 
-	auto result = my_btree->try_emplace(key, value);
+	invalidate_scan_positions();
+
+	auto result = insert(key, value);
 	if (!result.second) { // key already exists, so update
 		typename internal::stree::btree_type::value_type &entry = *result.first;
+		preserve(result.first);
+		internal::phase_timer flush_timer(internal::op_phase::flush);
 		transaction::manual tx(pmpool);
 		entry.second = value;
 		transaction::commit();
@@ -255,22 +555,200 @@ status stree::remove(string_view key)
 	LOG("remove key=" << std::string(key.data(), key.size()));
 	check_outside_tx();
 
+	invalidate_scan_positions();
+
+	if (versions.active()) {
+		auto it = my_btree->find(key);
+		if (it != my_btree->end())
+			preserve(it);
+	}
+
 	auto result = my_btree->erase(key);
 	return (result == 1) ? status::OK : status::NOT_FOUND;
 }
 
+status stree::remove_range(string_view key1, string_view key2)
+{
+	LOG("remove_range key range=[" << std::string(key1.data(), key1.size()) << ","
+				       << std::string(key2.data(), key2.size()) << ")");
+	check_outside_tx();
+
+	if (!my_btree->key_comp()(key1, key2))
+		return status::OK;
+
+	return erase_range(key1, &key2);
+}
+
+status stree::remove_prefix(string_view prefix)
+{
+	LOG("remove_prefix prefix=" << std::string(prefix.data(), prefix.size()));
+	check_outside_tx();
+
+	if (!internal::has_binary_order(*config))
+		return engine_base::remove_prefix(prefix);
+
+	std::string bound;
+	if (!internal::prefix_upper_bound(prefix, bound))
+		return erase_range(prefix, nullptr);
+
+	string_view upper(bound);
+	return erase_range(prefix, &upper);
+}
+
+/*
+ * Records are removed in chunks, each in a single transaction (instead of
+ * a transaction per record). Keys of a chunk are collected with a single pass
+ * over the leaves, as iterators are not valid after erase().
+ */
+status stree::erase_range(string_view key1, const string_view *key2)
+{
+	invalidate_scan_positions();
+
+	std::vector<std::string> keys;
+	do {
+		keys.clear();
+
+		auto last = key2 ? my_btree->lower_bound(*key2) : my_btree->end();
+		for (auto it = my_btree->lower_bound(key1);
+		     it != last && keys.size() < internal::stree::REMOVE_CHUNK_SIZE; ++it)
+			keys.emplace_back(it->first.c_str(), it->first.size());
+
+		if (keys.empty())
+			break;
+
+		transaction::run(pmpool, [&] {
+			for (auto &key : keys) {
+				string_view k(key);
+				if (versions.active())
+					preserve(my_btree->find(k));
+
+				my_btree->erase(k);
+			}
+		});
+	} while (keys.size() == internal::stree::REMOVE_CHUNK_SIZE);
+
+	return status::OK;
+}
+
+/*
+ * An empty tree is built directly from the sorted records: each record is
+ * appended to the rightmost leaf (a new leaf is allocated once it is full),
+ * without a descent from the root and a transaction per record. If the load
+ * fails (e.g. keys are not sorted), already committed chunks are removed, so
+ * the tree is left empty.
+ */
+status stree::bulk_load(internal::bulk_load_source &source)
+{
+	LOG("bulk_load");
+	check_outside_tx();
+
+	if (my_btree->size() != 0 || versions.active())
+		return engine_base::bulk_load(source);
+
+	invalidate_scan_positions();
+
+	try {
+		string_view key, value;
+		bool more = source.next(key, value);
+		while (more) {
+			transaction::run(pmpool, [&] {
+				for (size_t n = 0;
+				     more && n < internal::stree::BULK_LOAD_CHUNK_SIZE;
+				     n++) {
+					if (!my_btree->push_back(key, value))
+						throw internal::invalid_argument(
+							"Keys are not sorted in ascending order");
+
+					more = source.next(key, value);
+				}
+			});
+		}
+	} catch (...) {
+		if (my_btree->size() != 0) {
+			auto first = my_btree->begin();
+			std::string first_key(first->first.c_str(), first->first.size());
+			erase_range(first_key, nullptr);
+		}
+
+		throw;
+	}
+
+	return status::OK;
+}
+
+void stree::preserve(const container_iterator &it)
+{
+	string_view value(it->second.c_str(), it->second.size());
+
+	versions.preserve(string_view(it->first.c_str(), it->first.size()), &value);
+}
+
+/* try_emplace() which first preserves absence of the key for open snapshots */
+std::pair<stree::container_iterator, bool> stree::insert(string_view key,
+							 string_view value)
+{
+	if (versions.active() && my_btree->find(key) == my_btree->end())
+		versions.preserve(key, nullptr);
+
+	return my_btree->try_emplace(key, value);
+}
+
+/*
+ * stree is not thread-safe, so the whole batch is applied in a single pmem
+ * transaction - all modifications are flushed and drained once, on commit,
+ * instead of once per put/remove.
+ */
+status stree::apply_batch(const internal::write_batch &batch)
+{
+	LOG("apply_batch of " << batch.size() << " operations");
+	check_outside_tx();
+
+	invalidate_scan_positions();
+
+	status s = status::OK;
+	transaction::run(pmpool, [&] {
+		s = batch.foreach ([&](const internal::write_batch::entry &e) -> status {
+			if (e.op == internal::write_batch::operation::remove) {
+				auto it = my_btree->find(e.key);
+				if (it != my_btree->end()) {
+					preserve(it);
+					my_btree->erase(e.key);
+				}
+				return status::OK;
+			}
+
+			auto result = insert(e.key, e.value);
+			if (!result.second) {
+				preserve(result.first);
+				result.first->second = e.value;
+			}
+
+			return status::OK;
+		});
+	});
+
+	return s;
+}
+
 void stree::Recover()
 {
 	if (!OID_IS_NULL(*root_oid)) {
 		my_btree = (internal::stree::btree_type *)pmemobj_direct(*root_oid);
+		if (!my_btree->compatible_layout())
+			throw internal::invalid_argument(
+				"Pool was created by an incompatible version of stree");
 		my_btree->key_comp().runtime_initialize(
 			internal::extract_comparator(*config));
 	} else {
+		/* the layout of the tree is chosen only when it is created */
+		uint64_t subtree_counts = 0;
+		config->get_uint64("subtree_counts", &subtree_counts);
+
 		pmem::obj::transaction::run(pmpool, [&] {
 			pmem::obj::transaction::snapshot(root_oid);
-			*root_oid =
-				pmem::obj::make_persistent<internal::stree::btree_type>()
-					.raw();
+			*root_oid = pmem::obj::make_persistent<internal::stree::btree_type>(
+					    subtree_counts != 0)
+					    .raw();
 			my_btree =
 				(internal::stree::btree_type *)pmemobj_direct(*root_oid);
 			my_btree->key_comp().initialize(
@@ -281,27 +759,71 @@ void stree::Recover()
 
 internal::iterator_base *stree::new_iterator()
 {
-	return new stree_iterator<false>{my_btree};
+	return new stree_iterator<false>{my_btree, internal::has_binary_order(*config),
+					 versions};
 }
 
 internal::iterator_base *stree::new_const_iterator()
 {
-	return new stree_iterator<true>{my_btree};
+	return new stree_iterator<true>{my_btree, internal::has_binary_order(*config)};
 }
 
-stree::stree_iterator<true>::stree_iterator(container_type *c)
-    : container(c), it_(nullptr), pop(pmem::obj::pool_by_vptr(c))
+internal::snapshot *stree::new_snapshot()
 {
+	check_outside_tx();
+
+	return new stree_snapshot(my_btree, versions);
+}
+
+stree::stree_snapshot::stree_snapshot(container_type *c,
+				      internal::version_store &versions)
+    : internal::sorted_snapshot(versions), container(c)
+{
+}
+
+bool stree::stree_snapshot::read(string_view key, std::string &value)
+{
+	auto it = container->find(key);
+	if (it == container->end())
+		return resolve(key, false, value);
+
+	value.assign(it->second.c_str(), it->second.size());
+
+	return resolve(key, true, value);
 }
 
-stree::stree_iterator<false>::stree_iterator(container_type *c)
-    : stree::stree_iterator<true>(c)
+bool stree::stree_snapshot::read_chunk(const std::string *after, std::size_t max,
+				       std::vector<internal::version_store::record> &records)
+{
+	auto it = after ? container->upper_bound(string_view(after->data(), after->size()))
+			: container->begin();
+	for (; it != container->end(); ++it) {
+		if (records.size() == max)
+			return true;
+
+		records.push_back({std::string(it->first.c_str(), it->first.size()),
+				   std::string(it->second.c_str(), it->second.size())});
+	}
+
+	return false;
+}
+
+stree::stree_iterator<true>::stree_iterator(container_type *c, bool binary_order)
+    : container(c), it_(nullptr), pop(pmem::obj::pool_by_vptr(c)),
+      binary_order(binary_order)
+{
+}
+
+stree::stree_iterator<false>::stree_iterator(container_type *c, bool binary_order,
+					     internal::version_store &versions)
+    : stree::stree_iterator<true>(c, binary_order), versions(versions)
 {
 }
 
 status stree::stree_iterator<true>::seek(string_view key)
 {
 	init_seek();
+	prefix_bound.clear();
 
 	it_ = container->find(key);
 	if (it_ != container->end())
@@ -313,6 +835,7 @@ status stree::stree_iterator<true>::seek(string_view key)
 status stree::stree_iterator<true>::seek_lower(string_view key)
 {
 	init_seek();
+	prefix_bound.clear();
 
 	it_ = container->lower_bound(key);
 	if (it_ == container->begin()) {
@@ -328,6 +851,7 @@ status stree::stree_iterator<true>::seek_lower(string_view key)
 status stree::stree_iterator<true>::seek_lower_eq(string_view key)
 {
 	init_seek();
+	prefix_bound.clear();
 
 	it_ = container->upper_bound(key);
 	if (it_ == container->begin()) {
@@ -343,6 +867,7 @@ status stree::stree_iterator<true>::seek_lower_eq(string_view key)
 status stree::stree_iterator<true>::seek_higher(string_view key)
 {
 	init_seek();
+	prefix_bound.clear();
 
 	it_ = container->upper_bound(key);
 	if (it_ == container->end())
@@ -354,6 +879,7 @@ status stree::stree_iterator<true>::seek_higher(string_view key)
 status stree::stree_iterator<true>::seek_higher_eq(string_view key)
 {
 	init_seek();
+	prefix_bound.clear();
 
 	it_ = container->lower_bound(key);
 	if (it_ == container->end())
@@ -362,9 +888,28 @@ status stree::stree_iterator<true>::seek_higher_eq(string_view key)
 	return status::OK;
 }
 
+status stree::stree_iterator<true>::seek_prefix(string_view prefix)
+{
+	init_seek();
+
+	if (!binary_order)
+		return status::NOT_SUPPORTED;
+
+	prefix_bound.assign(prefix.data(), prefix.size());
+
+	it_ = container->lower_bound(prefix);
+	if (it_ == container->end() || !within_prefix_bound(it_)) {
+		it_ = container->end();
+		return status::NOT_FOUND;
+	}
+
+	return status::OK;
+}
+
 status stree::stree_iterator<true>::seek_to_first()
 {
 	init_seek();
+	prefix_bound.clear();
 
 	if (container->size() == 0)
 		return status::NOT_FOUND;
@@ -377,6 +922,7 @@ status stree::stree_iterator<true>::seek_to_first()
 status stree::stree_iterator<true>::seek_to_last()
 {
 	init_seek();
+	prefix_bound.clear();
 
 	if (container->size() == 0)
 		return status::NOT_FOUND;
@@ -390,7 +936,8 @@ status stree::stree_iterator<true>::seek_to_last()
 status stree::stree_iterator<true>::is_next()
 {
 	auto tmp = it_;
-	if (tmp == container->end() || ++tmp == container->end())
+	if (tmp == container->end() || ++tmp == container->end() ||
+	    !within_prefix_bound(tmp))
 		return status::NOT_FOUND;
 
 	return status::OK;
@@ -403,6 +950,11 @@ status stree::stree_iterator<true>::next()
 	if (it_ == container->end() || ++it_ == container->end())
 		return status::NOT_FOUND;
 
+	if (!within_prefix_bound(it_)) {
+		it_ = container->end();
+		return status::NOT_FOUND;
+	}
+
 	return status::OK;
 }
 
@@ -413,11 +965,22 @@ status stree::stree_iterator<true>::prev()
 	if (it_ == container->begin())
 		return status::NOT_FOUND;
 
-	--it_;
+	auto tmp = it_;
+	if (!within_prefix_bound(--tmp))
+		return status::NOT_FOUND;
+
+	it_ = tmp;
 
 	return status::OK;
 }
 
+bool stree::stree_iterator<true>::within_prefix_bound(
+	const container_type::iterator &it) const
+{
+	return internal::has_prefix(string_view(it->first.c_str(), it->first.size()),
+				    prefix_bound);
+}
+
 result<string_view> stree::stree_iterator<true>::key()
 {
 	assert(it_ != container->end());
@@ -436,6 +999,30 @@ result<pmem::obj::slice<const char *>> stree::stree_iterator<true>::read_range(s
 	return {it_->second.crange(pos, n)};
 }
 
+/* records are read directly from leaves, without virtual calls per record */
+status stree::stree_iterator<true>::read_batch(pmemkv_iterator_entry *entries, size_t n,
+					       size_t &count)
+{
+	init_seek();
+
+	count = 0;
+	/* iterator is not positioned (or already past the last record) */
+	if (it_ == container_type::iterator(nullptr) || it_ == container->end())
+		return status::NOT_FOUND;
+
+	while (count < n) {
+		entries[count++] = {it_->first.cdata(), it_->first.length(),
+				    it_->second.cdata(), it_->second.size()};
+
+		if (++it_ == container->end() || !within_prefix_bound(it_)) {
+			it_ = container->end();
+			return status::NOT_FOUND;
+		}
+	}
+
+	return status::OK;
+}
+
 result<pmem::obj::slice<char *>> stree::stree_iterator<false>::write_range(size_t pos,
 									   size_t n)
 {
@@ -452,6 +1039,12 @@ result<pmem::obj::slice<char *>> stree::stree_iterator<false>::write_range(size_
 
 status stree::stree_iterator<false>::commit()
 {
+	if (!log.empty()) {
+		string_view value(it_->second.c_str(), it_->second.size());
+		versions.preserve(string_view(it_->first.c_str(), it_->first.size()),
+				  &value);
+	}
+
 	pmem::obj::transaction::run(pop, [&] {
 		for (auto &p : log) {
 			auto dest = it_->second.range(p.second, p.first.size());
@@ -11,6 +11,7 @@
 #include "../comparator/pmemobj_comparator.h"
 #include "../iterator.h"
 #include "../pmemobj_engine.h"
+#include "../snapshot.h"
 #include "stree/persistent_b_tree.h"
 
 using pmem::obj::persistent_ptr;
@@ -31,6 +32,16 @@ namespace stree
  */
 const size_t DEGREE = 32;
 
+/**
+ * Maximum number of records removed by remove_range() in a single transaction.
+ */
+const size_t REMOVE_CHUNK_SIZE = 1024;
+
+/**
+ * Maximum number of records inserted by bulk_load() in a single transaction.
+ */
+const size_t BULK_LOAD_CHUNK_SIZE = 1024;
+
 using string_t = pmem::obj::string;
 
 using key_type = string_t;
@@ -47,6 +58,7 @@ private:
 
 	template <bool IsConst>
 	class stree_iterator;
+	class stree_snapshot;
 
 public:
 	stree(std::unique_ptr<internal::config> cfg);
@@ -70,21 +82,72 @@ public:
 	status get_below(string_view key, get_kv_callback *callback, void *arg) final;
 	status get_between(string_view key1, string_view key2, get_kv_callback *callback,
 			   void *arg) final;
+	status get_all_desc(get_kv_callback *callback, void *arg) final;
+	status get_above_desc(string_view key, get_kv_callback *callback,
+			      void *arg) final;
+	status get_equal_above_desc(string_view key, get_kv_callback *callback,
+				    void *arg) final;
+	status get_equal_below_desc(string_view key, get_kv_callback *callback,
+				    void *arg) final;
+	status get_below_desc(string_view key, get_kv_callback *callback,
+			      void *arg) final;
+	status get_between_desc(string_view key1, string_view key2,
+				get_kv_callback *callback, void *arg) final;
+	status count_prefix(string_view prefix, std::size_t &cnt) final;
+	status get_prefix(string_view prefix, get_kv_callback *callback, void *arg) final;
+
+	status get_keys(get_k_callback *callback, void *arg) final;
+	status get_keys_above(string_view key, get_k_callback *callback, void *arg) final;
+	status get_keys_below(string_view key, get_k_callback *callback, void *arg) final;
+	status get_keys_between(string_view key1, string_view key2,
+				get_k_callback *callback, void *arg) final;
+
+	status get_by_rank(std::size_t n, get_kv_callback *callback, void *arg) final;
+	status rank_of(string_view key, std::size_t &rank) final;
+
+	status get_split_points(std::size_t partitions,
+				std::vector<std::string> &keys) final;
+	status get_above_page(string_view key, internal::scan_cursor &cursor,
+			      get_kv_callback *callback, void *arg) final;
+	status get_between_page(string_view key1, string_view key2,
+				internal::scan_cursor &cursor, get_kv_callback *callback,
+				void *arg) final;
 	status exists(string_view key) final;
 	status get(string_view key, get_v_callback *callback, void *arg) final;
+	status value_size(string_view key, std::size_t &size) final;
+	status get_many(const std::vector<string_view> &keys, get_many_callback *callback,
+			void *arg) final;
 	status put(string_view key, string_view value) final;
 	status remove(string_view key) final;
+	status remove_range(string_view key1, string_view key2) final;
+	status remove_prefix(string_view prefix) final;
+	status apply_batch(const internal::write_batch &batch) final;
+	status bulk_load(internal::bulk_load_source &source) final;
 
 	internal::iterator_base *new_iterator() final;
 	internal::iterator_base *new_const_iterator() final;
 
+	internal::snapshot *new_snapshot() final;
+
 private:
 	stree(const stree &);
 	void operator=(const stree &);
 	void Recover();
+	static std::pair<string_view, string_view>
+	key_value(const container_iterator &it);
+
+	/* see internal::version_store::preserve() */
+	void preserve(const container_iterator &it);
+	std::pair<container_iterator, bool> insert(string_view key, string_view value);
+
+	/* removes keys from key1 (inclusive) to key2 (exclusive, nullptr - no bound) */
+	status erase_range(string_view key1, const string_view *key2);
 
 	internal::stree::btree_type *my_btree;
 	std::unique_ptr<internal::config> config;
+
+	/* previous versions of records, kept for open snapshots */
+	internal::version_store versions;
 };
 
 template <>
@@ -92,13 +155,14 @@ class stree::stree_iterator<true> : public internal::iterator_base {
 	using container_type = stree::container_type;
 
 public:
-	stree_iterator(container_type *container);
+	stree_iterator(container_type *container, bool binary_order);
 
 	status seek(string_view key) final;
 	status seek_lower(string_view key) final;
 	status seek_lower_eq(string_view key) final;
 	status seek_higher(string_view key) final;
 	status seek_higher_eq(string_view key) final;
+	status seek_prefix(string_view prefix) final;
 
 	status seek_to_first() final;
 	status seek_to_last() final;
@@ -110,11 +174,18 @@ public:
 	result<string_view> key() final;
 
 	result<pmem::obj::slice<const char *>> read_range(size_t pos, size_t n) final;
+	status read_batch(pmemkv_iterator_entry *entries, size_t n, size_t &count) final;
 
 protected:
+	bool within_prefix_bound(const container_type::iterator &it) const;
+
 	container_type *container;
 	container_type::iterator it_;
 	pmem::obj::pool_base pop;
+
+	/* set by seek_prefix(), is_next(), next() and prev() do not cross it */
+	std::string prefix_bound;
+	bool binary_order;
 };
 
 template <>
@@ -122,7 +193,8 @@ class stree::stree_iterator<false> : public stree::stree_iterator<true> {
 	using container_type = stree::container_type;
 
 public:
-	stree_iterator(container_type *container);
+	stree_iterator(container_type *container, bool binary_order,
+		       internal::version_store &versions);
 
 	result<pmem::obj::slice<char *>> write_range(size_t pos, size_t n) final;
 
@@ -131,6 +203,22 @@ public:
 
 private:
 	std::vector<std::pair<std::string, size_t>> log;
+	internal::version_store &versions;
+};
+
+class stree::stree_snapshot : public internal::sorted_snapshot {
+	using container_type = stree::container_type;
+
+public:
+	stree_snapshot(container_type *container, internal::version_store &versions);
+
+protected:
+	bool read(string_view key, std::string &value) final;
+	bool read_chunk(const std::string *after, std::size_t max,
+			std::vector<internal::version_store::record> &records) final;
+
+private:
+	container_type *container;
 };
 
 class stree_factory : public engine_base::factory_base {
@@ -11,6 +11,11 @@
 #include <libpmemobj++/pool.hpp>
 #include <libpmemobj++/transaction.hpp>
 
+#include "../../op_phases.h"
+#include "../../probes.h"
+
+#include <algorithm>
+#include <iterator>
 #include <numeric>
 #include <type_traits>
 #include <vector>
@@ -26,6 +31,16 @@ namespace internal
 
 using namespace pmem::obj;
 
+/**
+ * Issues a prefetch for every cache line of a node of the given size.
+ */
+inline void prefetch_node(const void *node, std::size_t size)
+{
+	const char *ptr = static_cast<const char *>(node);
+	for (std::size_t offset = 0; offset < size; offset += 64)
+		__builtin_prefetch(ptr + offset);
+}
+
 /**
  * Base node type for inner and leaf node types
  */
@@ -208,17 +223,23 @@ public:
 
 	inner_node_t(size_type level);
 	inner_node_t(size_type level, const_reference key, const node_pptr &first_child,
-		     const node_pptr &second_child);
+		     size_type first_count, const node_pptr &second_child,
+		     size_type second_count);
 	~inner_node_t();
 
-	iterator move(pool_base &pop, inner_node_t &other, key_pptr &partition_key);
+	iterator move(pool_base &pop, inner_node_t &other, key_pptr &partition_key,
+		      bool counted);
 	template <typename K>
 	void replace(iterator it, const K &key);
-	void delete_with_child(iterator it, bool left);
+	void delete_with_child(iterator it, bool left, bool counted);
 	void inherit_child(iterator it, node_pptr &child, bool left);
 	void update_splitted_child(pool_base &pop, const_reference key,
-				   node_pptr &left_child, node_pptr &right_child,
-				   const key_compare &);
+				   node_pptr &left_child, size_type left_count,
+				   node_pptr &right_child, size_type right_count,
+				   bool counted, const key_compare &);
+	void push_back(const_reference key, const node_pptr &child, size_type cnt,
+		       bool counted);
+	void pop_back();
 
 	template <typename K>
 	std::tuple<node_t *, node_t *, node_t *, iterator>
@@ -228,6 +249,12 @@ public:
 	const node_pptr &get_child(const_reference key, const key_compare &) const;
 	const node_pptr &get_left_child(const_iterator it) const;
 	const node_pptr &get_right_child(const_iterator it) const;
+	template <typename K>
+	size_type get_child_pos(const K &key, const key_compare &) const;
+
+	size_type count(size_type pos) const;
+	size_type total_count() const;
+	void set_count(size_type pos, size_type cnt);
 
 	bool full() const;
 
@@ -247,6 +274,13 @@ private:
 	key_pptr entries[capacity];
 	node_pptr children[capacity + 1];
 	pmem::obj::p<size_type> _size = 0;
+	/*
+	 * Number of entries in subtrees of children, maintained only in trees
+	 * with counts (see b_tree_base::counted()). It is the last member, so
+	 * nodes allocated without it (by versions of stree before the counts
+	 * were added) are still valid inner nodes of a tree without counts.
+	 */
+	pmem::obj::p<size_type> counts[capacity + 1];
 
 	pool_base get_pool() const noexcept;
 	bool is_sorted(const key_compare &);
@@ -327,7 +361,7 @@ public:
 	using reverse_iterator = std::reverse_iterator<iterator>;
 	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
-	b_tree_base();
+	b_tree_base(bool counted);
 	~b_tree_base();
 
 	template <typename K, typename M>
@@ -337,6 +371,10 @@ public:
 	iterator find(const K &key);
 	template <typename K>
 	const_iterator find(const K &key) const;
+	template <typename InputIt, typename OutputIt>
+	void find_many(InputIt first, InputIt last, OutputIt d_first);
+	template <typename OutputIt>
+	void split_keys(size_type n, OutputIt d_first) const;
 	template <typename K>
 	iterator lower_bound(const K &key);
 	template <typename K>
@@ -349,6 +387,14 @@ public:
 	template <typename K>
 	size_type erase(const K &key);
 
+	template <typename K, typename M>
+	bool push_back(K &&key, M &&obj);
+
+	template <typename K>
+	size_type rank(const K &key, bool inclusive) const;
+	iterator nth(size_type pos);
+	const_iterator nth(size_type pos) const;
+
 	iterator begin();
 	iterator end();
 	const_iterator begin() const;
@@ -366,19 +412,38 @@ public:
 	key_compare &key_comp();
 	const key_compare &key_comp() const;
 
+	bool compatible_layout() const;
+	bool counted() const;
+
 private:
+	/* inner nodes do not keep counts of entries in subtrees of children */
+	static constexpr uint64_t PLAIN_LAYOUT = 0;
+	/* inner nodes keep counts of entries, see update_counts() */
+	static constexpr uint64_t COUNTED_LAYOUT = 0x7374726565763201ULL;
+
 	node_pptr root;
-	node_pptr split_node;
+	/*
+	 * Layout of the tree, chosen when it is created. Together with the
+	 * reserved field it takes the place of a pointer which was never set by
+	 * versions of stree without counts, so trees created by them have the
+	 * PLAIN_LAYOUT.
+	 */
+	pmem::obj::p<uint64_t> layout_version;
+	pmem::obj::p<uint64_t> reserved;
 	node_pptr left_child;
 	node_pptr right_child;
 	key_compare compare;
 	pmem::obj::p<size_type> _size;
 
 	const key_type &get_last_key(const node_pptr &node);
+	size_type count(const node_pptr &node) const;
+	template <typename K>
+	void update_counts(const K &key, const node_t *last, bool inserted);
 	leaf_type *leftmost_leaf() const;
 	leaf_type *rightmost_leaf() const;
 
 	void create_new_root(const key_type &, node_pptr &, node_pptr &);
+	void append_child(path_type &path, const key_type &key, node_pptr child);
 	typename inner_type::const_iterator split_half(pool_base &pop, inner_pptr &node,
 						       inner_pptr &other,
 						       key_pptr &partition_key);
@@ -956,13 +1021,17 @@ inner_node_t<Key, Compare, capacity>::inner_node_t(size_type level)
 template <typename Key, typename Compare, uint64_t capacity>
 inner_node_t<Key, Compare, capacity>::inner_node_t(size_type level, const_reference key,
 						   const node_pptr &first_child,
-						   const node_pptr &second_child)
+						   size_type first_count,
+						   const node_pptr &second_child,
+						   size_type second_count)
     : node_t(level)
 {
 	assert(pmemobj_tx_stage() == TX_STAGE_WORK);
 	entries[0] = pmem::obj::persistent_ptr<key_type>(&key);
 	children[0] = first_child;
 	children[1] = second_child;
+	counts[0] = first_count;
+	counts[1] = second_count;
 	_size = 1;
 }
 
@@ -978,7 +1047,7 @@ inner_node_t<Key, Compare, capacity>::~inner_node_t()
 template <typename Key, typename Compare, uint64_t capacity>
 typename inner_node_t<Key, Compare, capacity>::iterator
 inner_node_t<Key, Compare, capacity>::move(pool_base &pop, inner_node_t &other,
-					   key_pptr &partition_key)
+					   key_pptr &partition_key, bool counted)
 {
 	assert(size() == 0);
 	assert(other.size() > size_type(1));
@@ -987,12 +1056,16 @@ inner_node_t<Key, Compare, capacity>::move(pool_base &pop, inner_node_t &other,
 	size_type new_size = static_cast<size_type>(std::distance(middle + 1, last));
 	node_pptr *middle_child = other.children + (other.size() / 2) + 1;
 	node_pptr *last_child = other.children + other.size() + 1;
+	p<size_type> *middle_count = other.counts + (other.size() / 2) + 1;
+	p<size_type> *last_count = other.counts + other.size() + 1;
 	/* move second half from 'other' to 'this' */
 	pmem::obj::transaction::run(pop, [&] {
 		/* save partition key */
 		partition_key = *middle;
 		std::move(middle + 1, last, entries);
 		std::move(middle_child, last_child, children);
+		if (counted)
+			std::move(middle_count, last_count, counts);
 		_size = new_size;
 		other._size -= (new_size + 1);
 	});
@@ -1017,14 +1090,16 @@ void inner_node_t<Key, Compare, capacity>::replace(iterator it, const K &key)
  * @param[in] pop - persistent pool
  * @param[in] key - key of the first entry in right_child
  * @param[in] left_child - new child node that must be linked
+ * @param[in] left_count - number of entries in left_child's subtree
  * @param[in] right_child - new child node that must be linked
+ * @param[in] right_count - number of entries in right_child's subtree
+ * @param[in] counted - whether counts of entries are kept in the tree
  */
 template <typename Key, typename Compare, uint64_t capacity>
-void inner_node_t<Key, Compare, capacity>::update_splitted_child(pool_base &pop,
-								 const_reference key,
-								 node_pptr &left_child,
-								 node_pptr &right_child,
-								 const key_compare &comp)
+void inner_node_t<Key, Compare, capacity>::update_splitted_child(
+	pool_base &pop, const_reference key, node_pptr &left_child, size_type left_count,
+	node_pptr &right_child, size_type right_count, bool counted,
+	const key_compare &comp)
 {
 	assert(pmemobj_tx_stage() == TX_STAGE_WORK);
 	assert(!full());
@@ -1044,16 +1119,59 @@ void inner_node_t<Key, Compare, capacity>::update_splitted_child(pool_base &pop,
 		children + insert_idx + 1, children + size(), children + size() + 1);
 	*(--to_insert_child) = right_child;
 	*(--to_insert_child) = left_child;
+	/* counts follow their children */
+	if (counted) {
+		p<size_type> *to_insert_count = std::copy_backward(
+			counts + insert_idx + 1, counts + size(), counts + size() + 1);
+		*(--to_insert_count) = right_count;
+		*(--to_insert_count) = left_count;
+	}
 
 	assert(is_sorted(comp));
 }
 
+/**
+ * Appends key and child (the right one of the key) at the end of the node.
+ * Number of entries in the child's subtree (cnt) is stored if counted is true.
+ *
+ * @pre key must be greater than all keys in the node.
+ * @pre must be called in a transaction scope.
+ */
+template <typename Key, typename Compare, uint64_t capacity>
+void inner_node_t<Key, Compare, capacity>::push_back(const_reference key,
+						     const node_pptr &child,
+						     size_type cnt, bool counted)
+{
+	assert(pmemobj_tx_stage() == TX_STAGE_WORK);
+	assert(!full());
+	entries[size()] = pmem::obj::persistent_ptr<key_type>(&key);
+	children[size() + 1] = child;
+	if (counted)
+		counts[size() + 1] = cnt;
+	++_size;
+}
+
+/**
+ * Removes the last key and the last child from the node.
+ *
+ * @pre must be called in a transaction scope.
+ */
+template <typename Key, typename Compare, uint64_t capacity>
+void inner_node_t<Key, Compare, capacity>::pop_back()
+{
+	assert(pmemobj_tx_stage() == TX_STAGE_WORK);
+	assert(size() > 0);
+	children[size()] = nullptr;
+	--_size;
+}
+
 /**
  * Deletes key specified by iterator.
  * Must be followed by node balancing.
  */
 template <typename Key, typename Compare, uint64_t capacity>
-void inner_node_t<Key, Compare, capacity>::delete_with_child(iterator it, bool left)
+void inner_node_t<Key, Compare, capacity>::delete_with_child(iterator it, bool left,
+							     bool counted)
 {
 	assert(pmemobj_tx_stage() == TX_STAGE_WORK);
 	assert(size() > 0);
@@ -1062,8 +1180,13 @@ void inner_node_t<Key, Compare, capacity>::delete_with_child(iterator it, bool l
 	std::move(entries + pos + 1, entries + size(), entries + pos);
 	if (left) {
 		std::move(children + pos + 1, children + size() + 1, children + pos);
+		if (counted)
+			std::move(counts + pos + 1, counts + size() + 1, counts + pos);
 	} else {
 		std::move(children + pos + 2, children + size() + 1, children + pos + 1);
+		if (counted)
+			std::move(counts + pos + 2, counts + size() + 1,
+				  counts + pos + 1);
 	}
 	--_size;
 }
@@ -1072,6 +1195,8 @@ void inner_node_t<Key, Compare, capacity>::delete_with_child(iterator it, bool l
  * Inherits child specified by iterator and 'left' bool.
  * Key is updated by smallest in right subtree.
  * Assuming that previous child is no longer used and must be deleted.
+ * The count is not changed - the child was the only non-empty descendant of
+ * the previous one.
  *
  * @pre child.size() == 0
  */
@@ -1160,6 +1285,53 @@ inner_node_t<Key, Compare, capacity>::get_right_child(const_iterator it) const
 	return children[child_pos];
 }
 
+/**
+ * Returns position of the child, which subtree the given key belongs to.
+ */
+template <typename Key, typename Compare, uint64_t capacity>
+template <typename K>
+typename inner_node_t<Key, Compare, capacity>::size_type
+inner_node_t<Key, Compare, capacity>::get_child_pos(const K &key,
+						    const key_compare &comp) const
+{
+	const_iterator it = std::upper_bound(
+		cbegin(), cend(), key,
+		[&comp](const K &lhs, const_reference rhs) { return comp(lhs, rhs); });
+	return static_cast<size_type>(std::distance(cbegin(), it));
+}
+
+/**
+ * Returns number of entries in the subtree of the child at given position.
+ */
+template <typename Key, typename Compare, uint64_t capacity>
+typename inner_node_t<Key, Compare, capacity>::size_type
+inner_node_t<Key, Compare, capacity>::count(size_type pos) const
+{
+	assert(pos <= size());
+	return counts[pos];
+}
+
+/**
+ * Returns number of entries in the subtree of this node.
+ */
+template <typename Key, typename Compare, uint64_t capacity>
+typename inner_node_t<Key, Compare, capacity>::size_type
+inner_node_t<Key, Compare, capacity>::total_count() const
+{
+	return std::accumulate(counts, counts + size() + 1, size_type(0));
+}
+
+/**
+ * @pre must be called in a transaction scope.
+ */
+template <typename Key, typename Compare, uint64_t capacity>
+void inner_node_t<Key, Compare, capacity>::set_count(size_type pos, size_type cnt)
+{
+	assert(pmemobj_tx_stage() == TX_STAGE_WORK);
+	assert(pos <= size());
+	counts[pos] = cnt;
+}
+
 template <typename Key, typename Compare, uint64_t capacity>
 bool inner_node_t<Key, Compare, capacity>::full() const
 {
@@ -1352,6 +1524,7 @@ b_tree_iterator<LeafType, is_const> &b_tree_iterator<LeafType, is_const>::operat
 		if (tmp) {
 			current_node = tmp;
 			leaf_it = current_node->end();
+			--leaf_it;
 		}
 	} else {
 		--leaf_it;
@@ -1398,9 +1571,21 @@ typename b_tree_iterator<LeafType, is_const>::pointer
 // -------------------------------------------------------------------------------------
 
 template <typename Key, typename T, typename Compare, std::size_t degree>
-b_tree_base<Key, T, Compare, degree>::b_tree_base()
+constexpr uint64_t b_tree_base<Key, T, Compare, degree>::PLAIN_LAYOUT;
+
+template <typename Key, typename T, typename Compare, std::size_t degree>
+constexpr uint64_t b_tree_base<Key, T, Compare, degree>::COUNTED_LAYOUT;
+
+/**
+ * Creates an empty tree. If counted is true, inner nodes keep counts of entries
+ * in subtrees of their children: rank() and nth() take a single descent, at the
+ * cost of updating a count on each level of the tree in every insert and erase.
+ */
+template <typename Key, typename T, typename Compare, std::size_t degree>
+b_tree_base<Key, T, Compare, degree>::b_tree_base(bool counted)
 {
 	assert(pmemobj_tx_stage() == TX_STAGE_WORK);
+	layout_version = counted ? COUNTED_LAYOUT : PLAIN_LAYOUT;
 	cast_leaf(root) = allocate_leaf();
 	_size = 0;
 }
@@ -1422,20 +1607,36 @@ b_tree_base<Key, T, Compare, degree>::try_emplace(K &&key, M &&obj)
 {
 	auto pop = get_pool_base();
 
+	internal::phase_timer lookup_timer(internal::op_phase::lookup);
 	path_type path;
 	leaf_pptr leaf = find_leaf_to_insert(std::forward<K>(key), path);
 
 	// --------------- entry with the same key found ---------------
 	typename leaf_type::iterator leaf_it = leaf->find(std::forward<K>(key), compare);
+	lookup_timer.stop();
 	if (leaf_it != leaf->end()) {
 		return std::pair<iterator, bool>(iterator(leaf.get(), leaf_it), false);
 	}
 
 	// ------------------ leaf not full -> insert ------------------
 	if (!leaf->full()) {
-		return internal_insert(leaf, std::forward<K>(key), std::forward<M>(obj));
+		internal::phase_timer flush_timer(internal::op_phase::flush);
+		if (!counted())
+			return internal_insert(leaf, std::forward<K>(key),
+					       std::forward<M>(obj));
+
+		std::pair<iterator, bool> result(nullptr, false);
+		pmem::obj::transaction::run(pop, [&] {
+			result = internal_insert(leaf, std::forward<K>(key),
+						 std::forward<M>(obj));
+			update_counts(key, leaf.get(), true);
+		});
+		return result;
 	}
 
+	/* splits allocate new nodes */
+	internal::phase_timer alloc_timer(internal::op_phase::allocation);
+
 	// -------------------- if root is leaf ------------------------
 	if (path.empty()) {
 		return split_leaf_node(pop, leaf, std::forward<K>(key),
@@ -1497,6 +1698,91 @@ b_tree_base<Key, T, Compare, degree>::find(const K &key) const
 	return const_iterator(leaf, leaf_it);
 }
 
+/**
+ * Looks up every key from the [first, last) range and writes the resulting
+ * iterators (end() for keys which are not present) to d_first.
+ *
+ * Unlike find() called in a loop, all keys descend the tree together, one level
+ * at a time. Every node is prefetched as soon as its address is known, so the
+ * loads for independent keys overlap instead of being serialized.
+ */
+template <typename Key, typename T, typename Compare, std::size_t degree>
+template <typename InputIt, typename OutputIt>
+void b_tree_base<Key, T, Compare, degree>::find_many(InputIt first, InputIt last,
+						     OutputIt d_first)
+{
+	assert(root != nullptr);
+	std::vector<node_t *> nodes(static_cast<size_type>(std::distance(first, last)),
+				    root.get());
+
+	/* all leaves are on the same level, so every key needs the same number of steps */
+	for (uint64_t level = root->level(); level > 0; --level) {
+		auto key_it = first;
+		for (auto &node : nodes) {
+			node = cast_inner(node)->get_child(*key_it, compare).get();
+			prefetch_node(node, level == 1 ? sizeof(leaf_type)
+						       : sizeof(inner_type));
+			++key_it;
+		}
+	}
+
+	auto key_it = first;
+	for (auto node : nodes) {
+		leaf_type *leaf = cast_leaf(node);
+		typename leaf_type::iterator leaf_it = leaf->find(*key_it, compare);
+		*d_first++ = leaf->end() == leaf_it ? end() : iterator(leaf, leaf_it);
+		++key_it;
+	}
+}
+
+/**
+ * Writes to d_first (in ascending order) pointers to at most n - 1 keys, which
+ * split the tree into n ranges of similar size.
+ *
+ * Keys are separators taken from the highest level of inner nodes which has
+ * enough of them (or from the lowest one, if the tree is too small), so no
+ * leaf is read.
+ */
+template <typename Key, typename T, typename Compare, std::size_t degree>
+template <typename OutputIt>
+void b_tree_base<Key, T, Compare, degree>::split_keys(size_type n,
+						      OutputIt d_first) const
+{
+	assert(root != nullptr);
+	if (n < 2 || root->leaf())
+		return;
+
+	std::vector<const inner_type *> nodes(1, cast_inner(root.get()));
+	std::vector<const key_type *> keys;
+
+	for (;;) {
+		keys.clear();
+		for (auto node : nodes) {
+			for (size_type i = 0; i < node->size(); i++)
+				keys.push_back(&(*node)[i]);
+		}
+
+		if (keys.size() + 1 >= n || nodes.front()->level() == 1)
+			break;
+
+		std::vector<const inner_type *> children;
+		for (auto node : nodes) {
+			for (size_type i = 0; i <= node->size(); i++)
+				children.push_back(cast_inner(
+					node->get_left_child(node->cbegin() + i).get()));
+		}
+		nodes.swap(children);
+	}
+
+	if (keys.size() + 1 <= n) {
+		std::copy(keys.begin(), keys.end(), d_first);
+		return;
+	}
+
+	for (size_type i = 1; i < n; i++)
+		*d_first++ = keys[i * (keys.size() + 1) / n - 1];
+}
+
 /**
  * Returns an iterator pointing to the least element which is larger than or equal
  * to the given key. Keys are sorted in binary order (see
@@ -1516,8 +1802,14 @@ b_tree_base<Key, T, Compare, degree>::lower_bound(const K &key)
 		leaf->begin(), leaf->end(), key, [this](const_reference e, const K &key) {
 			return compare(e.first, key);
 		});
-	if (leaf->end() == leaf_it)
+	/* all keys of the leaf are smaller - the least larger key (if any)
+	 * starts the next leaf */
+	if (leaf->end() == leaf_it) {
+		if (leaf->get_next())
+			return iterator(leaf->get_next().get(),
+					leaf->get_next()->begin());
 		return end();
+	}
 
 	return iterator(leaf, leaf_it);
 }
@@ -1542,8 +1834,12 @@ b_tree_base<Key, T, Compare, degree>::lower_bound(const K &key) const
 				 [this](const_reference e, const K &key) {
 					 return compare(e.first, key);
 				 });
-	if (leaf->cend() == leaf_it)
+	if (leaf->cend() == leaf_it) {
+		if (leaf->get_next())
+			return const_iterator(leaf->get_next().get(),
+					      leaf->get_next()->cbegin());
 		return cend();
+	}
 
 	return const_iterator(leaf, leaf_it);
 }
@@ -1656,7 +1952,7 @@ void b_tree_base<Key, T, Compare, degree>::delete_leaf_ext(leaf_pptr &leaf,
 							   bool no_left_sibling)
 {
 	/* if left sibling exists then leaf is right child */
-	parent.first->delete_with_child(parent.second, no_left_sibling);
+	parent.first->delete_with_child(parent.second, no_left_sibling, counted());
 	/* correct leaf siblings pointers before deleting it */
 	if (leaf->get_prev()) {
 		leaf->get_prev()->set_next(leaf->get_next());
@@ -1710,6 +2006,8 @@ b_tree_base<Key, T, Compare, degree>::erase(const K &key)
 			result = size_type(0);
 			return;
 		}
+		/* before any separator is replaced, as they route the key */
+		update_counts(key, leaf.get(), false);
 		/* still left elements in leaf -> replace pointer in inner node */
 		if (leaf->size() > 0) {
 			if (to_replace.first != nullptr) {
@@ -1757,6 +2055,139 @@ b_tree_base<Key, T, Compare, degree>::erase(const K &key)
 	return result;
 }
 
+/**
+ * Inserts a new entry at the end of the tree, without searching for its
+ * position. It is meant for building the tree from sorted data: leaves are
+ * filled up completely and nodes on the rightmost path of the tree are
+ * extended (or a new node is added next to them) as needed.
+ *
+ * @pre must be called in a transaction scope.
+ *
+ * @return false if the key is not greater than the last key in the tree
+ * (nothing is inserted)
+ */
+template <typename Key, typename T, typename Compare, std::size_t degree>
+template <typename K, typename M>
+bool b_tree_base<Key, T, Compare, degree>::push_back(K &&key, M &&obj)
+{
+	assert(pmemobj_tx_stage() == TX_STAGE_WORK);
+
+	/* rightmost path: [root, leaf) */
+	path_type path;
+	node_pptr node = root;
+	while (!node->leaf()) {
+		path.push_back(cast_inner(node));
+		node = cast_inner(node)->get_left_child(cast_inner(node)->end());
+	}
+
+	leaf_pptr leaf = cast_leaf(node);
+	if (leaf->size() > 0 && !compare(leaf->back().first, std::forward<K>(key)))
+		return false;
+
+	if (!leaf->full()) {
+		leaf->insert(leaf->end(), std::forward<K>(key), std::forward<M>(obj));
+		if (counted())
+			for (auto &node : path)
+				node->set_count(node->size(),
+						node->count(node->size()) + 1);
+		++_size;
+		return true;
+	}
+
+	leaf_pptr new_leaf = allocate_leaf();
+	new_leaf->insert(new_leaf->end(), std::forward<K>(key), std::forward<M>(obj));
+	new_leaf->set_prev(leaf);
+	leaf->set_next(new_leaf);
+	++_size;
+
+	append_child(path, new_leaf->front().first, cast_node(new_leaf));
+	return true;
+}
+
+/**
+ * Returns number of entries with keys less than the given key (or less than or
+ * equal to it, if inclusive is true). Counts of entries kept in inner nodes are
+ * summed up on the way down, so only a single leaf is searched. In a tree
+ * without counts, sizes of all leaves before that one are summed up instead.
+ */
+template <typename Key, typename T, typename Compare, std::size_t degree>
+template <typename K>
+typename b_tree_base<Key, T, Compare, degree>::size_type
+b_tree_base<Key, T, Compare, degree>::rank(const K &key, bool inclusive) const
+{
+	assert(root != nullptr);
+	size_type result = 0;
+	node_t *node = root.get();
+	while (!node->leaf()) {
+		inner_type *inner = cast_inner(node);
+		size_type pos = inner->get_child_pos(key, compare);
+		if (counted())
+			for (size_type i = 0; i < pos; i++)
+				result += inner->count(i);
+		node = inner->get_left_child(inner->cbegin() + pos).get();
+	}
+
+	const leaf_type *leaf = cast_leaf(node);
+	if (!counted())
+		for (const leaf_type *l = leftmost_leaf(); l != leaf;
+		     l = l->get_next().get())
+			result += l->size();
+	typename leaf_type::const_iterator leaf_it = inclusive
+		? std::upper_bound(leaf->cbegin(), leaf->cend(), key,
+				   [this](const K &key, const_reference e) {
+					   return compare(key, e.first);
+				   })
+		: std::lower_bound(leaf->cbegin(), leaf->cend(), key,
+				   [this](const_reference e, const K &key) {
+					   return compare(e.first, key);
+				   });
+
+	return result + static_cast<size_type>(std::distance(leaf->cbegin(), leaf_it));
+}
+
+/**
+ * Returns an iterator pointing to the entry at given position (in sorted
+ * order), or end() if pos is not less than size(). In a tree without counts
+ * the leaves are walked from the leftmost one.
+ */
+template <typename Key, typename T, typename Compare, std::size_t degree>
+typename b_tree_base<Key, T, Compare, degree>::iterator
+b_tree_base<Key, T, Compare, degree>::nth(size_type pos)
+{
+	assert(root != nullptr);
+	if (pos >= size())
+		return end();
+
+	if (!counted()) {
+		leaf_type *leaf = leftmost_leaf();
+		while (pos >= leaf->size()) {
+			pos -= leaf->size();
+			leaf = leaf->get_next().get();
+		}
+		return iterator(leaf, leaf->begin() + pos);
+	}
+
+	node_t *node = root.get();
+	while (!node->leaf()) {
+		inner_type *inner = cast_inner(node);
+		size_type i = 0;
+		for (; i < inner->size() && pos >= inner->count(i); i++)
+			pos -= inner->count(i);
+		node = inner->get_left_child(inner->cbegin() + i).get();
+	}
+
+	leaf_type *leaf = cast_leaf(node);
+	assert(pos < leaf->size());
+	return iterator(leaf, leaf->begin() + pos);
+}
+
+template <typename Key, typename T, typename Compare, std::size_t degree>
+typename b_tree_base<Key, T, Compare, degree>::const_iterator
+b_tree_base<Key, T, Compare, degree>::nth(size_type pos) const
+{
+	return const_cast<self_type *>(this)->nth(pos);
+}
+
 template <typename Key, typename T, typename Compare, std::size_t degree>
 typename b_tree_base<Key, T, Compare, degree>::iterator
 b_tree_base<Key, T, Compare, degree>::begin()
@@ -1826,24 +2257,14 @@ template <typename Key, typename T, typename Compare, std::size_t degree>
 typename b_tree_base<Key, T, Compare, degree>::reference
 	b_tree_base<Key, T, Compare, degree>::operator[](size_type pos)
 {
-	leaf_type *temp = leftmost_leaf();
-	while (temp != nullptr && pos >= temp->size()) {
-		pos -= temp->size();
-		temp = temp->get_next().get();
-	}
-	return temp->operator[](pos);
+	return *nth(pos);
 }
 
 template <typename Key, typename T, typename Compare, std::size_t degree>
 typename b_tree_base<Key, T, Compare, degree>::const_reference
 	b_tree_base<Key, T, Compare, degree>::operator[](size_type pos) const
 {
-	leaf_type *temp = leftmost_leaf();
-	while (temp != nullptr && pos >= temp->size()) {
-		pos -= temp->size();
-		temp = temp->get_next().get();
-	}
-	return temp->operator[](pos);
+	return *nth(pos);
 }
 
 template <typename Key, typename T, typename Compare, std::size_t degree>
@@ -1857,6 +2278,50 @@ b_tree_base<Key, T, Compare, degree>::get_last_key(const node_pptr &node)
 	}
 }
 
+/**
+ * Returns number of entries in the subtree of the node, or 0 in a tree without
+ * counts (the value is then passed to inner nodes, which do not store it).
+ */
+template <typename Key, typename T, typename Compare, std::size_t degree>
+typename b_tree_base<Key, T, Compare, degree>::size_type
+b_tree_base<Key, T, Compare, degree>::count(const node_pptr &node) const
+{
+	if (!counted())
+		return 0;
+	else if (node->leaf())
+		return cast_leaf(node.get())->size();
+	else
+		return cast_inner(node.get())->total_count();
+}
+
+/**
+ * Updates counts of inner nodes on the path of the key (from the root to the
+ * last node, exclusive) after an entry was inserted or removed. Does nothing
+ * in a tree without counts.
+ *
+ * @pre must be called in a transaction scope.
+ */
+template <typename Key, typename T, typename Compare, std::size_t degree>
+template <typename K>
+void b_tree_base<Key, T, Compare, degree>::update_counts(const K &key,
+							 const node_t *last,
+							 bool inserted)
+{
+	assert(pmemobj_tx_stage() == TX_STAGE_WORK);
+	if (!counted())
+		return;
+
+	node_t *node = root.get();
+	while (node != last && !node->leaf()) {
+		inner_type *inner = cast_inner(node);
+		size_type pos = inner->get_child_pos(key, compare);
+		assert(inserted || inner->count(pos) > 0);
+		inner->set_count(pos, inserted ? inner->count(pos) + 1
+					       : inner->count(pos) - 1);
+		node = inner->get_left_child(inner->cbegin() + pos).get();
+	}
+}
+
 template <typename Key, typename T, typename Compare, std::size_t degree>
 void b_tree_base<Key, T, Compare, degree>::create_new_root(const key_type &key,
 							   node_pptr &l_child,
@@ -1865,7 +2330,57 @@ void b_tree_base<Key, T, Compare, degree>::create_new_root(const key_type &key,
 	assert(l_child != nullptr);
 	assert(r_child != nullptr);
 	assert(pmemobj_tx_stage() == TX_STAGE_WORK);
-	cast_inner(root) = allocate_inner(root->level() + 1, key, l_child, r_child);
+	cast_inner(root) = allocate_inner(root->level() + 1, key, l_child, count(l_child),
+					  r_child, count(r_child));
+}
+
+/**
+ * Links child (with key as its separator) as the rightmost child of the last
+ * node of the path. If that node is full, its last child and the new one are
+ * moved to a new node (so that no inner node is left without keys), which is
+ * then linked to the parent in the same way. In a tree with counts, counts of
+ * the nodes left on the path are increased by entries of the child.
+ */
+template <typename Key, typename T, typename Compare, std::size_t degree>
+void b_tree_base<Key, T, Compare, degree>::append_child(path_type &path,
+							const key_type &key,
+							node_pptr child)
+{
+	assert(pmemobj_tx_stage() == TX_STAGE_WORK);
+	const key_type *separator = &key;
+	size_type added = count(child);
+
+	while (!path.empty()) {
+		inner_pptr parent = path.back();
+		path.pop_back();
+
+		if (!parent->full()) {
+			parent->push_back(*separator, child, count(child), counted());
+			if (!counted())
+				return;
+
+			/* the previous last child might have lost its own last child */
+			size_type prev = parent->size() - 1;
+			parent->set_count(
+				prev, count(parent->get_left_child(parent->cbegin() + prev)));
+
+			for (auto &node : path)
+				node->set_count(node->size(),
+						node->count(node->size()) + added);
+			return;
+		}
+
+		const key_type &last_key = parent->back();
+		node_pptr last_child = parent->get_left_child(parent->end());
+		node_pptr other = allocate_inner(parent->level(), *separator, last_child,
+						 count(last_child), child, count(child));
+		parent->pop_back();
+
+		separator = &last_key;
+		child = other;
+	}
+
+	create_new_root(*separator, root, child);
 }
 
 template <typename Key, typename T, typename Compare, std::size_t degree>
@@ -1877,7 +2392,7 @@ b_tree_base<Key, T, Compare, degree>::split_half(pool_base &pop, inner_pptr &nod
 	assert(pmemobj_tx_stage() == TX_STAGE_WORK);
 	assert(other == nullptr);
 	other = allocate_inner(node->level());
-	return other->move(pop, *node, partition_key);
+	return other->move(pop, *node, partition_key, counted());
 }
 
 /* when root is the only inner node */
@@ -1886,6 +2401,8 @@ void b_tree_base<Key, T, Compare, degree>::split_inner_node(pool_base &pop,
 							    inner_pptr &src_node)
 {
 	assert(root == src_node);
+	auto level = src_node->level();
+	PMEMKV_PROBE1(stree_split, level);
 	pmem::obj::transaction::run(pop, [&] {
 		node_pptr other(nullptr);
 		key_pptr partition_key(nullptr);
@@ -1893,6 +2410,7 @@ void b_tree_base<Key, T, Compare, degree>::split_inner_node(pool_base &pop,
 		assert(partition_key != nullptr);
 		create_new_root(*partition_key, cast_node(src_node), other);
 	});
+	PMEMKV_PROBE1(stree_split_done, level);
 }
 
 /* when root is not the only inner node (2 or more inner node layers) */
@@ -1901,14 +2419,19 @@ void b_tree_base<Key, T, Compare, degree>::split_inner_node(pool_base &pop,
 							    inner_pptr &src_node,
 							    inner_type *parent_node)
 {
+	auto level = src_node->level();
+	PMEMKV_PROBE1(stree_split, level);
 	pmem::obj::transaction::run(pop, [&] {
 		node_pptr other(nullptr);
 		key_pptr partition_key(nullptr);
 		split_half(pop, src_node, cast_inner(other), partition_key);
 		assert(partition_key != nullptr);
 		parent_node->update_splitted_child(pop, *partition_key,
-						   cast_node(src_node), other, compare);
+						   cast_node(src_node),
+						   count(cast_node(src_node)), other,
+						   count(other), counted(), compare);
 	});
+	PMEMKV_PROBE1(stree_split_done, level);
 }
 
 /* split leaf in case when root is leaf */
@@ -1925,6 +2448,7 @@ b_tree_base<Key, T, Compare, degree>::split_leaf_node(pool_base &pop,
 	std::pair<iterator, bool> result(nullptr, false);
 	auto middle = split_leaf->begin() + split_leaf->size() / 2;
 	bool less = compare(std::forward<K>(key), middle->first);
+	PMEMKV_PROBE1(stree_split, 0);
 	// move second half into node and insert new element where needed
 	pmem::obj::transaction::run(pop, [&] {
 		node = allocate_leaf();
@@ -1947,6 +2471,7 @@ b_tree_base<Key, T, Compare, degree>::split_leaf_node(pool_base &pop,
 		}
 		split_leaf->set_next(node);
 	});
+	PMEMKV_PROBE1(stree_split_done, 0);
 
 	assert(!compare(result.first->first, key) && !compare(key, result.first->first));
 	return result;
@@ -1967,6 +2492,7 @@ b_tree_base<Key, T, Compare, degree>::split_leaf_node(pool_base &pop,
 	std::pair<iterator, bool> result(nullptr, false);
 	auto middle = split_leaf->begin() + split_leaf->size() / 2;
 	bool less = compare(std::forward<K>(key), middle->first);
+	PMEMKV_PROBE1(stree_split, 0);
 	// move second half into node and insert new element where needed
 	pmem::obj::transaction::run(pop, [&] {
 		node = allocate_leaf();
@@ -1979,10 +2505,12 @@ b_tree_base<Key, T, Compare, degree>::split_leaf_node(pool_base &pop,
 			result = internal_insert(node, std::forward<K>(key),
 						 std::forward<M>(obj));
 		}
-		// take care of parent node
-		parent_node->update_splitted_child(pop, node->front().first,
-						   cast_node(split_leaf), cast_node(node),
-						   compare);
+		// take care of parent node and its ancestors
+		parent_node->update_splitted_child(
+			pop, node->front().first, cast_node(split_leaf),
+			split_leaf->size(), cast_node(node), node->size(), counted(),
+			compare);
+		update_counts(key, parent_node, true);
 		// re-set node's pointers
 		node->set_next(split_leaf->get_next());
 		node->set_prev(split_leaf);
@@ -1991,6 +2519,7 @@ b_tree_base<Key, T, Compare, degree>::split_leaf_node(pool_base &pop,
 		}
 		split_leaf->set_next(node);
 	});
+	PMEMKV_PROBE1(stree_split_done, 0);
 
 	assert(!compare(result.first->first, key) && !compare(key, result.first->first));
 	return result;
@@ -2081,6 +2610,24 @@ b_tree_base<Key, T, Compare, degree>::key_comp() const
 	return compare;
 }
 
+/**
+ * Returns true if the tree was created with a layout known to this version.
+ */
+template <typename Key, typename T, typename Compare, std::size_t degree>
+bool b_tree_base<Key, T, Compare, degree>::compatible_layout() const
+{
+	return layout_version == PLAIN_LAYOUT || layout_version == COUNTED_LAYOUT;
+}
+
+/**
+ * Returns true if inner nodes keep counts of entries in subtrees of children.
+ */
+template <typename Key, typename T, typename Compare, std::size_t degree>
+bool b_tree_base<Key, T, Compare, degree>::counted() const
+{
+	return layout_version == COUNTED_LAYOUT;
+}
+
 template <typename Key, typename T, typename Compare, std::size_t degree>
 typename b_tree_base<Key, T, Compare, degree>::leaf_type *
 b_tree_base<Key, T, Compare, degree>::leftmost_leaf() const
@@ -2236,7 +2783,7 @@ public:
 	using const_iterator = typename base_type::const_iterator;
 	using reverse_iterator = typename base_type::reverse_iterator;
 
-	explicit b_tree() : base_type()
+	explicit b_tree(bool counted = false) : base_type(counted)
 	{
 	}
 
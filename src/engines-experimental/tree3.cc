@@ -79,6 +79,37 @@ status tree3::get_all(get_kv_callback *callback, void *arg)
 	return status::OK;
 }
 
+status tree3::get_keys(get_k_callback *callback, void *arg)
+{
+	LOG("get_keys");
+	check_outside_tx();
+	// keys are kept in volatile leaf nodes, persistent leaves are not read
+	vector<internal::tree3::KVNode *> nodes;
+	if (tree_top)
+		nodes.push_back(tree_top.get());
+	while (!nodes.empty()) {
+		auto node = nodes.back();
+		nodes.pop_back();
+		if (!node->is_leaf) {
+			auto inner = (internal::tree3::KVInnerNode *)node;
+			for (int idx = inner->keycount + 1; idx--;)
+				nodes.push_back(inner->children[idx].get());
+			continue;
+		}
+		auto leafnode = (internal::tree3::KVLeafNode *)node;
+		for (int slot = LEAF_KEYS; slot--;) {
+			if (leafnode->hashes[slot] == 0)
+				continue;
+			auto &key = leafnode->keys[slot];
+			auto ret = callback(key.c_str(), key.size(), arg);
+			if (ret != 0)
+				return status::STOPPED_BY_CB;
+		}
+	}
+
+	return status::OK;
+}
+
 status tree3::exists(string_view key)
 {
 	LOG("exists for key=" << std::string(key.data(), key.size()));
@@ -126,6 +157,29 @@ status tree3::get(string_view key, get_v_callback *callback, void *arg)
 	return status::NOT_FOUND;
 }
 
+status tree3::value_size(string_view key, std::size_t &size)
+{
+	LOG("value_size for key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+	// XXX - do not create temporary string
+	auto leafnode = LeafSearch(std::string(key.data(), key.size()));
+	if (leafnode) {
+		const uint8_t hash = PearsonHash(key.data(), key.size());
+		for (int slot = LEAF_KEYS; slot--;) {
+			if (leafnode->hashes[slot] == hash) {
+				if (leafnode->keys[slot].compare(
+					    std::string(key.data(), key.size())) == 0) {
+					// only the header of the persistent slot is read
+					size = leafnode->leaf->slots[slot].get_ro().valsize();
+					return status::OK;
+				}
+			}
+		}
+	}
+	LOG("   could not find key");
+	return status::NOT_FOUND;
+}
+
 status tree3::put(string_view key, string_view value)
 {
 	LOG("put key=" << std::string(key.data(), key.size())
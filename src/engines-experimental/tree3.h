@@ -189,10 +189,12 @@ public:
 	status count_all(std::size_t &cnt) final;
 
 	status get_all(get_kv_callback *callback, void *arg) final;
+	status get_keys(get_k_callback *callback, void *arg) final;
 
 	status exists(string_view key) final;
 
 	status get(string_view key, get_v_callback *callback, void *arg) final;
+	status value_size(string_view key, std::size_t &size) final;
 
 	status put(string_view key, string_view value) final;
 
@@ -6,6 +6,7 @@
 
 #include "../engine.h"
 #include "../out.h"
+#include "../parallel_scan.h"
 
 #include <cassert>
 #include <memory>
@@ -32,14 +33,22 @@ public:
 	status count_all(std::size_t &cnt) final;
 
 	status get_all(get_kv_callback *callback, void *arg) final;
+	status get_all_parallel(std::size_t partitions, get_kv_callback *callback,
+				void *arg) final;
 
 	status exists(string_view key) final;
 
 	status get(string_view key, get_v_callback *callback, void *arg) final;
+	status value_size(string_view key, std::size_t &size) final;
 
 	status put(string_view key, string_view value) final;
 
+	status put_if_absent(string_view key, string_view value) final;
+	status compare_and_swap(string_view key, string_view expected,
+				string_view desired) final;
+
 	status remove(string_view key) final;
+	status remove_if(string_view key, string_view expected) final;
 
 	internal::iterator_base *new_iterator() final;
 	internal::iterator_base *new_const_iterator() final;
@@ -110,6 +119,43 @@ status basic_vcmap<AllocatorFactory>::get_all(get_kv_callback *callback, void *a
 	return status::OK;
 }
 
+/*
+ * Partitions are bucket ranges of the map, split in halves (breadth-first)
+ * until there are enough of them or none can be divided anymore.
+ */
+template <typename AllocatorFactory>
+status basic_vcmap<AllocatorFactory>::get_all_parallel(std::size_t partitions,
+						       get_kv_callback *callback,
+						       void *arg)
+{
+	LOG("get_all_parallel partitions=" << partitions);
+
+	/* reserved, so splitting a range does not invalidate it */
+	std::vector<typename map_t::range_type> ranges;
+	ranges.reserve(partitions);
+	ranges.push_back(pmem_kv_container.range());
+
+	bool divided = true;
+	while (divided && ranges.size() < partitions) {
+		divided = false;
+		for (std::size_t i = 0, n = ranges.size();
+		     i < n && ranges.size() < partitions; i++) {
+			if (ranges[i].is_divisible()) {
+				ranges.emplace_back(ranges[i], tbb::split());
+				divided = true;
+			}
+		}
+	}
+
+	internal::parallel_scan scan(callback, arg);
+
+	return scan.run(ranges.size(), [&](std::size_t i) {
+		return internal::iterate_through_pairs(ranges[i].begin(), ranges[i].end(),
+						       internal::parallel_scan::callback,
+						       &scan);
+	});
+}
+
 template <typename AllocatorFactory>
 status basic_vcmap<AllocatorFactory>::exists(string_view key)
 {
@@ -139,6 +185,23 @@ status basic_vcmap<AllocatorFactory>::get(string_view key, get_v_callback *callb
 	return status::OK;
 }
 
+template <typename AllocatorFactory>
+status basic_vcmap<AllocatorFactory>::value_size(string_view key, std::size_t &size)
+{
+	LOG("value_size key=" << std::string(key.data(), key.size()));
+	typename map_t::const_accessor result;
+	// XXX - do not create temporary string
+	const bool result_found = pmem_kv_container.find(
+		result, pmem_string(key.data(), key.size(), ch_allocator));
+	if (!result_found) {
+		LOG("  key not found");
+		return status::NOT_FOUND;
+	}
+
+	size = result->second.size();
+	return status::OK;
+}
+
 template <typename AllocatorFactory>
 status basic_vcmap<AllocatorFactory>::put(string_view key, string_view value)
 {
@@ -157,6 +220,47 @@ status basic_vcmap<AllocatorFactory>::put(string_view key, string_view value)
 	return status::OK;
 }
 
+template <typename AllocatorFactory>
+status basic_vcmap<AllocatorFactory>::put_if_absent(string_view key, string_view value)
+{
+	LOG("put_if_absent key=" << std::string(key.data(), key.size())
+				 << ", value.size=" << std::to_string(value.size()));
+
+	typename map_t::value_type kv_pair(
+		std::piecewise_construct,
+		std::forward_as_tuple(key.data(), key.size(), ch_allocator),
+		std::forward_as_tuple(value.data(), value.size(), ch_allocator));
+
+	typename map_t::accessor acc;
+	bool inserted = pmem_kv_container.insert(acc, std::move(kv_pair));
+
+	return inserted ? status::OK : status::CONDITION_NOT_MET;
+}
+
+template <typename AllocatorFactory>
+status basic_vcmap<AllocatorFactory>::compare_and_swap(string_view key,
+							string_view expected,
+							string_view desired)
+{
+	LOG("compare_and_swap key=" << std::string(key.data(), key.size())
+				    << ", desired.size="
+				    << std::to_string(desired.size()));
+
+	typename map_t::accessor acc;
+	// XXX - do not create temporary string
+	if (!pmem_kv_container.find(acc,
+				    pmem_string(key.data(), key.size(), ch_allocator)))
+		return status::NOT_FOUND;
+
+	if (acc->second.compare(0, acc->second.size(), expected.data(),
+				expected.size()) != 0)
+		return status::CONDITION_NOT_MET;
+
+	acc->second.assign(desired.data(), desired.size());
+
+	return status::OK;
+}
+
 template <typename AllocatorFactory>
 status basic_vcmap<AllocatorFactory>::remove(string_view key)
 {
@@ -168,6 +272,26 @@ status basic_vcmap<AllocatorFactory>::remove(string_view key)
 	return (erased ? status::OK : status::NOT_FOUND);
 }
 
+template <typename AllocatorFactory>
+status basic_vcmap<AllocatorFactory>::remove_if(string_view key, string_view expected)
+{
+	LOG("remove_if key=" << std::string(key.data(), key.size()));
+
+	typename map_t::accessor acc;
+	// XXX - do not create temporary string
+	if (!pmem_kv_container.find(acc,
+				    pmem_string(key.data(), key.size(), ch_allocator)))
+		return status::NOT_FOUND;
+
+	if (acc->second.compare(0, acc->second.size(), expected.data(),
+				expected.size()) != 0)
+		return status::CONDITION_NOT_MET;
+
+	pmem_kv_container.erase(acc);
+
+	return status::OK;
+}
+
 template <typename AllocatorFactory>
 class basic_vcmap<AllocatorFactory>::basic_vcmap_const_iterator
     : virtual public internal::iterator_base {
@@ -2,8 +2,13 @@
 /* Copyright 2017-2021, Intel Corporation */
 
 #include "cmap.h"
+#include "../op_phases.h"
 #include "../out.h"
 
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <numeric>
 #include <unistd.h>
 
 namespace pmem
@@ -11,7 +16,8 @@ namespace pmem
 namespace kv
 {
 
-cmap::cmap(std::unique_ptr<internal::config> cfg) : pmemobj_engine_base(cfg, "pmemkv")
+cmap::cmap(std::unique_ptr<internal::config> cfg)
+    : pmemobj_engine_base(cfg, "pmemkv"), config(std::move(cfg))
 {
 	static_assert(
 		sizeof(internal::cmap::string_t) == 40,
@@ -19,10 +25,27 @@ cmap::cmap(std::unique_ptr<internal::config> cfg) : pmemobj_engine_base(cfg, "pm
 
 	LOG("Started ok");
 	Recover();
+
+	uint64_t reap_rate = TTL_REAP_RATE_DEFAULT;
+	config->get_uint64("ttl_reap_rate", &reap_rate);
+
+	auto remove = [this](string_view key) {
+		container->erase(key);
+		if (deadlines)
+			deadlines->erase(key);
+	};
+	reaper.reset(new internal::expiry_reaper(expiry, reap_rate, remove));
+
+	/* otherwise the reaper is started by the first put_with_ttl() */
+	if (expiry.active())
+		start_ttl();
 }
 
 cmap::~cmap()
 {
+	/* reaper uses the container, so it has to be stopped first */
+	reaper.reset();
+
 	LOG("Stopped ok");
 }
 
@@ -49,10 +72,46 @@ status cmap::get_all(get_kv_callback *callback, void *arg)
 	return internal::iterate_through_pairs(it, end, callback, arg);
 }
 
+status cmap::get_keys(get_k_callback *callback, void *arg)
+{
+	LOG("get_keys");
+	check_outside_tx();
+	auto it = container->begin();
+	auto end = container->end();
+	return internal::iterate_through_keys(it, end, callback, arg);
+}
+
+/*
+ * concurrent_hash_map does not expose its buckets, so boundaries of partitions
+ * are found by walking the iterators (which reads only the links between
+ * nodes). Records are read and passed to callbacks by the partitions' threads.
+ */
+status cmap::get_all_parallel(std::size_t partitions, get_kv_callback *callback,
+			      void *arg)
+{
+	LOG("get_all_parallel partitions=" << partitions);
+	check_outside_tx();
+
+	auto bounds = internal::split_range(container->begin(), container->end(),
+					    container->size(), partitions);
+
+	internal::parallel_scan scan(callback, arg);
+
+	return scan.run(bounds.size() - 1, [&](std::size_t i) {
+		return internal::iterate_through_pairs(bounds[i], bounds[i + 1],
+						       internal::parallel_scan::callback,
+						       &scan);
+	});
+}
+
 status cmap::exists(string_view key)
 {
 	LOG("exists for key=" << std::string(key.data(), key.size()));
 	check_outside_tx();
+
+	if (expiry.is_expired(key))
+		return status::NOT_FOUND;
+
 	return container->count(key) == 1 ? status::OK : status::NOT_FOUND;
 }
 
@@ -60,8 +119,16 @@ status cmap::get(string_view key, get_v_callback *callback, void *arg)
 {
 	LOG("get key=" << std::string(key.data(), key.size()));
 	check_outside_tx();
+
+	if (expiry.is_expired(key)) {
+		LOG("  key expired");
+		return status::NOT_FOUND;
+	}
+
+	internal::phase_timer lookup_timer(internal::op_phase::lookup);
 	internal::cmap::map_t::const_accessor result;
 	bool found = container->find(result, key);
+	lookup_timer.stop();
 	if (!found) {
 		LOG("  key not found");
 		return status::NOT_FOUND;
@@ -71,14 +138,384 @@ status cmap::get(string_view key, get_v_callback *callback, void *arg)
 	return status::OK;
 }
 
+status cmap::value_size(string_view key, std::size_t &size)
+{
+	LOG("value_size key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	if (expiry.is_expired(key)) {
+		LOG("  key expired");
+		return status::NOT_FOUND;
+	}
+
+	internal::cmap::map_t::const_accessor result;
+	bool found = container->find(result, key);
+	if (!found) {
+		LOG("  key not found");
+		return status::NOT_FOUND;
+	}
+
+	size = result->second.size();
+	return status::OK;
+}
+
+namespace internal
+{
+namespace cmap
+{
+
+/* Element's read lock is held by the accessor as long as the value is pinned */
+class pinned_value : public internal::pinned_value {
+public:
+	map_t::const_accessor acc;
+
+	void pin()
+	{
+		val = string_view(acc->second.c_str(), acc->second.size());
+	}
+};
+
+} /* namespace cmap */
+} /* namespace internal */
+
+status cmap::get_pinned(string_view key, std::unique_ptr<internal::pinned_value> &pinned)
+{
+	LOG("get_pinned key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	if (expiry.is_expired(key)) {
+		LOG("  key expired");
+		return status::NOT_FOUND;
+	}
+
+	std::unique_ptr<internal::cmap::pinned_value> p(
+		new internal::cmap::pinned_value);
+	bool found = container->find(p->acc, key);
+	if (!found) {
+		LOG("  key not found");
+		return status::NOT_FOUND;
+	}
+
+	p->pin();
+	pinned = std::move(p);
+
+	return status::OK;
+}
+
+/*
+ * Keys are processed in windows of get_many_window elements. For every window
+ * all the lookups are done first and values of found elements are prefetched,
+ * then callbacks are executed. This way pmem loads of independent lookups can
+ * overlap instead of being serialized one after another.
+ */
+status cmap::get_many(const std::vector<string_view> &keys, get_many_callback *callback,
+		      void *arg)
+{
+	LOG("get_many for " << keys.size() << " keys");
+	check_outside_tx();
+
+	static constexpr std::size_t get_many_window = 16;
+
+	std::unique_ptr<internal::cmap::map_t::const_accessor[]> accessors(
+		new internal::cmap::map_t::const_accessor[get_many_window]);
+	bool found[get_many_window];
+
+	for (std::size_t first = 0; first < keys.size(); first += get_many_window) {
+		auto last = std::min(first + get_many_window, keys.size());
+
+		/* before any record of the window is locked, see is_expired() */
+		for (auto i = first; i < last; ++i)
+			found[i - first] = !expiry.is_expired(keys[i]);
+
+		for (auto i = first; i < last; ++i) {
+			auto &acc = accessors[i - first];
+			found[i - first] =
+				found[i - first] && container->find(acc, keys[i]);
+			if (found[i - first])
+				__builtin_prefetch(acc->second.c_str());
+		}
+
+		for (auto i = first; i < last; ++i) {
+			auto &acc = accessors[i - first];
+			if (found[i - first]) {
+				callback(i, PMEMKV_STATUS_OK, acc->second.c_str(),
+					 acc->second.size(), arg);
+				acc.release();
+			} else {
+				callback(i, PMEMKV_STATUS_NOT_FOUND, nullptr, 0, arg);
+			}
+		}
+	}
+
+	return status::OK;
+}
+
 status cmap::put(string_view key, string_view value)
 {
 	LOG("put key=" << std::string(key.data(), key.size())
 		       << ", value.size=" << std::to_string(value.size()));
 	check_outside_tx();
 
+	internal::phase_timer lock_timer(internal::op_phase::lock_wait);
+	auto lock = expiry.lock_if_active(key);
+	lock_timer.stop();
+
 	container->insert_or_assign(key, value);
 
+	if (lock.owns_lock())
+		clear_deadline(key);
+
+	return status::OK;
+}
+
+/*
+ * The key's shard of the expiry index stays locked until the deadline is set,
+ * so the reaper cannot remove the new value based on a previous deadline.
+ * The deadline is persisted before the value: after a crash in between, the
+ * previous value expires instead of the new one living forever.
+ */
+status cmap::put_with_ttl(string_view key, string_view value,
+			  std::chrono::milliseconds ttl)
+{
+	LOG("put_with_ttl key=" << std::string(key.data(), key.size())
+				<< ", value.size=" << std::to_string(value.size())
+				<< ", ttl=" << std::to_string(ttl.count()));
+	check_outside_tx();
+
+	start_ttl();
+
+	auto deadline = internal::expiry_index::clock_type::now() + ttl;
+	auto lock = expiry.lock(key);
+
+	set_deadline(key, deadline);
+	container->insert_or_assign(key, value);
+
+	return status::OK;
+}
+
+/*
+ * Creates the persistent map of deadlines (key -> persistent_deadline) and
+ * starts the reaper thread, once. The map is referenced from the pool's root
+ * object, so it is not available if the engine was opened by oid - deadlines
+ * are kept in DRAM only then.
+ */
+void cmap::start_ttl()
+{
+	std::call_once(ttl_started, [&] {
+		if (!deadlines && deadlines_oid) {
+			pmem::obj::transaction::run(pmpool, [&] {
+				pmem::obj::transaction::snapshot(deadlines_oid);
+				*deadlines_oid =
+					pmem::obj::make_persistent<internal::cmap::map_t>()
+						.raw();
+			});
+			deadlines = static_cast<internal::cmap::map_t *>(
+				pmemobj_direct(*deadlines_oid));
+			deadlines->runtime_initialize();
+		}
+
+		reaper->start();
+	});
+}
+
+/* Below two methods must be called with the key's shard locked */
+void cmap::set_deadline(string_view key, internal::expiry_index::time_point deadline)
+{
+	if (deadlines) {
+		auto d = internal::expiry_index::to_persistent(deadline);
+		deadlines->insert_or_assign(
+			key, string_view(reinterpret_cast<const char *>(&d), sizeof(d)));
+	}
+
+	expiry.set(key, deadline);
+}
+
+void cmap::clear_deadline(string_view key)
+{
+	if (expiry.clear(key) && deadlines)
+		deadlines->erase(key);
+}
+
+/*
+ * Removes the record if it has expired, so conditional writes treat it as
+ * a missing one. The key's shard of the expiry index must be locked.
+ */
+void cmap::expire(string_view key)
+{
+	if (!expiry.expired(key, internal::expiry_index::clock_type::now()))
+		return;
+
+	container->erase(key);
+	clear_deadline(key);
+}
+
+/*
+ * The record is locked by the accessor for the whole read-modify-write. If it
+ * does not exist, the merged value is inserted together with the key - unless
+ * another thread inserts the key first, then its value is merged instead.
+ */
+status cmap::merge(string_view key, string_view operand)
+{
+	LOG("merge key=" << std::string(key.data(), key.size())
+			 << ", operand.size=" << std::to_string(operand.size()));
+	check_outside_tx();
+
+	auto op = internal::extract_merge_operator(*config);
+	if (!op) {
+		out_err_stream("merge") << "merge operator not set in the config";
+		return status::INVALID_ARGUMENT;
+	}
+
+	auto merge_failed = [&]() {
+		out_err_stream("merge")
+			<< "merge operator \"" << op->name() << "\" failed";
+		return status::INVALID_ARGUMENT;
+	};
+
+	auto lock = expiry.lock_if_active(key);
+	if (lock.owns_lock())
+		expire(key);
+
+	std::string new_value;
+	internal::cmap::map_t::accessor acc;
+
+	if (!container->find(acc, key)) {
+		if (!op->merge(key, nullptr, operand, new_value))
+			return merge_failed();
+
+		if (insert(acc, key, string_view(new_value.data(), new_value.size())))
+			return status::OK;
+	}
+
+	string_view existing(acc->second.c_str(), acc->second.size());
+	if (!op->merge(key, &existing, operand, new_value))
+		return merge_failed();
+
+	acc->second = string_view(new_value.data(), new_value.size());
+
+	return status::OK;
+}
+
+/*
+ * Inserts the key together with its value, if the key is missing. Either way
+ * the record is locked by acc; false is returned if it already existed.
+ *
+ * concurrent_hash_map inserts a whole record only by copying a value_type,
+ * which (as pmem strings) can be built only in the pool - so it's built in the
+ * staging map first. Its accessor also serializes inserts of the same key.
+ * Records left in the staging map by a crash are dropped by Recover().
+ */
+bool cmap::insert(internal::cmap::map_t::accessor &acc, string_view key,
+		  string_view value)
+{
+	if (!staging) {
+		/* opened by oid - the key is persisted with an empty value first */
+		if (!container->insert(acc, key))
+			return false;
+
+		acc->second = value;
+		return true;
+	}
+
+	bool inserted;
+	{
+		internal::cmap::map_t::accessor record;
+		staging->insert(record, key);
+		record->second = value;
+
+		inserted = container->insert(acc, *record);
+	}
+
+	staging->erase(key);
+
+	return inserted;
+}
+
+/*
+ * Top bits of the hash are used, as only they are well mixed by fibonacci
+ * hashing.
+ */
+std::mutex &cmap::cond_lock(string_view key)
+{
+	static_assert(sizeof(size_t) == 8, "64-bit hash expected");
+
+	return cond_locks[internal::cmap::string_hasher()(key) >> (64 - 6)];
+}
+
+status cmap::put_if_absent(string_view key, string_view value)
+{
+	LOG("put_if_absent key=" << std::string(key.data(), key.size())
+				 << ", value.size=" << std::to_string(value.size()));
+	check_outside_tx();
+
+	auto lock = expiry.lock_if_active(key);
+	if (lock.owns_lock())
+		expire(key);
+
+	internal::cmap::map_t::accessor acc;
+	if (!insert(acc, key, value))
+		return status::CONDITION_NOT_MET;
+
+	return status::OK;
+}
+
+status cmap::compare_and_swap(string_view key, string_view expected, string_view desired)
+{
+	LOG("compare_and_swap key=" << std::string(key.data(), key.size())
+				    << ", desired.size="
+				    << std::to_string(desired.size()));
+	check_outside_tx();
+
+	std::lock_guard<std::mutex> cond(cond_lock(key));
+	auto lock = expiry.lock_if_active(key);
+	if (lock.owns_lock())
+		expire(key);
+
+	internal::cmap::map_t::accessor acc;
+	if (!container->find(acc, key))
+		return status::NOT_FOUND;
+
+	if (string_view(acc->second.c_str(), acc->second.size()).compare(expected) != 0)
+		return status::CONDITION_NOT_MET;
+
+	acc->second = desired;
+
+	return status::OK;
+}
+
+/*
+ * concurrent_hash_map erases records only by key, so the value is compared
+ * under the accessor and the record is erased after it's released. The key's
+ * lock taken by compare_and_swap and remove_if keeps the value unchanged by
+ * them in the meantime; a value changed by put or merge in that window may
+ * still be removed.
+ */
+status cmap::remove_if(string_view key, string_view expected)
+{
+	LOG("remove_if key=" << std::string(key.data(), key.size()));
+	check_outside_tx();
+
+	std::lock_guard<std::mutex> cond(cond_lock(key));
+	auto lock = expiry.lock_if_active(key);
+	if (lock.owns_lock())
+		expire(key);
+
+	{
+		internal::cmap::map_t::const_accessor acc;
+		if (!container->find(acc, key))
+			return status::NOT_FOUND;
+
+		if (string_view(acc->second.c_str(), acc->second.size())
+			    .compare(expected) != 0)
+			return status::CONDITION_NOT_MET;
+	}
+
+	/* erase() waits for all accessors of the record, so ours is released */
+	container->erase(key);
+
+	if (lock.owns_lock())
+		clear_deadline(key);
+
 	return status::OK;
 }
 
@@ -87,10 +524,71 @@ status cmap::remove(string_view key)
 	LOG("remove key=" << std::string(key.data(), key.size()));
 	check_outside_tx();
 
+	internal::phase_timer lock_timer(internal::op_phase::lock_wait);
+	auto lock = expiry.lock_if_active(key);
+	lock_timer.stop();
+	if (lock.owns_lock())
+		expire(key);
+
 	bool erased = container->erase(key);
+
+	if (lock.owns_lock())
+		clear_deadline(key);
+
 	return erased ? status::OK : status::NOT_FOUND;
 }
 
+/*
+ * cmap has no global lock and its methods cannot be called inside an outer
+ * transaction, so every key still has to be locked and persisted separately.
+ * Instead, only the last operation for each key is applied - the final state
+ * is the same (batch is not atomic anyway), but overwritten values are never
+ * allocated and persisted.
+ */
+status cmap::apply_batch(const internal::write_batch &batch)
+{
+	LOG("apply_batch of " << batch.size() << " operations");
+	check_outside_tx();
+
+	/* stable sort keeps operations on the same key in the batch order */
+	std::vector<std::size_t> order(batch.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](std::size_t lhs, std::size_t rhs) {
+		return batch[lhs].key.compare(batch[rhs].key) < 0;
+	});
+
+	for (std::size_t i = 0; i < order.size(); ++i) {
+		auto e = batch[order[i]];
+
+		/* superseded by a later operation on the same key */
+		if (i + 1 < order.size() && batch[order[i + 1]].key.compare(e.key) == 0)
+			continue;
+
+		auto lock = expiry.lock_if_active(e.key);
+
+		if (e.op == internal::write_batch::operation::remove)
+			container->erase(e.key);
+		else
+			container->insert_or_assign(e.key, e.value);
+
+		if (lock.owns_lock())
+			clear_deadline(e.key);
+	}
+
+	return status::OK;
+}
+
+/*
+ * Buckets are rehashed lazily, on first access after the table grows, so
+ * number of buckets (which doubles on every growth) is reported instead of
+ * number of rehashes.
+ */
+void cmap::get_engine_counters(internal::engine_counters &counters)
+{
+	counters.emplace_back("bucket_count", container->bucket_count());
+	counters.emplace_back("size", container->size());
+}
+
 status cmap::defrag(double start_percent, double amount_percent)
 {
 	LOG("defrag: start_percent = " << start_percent
@@ -125,6 +623,43 @@ void cmap::Recover()
 			container->runtime_initialize();
 		});
 	}
+
+	if (staging_oid) {
+		if (OID_IS_NULL(*staging_oid)) {
+			pmem::obj::transaction::run(pmpool, [&] {
+				pmem::obj::transaction::snapshot(staging_oid);
+				*staging_oid =
+					pmem::obj::make_persistent<internal::cmap::map_t>()
+						.raw();
+			});
+		}
+
+		staging = static_cast<internal::cmap::map_t *>(
+			pmemobj_direct(*staging_oid));
+		staging->runtime_initialize();
+
+		/* records of inserts interrupted by a crash */
+		if (staging->size() != 0)
+			staging->clear();
+	}
+
+	if (deadlines_oid && !OID_IS_NULL(*deadlines_oid)) {
+		deadlines = static_cast<internal::cmap::map_t *>(
+			pmemobj_direct(*deadlines_oid));
+		deadlines->runtime_initialize();
+
+		for (auto it = deadlines->begin(); it != deadlines->end(); ++it) {
+			string_view key(it->first.c_str(), it->first.size());
+			internal::expiry_index::persistent_deadline d;
+			if (it->second.size() != sizeof(d))
+				continue;
+
+			std::memcpy(&d, it->second.c_str(), sizeof(d));
+
+			auto lock = expiry.lock(key);
+			expiry.set(key, internal::expiry_index::from_persistent(d));
+		}
+	}
 }
 
 internal::iterator_base *cmap::new_iterator()
@@ -4,13 +4,19 @@
 #ifndef LIBPMEMKV_CMAP_H
 #define LIBPMEMKV_CMAP_H
 
+#include "../expiry.h"
 #include "../iterator.h"
+#include "../merge_operator.h"
+#include "../parallel_scan.h"
 #include "../pmemobj_engine.h"
 #include "../polymorphic_string.h"
 
 #include <libpmemobj++/container/concurrent_hash_map.hpp>
 #include <libpmemobj++/persistent_ptr.hpp>
 
+#include <array>
+#include <mutex>
+
 namespace pmem
 {
 namespace kv
@@ -80,23 +86,64 @@ public:
 	status count_all(std::size_t &cnt) final;
 
 	status get_all(get_kv_callback *callback, void *arg) final;
+	status get_keys(get_k_callback *callback, void *arg) final;
+	status get_all_parallel(std::size_t partitions, get_kv_callback *callback,
+				void *arg) final;
 
 	status exists(string_view key) final;
 
 	status get(string_view key, get_v_callback *callback, void *arg) final;
+	status value_size(string_view key, std::size_t &size) final;
+	status get_many(const std::vector<string_view> &keys, get_many_callback *callback,
+			void *arg) final;
+	status get_pinned(string_view key,
+			  std::unique_ptr<internal::pinned_value> &pinned) final;
 
 	status put(string_view key, string_view value) final;
+	status put_with_ttl(string_view key, string_view value,
+			    std::chrono::milliseconds ttl) final;
+
+	status merge(string_view key, string_view operand) final;
+
+	status put_if_absent(string_view key, string_view value) final;
+	status compare_and_swap(string_view key, string_view expected,
+				string_view desired) final;
+	status remove_if(string_view key, string_view expected) final;
 
 	status remove(string_view key) final;
 
+	status apply_batch(const internal::write_batch &batch) final;
+
 	status defrag(double start_percent, double amount_percent) final;
 
+	void get_engine_counters(internal::engine_counters &counters) final;
+
 	internal::iterator_base *new_iterator() final;
 	internal::iterator_base *new_const_iterator() final;
 
 private:
 	void Recover();
+	void expire(string_view key);
+	void start_ttl();
+	void set_deadline(string_view key, internal::expiry_index::time_point deadline);
+	void clear_deadline(string_view key);
+	bool insert(internal::cmap::map_t::accessor &acc, string_view key,
+		    string_view value);
+	std::mutex &cond_lock(string_view key);
+
 	internal::cmap::map_t *container;
+	std::unique_ptr<internal::config> config;
+
+	internal::expiry_index expiry;
+	std::unique_ptr<internal::expiry_reaper> reaper;
+	/* persistent deadlines of records, nullptr until the first TTL is set */
+	internal::cmap::map_t *deadlines = nullptr;
+	std::once_flag ttl_started;
+
+	/* records being inserted, nullptr if the engine was opened by oid */
+	internal::cmap::map_t *staging = nullptr;
+	/* locks of keys taken by compare_and_swap and remove_if only */
+	std::array<std::mutex, 64> cond_locks;
 };
 
 template <>
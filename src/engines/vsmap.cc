@@ -169,6 +169,127 @@ status vsmap::get_between(string_view key1, string_view key2, get_kv_callback *c
 	return status::OK;
 }
 
+status vsmap::get_all_desc(get_kv_callback *callback, void *arg)
+{
+	LOG("get_all_desc");
+	return internal::iterate_through_pairs_desc(
+		pmem_kv_container.begin(), pmem_kv_container.end(), callback, arg);
+}
+
+status vsmap::get_above_desc(string_view key, get_kv_callback *callback, void *arg)
+{
+	LOG("get_above_desc for key=" << std::string(key.data(), key.size()));
+	// XXX - do not create temporary string
+	auto it = pmem_kv_container.upper_bound(
+		key_type(key.data(), key.size(), kv_allocator));
+	auto end = pmem_kv_container.end();
+	return internal::iterate_through_pairs_desc(it, end, callback, arg);
+}
+
+status vsmap::get_equal_above_desc(string_view key, get_kv_callback *callback, void *arg)
+{
+	LOG("get_equal_above_desc for key=" << std::string(key.data(), key.size()));
+	// XXX - do not create temporary string
+	auto it = pmem_kv_container.lower_bound(
+		key_type(key.data(), key.size(), kv_allocator));
+	auto end = pmem_kv_container.end();
+	return internal::iterate_through_pairs_desc(it, end, callback, arg);
+}
+
+status vsmap::get_equal_below_desc(string_view key, get_kv_callback *callback, void *arg)
+{
+	LOG("get_equal_below_desc for key=" << std::string(key.data(), key.size()));
+	auto it = pmem_kv_container.begin();
+	// XXX - do not create temporary string
+	auto end = pmem_kv_container.upper_bound(
+		key_type(key.data(), key.size(), kv_allocator));
+	return internal::iterate_through_pairs_desc(it, end, callback, arg);
+}
+
+status vsmap::get_below_desc(string_view key, get_kv_callback *callback, void *arg)
+{
+	LOG("get_below_desc for key=" << std::string(key.data(), key.size()));
+	auto it = pmem_kv_container.begin();
+	// XXX - do not create temporary string
+	auto end = pmem_kv_container.lower_bound(
+		key_type(key.data(), key.size(), kv_allocator));
+	return internal::iterate_through_pairs_desc(it, end, callback, arg);
+}
+
+status vsmap::get_between_desc(string_view key1, string_view key2,
+			       get_kv_callback *callback, void *arg)
+{
+	LOG("get_between_desc for key1=" << std::string(key1.data(), key1.size())
+					 << ", key2="
+					 << std::string(key2.data(), key2.size()));
+	if (pmem_kv_container.key_comp()(key1, key2)) {
+		// XXX - do not create temporary string
+		auto it = pmem_kv_container.upper_bound(
+			key_type(key1.data(), key1.size(), kv_allocator));
+		auto end = pmem_kv_container.lower_bound(
+			key_type(key2.data(), key2.size(), kv_allocator));
+		return internal::iterate_through_pairs_desc(it, end, callback, arg);
+	}
+
+	return status::OK;
+}
+
+std::pair<string_view, string_view> vsmap::key_value(const map_type::iterator &it)
+{
+	return {string_view(it->first.c_str(), it->first.size()),
+		string_view(it->second.c_str(), it->second.size())};
+}
+
+/*
+ * Pages are continued from the cached position of the last returned element,
+ * unless any element was erased since (std::map iterators are invalidated only
+ * by erase of the element they point to).
+ */
+status vsmap::get_above_page(string_view key, internal::scan_cursor &cursor,
+			     get_kv_callback *callback, void *arg)
+{
+	LOG("get_above_page for key=" << std::string(key.data(), key.size()));
+
+	auto last = pmem_kv_container.end();
+	auto first = last;
+	if (!cursor.resume(key, scan_version(), first))
+		// XXX - do not create temporary string
+		first = pmem_kv_container.upper_bound(
+			key_type(key.data(), key.size(), kv_allocator));
+
+	return cursor.fill(
+		first, [&](const map_type::iterator &it) { return it == last; }, key_value,
+		scan_version(), callback, arg);
+}
+
+status vsmap::get_between_page(string_view key1, string_view key2,
+			       internal::scan_cursor &cursor, get_kv_callback *callback,
+			       void *arg)
+{
+	LOG("get_between_page for key1=" << std::string(key1.data(), key1.size())
+					 << ", key2="
+					 << std::string(key2.data(), key2.size()));
+
+	if (!pmem_kv_container.key_comp()(key1, key2)) {
+		cursor.reset();
+		return status::OK;
+	}
+
+	auto last = pmem_kv_container.end();
+	auto first = last;
+	if (!cursor.resume(key1, scan_version(), first))
+		// XXX - do not create temporary string
+		first = pmem_kv_container.upper_bound(
+			key_type(key1.data(), key1.size(), kv_allocator));
+
+	return cursor.fill(
+		first,
+		[&](const map_type::iterator &it) {
+			return it == last || !pmem_kv_container.key_comp()(it->first, key2);
+		},
+		key_value, scan_version(), callback, arg);
+}
+
 status vsmap::exists(string_view key)
 {
 	LOG("exists for key=" << std::string(key.data(), key.size()));
@@ -193,6 +314,21 @@ status vsmap::get(string_view key, get_v_callback *callback, void *arg)
 	return status::OK;
 }
 
+status vsmap::value_size(string_view key, std::size_t &size)
+{
+	LOG("value_size key=" << std::string(key.data(), key.size()));
+	// XXX - do not create temporary string
+	const auto pos =
+		pmem_kv_container.find(key_type(key.data(), key.size(), kv_allocator));
+	if (pos == pmem_kv_container.end()) {
+		LOG("  key not found");
+		return status::NOT_FOUND;
+	}
+
+	size = pos->second.size();
+	return status::OK;
+}
+
 status vsmap::put(string_view key, string_view value)
 {
 	LOG("put key=" << std::string(key.data(), key.size())
@@ -213,12 +349,33 @@ status vsmap::remove(string_view key)
 {
 	LOG("remove key=" << std::string(key.data(), key.size()));
 
+	invalidate_scan_positions();
+
 	// XXX - do not create temporary string
 	bool erased =
 		pmem_kv_container.erase(key_type(key.data(), key.size(), kv_allocator));
 	return (erased ? status::OK : status::NOT_FOUND);
 }
 
+status vsmap::remove_range(string_view key1, string_view key2)
+{
+	LOG("remove_range for key1=" << std::string(key1.data(), key1.size())
+				     << ", key2=" << std::string(key2.data(), key2.size()));
+
+	if (pmem_kv_container.key_comp()(key1, key2)) {
+		invalidate_scan_positions();
+
+		// XXX - do not create temporary string
+		auto first = pmem_kv_container.lower_bound(
+			key_type(key1.data(), key1.size(), kv_allocator));
+		auto last = pmem_kv_container.lower_bound(
+			key_type(key2.data(), key2.size(), kv_allocator));
+		pmem_kv_container.erase(first, last);
+	}
+
+	return status::OK;
+}
+
 internal::iterator_base *vsmap::new_iterator()
 {
 	return new vsmap_iterator<false>{&pmem_kv_container, &kv_allocator};
@@ -231,7 +388,7 @@ internal::iterator_base *vsmap::new_const_iterator()
 
 vsmap::vsmap_iterator<true>::vsmap_iterator(container_type *c,
 					    vsmap::map_allocator_type *alloc)
-    : container(c), kv_allocator(alloc)
+    : container(c), kv_allocator(alloc), it_(c->end())
 {
 }
 
@@ -382,6 +539,28 @@ result<pmem::obj::slice<const char *>> vsmap::vsmap_iterator<true>::read_range(s
 	return {{it_->second.data() + pos, it_->second.data() + pos + n}};
 }
 
+/* records are read directly from the map, without virtual calls per record */
+status vsmap::vsmap_iterator<true>::read_batch(pmemkv_iterator_entry *entries, size_t n,
+					       size_t &count)
+{
+	init_seek();
+
+	count = 0;
+	/* iterator is not positioned (or already past the last record) */
+	if (it_ == container->end())
+		return status::NOT_FOUND;
+
+	while (count < n) {
+		entries[count++] = {it_->first.data(), it_->first.length(),
+				    it_->second.data(), it_->second.size()};
+
+		if (++it_ == container->end())
+			return status::NOT_FOUND;
+	}
+
+	return status::OK;
+}
+
 result<pmem::obj::slice<char *>> vsmap::vsmap_iterator<false>::write_range(size_t pos,
 									   size_t n)
 {
@@ -51,13 +51,33 @@ public:
 	status get_between(string_view key1, string_view key2, get_kv_callback *callback,
 			   void *arg) final;
 
+	status get_all_desc(get_kv_callback *callback, void *arg) final;
+	status get_above_desc(string_view key, get_kv_callback *callback,
+			      void *arg) final;
+	status get_equal_above_desc(string_view key, get_kv_callback *callback,
+				    void *arg) final;
+	status get_equal_below_desc(string_view key, get_kv_callback *callback,
+				    void *arg) final;
+	status get_below_desc(string_view key, get_kv_callback *callback,
+			      void *arg) final;
+	status get_between_desc(string_view key1, string_view key2,
+				get_kv_callback *callback, void *arg) final;
+
+	status get_above_page(string_view key, internal::scan_cursor &cursor,
+			      get_kv_callback *callback, void *arg) final;
+	status get_between_page(string_view key1, string_view key2,
+				internal::scan_cursor &cursor, get_kv_callback *callback,
+				void *arg) final;
+
 	status exists(string_view key) final;
 
 	status get(string_view key, get_v_callback *callback, void *arg) final;
+	status value_size(string_view key, std::size_t &size) final;
 
 	status put(string_view key, string_view value) final;
 
 	status remove(string_view key) final;
+	status remove_range(string_view key1, string_view key2) final;
 
 	internal::iterator_base *new_iterator() final;
 	internal::iterator_base *new_const_iterator() final;
@@ -73,6 +93,9 @@ private:
 	using map_type = std::map<key_type, mapped_type, internal::volatile_compare,
 				  std::scoped_allocator_adaptor<map_allocator_type>>;
 
+	static std::pair<string_view, string_view>
+	key_value(const map_type::iterator &it);
+
 	map_allocator_type kv_allocator;
 	map_type pmem_kv_container;
 	std::unique_ptr<internal::config> config;
@@ -102,6 +125,7 @@ public:
 	result<string_view> key() final;
 
 	result<pmem::obj::slice<const char *>> read_range(size_t pos, size_t n) final;
+	status read_batch(pmemkv_iterator_entry *entries, size_t n, size_t &count) final;
 
 protected:
 	container_type *container;
@@ -0,0 +1,255 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "expiry.h"
+#include "exceptions.h"
+
+namespace pmem
+{
+namespace kv
+{
+namespace internal
+{
+
+/* How often the reaper runs; the rate limit is split evenly between runs */
+static const auto reap_interval = std::chrono::milliseconds(100);
+
+expiry_index::expiry_index(std::size_t shards_number, clock_type::duration bucket_width)
+    : bucket_width(bucket_width), active_(false)
+{
+	if (shards_number == 0)
+		throw internal::invalid_argument("Number of expiry shards must be > 0");
+
+	shards.reserve(shards_number);
+	for (std::size_t i = 0; i < shards_number; i++) {
+		shards.emplace_back(new shard);
+		shards.back()->earliest.store(time_point::max().time_since_epoch().count());
+	}
+}
+
+expiry_index::shard &expiry_index::shard_of(string_view key)
+{
+	/* FNV-1a */
+	uint64_t h = 14695981039346656037ULL;
+	for (std::size_t i = 0; i < key.size(); i++) {
+		h ^= static_cast<unsigned char>(key.data()[i]);
+		h *= 1099511628211ULL;
+	}
+
+	return *shards[h % shards.size()];
+}
+
+/*
+ * Buckets are rounded up, so the first bucket minus its width is not later
+ * than any deadline in the shard. Stale bucket entries only make it earlier.
+ */
+void expiry_index::update_earliest(shard &s)
+{
+	auto earliest = s.buckets.empty() ? time_point::max()
+					  : s.buckets.begin()->first - bucket_width;
+
+	s.earliest.store(earliest.time_since_epoch().count(), std::memory_order_release);
+}
+
+expiry_index::lock_type expiry_index::lock(string_view key)
+{
+	return lock_type(shard_of(key).mtx);
+}
+
+expiry_index::lock_type expiry_index::lock_if_active(string_view key)
+{
+	if (!active())
+		return lock_type();
+
+	return lock(key);
+}
+
+void expiry_index::set(string_view key, time_point deadline)
+{
+	auto &s = shard_of(key);
+	std::string k(key.data(), key.size());
+
+	auto bucket = time_point(
+		((deadline.time_since_epoch() + bucket_width - clock_type::duration(1)) /
+		 bucket_width) *
+		bucket_width);
+
+	s.buckets[bucket].push_back(k);
+	{
+		lock_type lock(s.deadlines_mtx);
+		s.deadlines[std::move(k)] = deadline;
+	}
+	update_earliest(s);
+
+	active_.store(true, std::memory_order_release);
+}
+
+bool expiry_index::clear(string_view key)
+{
+	auto &s = shard_of(key);
+	if (s.deadlines.empty())
+		return false;
+
+	lock_type lock(s.deadlines_mtx);
+
+	return s.deadlines.erase(std::string(key.data(), key.size())) > 0;
+}
+
+bool expiry_index::expired(string_view key, time_point now)
+{
+	auto &s = shard_of(key);
+	if (s.deadlines.empty())
+		return false;
+
+	auto it = s.deadlines.find(std::string(key.data(), key.size()));
+
+	return it != s.deadlines.end() && it->second <= now;
+}
+
+bool expiry_index::is_expired(string_view key)
+{
+	if (!active())
+		return false;
+
+	auto now = clock_type::now();
+	auto &s = shard_of(key);
+	if (now.time_since_epoch().count() < s.earliest.load(std::memory_order_acquire))
+		return false;
+
+	lock_type lock(s.deadlines_mtx);
+
+	return expired(key, now);
+}
+
+expiry_index::persistent_deadline expiry_index::to_persistent(time_point deadline)
+{
+	auto remaining = deadline - clock_type::now();
+	auto wall = std::chrono::system_clock::now() +
+		std::chrono::duration_cast<std::chrono::system_clock::duration>(remaining);
+
+	return static_cast<persistent_deadline>(
+		std::chrono::duration_cast<std::chrono::milliseconds>(
+			wall.time_since_epoch())
+			.count());
+}
+
+expiry_index::time_point expiry_index::from_persistent(persistent_deadline deadline)
+{
+	auto wall = std::chrono::system_clock::time_point(
+		std::chrono::milliseconds(static_cast<int64_t>(deadline)));
+	auto remaining = wall - std::chrono::system_clock::now();
+
+	return clock_type::now() + std::chrono::duration_cast<clock_type::duration>(remaining);
+}
+
+/*
+ * Shards are visited round-robin, starting where the previous call stopped, so
+ * a limited number of removals is spread over all shards.
+ */
+std::size_t expiry_index::reap(time_point now, std::size_t max,
+			       const remove_function &remove)
+{
+	std::size_t removed = 0;
+
+	for (std::size_t n = 0; n < shards.size() && removed < max; n++) {
+		auto &s = *shards[next_shard];
+		next_shard = (next_shard + 1) % shards.size();
+
+		lock_type lock(s.mtx);
+
+		while (removed < max && !s.buckets.empty() &&
+		       s.buckets.begin()->first <= now) {
+			auto &keys = s.buckets.begin()->second;
+
+			while (removed < max && !keys.empty()) {
+				auto key = std::move(keys.back());
+				keys.pop_back();
+
+				/* key was removed or put again with a new deadline */
+				auto it = s.deadlines.find(key);
+				if (it == s.deadlines.end() || it->second > now)
+					continue;
+
+				{
+					lock_type deadlines_lock(s.deadlines_mtx);
+					s.deadlines.erase(it);
+				}
+				remove(string_view(key.data(), key.size()));
+				removed++;
+			}
+
+			if (keys.empty())
+				s.buckets.erase(s.buckets.begin());
+		}
+
+		update_earliest(s);
+	}
+
+	return removed;
+}
+
+expiry_reaper::expiry_reaper(expiry_index &index, std::size_t rate,
+			     expiry_index::remove_function remove)
+    : index(index),
+      rate(rate),
+      remove(std::move(remove)),
+      next_step(expiry_index::clock_type::now())
+{
+}
+
+expiry_reaper::~expiry_reaper()
+{
+	{
+		std::unique_lock<std::mutex> lock(mtx);
+		stop = true;
+		stop_cv.notify_all();
+	}
+
+	if (thread.joinable())
+		thread.join();
+}
+
+void expiry_reaper::start()
+{
+	if (rate == 0)
+		return;
+
+	thread = std::thread([this] { run(); });
+}
+
+std::size_t expiry_reaper::step()
+{
+	if (rate == 0 || !index.active())
+		return 0;
+
+	auto now = expiry_index::clock_type::now();
+	if (now < next_step)
+		return 0;
+
+	next_step = now + reap_interval;
+
+	auto max = rate * static_cast<std::size_t>(reap_interval.count()) / 1000;
+
+	return index.reap(now, max > 0 ? max : 1, remove);
+}
+
+void expiry_reaper::run()
+{
+	std::unique_lock<std::mutex> lock(mtx);
+
+	while (!stop) {
+		lock.unlock();
+		try {
+			step();
+		} catch (...) {
+			/* record which failed to be removed stays in the engine */
+		}
+		lock.lock();
+
+		stop_cv.wait_for(lock, reap_interval, [&] { return stop; });
+	}
+}
+
+} /* namespace internal */
+} /* namespace kv */
+} /* namespace pmem */
@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#ifndef LIBPMEMKV_EXPIRY_H
+#define LIBPMEMKV_EXPIRY_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "libpmemkv.hpp"
+
+namespace pmem
+{
+namespace kv
+{
+namespace internal
+{
+
+/* Default maximum number of expired records removed per second */
+#define TTL_REAP_RATE_DEFAULT 10000
+
+/**
+ * expiry_index keeps deadlines of records put with a time-to-live (see
+ * engine_base::put_with_ttl()). Engines use it to hide expired records from
+ * point lookups (lazy expiry) and expiry_reaper uses it to find records to
+ * remove, without scanning the whole engine.
+ *
+ * Deadlines are kept in DRAM, split into shards by hash of the key. Engines
+ * persist them separately (see to_persistent()) and set them again when the
+ * database is opened. Every shard
+ * maps keys to their deadlines and groups keys in time buckets (deadline
+ * rounded up to bucket_width), so only buckets which are already due have to
+ * be visited. Bucket entries are not removed when a key is overwritten or
+ * removed - they are verified against the current deadline of the key when
+ * the bucket is processed.
+ *
+ * A shard's mutex has to be held while a record with a key from this shard is
+ * modified (see lock()), so a record overwritten after it expired is never
+ * removed by the reaper. Shards are not locked at all until the first deadline
+ * is set (see active()). Writers hold the shard's mutex while they wait for
+ * locks of records, so is_expired() (called by readers, which may hold locks
+ * of other records) takes only a separate mutex of the shard's deadlines.
+ */
+class expiry_index {
+public:
+	using clock_type = std::chrono::steady_clock;
+	using time_point = clock_type::time_point;
+	/* Deadline stored by engines: milliseconds since the system clock's epoch */
+	using persistent_deadline = uint64_t;
+	using lock_type = std::unique_lock<std::mutex>;
+	using remove_function = std::function<void(string_view key)>;
+
+	expiry_index(std::size_t shards_number = 64,
+		     clock_type::duration bucket_width = std::chrono::milliseconds(100));
+
+	expiry_index(const expiry_index &) = delete;
+	expiry_index &operator=(const expiry_index &) = delete;
+
+	/* Returns false if no deadline was ever set */
+	bool active() const
+	{
+		return active_.load(std::memory_order_acquire);
+	}
+
+	/* Locks the shard of the key */
+	lock_type lock(string_view key);
+
+	/* Locks the shard of the key if active(), returns not owning lock otherwise */
+	lock_type lock_if_active(string_view key);
+
+	/*
+	 * Below three methods must be called with the key's shard locked. clear()
+	 * returns false if the key had no deadline.
+	 */
+	void set(string_view key, time_point deadline);
+	bool clear(string_view key);
+	bool expired(string_view key, time_point now);
+
+	/*
+	 * Checks if the key has expired. It does not lock the key's shard, so it
+	 * can be called with locks of records held. Deadlines of the shard are
+	 * locked only if its earliest deadline has already passed.
+	 */
+	bool is_expired(string_view key);
+
+	/*
+	 * Converts deadlines to and from their persistent form. Time points of the
+	 * steady clock are not valid after restart, so the system clock is used.
+	 */
+	static persistent_deadline to_persistent(time_point deadline);
+	static time_point from_persistent(persistent_deadline deadline);
+
+	/*
+	 * Calls remove() (with the shard locked) for at most max keys, which
+	 * expired before now, and forgets their deadlines. Returns number of
+	 * removed keys. It must not be called concurrently with itself.
+	 */
+	std::size_t reap(time_point now, std::size_t max, const remove_function &remove);
+
+private:
+	struct shard {
+		std::mutex mtx;
+		std::unordered_map<std::string, time_point> deadlines;
+		/* held (besides mtx) while deadlines are modified, see is_expired() */
+		std::mutex deadlines_mtx;
+		std::map<time_point, std::vector<std::string>> buckets;
+		/* lower bound of deadlines in the shard, read without the lock */
+		std::atomic<clock_type::rep> earliest;
+	};
+
+	shard &shard_of(string_view key);
+	void update_earliest(shard &s);
+
+	std::vector<std::unique_ptr<shard>> shards;
+	clock_type::duration bucket_width;
+	std::atomic<bool> active_;
+	std::size_t next_shard = 0;
+};
+
+/**
+ * expiry_reaper removes expired records found in an expiry_index, at most rate
+ * records per second. Engines which are thread-safe start() it, so records are
+ * removed by a background thread; single-threaded engines call step() from
+ * their write operations instead.
+ */
+class expiry_reaper {
+public:
+	expiry_reaper(expiry_index &index, std::size_t rate,
+		      expiry_index::remove_function remove);
+
+	/* Stops the background thread (if any) */
+	~expiry_reaper();
+
+	expiry_reaper(const expiry_reaper &) = delete;
+	expiry_reaper &operator=(const expiry_reaper &) = delete;
+
+	void start();
+
+	/* Removes expired records, if the rate limit allows it */
+	std::size_t step();
+
+private:
+	void run();
+
+	expiry_index &index;
+	std::size_t rate;
+	expiry_index::remove_function remove;
+	expiry_index::time_point next_step;
+
+	std::mutex mtx;
+	std::condition_variable stop_cv;
+	bool stop = false;
+	std::thread thread;
+};
+
+} /* namespace internal */
+} /* namespace kv */
+} /* namespace pmem */
+
+#endif /* LIBPMEMKV_EXPIRY_H */
@@ -0,0 +1,227 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "flight_recorder.h"
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace pmem
+{
+namespace kv
+{
+namespace internal
+{
+
+constexpr uint64_t flight_recorder::FATAL_DUMP_INTERVAL_NS;
+
+static uint64_t to_ns(flight_recorder::clock_type::duration d)
+{
+	return static_cast<uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+}
+
+static std::size_t round_up_pow2(std::size_t n)
+{
+	std::size_t size = 1;
+	while (size < n)
+		size <<= 1;
+
+	return size;
+}
+
+flight_recorder::ring::ring(std::size_t size, std::thread::id tid)
+    : entries(new entry[size]()), mask(size - 1), tid(tid)
+{
+	/* value-initialization above zeroes all sequence numbers */
+}
+
+flight_recorder::flight_recorder(std::size_t entries, const std::string &fatal_dump_path)
+    : id([] {
+	      static std::atomic<uint64_t> next_id(1);
+	      return next_id.fetch_add(1, std::memory_order_relaxed);
+      }()),
+      entries(round_up_pow2(entries)),
+      fatal_dump_path(fatal_dump_path),
+      last_fatal_dump_ns(0)
+{
+}
+
+void flight_recorder::record(op_type op, uint64_t key_hash,
+			     clock_type::time_point start, clock_type::duration latency,
+			     status s)
+{
+	ring *r;
+	try {
+		r = &local_ring();
+	} catch (std::exception &) {
+		/* registering the thread failed (out of memory), skip the record;
+		 * it may be called from a destructor, so it must not throw */
+		return;
+	}
+
+	auto &e = r->entries[r->head & r->mask];
+	r->head++;
+
+	/* invalidate the entry before overwriting it, for concurrent dumps */
+	e.seq.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	e.start_ns.store(to_ns(start.time_since_epoch()), std::memory_order_relaxed);
+	e.key_hash.store(key_hash, std::memory_order_relaxed);
+	e.info.store(to_ns(latency) << 16 | static_cast<uint64_t>(op) << 8 |
+			     static_cast<uint64_t>(s),
+		     std::memory_order_relaxed);
+	e.seq.store(r->head, std::memory_order_release);
+
+	if (is_fatal(s) && !fatal_dump_path.empty())
+		fatal_dump(to_ns(start.time_since_epoch() + latency));
+}
+
+void flight_recorder::dump(const std::string &path) const
+{
+	struct op {
+		uint64_t seq;
+		uint64_t start_ns;
+		uint64_t key_hash;
+		uint64_t info;
+	};
+
+	std::ofstream out(path, std::ios::trunc);
+	if (!out)
+		throw std::runtime_error("Cannot open flight recorder dump file: " +
+					 path);
+
+	/* steady clock has no defined epoch, convert its time points to UTC */
+	auto steady_now = clock_type::now();
+	auto system_now = std::chrono::system_clock::now();
+	auto to_system = [&](uint64_t ns) {
+		auto ago = std::chrono::duration_cast<std::chrono::system_clock::duration>(
+			steady_now.time_since_epoch() - std::chrono::nanoseconds(ns));
+		return system_now - ago;
+	};
+
+	out << "# pmemkv flight recorder, " << entries << " operations per thread\n"
+	    << "# start (UTC) op key_hash latency_ns status\n";
+
+	std::lock_guard<std::mutex> guard(rings_lock);
+	for (auto &r : rings) {
+		std::vector<op> ops;
+		for (std::size_t i = 0; i <= r->mask; i++) {
+			auto &e = r->entries[i];
+			op o;
+			o.seq = e.seq.load(std::memory_order_acquire);
+			if (o.seq == 0)
+				continue;
+
+			o.start_ns = e.start_ns.load(std::memory_order_relaxed);
+			o.key_hash = e.key_hash.load(std::memory_order_relaxed);
+			o.info = e.info.load(std::memory_order_relaxed);
+
+			/* skip the entry if its owner overwrote it in the meantime */
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (e.seq.load(std::memory_order_relaxed) != o.seq)
+				continue;
+
+			ops.push_back(o);
+		}
+
+		std::sort(ops.begin(), ops.end(),
+			  [](const op &a, const op &b) { return a.seq < b.seq; });
+
+		out << "thread " << r->tid << "\n";
+		for (auto &o : ops) {
+			auto start = to_system(o.start_ns);
+			auto t = std::chrono::system_clock::to_time_t(start);
+			auto ns = to_ns(start.time_since_epoch()) % 1000000000;
+			std::tm tm;
+			gmtime_r(&t, &tm);
+
+			auto op_id = static_cast<op_type>((o.info >> 8) & 0xff);
+			auto s = static_cast<status>(o.info & 0xff);
+
+			out << std::put_time(&tm, "%Y-%m-%dT%H:%M:%S") << "."
+			    << std::setfill('0') << std::setw(9) << ns << std::setfill(' ')
+			    << " " << stats::op_name(op_id) << " 0x" << std::hex
+			    << std::setw(16) << std::setfill('0') << o.key_hash << std::dec
+			    << std::setfill(' ') << " " << (o.info >> 16) << " " << s
+			    << "\n";
+		}
+	}
+
+	out.flush();
+	if (!out)
+		throw std::runtime_error("Cannot write flight recorder dump file: " +
+					 path);
+}
+
+bool flight_recorder::is_fatal(status s)
+{
+	return s == status::UNKNOWN_ERROR || s == status::OUT_OF_MEMORY ||
+		s == status::TRANSACTION_SCOPE_ERROR;
+}
+
+/*
+ * Every thread caches rings of the last few recorders it used (a thread may
+ * use multiple databases), so rings_lock is taken only on a cache miss. Ids
+ * of recorders are never reused, so entries of destroyed recorders are never
+ * matched - they are just replaced, oldest first.
+ */
+flight_recorder::ring &flight_recorder::local_ring()
+{
+	static constexpr std::size_t CACHED_RINGS = 8;
+
+	struct cached_ring {
+		uint64_t recorder_id;
+		ring *r;
+	};
+	struct ring_cache {
+		cached_ring rings[CACHED_RINGS];
+		std::size_t next;
+	};
+	thread_local ring_cache cache = {};
+
+	for (auto &c : cache.rings) {
+		if (c.recorder_id == id)
+			return *c.r;
+	}
+
+	auto tid = std::this_thread::get_id();
+	std::lock_guard<std::mutex> guard(rings_lock);
+
+	auto it = std::find_if(rings.begin(), rings.end(),
+			       [&](const std::unique_ptr<ring> &r) { return r->tid == tid; });
+	if (it == rings.end()) {
+		std::unique_ptr<ring> r(new ring(entries, tid));
+		rings.push_back(std::move(r));
+		it = rings.end() - 1;
+	}
+
+	auto &c = cache.rings[cache.next];
+	cache.next = (cache.next + 1) % CACHED_RINGS;
+
+	c = {id, it->get()};
+	return *c.r;
+}
+
+void flight_recorder::fatal_dump(uint64_t now_ns)
+{
+	auto last = last_fatal_dump_ns.load(std::memory_order_relaxed);
+	if (last != 0 && now_ns - last < FATAL_DUMP_INTERVAL_NS)
+		return;
+	if (!last_fatal_dump_ns.compare_exchange_strong(last, now_ns))
+		return;
+
+	try {
+		dump(fatal_dump_path);
+	} catch (std::exception &) {
+		/* the error of the operation itself is the one to report */
+	}
+}
+
+} /* namespace internal */
+} /* namespace kv */
+} /* namespace pmem */
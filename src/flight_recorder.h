@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#ifndef LIBPMEMKV_FLIGHT_RECORDER_H
+#define LIBPMEMKV_FLIGHT_RECORDER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "libpmemkv.hpp"
+#include "stats.h"
+
+namespace pmem
+{
+namespace kv
+{
+namespace internal
+{
+
+/**
+ * flight_recorder keeps the last operations of every thread (type, hash of the
+ * key, start time, latency and status) of a single engine instance, so they
+ * can be dumped to a file after an incident. It's created by pmemkv_open() if
+ * "flight_recorder" config item (number of operations kept per thread) is set.
+ *
+ * Every thread writes only to its own ring buffer, registered on its first
+ * operation, so recording takes no locks and no read-modify-write atomics.
+ * Entries are guarded by sequence numbers (as in a seqlock): a reader (dump)
+ * skips an entry which was overwritten while being copied. Rings of exited
+ * threads are kept (and reused by new threads with the same id), so their
+ * operations can be dumped as well.
+ */
+class flight_recorder {
+public:
+	using op_type = stats::op_type;
+	using clock_type = stats::clock_type;
+
+	/* entries per thread are rounded up to a power of two */
+	flight_recorder(std::size_t entries, const std::string &fatal_dump_path);
+
+	void record(op_type op, uint64_t key_hash, clock_type::time_point start,
+		    clock_type::duration latency, status s);
+
+	/* Writes all recorded operations, oldest first, to a text file */
+	void dump(const std::string &path) const;
+
+private:
+	/* dump after a fatal error at most once per this interval */
+	static constexpr uint64_t FATAL_DUMP_INTERVAL_NS = 1000000000;
+
+	struct entry {
+		/* position in the ring + 1, 0 while the entry is written */
+		std::atomic<uint64_t> seq;
+		std::atomic<uint64_t> start_ns;
+		std::atomic<uint64_t> key_hash;
+		/* latency_ns << 16 | op << 8 | status */
+		std::atomic<uint64_t> info;
+	};
+
+	struct ring {
+		ring(std::size_t size, std::thread::id tid);
+
+		std::unique_ptr<entry[]> entries;
+		std::size_t mask;
+		/* written only by the owning thread */
+		uint64_t head = 0;
+		std::thread::id tid;
+	};
+
+	static bool is_fatal(status s);
+
+	ring &local_ring();
+	void fatal_dump(uint64_t now_ns);
+
+	/* distinguishes recorders in per-thread caches of rings */
+	const uint64_t id;
+	const std::size_t entries;
+	const std::string fatal_dump_path;
+	std::atomic<uint64_t> last_fatal_dump_ns;
+
+	mutable std::mutex rings_lock;
+	std::vector<std::unique_ptr<ring>> rings;
+};
+
+} /* namespace internal */
+} /* namespace kv */
+} /* namespace pmem */
+
+#endif /* LIBPMEMKV_FLIGHT_RECORDER_H */
@@ -1,8 +1,10 @@
 // SPDX-License-Identifier: BSD-3-Clause
-/* Copyright 2020, Intel Corporation */
+/* Copyright 2020-2021, Intel Corporation */
 
 #include "iterator.h"
 
+#include <limits>
+
 namespace pmem
 {
 namespace kv
@@ -30,6 +32,11 @@ status iterator_base::seek_higher_eq(string_view key)
 	return status::NOT_SUPPORTED;
 }
 
+status iterator_base::seek_prefix(string_view prefix)
+{
+	return status::NOT_SUPPORTED;
+}
+
 status iterator_base::seek_to_first()
 {
 	return status::NOT_SUPPORTED;
@@ -55,6 +62,35 @@ status iterator_base::prev()
 	return status::NOT_SUPPORTED;
 }
 
+/*
+ * Default implementation reads records one by one, with key(), read_range()
+ * and next(). Sorted engines read them directly from their containers.
+ */
+status iterator_base::read_batch(pmemkv_iterator_entry *entries, size_t n,
+				 size_t &count)
+{
+	count = 0;
+	while (count < n) {
+		auto key_res = key();
+		if (!key_res.is_ok())
+			return key_res.get_status();
+
+		auto value_res = read_range(0, std::numeric_limits<size_t>::max());
+		if (!value_res.is_ok())
+			return value_res.get_status();
+
+		auto key = std::move(key_res).get_value();
+		auto value = std::move(value_res).get_value();
+		entries[count++] = {key.data(), key.size(), value.begin(), value.size()};
+
+		auto s = next();
+		if (s != status::OK)
+			return s;
+	}
+
+	return status::OK;
+}
+
 result<pmem::obj::slice<char *>> iterator_base::write_range(size_t pos, size_t n)
 {
 	return {status::NOT_SUPPORTED};
@@ -25,6 +25,7 @@ public:
 	virtual status seek_lower_eq(string_view key);
 	virtual status seek_higher(string_view key);
 	virtual status seek_higher_eq(string_view key);
+	virtual status seek_prefix(string_view prefix);
 
 	virtual status seek_to_first();
 	virtual status seek_to_last();
@@ -36,6 +37,8 @@ public:
 	virtual result<string_view> key() = 0;
 	virtual result<pmem::obj::slice<const char *>> read_range(size_t pos,
 								  size_t n) = 0;
+	virtual status read_batch(pmemkv_iterator_entry *entries, size_t n,
+				  size_t &count);
 
 	virtual result<pmem::obj::slice<char *>> write_range(size_t pos, size_t n);
 
@@ -54,6 +57,36 @@ std::size_t distance(It first, It last)
 	return static_cast<std::size_t>(dist);
 }
 
+/**
+ * Checks if the key starts with the prefix (in binary representation).
+ */
+static inline bool has_prefix(string_view key, string_view prefix)
+{
+	return key.size() >= prefix.size() &&
+		string_view(key.data(), prefix.size()).compare(prefix) == 0;
+}
+
+/**
+ * Sets bound to the smallest key (in binary representation) greater than all
+ * keys starting with the prefix. Returns false if there is no such key (the
+ * prefix is empty or consists of 0xFF bytes only).
+ */
+static inline bool prefix_upper_bound(string_view prefix, std::string &bound)
+{
+	bound.assign(prefix.data(), prefix.size());
+
+	while (!bound.empty()) {
+		auto last = static_cast<unsigned char>(bound.back());
+		if (last != 0xFF) {
+			bound.back() = static_cast<char>(last + 1);
+			return true;
+		}
+		bound.pop_back();
+	}
+
+	return false;
+}
+
 /**
  * Helper function to iterate between specified range and execute
  * callback on every item.
@@ -70,6 +103,39 @@ status iterate_through_pairs(It first, It last, get_kv_callback *callback, void
 	return status::OK;
 }
 
+/**
+ * Helper function to iterate between specified range and execute
+ * callback on the key of every item (values are not accessed).
+ */
+template <typename It>
+status iterate_through_keys(It first, It last, get_k_callback *callback, void *arg)
+{
+	for (auto it = first; it != last; ++it) {
+		auto ret = callback(it->first.c_str(), it->first.size(), arg);
+		if (ret != 0)
+			return status::STOPPED_BY_CB;
+	}
+	return status::OK;
+}
+
+/**
+ * Helper function to iterate between specified range in descending order
+ * (starting with the element preceding last) and execute callback on every item.
+ */
+template <typename It>
+status iterate_through_pairs_desc(It first, It last, get_kv_callback *callback,
+				  void *arg)
+{
+	while (last != first) {
+		--last;
+		auto ret = callback(last->first.c_str(), last->first.size(),
+				    last->second.c_str(), last->second.size(), arg);
+		if (ret != 0)
+			return status::STOPPED_BY_CB;
+	}
+	return status::OK;
+}
+
 } /* namespace internal */
 } /* namespace kv */
 } /* namespace pmem */
@@ -5,6 +5,7 @@
 
 #include <sys/stat.h>
 
+#include "bulk_load.h"
 #include "comparator/comparator.h"
 #include "config.h"
 #include "engine.h"
@@ -13,15 +14,28 @@
 #include "libpmemkv.h"
 #include "libpmemkv.hpp"
 #include "libpmemobj++/pexceptions.hpp"
+#include "merge_operator.h"
 #include "out.h"
+#include "probes.h"
+#include "snapshot.h"
+#include "stats.h"
 #include "transaction.h"
+#include "write_batch.h"
 
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+/* Default size of a queue of each async worker */
+#define ASYNC_QUEUE_SIZE_DEFAULT 1024
+/* Default maximum number of puts coalesced into a single batch by async worker */
+#define ASYNC_MAX_BATCH_DEFAULT 64
+/* Maximum time-to-live of a record (10 years), so the deadline never overflows */
+#define TTL_MAX_MS (10ULL * 365 * 24 * 3600 * 1000)
+
 static inline pmemkv_config *config_from_internal(pmem::kv::internal::config *config)
 {
 	return reinterpret_cast<pmemkv_config *>(config);
@@ -44,6 +58,18 @@ comparator_to_internal(pmemkv_comparator *comparator)
 	return reinterpret_cast<pmem::kv::internal::comparator *>(comparator);
 }
 
+static inline pmemkv_merge_operator *
+merge_operator_from_internal(pmem::kv::internal::merge_operator *merge_operator)
+{
+	return reinterpret_cast<pmemkv_merge_operator *>(merge_operator);
+}
+
+static inline pmem::kv::internal::merge_operator *
+merge_operator_to_internal(pmemkv_merge_operator *merge_operator)
+{
+	return reinterpret_cast<pmem::kv::internal::merge_operator *>(merge_operator);
+}
+
 static inline pmem::kv::engine_base *db_to_internal(pmemkv_db *db)
 {
 	return reinterpret_cast<pmem::kv::engine_base *>(db);
@@ -64,6 +90,52 @@ static inline pmem::kv::internal::transaction *tx_to_internal(pmemkv_tx *tx)
 	return reinterpret_cast<pmem::kv::internal::transaction *>(tx);
 }
 
+static inline pmemkv_scan_cursor *
+scan_cursor_from_internal(pmem::kv::internal::scan_cursor *cursor)
+{
+	return reinterpret_cast<pmemkv_scan_cursor *>(cursor);
+}
+
+static inline pmem::kv::internal::scan_cursor *
+scan_cursor_to_internal(pmemkv_scan_cursor *cursor)
+{
+	return reinterpret_cast<pmem::kv::internal::scan_cursor *>(cursor);
+}
+
+static inline pmemkv_pinned_value *
+pinned_value_from_internal(pmem::kv::internal::pinned_value *pv)
+{
+	return reinterpret_cast<pmemkv_pinned_value *>(pv);
+}
+
+static inline pmem::kv::internal::pinned_value *
+pinned_value_to_internal(pmemkv_pinned_value *pv)
+{
+	return reinterpret_cast<pmem::kv::internal::pinned_value *>(pv);
+}
+
+static inline pmemkv_snapshot *snapshot_from_internal(pmem::kv::internal::snapshot *sn)
+{
+	return reinterpret_cast<pmemkv_snapshot *>(sn);
+}
+
+static inline pmem::kv::internal::snapshot *snapshot_to_internal(pmemkv_snapshot *sn)
+{
+	return reinterpret_cast<pmem::kv::internal::snapshot *>(sn);
+}
+
+static inline pmemkv_write_batch *
+write_batch_from_internal(pmem::kv::internal::write_batch *batch)
+{
+	return reinterpret_cast<pmemkv_write_batch *>(batch);
+}
+
+static inline pmem::kv::internal::write_batch *
+write_batch_to_internal(pmemkv_write_batch *batch)
+{
+	return reinterpret_cast<pmem::kv::internal::write_batch *>(batch);
+}
+
 pmem::kv::internal::iterator_base *iterator_to_base(pmemkv_iterator *it)
 {
 	return reinterpret_cast<pmem::kv::internal::iterator_base *>(it);
@@ -78,6 +150,8 @@ iterator_from_internal(pmem::kv::internal::iterator_base *it)
 template <typename Function>
 static inline int catch_and_return_status(const char *func_name, Function &&f)
 {
+	PMEMKV_PROBE1(op_entry, func_name);
+
 	int status = PMEMKV_STATUS_UNKNOWN_ERROR;
 	try {
 		status = static_cast<int>(f());
@@ -104,9 +178,43 @@ static inline int catch_and_return_status(const char *func_name, Function &&f)
 		status = PMEMKV_STATUS_UNKNOWN_ERROR;
 	}
 	set_last_status(status);
+
+	PMEMKV_PROBE2(op_exit, func_name, status);
 	return status;
 }
 
+/* Passes value to the user's callback and remembers its size for stats */
+struct GetStatsCallbackContext {
+	pmemkv_get_v_callback *c;
+	void *arg;
+	size_t value_size;
+};
+
+static void get_stats_callback(const char *v, size_t vb, void *arg)
+{
+	const auto ctx = static_cast<GetStatsCallbackContext *>(arg);
+
+	ctx->value_size = vb;
+	ctx->c(v, vb, ctx->arg);
+}
+
+static pmem::kv::status get_with_stats(pmem::kv::engine_base *engine,
+				       pmem::kv::string_view key,
+				       pmemkv_get_v_callback *c, void *arg)
+{
+	auto stats = engine->op_stats();
+	auto recorder = engine->op_recorder();
+	auto slow_ops = engine->slow_ops();
+	if (!stats && !recorder && !slow_ops)
+		return engine->get(key, c, arg);
+
+	pmem::kv::internal::stats::op_timer timer(
+		stats, recorder, slow_ops, pmem::kv::internal::stats::op_type::get, key);
+	GetStatsCallbackContext ctx = {c, arg, 0};
+
+	return timer.finish(engine->get(key, &get_stats_callback, &ctx), ctx.value_size);
+}
+
 extern "C" {
 
 pmemkv_config *pmemkv_config_new(void)
@@ -236,6 +344,14 @@ int pmemkv_config_put_comparator(pmemkv_config *config, pmemkv_comparator *compa
 					(void (*)(void *)) & pmemkv_comparator_delete);
 }
 
+int pmemkv_config_put_merge_operator(pmemkv_config *config,
+				     pmemkv_merge_operator *merge_operator)
+{
+	return pmemkv_config_put_object(
+		config, "merge_operator", merge_operator,
+		(void (*)(void *)) & pmemkv_merge_operator_delete);
+}
+
 int pmemkv_config_put_oid(pmemkv_config *config, PMEMoid *oid)
 {
 	return pmemkv_config_put_object(config, "oid", oid, NULL);
@@ -333,13 +449,111 @@ void pmemkv_comparator_delete(pmemkv_comparator *comparator)
 	}
 }
 
+pmemkv_merge_operator *pmemkv_merge_operator_new(pmemkv_merge_function *fn,
+						 const char *name, void *arg)
+{
+	if (!fn || !name) {
+		ERR() << "merge function and name must not be NULL";
+		return nullptr;
+	}
+
+	try {
+		return merge_operator_from_internal(
+			new pmem::kv::internal::merge_operator(fn, name, arg));
+	} catch (const std::exception &exc) {
+		ERR() << exc.what();
+		return nullptr;
+	} catch (...) {
+		ERR() << "Unspecified failure";
+		return nullptr;
+	}
+}
+
+void pmemkv_merge_operator_delete(pmemkv_merge_operator *merge_operator)
+{
+	try {
+		delete merge_operator_to_internal(merge_operator);
+	} catch (const std::exception &exc) {
+		ERR() << exc.what();
+	} catch (...) {
+		ERR() << "Unspecified failure";
+	}
+}
+
+/*
+ * Both values are 8-byte unsigned integers in native byte order; a missing
+ * record is treated as 0. The sum wraps around on overflow.
+ */
+int pmemkv_merge_uint64_add(const char *key, size_t keybytes, const char *existing_value,
+			    size_t existing_valuebytes, const char *operand,
+			    size_t operandbytes, pmemkv_get_v_callback *c, void *c_arg,
+			    void *arg)
+{
+	(void)key;
+	(void)keybytes;
+	(void)arg;
+
+	uint64_t value = 0;
+	uint64_t addend;
+
+	if (operandbytes != sizeof(addend))
+		return 1;
+	if (existing_value && existing_valuebytes != sizeof(value))
+		return 1;
+
+	if (existing_value)
+		std::memcpy(&value, existing_value, sizeof(value));
+	std::memcpy(&addend, operand, sizeof(addend));
+
+	value += addend;
+	c(reinterpret_cast<const char *>(&value), sizeof(value), c_arg);
+
+	return 0;
+}
+
+int pmemkv_merge_append(const char *key, size_t keybytes, const char *existing_value,
+			size_t existing_valuebytes, const char *operand,
+			size_t operandbytes, pmemkv_get_v_callback *c, void *c_arg,
+			void *arg)
+{
+	(void)key;
+	(void)keybytes;
+	(void)arg;
+
+	try {
+		std::string value;
+		value.reserve(existing_valuebytes + operandbytes);
+		value.append(existing_value, existing_valuebytes);
+		value.append(operand, operandbytes);
+
+		c(value.data(), value.size(), c_arg);
+	} catch (const std::exception &exc) {
+		ERR() << exc.what();
+		return 1;
+	}
+
+	return 0;
+}
+
 int pmemkv_tx_begin(pmemkv_db *db, pmemkv_tx **tx)
 {
 	if (!tx || !db)
 		return PMEMKV_STATUS_INVALID_ARGUMENT;
 
 	return catch_and_return_status(__func__, [&] {
-		*tx = tx_from_internal(db_to_internal(db)->begin_tx());
+		auto engine = db_to_internal(db);
+		std::unique_ptr<pmem::kv::internal::transaction> internal_tx(
+			engine->begin_tx());
+
+		auto stats = engine->op_stats();
+		auto recorder = engine->op_recorder();
+		auto slow_ops = engine->slow_ops();
+		if (stats || recorder || slow_ops)
+			internal_tx.reset(new pmem::kv::internal::stats_transaction(
+				std::move(internal_tx), stats, recorder, slow_ops));
+
+		*tx = tx_from_internal(internal_tx.release());
+		PMEMKV_PROBE1(tx_begin, *tx);
 		return PMEMKV_STATUS_OK;
 	});
 }
@@ -372,7 +586,11 @@ int pmemkv_tx_commit(pmemkv_tx *tx)
 
 	auto internal_tx = tx_to_internal(tx);
 
-	return catch_and_return_status(__func__, [&] { return internal_tx->commit(); });
+	PMEMKV_PROBE1(tx_commit, tx);
+	auto s = catch_and_return_status(__func__, [&] { return internal_tx->commit(); });
+	PMEMKV_PROBE2(tx_commit_done, tx, s);
+
+	return s;
 }
 
 void pmemkv_tx_abort(pmemkv_tx *tx)
@@ -382,6 +600,7 @@ void pmemkv_tx_abort(pmemkv_tx *tx)
 
 	auto internal_tx = tx_to_internal(tx);
 
+	PMEMKV_PROBE1(tx_abort, tx);
 	try {
 		internal_tx->abort();
 	} catch (const std::exception &exc) {
@@ -404,6 +623,82 @@ void pmemkv_tx_end(pmemkv_tx *tx)
 	}
 }
 
+pmemkv_write_batch *pmemkv_write_batch_new(void)
+{
+	try {
+		return write_batch_from_internal(new pmem::kv::internal::write_batch);
+	} catch (const std::exception &exc) {
+		ERR() << exc.what();
+		return nullptr;
+	} catch (...) {
+		ERR() << "Unspecified failure";
+		return nullptr;
+	}
+}
+
+void pmemkv_write_batch_delete(pmemkv_write_batch *batch)
+{
+	try {
+		delete write_batch_to_internal(batch);
+	} catch (const std::exception &exc) {
+		ERR() << exc.what();
+	} catch (...) {
+		ERR() << "Unspecified failure";
+	}
+}
+
+int pmemkv_write_batch_put(pmemkv_write_batch *batch, const char *k, size_t kb,
+			   const char *v, size_t vb)
+{
+	if (!batch)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		write_batch_to_internal(batch)->put(pmem::kv::string_view(k, kb),
+						    pmem::kv::string_view(v, vb));
+		return PMEMKV_STATUS_OK;
+	});
+}
+
+int pmemkv_write_batch_remove(pmemkv_write_batch *batch, const char *k, size_t kb)
+{
+	if (!batch)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		write_batch_to_internal(batch)->remove(pmem::kv::string_view(k, kb));
+		return PMEMKV_STATUS_OK;
+	});
+}
+
+int pmemkv_write_batch_count(pmemkv_write_batch *batch, size_t *cnt)
+{
+	if (!batch || !cnt)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	*cnt = write_batch_to_internal(batch)->size();
+
+	return PMEMKV_STATUS_OK;
+}
+
+void pmemkv_write_batch_clear(pmemkv_write_batch *batch)
+{
+	if (!batch)
+		return;
+
+	write_batch_to_internal(batch)->clear();
+}
+
+int pmemkv_write(pmemkv_db *db, pmemkv_write_batch *batch)
+{
+	if (!db || !batch)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		return db_to_internal(db)->apply_batch(*write_batch_to_internal(batch));
+	});
+}
+
 int pmemkv_open(const char *engine_c_str, pmemkv_config *config, pmemkv_db **db)
 {
 	std::unique_ptr<pmem::kv::internal::config> cfg(config_to_internal(config));
@@ -412,9 +707,50 @@ int pmemkv_open(const char *engine_c_str, pmemkv_config *config, pmemkv_db **db)
 		return PMEMKV_STATUS_INVALID_ARGUMENT;
 
 	return catch_and_return_status(__func__, [&] {
+		uint64_t async_workers = 0;
+		uint64_t async_queue_size = ASYNC_QUEUE_SIZE_DEFAULT;
+		uint64_t async_max_batch = ASYNC_MAX_BATCH_DEFAULT;
+		uint64_t stats = 0;
+		uint64_t flight_recorder = 0;
+		uint64_t slow_op_threshold_us = 0;
+		std::string flight_recorder_path;
+		std::string bulk_load_path;
+		if (cfg) {
+			cfg->get_uint64("async_workers", &async_workers);
+			cfg->get_uint64("async_queue_size", &async_queue_size);
+			cfg->get_uint64("async_max_batch", &async_max_batch);
+			cfg->get_uint64("stats", &stats);
+			cfg->get_uint64("flight_recorder", &flight_recorder);
+			cfg->get_uint64("slow_op_threshold_us", &slow_op_threshold_us);
+
+			const char *path;
+			if (cfg->get_string("flight_recorder_path", &path))
+				flight_recorder_path = path;
+			if (cfg->get_string("bulk_load_path", &path))
+				bulk_load_path = path;
+		}
+
 		auto engine = pmem::kv::storage_engine_factory::create_engine(
 			engine_c_str, std::move(cfg));
 
+		if (stats)
+			engine->enable_stats();
+		if (flight_recorder)
+			engine->enable_flight_recorder(flight_recorder,
+						       flight_recorder_path);
+		if (slow_op_threshold_us)
+			engine->enable_slow_op_log(
+				std::chrono::microseconds(slow_op_threshold_us));
+
+		if (!bulk_load_path.empty()) {
+			pmem::kv::internal::file_source source(bulk_load_path);
+			auto s = engine->bulk_load(source);
+			if (s != pmem::kv::status::OK)
+				return static_cast<int>(s);
+		}
+
+		engine->start_async(async_workers, async_queue_size, async_max_batch);
+
 		*db = db_from_internal(engine.release());
 
 		return PMEMKV_STATUS_OK;
@@ -424,6 +760,10 @@ int pmemkv_open(const char *engine_c_str, pmemkv_config *config, pmemkv_db **db)
 void pmemkv_close(pmemkv_db *db)
 {
 	try {
+		/* pending async requests need the engine, so finish them first */
+		if (db)
+			db_to_internal(db)->stop_async();
+
 		delete db_to_internal(db);
 	} catch (const std::exception &exc) {
 		ERR() << exc.what();
@@ -498,6 +838,16 @@ int pmemkv_count_between(pmemkv_db *db, const char *k1, size_t kb1, const char *
 	});
 }
 
+int pmemkv_count_prefix(pmemkv_db *db, const char *p, size_t pb, size_t *cnt)
+{
+	if (!db || !cnt)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		return db_to_internal(db)->count_prefix(pmem::kv::string_view(p, pb), *cnt);
+	});
+}
+
 int pmemkv_get_all(pmemkv_db *db, pmemkv_get_kv_callback *c, void *arg)
 {
 	if (!db)
@@ -568,129 +918,729 @@ int pmemkv_get_between(pmemkv_db *db, const char *k1, size_t kb1, const char *k2
 	});
 }
 
-int pmemkv_exists(pmemkv_db *db, const char *k, size_t kb)
+int pmemkv_get_all_desc(pmemkv_db *db, pmemkv_get_kv_callback *c, void *arg)
+{
+	if (!db)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(
+		__func__, [&] { return db_to_internal(db)->get_all_desc(c, arg); });
+}
+
+int pmemkv_get_above_desc(pmemkv_db *db, const char *k, size_t kb,
+			  pmemkv_get_kv_callback *c, void *arg)
 {
 	if (!db)
 		return PMEMKV_STATUS_INVALID_ARGUMENT;
 
 	return catch_and_return_status(__func__, [&] {
-		return db_to_internal(db)->exists(pmem::kv::string_view(k, kb));
+		return db_to_internal(db)->get_above_desc(
+			pmem::kv::string_view(k, kb), c, arg);
 	});
 }
 
-int pmemkv_get(pmemkv_db *db, const char *k, size_t kb, pmemkv_get_v_callback *c,
-	       void *arg)
+int pmemkv_get_equal_above_desc(pmemkv_db *db, const char *k, size_t kb,
+				pmemkv_get_kv_callback *c, void *arg)
 {
 	if (!db)
 		return PMEMKV_STATUS_INVALID_ARGUMENT;
 
 	return catch_and_return_status(__func__, [&] {
-		return db_to_internal(db)->get(pmem::kv::string_view(k, kb), c, arg);
+		return db_to_internal(db)->get_equal_above_desc(
+			pmem::kv::string_view(k, kb), c, arg);
 	});
 }
 
-struct GetCopyCallbackContext {
-	int result;
+int pmemkv_get_equal_below_desc(pmemkv_db *db, const char *k, size_t kb,
+				pmemkv_get_kv_callback *c, void *arg)
+{
+	if (!db)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
 
-	size_t buffer_size;
-	char *buffer;
+	return catch_and_return_status(__func__, [&] {
+		return db_to_internal(db)->get_equal_below_desc(
+			pmem::kv::string_view(k, kb), c, arg);
+	});
+}
 
-	size_t *value_size;
-};
+int pmemkv_get_below_desc(pmemkv_db *db, const char *k, size_t kb,
+			  pmemkv_get_kv_callback *c, void *arg)
+{
+	if (!db)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
 
-static void get_copy_callback(const char *v, size_t vb, void *arg)
+	return catch_and_return_status(__func__, [&] {
+		return db_to_internal(db)->get_below_desc(
+			pmem::kv::string_view(k, kb), c, arg);
+	});
+}
+
+int pmemkv_get_between_desc(pmemkv_db *db, const char *k1, size_t kb1, const char *k2,
+			    size_t kb2, pmemkv_get_kv_callback *c, void *arg)
 {
-	const auto c = ((GetCopyCallbackContext *)arg);
+	if (!db)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
 
-	if (c->value_size != nullptr)
-		*(c->value_size) = vb;
+	return catch_and_return_status(__func__, [&] {
+		return db_to_internal(db)->get_between_desc(
+			pmem::kv::string_view(k1, kb1), pmem::kv::string_view(k2, kb2), c,
+			arg);
+	});
+}
 
-	if (vb <= c->buffer_size) {
-		c->result = PMEMKV_STATUS_OK;
-		if (c->buffer != nullptr)
-			memcpy(c->buffer, v, vb);
-	} else {
-		c->result = PMEMKV_STATUS_OUT_OF_MEMORY;
+pmemkv_scan_cursor *pmemkv_scan_cursor_new(size_t max_count, size_t max_bytes)
+{
+	try {
+		return scan_cursor_from_internal(
+			new pmem::kv::internal::scan_cursor(max_count, max_bytes));
+	} catch (const std::exception &exc) {
+		ERR() << exc.what();
+		return nullptr;
+	} catch (...) {
+		ERR() << "Unspecified failure";
+		return nullptr;
 	}
 }
 
-int pmemkv_get_copy(pmemkv_db *db, const char *k, size_t kb, char *buffer,
-		    size_t buffer_size, size_t *value_size)
+void pmemkv_scan_cursor_delete(pmemkv_scan_cursor *cursor)
 {
-	if (!db)
+	try {
+		delete scan_cursor_to_internal(cursor);
+	} catch (const std::exception &exc) {
+		ERR() << exc.what();
+	} catch (...) {
+		ERR() << "Unspecified failure";
+	}
+}
+
+int pmemkv_scan_cursor_next_key(pmemkv_scan_cursor *cursor, const char **k, size_t *kb)
+{
+	if (!cursor || !k || !kb)
 		return PMEMKV_STATUS_INVALID_ARGUMENT;
 
-	GetCopyCallbackContext ctx = {PMEMKV_STATUS_NOT_FOUND, buffer_size, buffer,
-				      value_size};
+	auto c = scan_cursor_to_internal(cursor);
+	if (!c->has_more())
+		return PMEMKV_STATUS_NOT_FOUND;
 
-	if (buffer != nullptr)
-		memset(buffer, 0, buffer_size);
+	auto key = c->next_key();
+	*k = key.data();
+	*kb = key.size();
 
-	auto ret = catch_and_return_status(__func__, [&] {
-		return db_to_internal(db)->get(pmem::kv::string_view(k, kb),
-					       &get_copy_callback, &ctx);
+	return PMEMKV_STATUS_OK;
+}
+
+int pmemkv_get_prefix(pmemkv_db *db, const char *p, size_t pb, pmemkv_get_kv_callback *c,
+		      void *arg)
+{
+	if (!db)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		return db_to_internal(db)->get_prefix(pmem::kv::string_view(p, pb), c,
+						      arg);
 	});
+}
 
-	if (ret != PMEMKV_STATUS_OK)
-		return ret;
+int pmemkv_get_keys(pmemkv_db *db, pmemkv_get_k_callback *c, void *arg)
+{
+	if (!db)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
 
-	return ctx.result;
+	return catch_and_return_status(
+		__func__, [&] { return db_to_internal(db)->get_keys(c, arg); });
 }
 
-int pmemkv_put(pmemkv_db *db, const char *k, size_t kb, const char *v, size_t vb)
+int pmemkv_get_keys_above(pmemkv_db *db, const char *k, size_t kb, pmemkv_get_k_callback *c,
+			  void *arg)
 {
 	if (!db)
 		return PMEMKV_STATUS_INVALID_ARGUMENT;
 
 	return catch_and_return_status(__func__, [&] {
-		return db_to_internal(db)->put(pmem::kv::string_view(k, kb),
-					       pmem::kv::string_view(v, vb));
+		return db_to_internal(db)->get_keys_above(pmem::kv::string_view(k, kb), c,
+							  arg);
 	});
 }
 
-int pmemkv_remove(pmemkv_db *db, const char *k, size_t kb)
+int pmemkv_get_keys_below(pmemkv_db *db, const char *k, size_t kb, pmemkv_get_k_callback *c,
+			  void *arg)
 {
 	if (!db)
 		return PMEMKV_STATUS_INVALID_ARGUMENT;
 
 	return catch_and_return_status(__func__, [&] {
-		return db_to_internal(db)->remove(pmem::kv::string_view(k, kb));
+		return db_to_internal(db)->get_keys_below(pmem::kv::string_view(k, kb), c,
+							  arg);
 	});
 }
 
-int pmemkv_defrag(pmemkv_db *db, double start_percent, double amount_percent)
+int pmemkv_get_keys_between(pmemkv_db *db, const char *k1, size_t kb1, const char *k2,
+			    size_t kb2, pmemkv_get_k_callback *c, void *arg)
 {
 	if (!db)
 		return PMEMKV_STATUS_INVALID_ARGUMENT;
 
 	return catch_and_return_status(__func__, [&] {
-		return db_to_internal(db)->defrag(start_percent, amount_percent);
+		return db_to_internal(db)->get_keys_between(pmem::kv::string_view(k1, kb1),
+							    pmem::kv::string_view(k2, kb2),
+							    c, arg);
 	});
 }
 
-int pmemkv_iterator_new(pmemkv_db *db, pmemkv_iterator **it)
+int pmemkv_get_above_page(pmemkv_db *db, const char *k, size_t kb,
+			  pmemkv_scan_cursor *cursor, pmemkv_get_kv_callback *c, void *arg)
 {
-	if (!db || !it)
+	if (!db || !cursor)
 		return PMEMKV_STATUS_INVALID_ARGUMENT;
 
 	return catch_and_return_status(__func__, [&] {
-		*it = iterator_from_internal(db_to_internal(db)->new_const_iterator());
-		return PMEMKV_STATUS_OK;
+		return db_to_internal(db)->get_above_page(
+			pmem::kv::string_view(k, kb), *scan_cursor_to_internal(cursor),
+			c, arg);
 	});
 }
 
-int pmemkv_write_iterator_new(pmemkv_db *db, pmemkv_write_iterator **it)
+int pmemkv_get_between_page(pmemkv_db *db, const char *k1, size_t kb1, const char *k2,
+			    size_t kb2, pmemkv_scan_cursor *cursor,
+			    pmemkv_get_kv_callback *c, void *arg)
 {
-	if (!db || !it)
+	if (!db || !cursor)
 		return PMEMKV_STATUS_INVALID_ARGUMENT;
 
 	return catch_and_return_status(__func__, [&] {
-		/* pmemkv_write_iterator is returned by pointer, not by copy to be
-		 * consistent with pmemkv_iterator */
-		auto unique_it = std::unique_ptr<pmemkv_write_iterator>(
-			new pmemkv_write_iterator());
-		unique_it->iter =
-			iterator_from_internal(db_to_internal(db)->new_iterator());
+		return db_to_internal(db)->get_between_page(
+			pmem::kv::string_view(k1, kb1), pmem::kv::string_view(k2, kb2),
+			*scan_cursor_to_internal(cursor), c, arg);
+	});
+}
+
+int pmemkv_exists(pmemkv_db *db, const char *k, size_t kb)
+{
+	if (!db)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		auto engine = db_to_internal(db);
+		pmem::kv::internal::stats::op_timer timer(
+			engine->op_stats(), engine->op_recorder(), engine->slow_ops(),
+			pmem::kv::internal::stats::op_type::exists,
+			pmem::kv::string_view(k, kb));
+
+		return timer.finish(engine->exists(pmem::kv::string_view(k, kb)), 0);
+	});
+}
+
+int pmemkv_get(pmemkv_db *db, const char *k, size_t kb, pmemkv_get_v_callback *c,
+	       void *arg)
+{
+	if (!db)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		return get_with_stats(db_to_internal(db), pmem::kv::string_view(k, kb), c,
+				      arg);
+	});
+}
+
+struct GetCopyCallbackContext {
+	int result;
+
+	size_t buffer_size;
+	char *buffer;
+
+	size_t *value_size;
+};
+
+static void get_copy_callback(const char *v, size_t vb, void *arg)
+{
+	const auto c = ((GetCopyCallbackContext *)arg);
+
+	if (c->value_size != nullptr)
+		*(c->value_size) = vb;
+
+	if (vb <= c->buffer_size) {
+		c->result = PMEMKV_STATUS_OK;
+		if (c->buffer != nullptr)
+			memcpy(c->buffer, v, vb);
+	} else {
+		c->result = PMEMKV_STATUS_OUT_OF_MEMORY;
+	}
+}
+
+int pmemkv_get_copy(pmemkv_db *db, const char *k, size_t kb, char *buffer,
+		    size_t buffer_size, size_t *value_size)
+{
+	if (!db)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	GetCopyCallbackContext ctx = {PMEMKV_STATUS_NOT_FOUND, buffer_size, buffer,
+				      value_size};
+
+	if (buffer != nullptr)
+		memset(buffer, 0, buffer_size);
+
+	auto ret = catch_and_return_status(__func__, [&] {
+		return get_with_stats(db_to_internal(db), pmem::kv::string_view(k, kb),
+				      &get_copy_callback, &ctx);
+	});
+
+	if (ret != PMEMKV_STATUS_OK)
+		return ret;
+
+	return ctx.result;
+}
+
+int pmemkv_get_many(pmemkv_db *db, size_t n, const char *const *ks, const size_t *kbs,
+		    pmemkv_get_many_callback *c, void *arg)
+{
+	if (!db || !c || (n > 0 && (!ks || !kbs)))
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		std::vector<pmem::kv::string_view> keys;
+		keys.reserve(n);
+		for (size_t i = 0; i < n; ++i)
+			keys.emplace_back(ks[i], kbs[i]);
+
+		return db_to_internal(db)->get_many(keys, c, arg);
+	});
+}
+
+int pmemkv_put_async(pmemkv_db *db, const char *k, size_t kb, const char *v, size_t vb,
+		     pmemkv_completion_callback *c, void *arg)
+{
+	if (!db || !c)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		return db_to_internal(db)->put_async(pmem::kv::string_view(k, kb),
+						     pmem::kv::string_view(v, vb), c, arg);
+	});
+}
+
+int pmemkv_get_async(pmemkv_db *db, const char *k, size_t kb,
+		     pmemkv_completion_callback *c, void *arg)
+{
+	if (!db || !c)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		return db_to_internal(db)->get_async(pmem::kv::string_view(k, kb), c,
+						     arg);
+	});
+}
+
+int pmemkv_get_pinned(pmemkv_db *db, const char *k, size_t kb, pmemkv_pinned_value **pv)
+{
+	if (!db || !pv)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		std::unique_ptr<pmem::kv::internal::pinned_value> pinned;
+		auto s = db_to_internal(db)->get_pinned(pmem::kv::string_view(k, kb),
+							pinned);
+		if (s == pmem::kv::status::OK)
+			*pv = pinned_value_from_internal(pinned.release());
+
+		return s;
+	});
+}
+
+int pmemkv_pinned_value_read(pmemkv_pinned_value *pv, const char **value, size_t *vb)
+{
+	if (!pv || !value || !vb)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	auto v = pinned_value_to_internal(pv)->value();
+	*value = v.data();
+	*vb = v.size();
+
+	return PMEMKV_STATUS_OK;
+}
+
+void pmemkv_pinned_value_delete(pmemkv_pinned_value *pv)
+{
+	try {
+		delete pinned_value_to_internal(pv);
+	} catch (const std::exception &exc) {
+		ERR() << exc.what();
+	} catch (...) {
+		ERR() << "Unspecified failure";
+	}
+}
+
+int pmemkv_value_size(pmemkv_db *db, const char *k, size_t kb, size_t *value_size)
+{
+	if (!db || !value_size)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		return db_to_internal(db)->value_size(pmem::kv::string_view(k, kb),
+						      *value_size);
+	});
+}
+
+int pmemkv_snapshot_new(pmemkv_db *db, pmemkv_snapshot **snapshot)
+{
+	if (!db || !snapshot)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		*snapshot = snapshot_from_internal(db_to_internal(db)->new_snapshot());
+		return PMEMKV_STATUS_OK;
+	});
+}
+
+void pmemkv_snapshot_delete(pmemkv_snapshot *snapshot)
+{
+	try {
+		delete snapshot_to_internal(snapshot);
+	} catch (const std::exception &exc) {
+		ERR() << exc.what();
+	} catch (...) {
+		ERR() << "Unspecified failure";
+	}
+}
+
+int pmemkv_snapshot_count_all(pmemkv_snapshot *snapshot, size_t *cnt)
+{
+	if (!snapshot || !cnt)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(
+		__func__, [&] { return snapshot_to_internal(snapshot)->count_all(*cnt); });
+}
+
+int pmemkv_snapshot_get_all(pmemkv_snapshot *snapshot, pmemkv_get_kv_callback *c,
+			    void *arg)
+{
+	if (!snapshot)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(
+		__func__, [&] { return snapshot_to_internal(snapshot)->get_all(c, arg); });
+}
+
+int pmemkv_snapshot_get_above(pmemkv_snapshot *snapshot, const char *k, size_t kb,
+			      pmemkv_get_kv_callback *c, void *arg)
+{
+	if (!snapshot)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		return snapshot_to_internal(snapshot)->get_above(
+			pmem::kv::string_view(k, kb), c, arg);
+	});
+}
+
+int pmemkv_snapshot_get_between(pmemkv_snapshot *snapshot, const char *k1, size_t kb1,
+				const char *k2, size_t kb2, pmemkv_get_kv_callback *c,
+				void *arg)
+{
+	if (!snapshot)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		return snapshot_to_internal(snapshot)->get_between(
+			pmem::kv::string_view(k1, kb1), pmem::kv::string_view(k2, kb2), c,
+			arg);
+	});
+}
+
+int pmemkv_snapshot_exists(pmemkv_snapshot *snapshot, const char *k, size_t kb)
+{
+	if (!snapshot)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		return snapshot_to_internal(snapshot)->exists(pmem::kv::string_view(k, kb));
+	});
+}
+
+int pmemkv_snapshot_get(pmemkv_snapshot *snapshot, const char *k, size_t kb,
+			pmemkv_get_v_callback *c, void *arg)
+{
+	if (!snapshot)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		return snapshot_to_internal(snapshot)->get(pmem::kv::string_view(k, kb),
+							   c, arg);
+	});
+}
+
+int pmemkv_get_split_points(pmemkv_db *db, size_t partitions, pmemkv_get_v_callback *c,
+			    void *arg)
+{
+	if (!db || !c || partitions == 0)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		std::vector<std::string> keys;
+		auto s = db_to_internal(db)->get_split_points(partitions, keys);
+		if (s != pmem::kv::status::OK)
+			return s;
+
+		for (auto &key : keys)
+			c(key.data(), key.size(), arg);
+
+		return pmem::kv::status::OK;
+	});
+}
+
+int pmemkv_get_all_parallel(pmemkv_db *db, size_t partitions, pmemkv_get_kv_callback *c,
+			    void *arg)
+{
+	if (!db || partitions == 0)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		return db_to_internal(db)->get_all_parallel(partitions, c, arg);
+	});
+}
+
+int pmemkv_get_by_rank(pmemkv_db *db, size_t n, pmemkv_get_kv_callback *c, void *arg)
+{
+	if (!db)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		return db_to_internal(db)->get_by_rank(n, c, arg);
+	});
+}
+
+int pmemkv_rank_of(pmemkv_db *db, const char *k, size_t kb, size_t *rank)
+{
+	if (!db || !rank)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		return db_to_internal(db)->rank_of(pmem::kv::string_view(k, kb), *rank);
+	});
+}
+
+int pmemkv_put(pmemkv_db *db, const char *k, size_t kb, const char *v, size_t vb)
+{
+	if (!db)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		auto engine = db_to_internal(db);
+		pmem::kv::internal::stats::op_timer timer(
+			engine->op_stats(), engine->op_recorder(), engine->slow_ops(),
+			pmem::kv::internal::stats::op_type::put,
+			pmem::kv::string_view(k, kb));
+
+		return timer.finish(engine->put(pmem::kv::string_view(k, kb),
+						pmem::kv::string_view(v, vb)),
+				    kb + vb);
+	});
+}
+
+int pmemkv_put_with_ttl(pmemkv_db *db, const char *k, size_t kb, const char *v, size_t vb,
+			uint64_t ttl_ms)
+{
+	if (!db || ttl_ms == 0 || ttl_ms > TTL_MAX_MS)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		return db_to_internal(db)->put_with_ttl(
+			pmem::kv::string_view(k, kb), pmem::kv::string_view(v, vb),
+			std::chrono::milliseconds(ttl_ms));
+	});
+}
+
+int pmemkv_merge(pmemkv_db *db, const char *k, size_t kb, const char *op, size_t ob)
+{
+	if (!db)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		return db_to_internal(db)->merge(pmem::kv::string_view(k, kb),
+						 pmem::kv::string_view(op, ob));
+	});
+}
+
+int pmemkv_put_if_absent(pmemkv_db *db, const char *k, size_t kb, const char *v,
+			 size_t vb)
+{
+	if (!db)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		return db_to_internal(db)->put_if_absent(pmem::kv::string_view(k, kb),
+							 pmem::kv::string_view(v, vb));
+	});
+}
+
+int pmemkv_compare_and_swap(pmemkv_db *db, const char *k, size_t kb, const char *ev,
+			    size_t evb, const char *dv, size_t dvb)
+{
+	if (!db)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		return db_to_internal(db)->compare_and_swap(
+			pmem::kv::string_view(k, kb), pmem::kv::string_view(ev, evb),
+			pmem::kv::string_view(dv, dvb));
+	});
+}
+
+int pmemkv_remove_if(pmemkv_db *db, const char *k, size_t kb, const char *ev, size_t evb)
+{
+	if (!db)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		return db_to_internal(db)->remove_if(pmem::kv::string_view(k, kb),
+						     pmem::kv::string_view(ev, evb));
+	});
+}
+
+int pmemkv_remove(pmemkv_db *db, const char *k, size_t kb)
+{
+	if (!db)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		auto engine = db_to_internal(db);
+		pmem::kv::internal::stats::op_timer timer(
+			engine->op_stats(), engine->op_recorder(), engine->slow_ops(),
+			pmem::kv::internal::stats::op_type::remove,
+			pmem::kv::string_view(k, kb));
+
+		return timer.finish(engine->remove(pmem::kv::string_view(k, kb)), 0);
+	});
+}
+
+int pmemkv_remove_range(pmemkv_db *db, const char *k1, size_t kb1, const char *k2,
+			size_t kb2)
+{
+	if (!db)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		return db_to_internal(db)->remove_range(pmem::kv::string_view(k1, kb1),
+							pmem::kv::string_view(k2, kb2));
+	});
+}
+
+int pmemkv_remove_prefix(pmemkv_db *db, const char *p, size_t pb)
+{
+	if (!db)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		return db_to_internal(db)->remove_prefix(pmem::kv::string_view(p, pb));
+	});
+}
+
+int pmemkv_bulk_load(pmemkv_db *db, pmemkv_bulk_load_callback *c, void *arg)
+{
+	if (!db || !c)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		pmem::kv::internal::callback_source source(c, arg);
+		return db_to_internal(db)->bulk_load(source);
+	});
+}
+
+int pmemkv_bulk_load_file(pmemkv_db *db, const char *path)
+{
+	if (!db || !path)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		pmem::kv::internal::file_source source(path);
+		return db_to_internal(db)->bulk_load(source);
+	});
+}
+
+int pmemkv_defrag(pmemkv_db *db, double start_percent, double amount_percent)
+{
+	if (!db)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	PMEMKV_PROBE1(defrag, db);
+	auto s = catch_and_return_status(__func__, [&] {
+		auto engine = db_to_internal(db);
+		pmem::kv::internal::stats::op_timer timer(
+			engine->op_stats(), engine->op_recorder(), engine->slow_ops(),
+			pmem::kv::internal::stats::op_type::defrag);
+
+		return timer.finish(engine->defrag(start_percent, amount_percent), 0);
+	});
+	PMEMKV_PROBE2(defrag_done, db, s);
+
+	return s;
+}
+
+int pmemkv_get_stats(pmemkv_db *db, pmemkv_get_v_callback *c, void *arg)
+{
+	if (!db || !c)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		std::string json;
+		auto s = db_to_internal(db)->get_stats(json);
+		if (s == pmem::kv::status::OK)
+			c(json.c_str(), json.size(), arg);
+
+		return s;
+	});
+}
+
+int pmemkv_get_memory_usage(pmemkv_db *db, pmemkv_memory_usage *usage)
+{
+	if (!db || !usage)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(
+		__func__, [&] { return db_to_internal(db)->memory_usage(*usage); });
+}
+
+int pmemkv_flight_recorder_dump(pmemkv_db *db, const char *path)
+{
+	if (!db || !path)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(
+		__func__, [&] { return db_to_internal(db)->flight_recorder_dump(path); });
+}
+
+int pmemkv_get_slow_ops(pmemkv_db *db, pmemkv_slow_op_callback *c, void *arg)
+{
+	if (!db || !c)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(
+		__func__, [&] { return db_to_internal(db)->get_slow_ops(c, arg); });
+}
+
+int pmemkv_iterator_new(pmemkv_db *db, pmemkv_iterator **it)
+{
+	if (!db || !it)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		*it = iterator_from_internal(db_to_internal(db)->new_const_iterator());
+		return PMEMKV_STATUS_OK;
+	});
+}
+
+int pmemkv_write_iterator_new(pmemkv_db *db, pmemkv_write_iterator **it)
+{
+	if (!db || !it)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		/* pmemkv_write_iterator is returned by pointer, not by copy to be
+		 * consistent with pmemkv_iterator */
+		auto unique_it = std::unique_ptr<pmemkv_write_iterator>(
+			new pmemkv_write_iterator());
+		unique_it->iter =
+			iterator_from_internal(db_to_internal(db)->new_iterator());
 		*it = unique_it.release();
 		return PMEMKV_STATUS_OK;
 	});
@@ -775,6 +1725,16 @@ int pmemkv_iterator_seek_higher_eq(pmemkv_iterator *it, const char *k, size_t kb
 	});
 }
 
+int pmemkv_iterator_seek_prefix(pmemkv_iterator *it, const char *p, size_t pb)
+{
+	if (!it)
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	return catch_and_return_status(__func__, [&] {
+		return iterator_to_base(it)->seek_prefix(pmem::kv::string_view(p, pb));
+	});
+}
+
 int pmemkv_iterator_seek_to_first(pmemkv_iterator *it)
 {
 	if (!it)
@@ -859,6 +1819,19 @@ int pmemkv_iterator_read_range(pmemkv_iterator *it, size_t pos, size_t n,
 	});
 }
 
+int pmemkv_iterator_read_batch(pmemkv_iterator *it, pmemkv_iterator_entry *entries,
+			       size_t n, size_t *count)
+{
+	if (!it || !count || (!entries && n > 0))
+		return PMEMKV_STATUS_INVALID_ARGUMENT;
+
+	*count = 0;
+
+	return catch_and_return_status(__func__, [&] {
+		return iterator_to_base(it)->read_batch(entries, n, *count);
+	});
+}
+
 int pmemkv_write_iterator_write_range(pmemkv_write_iterator *it, size_t pos, size_t n,
 				      char **data, size_t *wb)
 {
@@ -26,20 +26,68 @@ extern "C" {
 #define PMEMKV_STATUS_TRANSACTION_SCOPE_ERROR 10
 #define PMEMKV_STATUS_DEFRAG_ERROR 11
 #define PMEMKV_STATUS_COMPARATOR_MISMATCH 12
+#define PMEMKV_STATUS_CONDITION_NOT_MET 13
 
 typedef struct pmemkv_db pmemkv_db;
 typedef struct pmemkv_config pmemkv_config;
 typedef struct pmemkv_comparator pmemkv_comparator;
+typedef struct pmemkv_merge_operator pmemkv_merge_operator;
 typedef struct pmemkv_tx pmemkv_tx;
+typedef struct pmemkv_write_batch pmemkv_write_batch;
+typedef struct pmemkv_pinned_value pmemkv_pinned_value;
+typedef struct pmemkv_scan_cursor pmemkv_scan_cursor;
+typedef struct pmemkv_snapshot pmemkv_snapshot;
 
 typedef struct pmemkv_iterator pmemkv_iterator;
 typedef struct {
 	pmemkv_iterator *iter;
 } pmemkv_write_iterator;
 
+/* This API is EXPERIMENTAL and might change. */
+typedef struct pmemkv_iterator_entry {
+	const char *key;
+	size_t keybytes;
+	const char *value;
+	size_t valuebytes;
+} pmemkv_iterator_entry;
+
+/* This API is EXPERIMENTAL and might change. */
+typedef struct pmemkv_memory_usage {
+	size_t pool_size;
+	size_t allocated;
+	size_t free;
+	size_t keys;
+	size_t values;
+	size_t index;
+	double fragmentation;
+} pmemkv_memory_usage;
+
+typedef struct pmemkv_slow_op {
+	const char *op;
+	const char *key_prefix;
+	size_t key_prefix_size;
+	size_t key_size;
+	uint64_t start_ns;
+	uint64_t latency_ns;
+	uint64_t lookup_ns;
+	uint64_t allocation_ns;
+	uint64_t flush_ns;
+	uint64_t lock_wait_ns;
+	uint64_t thread_id;
+	int status;
+} pmemkv_slow_op;
+
 typedef int pmemkv_get_kv_callback(const char *key, size_t keybytes, const char *value,
 				   size_t valuebytes, void *arg);
 typedef void pmemkv_get_v_callback(const char *value, size_t valuebytes, void *arg);
+typedef int pmemkv_get_k_callback(const char *key, size_t keybytes, void *arg);
+typedef void pmemkv_get_many_callback(size_t idx, int status, const char *value,
+				      size_t valuebytes, void *arg);
+typedef void pmemkv_completion_callback(int status, const char *value, size_t valuebytes,
+					void *arg);
+typedef int pmemkv_bulk_load_callback(const char **key, size_t *keybytes,
+				      const char **value, size_t *valuebytes, void *arg);
+typedef int pmemkv_slow_op_callback(const pmemkv_slow_op *op, void *arg);
 
 typedef int pmemkv_compare_function(const char *key1, size_t keybytes1, const char *key2,
 				    size_t keybytes2, void *arg);
@@ -48,6 +96,25 @@ pmemkv_comparator *pmemkv_comparator_new(pmemkv_compare_function *fn, const char
 					 void *arg);
 void pmemkv_comparator_delete(pmemkv_comparator *comparator);
 
+/* This API is EXPERIMENTAL and might change. */
+typedef int pmemkv_merge_function(const char *key, size_t keybytes,
+				  const char *existing_value, size_t existing_valuebytes,
+				  const char *operand, size_t operandbytes,
+				  pmemkv_get_v_callback *c, void *c_arg, void *arg);
+
+pmemkv_merge_operator *pmemkv_merge_operator_new(pmemkv_merge_function *fn,
+						 const char *name, void *arg);
+void pmemkv_merge_operator_delete(pmemkv_merge_operator *merge_operator);
+
+int pmemkv_merge_uint64_add(const char *key, size_t keybytes, const char *existing_value,
+			    size_t existing_valuebytes, const char *operand,
+			    size_t operandbytes, pmemkv_get_v_callback *c, void *c_arg,
+			    void *arg);
+int pmemkv_merge_append(const char *key, size_t keybytes, const char *existing_value,
+			size_t existing_valuebytes, const char *operand,
+			size_t operandbytes, pmemkv_get_v_callback *c, void *c_arg,
+			void *arg);
+
 pmemkv_config *pmemkv_config_new(void);
 void pmemkv_config_delete(pmemkv_config *config);
 int pmemkv_config_put_data(pmemkv_config *config, const char *key, const void *value,
@@ -74,6 +141,9 @@ int pmemkv_config_put_create_or_error_if_exists(pmemkv_config *config, bool valu
 int pmemkv_config_put_create_if_missing(pmemkv_config *config, bool value);
 int pmemkv_config_put_comparator(pmemkv_config *config, pmemkv_comparator *comparator);
 int pmemkv_config_put_oid(pmemkv_config *config, PMEMoid *oid);
+/* This API is EXPERIMENTAL and might change. */
+int pmemkv_config_put_merge_operator(pmemkv_config *config,
+				     pmemkv_merge_operator *merge_operator);
 
 int pmemkv_open(const char *engine, pmemkv_config *config, pmemkv_db **db);
 void pmemkv_close(pmemkv_db *kv);
@@ -104,6 +174,8 @@ int pmemkv_get(pmemkv_db *db, const char *k, size_t kb, pmemkv_get_v_callback *c
 	       void *arg);
 int pmemkv_get_copy(pmemkv_db *db, const char *k, size_t kb, char *buffer,
 		    size_t buffer_size, size_t *value_size);
+int pmemkv_get_many(pmemkv_db *db, size_t n, const char *const *ks, const size_t *kbs,
+		    pmemkv_get_many_callback *c, void *arg);
 int pmemkv_put(pmemkv_db *db, const char *k, size_t kb, const char *v, size_t vb);
 
 int pmemkv_remove(pmemkv_db *db, const char *k, size_t kb);
@@ -120,6 +192,121 @@ int pmemkv_tx_commit(pmemkv_tx *tx);
 void pmemkv_tx_abort(pmemkv_tx *tx);
 void pmemkv_tx_end(pmemkv_tx *tx);
 
+/* This API is EXPERIMENTAL and might change. */
+pmemkv_write_batch *pmemkv_write_batch_new(void);
+void pmemkv_write_batch_delete(pmemkv_write_batch *batch);
+int pmemkv_write_batch_put(pmemkv_write_batch *batch, const char *k, size_t kb,
+			   const char *v, size_t vb);
+int pmemkv_write_batch_remove(pmemkv_write_batch *batch, const char *k, size_t kb);
+int pmemkv_write_batch_count(pmemkv_write_batch *batch, size_t *cnt);
+void pmemkv_write_batch_clear(pmemkv_write_batch *batch);
+int pmemkv_write(pmemkv_db *db, pmemkv_write_batch *batch);
+
+/* This API is EXPERIMENTAL and might change. */
+int pmemkv_put_async(pmemkv_db *db, const char *k, size_t kb, const char *v, size_t vb,
+		     pmemkv_completion_callback *c, void *arg);
+int pmemkv_get_async(pmemkv_db *db, const char *k, size_t kb,
+		     pmemkv_completion_callback *c, void *arg);
+
+/* This API is EXPERIMENTAL and might change. */
+int pmemkv_count_prefix(pmemkv_db *db, const char *p, size_t pb, size_t *cnt);
+int pmemkv_get_prefix(pmemkv_db *db, const char *p, size_t pb, pmemkv_get_kv_callback *c,
+		      void *arg);
+
+/* This API is EXPERIMENTAL and might change. */
+int pmemkv_get_keys(pmemkv_db *db, pmemkv_get_k_callback *c, void *arg);
+int pmemkv_get_keys_above(pmemkv_db *db, const char *k, size_t kb, pmemkv_get_k_callback *c,
+			  void *arg);
+int pmemkv_get_keys_below(pmemkv_db *db, const char *k, size_t kb, pmemkv_get_k_callback *c,
+			  void *arg);
+int pmemkv_get_keys_between(pmemkv_db *db, const char *k1, size_t kb1, const char *k2,
+			    size_t kb2, pmemkv_get_k_callback *c, void *arg);
+
+/* This API is EXPERIMENTAL and might change. */
+int pmemkv_put_with_ttl(pmemkv_db *db, const char *k, size_t kb, const char *v, size_t vb,
+			uint64_t ttl_ms);
+
+/* This API is EXPERIMENTAL and might change. */
+int pmemkv_merge(pmemkv_db *db, const char *k, size_t kb, const char *op, size_t ob);
+
+/* This API is EXPERIMENTAL and might change. */
+int pmemkv_put_if_absent(pmemkv_db *db, const char *k, size_t kb, const char *v,
+			 size_t vb);
+int pmemkv_compare_and_swap(pmemkv_db *db, const char *k, size_t kb, const char *ev,
+			    size_t evb, const char *dv, size_t dvb);
+int pmemkv_remove_if(pmemkv_db *db, const char *k, size_t kb, const char *ev, size_t evb);
+
+/* This API is EXPERIMENTAL and might change. */
+int pmemkv_remove_range(pmemkv_db *db, const char *k1, size_t kb1, const char *k2,
+			size_t kb2);
+int pmemkv_remove_prefix(pmemkv_db *db, const char *p, size_t pb);
+
+/* This API is EXPERIMENTAL and might change. */
+int pmemkv_bulk_load(pmemkv_db *db, pmemkv_bulk_load_callback *c, void *arg);
+int pmemkv_bulk_load_file(pmemkv_db *db, const char *path);
+
+/* This API is EXPERIMENTAL and might change. */
+int pmemkv_get_all_desc(pmemkv_db *db, pmemkv_get_kv_callback *c, void *arg);
+int pmemkv_get_above_desc(pmemkv_db *db, const char *k, size_t kb,
+			  pmemkv_get_kv_callback *c, void *arg);
+int pmemkv_get_equal_above_desc(pmemkv_db *db, const char *k, size_t kb,
+				pmemkv_get_kv_callback *c, void *arg);
+int pmemkv_get_equal_below_desc(pmemkv_db *db, const char *k, size_t kb,
+				pmemkv_get_kv_callback *c, void *arg);
+int pmemkv_get_below_desc(pmemkv_db *db, const char *k, size_t kb,
+			  pmemkv_get_kv_callback *c, void *arg);
+int pmemkv_get_between_desc(pmemkv_db *db, const char *k1, size_t kb1, const char *k2,
+			    size_t kb2, pmemkv_get_kv_callback *c, void *arg);
+
+/* This API is EXPERIMENTAL and might change. */
+pmemkv_scan_cursor *pmemkv_scan_cursor_new(size_t max_count, size_t max_bytes);
+void pmemkv_scan_cursor_delete(pmemkv_scan_cursor *cursor);
+int pmemkv_scan_cursor_next_key(pmemkv_scan_cursor *cursor, const char **k, size_t *kb);
+int pmemkv_get_above_page(pmemkv_db *db, const char *k, size_t kb,
+			  pmemkv_scan_cursor *cursor, pmemkv_get_kv_callback *c, void *arg);
+int pmemkv_get_between_page(pmemkv_db *db, const char *k1, size_t kb1, const char *k2,
+			    size_t kb2, pmemkv_scan_cursor *cursor,
+			    pmemkv_get_kv_callback *c, void *arg);
+
+/* This API is EXPERIMENTAL and might change. */
+int pmemkv_get_pinned(pmemkv_db *db, const char *k, size_t kb, pmemkv_pinned_value **pv);
+int pmemkv_pinned_value_read(pmemkv_pinned_value *pv, const char **value, size_t *vb);
+void pmemkv_pinned_value_delete(pmemkv_pinned_value *pv);
+
+/* This API is EXPERIMENTAL and might change. */
+int pmemkv_value_size(pmemkv_db *db, const char *k, size_t kb, size_t *value_size);
+
+/* This API is EXPERIMENTAL and might change. */
+int pmemkv_snapshot_new(pmemkv_db *db, pmemkv_snapshot **snapshot);
+void pmemkv_snapshot_delete(pmemkv_snapshot *snapshot);
+int pmemkv_snapshot_count_all(pmemkv_snapshot *snapshot, size_t *cnt);
+int pmemkv_snapshot_get_all(pmemkv_snapshot *snapshot, pmemkv_get_kv_callback *c,
+			    void *arg);
+int pmemkv_snapshot_get_above(pmemkv_snapshot *snapshot, const char *k, size_t kb,
+			      pmemkv_get_kv_callback *c, void *arg);
+int pmemkv_snapshot_get_between(pmemkv_snapshot *snapshot, const char *k1, size_t kb1,
+				const char *k2, size_t kb2, pmemkv_get_kv_callback *c,
+				void *arg);
+int pmemkv_snapshot_exists(pmemkv_snapshot *snapshot, const char *k, size_t kb);
+int pmemkv_snapshot_get(pmemkv_snapshot *snapshot, const char *k, size_t kb,
+			pmemkv_get_v_callback *c, void *arg);
+
+/* This API is EXPERIMENTAL and might change. */
+int pmemkv_get_split_points(pmemkv_db *db, size_t partitions, pmemkv_get_v_callback *c,
+			    void *arg);
+int pmemkv_get_all_parallel(pmemkv_db *db, size_t partitions, pmemkv_get_kv_callback *c,
+			    void *arg);
+
+/* This API is EXPERIMENTAL and might change. */
+int pmemkv_get_by_rank(pmemkv_db *db, size_t n, pmemkv_get_kv_callback *c, void *arg);
+int pmemkv_rank_of(pmemkv_db *db, const char *k, size_t kb, size_t *rank);
+
+/* This API is EXPERIMENTAL and might change. */
+int pmemkv_get_stats(pmemkv_db *db, pmemkv_get_v_callback *c, void *arg);
+int pmemkv_get_memory_usage(pmemkv_db *db, pmemkv_memory_usage *usage);
+int pmemkv_flight_recorder_dump(pmemkv_db *db, const char *path);
+int pmemkv_get_slow_ops(pmemkv_db *db, pmemkv_slow_op_callback *c, void *arg);
+
 /* This API is EXPERIMENTAL and might change. */
 int pmemkv_iterator_new(pmemkv_db *db, pmemkv_iterator **it);
 int pmemkv_write_iterator_new(pmemkv_db *db, pmemkv_write_iterator **it);
@@ -132,6 +319,7 @@ int pmemkv_iterator_seek_lower(pmemkv_iterator *it, const char *k, size_t kb);
 int pmemkv_iterator_seek_lower_eq(pmemkv_iterator *it, const char *k, size_t kb);
 int pmemkv_iterator_seek_higher(pmemkv_iterator *it, const char *k, size_t kb);
 int pmemkv_iterator_seek_higher_eq(pmemkv_iterator *it, const char *k, size_t kb);
+int pmemkv_iterator_seek_prefix(pmemkv_iterator *it, const char *p, size_t pb);
 
 int pmemkv_iterator_seek_to_first(pmemkv_iterator *it);
 int pmemkv_iterator_seek_to_last(pmemkv_iterator *it);
@@ -144,6 +332,8 @@ int pmemkv_iterator_key(pmemkv_iterator *it, const char **k, size_t *kb);
 
 int pmemkv_iterator_read_range(pmemkv_iterator *it, size_t pos, size_t n,
 			       const char **data, size_t *rb);
+int pmemkv_iterator_read_batch(pmemkv_iterator *it, pmemkv_iterator_entry *entries,
+			       size_t n, size_t *count);
 int pmemkv_write_iterator_write_range(pmemkv_write_iterator *it, size_t pos, size_t n,
 				      char **data, size_t *wb);
 
@@ -5,7 +5,9 @@
 #define LIBPMEMKV_HPP
 
 #include <cassert>
+#include <chrono>
 #include <functional>
+#include <future>
 #include <iostream>
 #include <libpmemobj++/slice.hpp>
 #include <libpmemobj++/string_view.hpp>
@@ -13,6 +15,7 @@
 #include <stdexcept>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "libpmemkv.h"
 #include <libpmemobj/pool_base.h>
@@ -61,6 +64,14 @@ typedef int get_kv_function(string_view key, string_view value);
  */
 typedef void get_v_function(string_view value);
 
+/**
+ * The C++ idiomatic function type to use for callback using only the key.
+ * It is used by key-only scans (db::get_keys() and others).
+ *
+ * @param[in] key returned by callback item's key
+ */
+typedef int get_k_function(string_view key);
+
 /**
  * Key-value pair callback, C-style.
  */
@@ -69,6 +80,39 @@ using get_kv_callback = pmemkv_get_kv_callback;
  * Value-only callback, C-style.
  */
 using get_v_callback = pmemkv_get_v_callback;
+/**
+ * Key-only callback, C-style.
+ */
+using get_k_callback = pmemkv_get_k_callback;
+/**
+ * Callback used by db::get_many(), C-style.
+ */
+using get_many_callback = pmemkv_get_many_callback;
+/**
+ * Completion callback of asynchronous operations (db::put_async(),
+ * db::get_async()), C-style.
+ */
+using completion_callback = pmemkv_completion_callback;
+/**
+ * Source of records for db::bulk_load(), C-style.
+ */
+using bulk_load_callback = pmemkv_bulk_load_callback;
+/**
+ * Space usage of a pool, returned by db::memory_usage().
+ */
+using memory_usage_info = pmemkv_memory_usage;
+/**
+ * Operation which took longer than "slow_op_threshold_us", passed to the
+ * function given to db::get_slow_ops().
+ */
+using slow_op_info = pmemkv_slow_op;
+/**
+ * The C++ idiomatic function type to use for callback of db::get_slow_ops().
+ * Iteration stops if it returns non-zero value.
+ *
+ * @param[in] op slow operation
+ */
+typedef int slow_op_function(const slow_op_info &op);
 
 /*! \enum status
 	\brief Status returned by most of pmemkv functions.
@@ -110,8 +154,31 @@ enum class status {
 	COMPARATOR_MISMATCH =
 		PMEMKV_STATUS_COMPARATOR_MISMATCH, /**< db was created with a different
 						      comparator */
+	CONDITION_NOT_MET =
+		PMEMKV_STATUS_CONDITION_NOT_MET, /**< condition of a conditional write
+						    was not met (record not modified) */
 };
 
+/**
+ * The C++ idiomatic function type to use for callback in db::get_many().
+ *
+ * @param[in] idx position of the key in the input vector
+ * @param[in] s status of the lookup for this key
+ * @param[in] value item's data (empty if s is not status::OK)
+ */
+typedef void get_many_function(std::size_t idx, status s, string_view value);
+
+/**
+ * The C++ idiomatic function type to use as a source of records in
+ * db::bulk_load().
+ *
+ * @param[out] key key of the next record
+ * @param[out] value value of the next record
+ *
+ * @return true if the next record was set, false at the end of data
+ */
+typedef bool bulk_load_function(string_view &key, string_view &value);
+
 /**
  * Provides string representation of a status, along with its number
  * as specified by enum.
@@ -135,7 +202,8 @@ inline std::ostream &operator<<(std::ostream &os, const status &s)
 					       "WRONG_ENGINE_NAME",
 					       "TRANSACTION_SCOPE_ERROR",
 					       "DEFRAG_ERROR",
-					       "COMPARATOR_MISMATCH"};
+					       "COMPARATOR_MISMATCH",
+					       "CONDITION_NOT_MET"};
 
 	int status_no = static_cast<int>(s);
 	os << statuses[status_no] << " (" << status_no << ")";
@@ -471,6 +539,8 @@ public:
 	status put_oid(PMEMoid *oid) noexcept;
 	template <typename Comparator>
 	status put_comparator(Comparator &&comparator);
+	template <typename MergeOperator>
+	status put_merge_operator(MergeOperator &&merge_operator);
 
 	template <typename T>
 	status get_data(const std::string &key, T *&value, std::size_t &number) const
@@ -518,6 +588,158 @@ private:
 	std::unique_ptr<pmemkv_tx, decltype(&pmemkv_tx_end)> tx_;
 };
 
+/*! \class write_batch
+	\brief Sequence of put and remove operations, applied with db::write().
+
+	__This API is EXPERIMENTAL and might change.__
+
+	The write_batch class allows handing many put and remove operations to
+	an engine in a single call, so the engine can amortize the cost of locking
+	and flushing across all of them. Contrary to tx, a batch is NOT atomic:
+	if an error occurs (or the application crashes) while the batch is being
+	applied, some of its operations may already be applied and others not.
+	Operations are applied in the order in which they were added. The batch
+	is not modified by db::write() and can be reused (or cleared) afterwards.
+*/
+class write_batch {
+public:
+	write_batch() noexcept;
+
+	status put(string_view key, string_view value) noexcept;
+	status remove(string_view key) noexcept;
+	std::size_t count() const noexcept;
+	void clear() noexcept;
+
+private:
+	friend class db;
+
+	int init() noexcept;
+
+	std::unique_ptr<pmemkv_write_batch, decltype(&pmemkv_write_batch_delete)> batch_;
+};
+
+/*! \class scan_cursor
+	\brief Limits and state of a paginated scan (db::get_above_page(),
+	db::get_between_page()).
+
+	__This API is EXPERIMENTAL and might change.__
+
+	Every page returns at most max_count records and at most max_bytes bytes
+	of keys and values (0 means no limit; at least one record is returned if
+	any is in the range). After a page is returned, has_more() tells if the
+	range may contain more records and next_key() returns the continuation
+	key (key of the last returned record), to be passed as the lower bound
+	of the next page, together with the same cursor. Engines may cache their
+	position in the cursor, so the next page does not need to seek from the
+	beginning.
+
+	__Example__ usage:
+	@code
+	pmem::kv::scan_cursor cursor(100);
+	auto s = kv.get_above_page("", cursor, f);
+	while (s == pmem::kv::status::OK && cursor.has_more())
+		s = kv.get_above_page(std::string(cursor.next_key().data(),
+						  cursor.next_key().size()), cursor, f);
+	@endcode
+*/
+class scan_cursor {
+public:
+	scan_cursor(std::size_t max_count, std::size_t max_bytes = 0) noexcept;
+
+	bool has_more() const noexcept;
+	string_view next_key() const noexcept;
+
+private:
+	friend class db;
+
+	int init() noexcept;
+
+	std::size_t max_count;
+	std::size_t max_bytes;
+	std::unique_ptr<pmemkv_scan_cursor, decltype(&pmemkv_scan_cursor_delete)> cursor_;
+};
+
+/*! \class pinned_value
+	\brief Value of a record, referenced without copying, returned by db::get_pinned().
+
+	__This API is EXPERIMENTAL and might change.__
+
+	The pinned_value points directly to the place where the value is stored
+	and keeps the record alive (and unchanged) until it is released - either
+	explicitly with release() or when the object is destroyed. Depending on
+	the engine, the record may stay locked against modification in the
+	meantime, so pinned values should be released as soon as possible and
+	the thread holding a pinned value must not modify the same record.
+	Engines which cannot reference their storage directly return a copy.
+*/
+class pinned_value {
+public:
+	pinned_value(pmemkv_pinned_value *pv) noexcept;
+
+	string_view value() const noexcept;
+	void release() noexcept;
+
+private:
+	std::unique_ptr<pmemkv_pinned_value, decltype(&pmemkv_pinned_value_delete)> pv_;
+	string_view value_;
+};
+
+/*! \class snapshot
+	\brief Read-only, point-in-time view of the database, returned by db::snapshot().
+
+	__This API is EXPERIMENTAL and might change.__
+
+	Reads from a snapshot return records as they were when the snapshot was
+	created - records put, updated or removed afterwards are seen in their
+	previous state, also when they change in the middle of a scan. Reading
+	from a snapshot does not block writers: previous versions of modified
+	records are kept in DRAM while any snapshot is open, and scans read the
+	database in chunks, with no lock held between chunks nor while callbacks
+	are executed. Keeping snapshots open for a long time under a heavy write
+	load increases memory usage.
+
+	A snapshot must be released (or destroyed) before the database is closed.
+	Previous versions are kept only in DRAM, so snapshots do not survive
+	closing the database. Supported by csmap and stree; other engines return
+	pmem::kv::status::NOT_SUPPORTED from db::snapshot().
+
+	__Example__ usage:
+	@code
+	auto sn = kv.snapshot();
+	if (sn.is_ok())
+		sn.get_value().get_all([&](pmem::kv::string_view k,
+					   pmem::kv::string_view v) { return 0; });
+	@endcode
+*/
+class snapshot {
+public:
+	snapshot(pmemkv_snapshot *sn) noexcept;
+
+	status count_all(std::size_t &cnt) noexcept;
+
+	status get_all(get_kv_callback *callback, void *arg) noexcept;
+	status get_all(std::function<get_kv_function> f) noexcept;
+
+	status get_above(string_view key, get_kv_callback *callback, void *arg) noexcept;
+	status get_above(string_view key, std::function<get_kv_function> f) noexcept;
+
+	status get_between(string_view key1, string_view key2, get_kv_callback *callback,
+			   void *arg) noexcept;
+	status get_between(string_view key1, string_view key2,
+			   std::function<get_kv_function> f) noexcept;
+
+	status exists(string_view key) noexcept;
+
+	status get(string_view key, get_v_callback *callback, void *arg) noexcept;
+	status get(string_view key, std::function<get_v_function> f) noexcept;
+	status get(string_view key, std::string *value) noexcept;
+
+	void release() noexcept;
+
+private:
+	std::unique_ptr<pmemkv_snapshot, decltype(&pmemkv_snapshot_delete)> sn_;
+};
+
 /*! \class db
 	\brief Main pmemkv class, it provides functions to operate on data in database.
 
@@ -560,10 +782,22 @@ public:
 	status count_below(string_view key, std::size_t &cnt) noexcept;
 	status count_between(string_view key1, string_view key2,
 			     std::size_t &cnt) noexcept;
+	status count_prefix(string_view prefix, std::size_t &cnt) noexcept;
 
 	status get_all(get_kv_callback *callback, void *arg) noexcept;
 	status get_all(std::function<get_kv_function> f) noexcept;
 
+	status get_split_points(std::size_t partitions,
+				std::vector<std::string> &keys) noexcept;
+	status get_all_parallel(std::size_t partitions, get_kv_callback *callback,
+				void *arg) noexcept;
+	status get_all_parallel(std::size_t partitions,
+				std::function<get_kv_function> f) noexcept;
+
+	status get_by_rank(std::size_t n, get_kv_callback *callback, void *arg) noexcept;
+	status get_by_rank(std::size_t n, std::function<get_kv_function> f) noexcept;
+	status rank_of(string_view key, std::size_t &rank) noexcept;
+
 	status get_above(string_view key, get_kv_callback *callback, void *arg) noexcept;
 	status get_above(string_view key, std::function<get_kv_function> f) noexcept;
 
@@ -585,18 +819,102 @@ public:
 	status get_between(string_view key1, string_view key2,
 			   std::function<get_kv_function> f) noexcept;
 
+	status get_prefix(string_view prefix, get_kv_callback *callback,
+			  void *arg) noexcept;
+	status get_prefix(string_view prefix, std::function<get_kv_function> f) noexcept;
+
+	status get_keys(get_k_callback *callback, void *arg) noexcept;
+	status get_keys(std::function<get_k_function> f) noexcept;
+	status get_keys_above(string_view key, get_k_callback *callback,
+			      void *arg) noexcept;
+	status get_keys_above(string_view key, std::function<get_k_function> f) noexcept;
+	status get_keys_below(string_view key, get_k_callback *callback,
+			      void *arg) noexcept;
+	status get_keys_below(string_view key, std::function<get_k_function> f) noexcept;
+	status get_keys_between(string_view key1, string_view key2,
+				get_k_callback *callback, void *arg) noexcept;
+	status get_keys_between(string_view key1, string_view key2,
+				std::function<get_k_function> f) noexcept;
+
+	status get_all_desc(get_kv_callback *callback, void *arg) noexcept;
+	status get_all_desc(std::function<get_kv_function> f) noexcept;
+	status get_above_desc(string_view key, get_kv_callback *callback,
+			      void *arg) noexcept;
+	status get_above_desc(string_view key, std::function<get_kv_function> f) noexcept;
+	status get_equal_above_desc(string_view key, get_kv_callback *callback,
+				    void *arg) noexcept;
+	status get_equal_above_desc(string_view key,
+				    std::function<get_kv_function> f) noexcept;
+	status get_equal_below_desc(string_view key, get_kv_callback *callback,
+				    void *arg) noexcept;
+	status get_equal_below_desc(string_view key,
+				    std::function<get_kv_function> f) noexcept;
+	status get_below_desc(string_view key, get_kv_callback *callback,
+			      void *arg) noexcept;
+	status get_below_desc(string_view key, std::function<get_kv_function> f) noexcept;
+	status get_between_desc(string_view key1, string_view key2,
+				get_kv_callback *callback, void *arg) noexcept;
+	status get_between_desc(string_view key1, string_view key2,
+				std::function<get_kv_function> f) noexcept;
+
+	status get_above_page(string_view key, scan_cursor &cursor,
+			      get_kv_callback *callback, void *arg) noexcept;
+	status get_above_page(string_view key, scan_cursor &cursor,
+			      std::function<get_kv_function> f) noexcept;
+	status get_between_page(string_view key1, string_view key2, scan_cursor &cursor,
+				get_kv_callback *callback, void *arg) noexcept;
+	status get_between_page(string_view key1, string_view key2, scan_cursor &cursor,
+				std::function<get_kv_function> f) noexcept;
+
 	status exists(string_view key) noexcept;
 
 	status get(string_view key, get_v_callback *callback, void *arg) noexcept;
 	status get(string_view key, std::function<get_v_function> f) noexcept;
 	status get(string_view key, std::string *value) noexcept;
 
+	status get_many(const std::vector<string_view> &keys,
+			get_many_callback *callback, void *arg) noexcept;
+	status get_many(const std::vector<string_view> &keys,
+			std::function<get_many_function> f) noexcept;
+
+	result<pinned_value> get_pinned(string_view key) noexcept;
+	status value_size(string_view key, std::size_t &size) noexcept;
+
+	result<pmem::kv::snapshot> snapshot() noexcept;
+
 	status put(string_view key, string_view value) noexcept;
+	status put(string_view key, string_view value,
+		   std::chrono::milliseconds ttl) noexcept;
+	status merge(string_view key, string_view operand) noexcept;
+	status put_if_absent(string_view key, string_view value) noexcept;
+	status compare_and_swap(string_view key, string_view expected,
+				string_view desired) noexcept;
+	status remove_if(string_view key, string_view expected) noexcept;
 	status remove(string_view key) noexcept;
+	status remove_range(string_view key1, string_view key2) noexcept;
+	status remove_prefix(string_view prefix) noexcept;
+
+	status bulk_load(bulk_load_callback *callback, void *arg) noexcept;
+	status bulk_load(std::function<bulk_load_function> f) noexcept;
+	status bulk_load_file(const std::string &path) noexcept;
+
+	status put_async(string_view key, string_view value,
+			 completion_callback *callback, void *arg) noexcept;
+	std::future<status> put_async(string_view key, string_view value);
+	status get_async(string_view key, completion_callback *callback,
+			 void *arg) noexcept;
+	std::future<result<std::string>> get_async(string_view key);
+
 	status defrag(double start_percent = 0, double amount_percent = 100);
+	status get_stats(std::string *json) noexcept;
+	result<memory_usage_info> memory_usage() noexcept;
+	status flight_recorder_dump(const std::string &path) noexcept;
+	status get_slow_ops(std::function<slow_op_function> f) noexcept;
 
 	result<tx> tx_begin() noexcept;
 
+	status write(const write_batch &batch) noexcept;
+
 	result<read_iterator> new_read_iterator();
 	result<write_iterator> new_write_iterator();
 
@@ -643,6 +961,7 @@ public:
 	status seek_lower_eq(string_view key) noexcept;
 	status seek_higher(string_view key) noexcept;
 	status seek_higher_eq(string_view key) noexcept;
+	status seek_prefix(string_view prefix) noexcept;
 
 	status seek_to_first() noexcept;
 	status seek_to_last() noexcept;
@@ -657,6 +976,9 @@ public:
 	read_range(size_t pos = 0,
 		   size_t n = std::numeric_limits<size_t>::max()) noexcept;
 
+	status read_batch(std::vector<std::pair<string_view, string_view>> &entries,
+			  std::size_t n) noexcept;
+
 	template <bool IC = IsConst>
 	typename std::enable_if<!IC, result<pmem::obj::slice<OutputIterator<char>>>>::type
 	write_range(size_t pos = 0,
@@ -926,6 +1248,32 @@ inline status db::iterator<IsConst>::seek_higher_eq(string_view key) noexcept
 		this->get_raw_it(), key.data(), key.size()));
 }
 
+/**
+ * Changes iterator position to the first record with key starting with the
+ * given *prefix* and bounds the iterator to such records: is_next(), next()
+ * and prev() return pmem::kv::status::NOT_FOUND instead of crossing the prefix
+ * boundary (until the iterator is moved by another seek function).
+ * If the record is present and no errors occurred, returns pmem::kv::status::OK.
+ * If no key starts with the *prefix*, pmem::kv::status::NOT_FOUND is returned
+ * and the iterator position is undefined. Engines using a custom comparator
+ * return pmem::kv::status::NOT_SUPPORTED. Other possible return values are
+ * described in pmem::kv::status.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * It internally aborts all changes made to an element previously pointed by the iterator.
+ *
+ * @param[in] prefix prefix of keys of records, which the iterator can point to
+ *
+ * @return pmem::kv::status
+ */
+template <bool IsConst>
+inline status db::iterator<IsConst>::seek_prefix(string_view prefix) noexcept
+{
+	return static_cast<status>(pmemkv_iterator_seek_prefix(
+		this->get_raw_it(), prefix.data(), prefix.size()));
+}
+
 /**
  * Changes iterator position to the first record.
  * If db isn't empty, and no errors occurred, returns
@@ -1067,6 +1415,53 @@ inline result<string_view> db::iterator<IsConst>::read_range(size_t pos,
 		return {s};
 }
 
+/**
+ * Reads (into *entries*) keys and values of up to *n* records, starting from
+ * the current one, and moves the iterator to the record following the last
+ * one read - with a single call, instead of db::iterator::key(),
+ * db::iterator::read_range() and db::iterator::next() for every record.
+ *
+ * If there are more records, pmem::kv::status::OK is returned. Otherwise
+ * pmem::kv::status::NOT_FOUND is returned, *entries* contain records up to the
+ * last one and the iterator position is undefined (as after
+ * db::iterator::next()). Records are read in the order of db::iterator::next(),
+ * so engines which do not support it return pmem::kv::status::NOT_SUPPORTED
+ * after the first record.
+ *
+ * Keys and values are valid until the iterator is moved (or the records are
+ * modified). It internally aborts all changes made to an element previously
+ * pointed by the iterator.
+ *
+ * For csmap, radix, stree and vsmap, if the iterator was not positioned yet or
+ * it's already past the last record (after pmem::kv::status::NOT_FOUND was
+ * returned), no records are read and pmem::kv::status::NOT_FOUND is returned.
+ * On any other undefined position, calling this method is undefined behaviour.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[out] entries pairs of key and value of records read
+ * @param[in] n maximum number of records to read
+ *
+ * @return pmem::kv::status
+ */
+template <bool IsConst>
+inline status
+db::iterator<IsConst>::read_batch(std::vector<std::pair<string_view, string_view>> &entries,
+				  std::size_t n) noexcept
+{
+	std::vector<pmemkv_iterator_entry> batch(n);
+	size_t count;
+	auto s = static_cast<status>(pmemkv_iterator_read_batch(
+		this->get_raw_it(), batch.data(), n, &count));
+
+	entries.clear();
+	for (size_t i = 0; i < count; i++)
+		entries.emplace_back(string_view(batch[i].key, batch[i].keybytes),
+				     string_view(batch[i].value, batch[i].valuebytes));
+
+	return s;
+}
+
 /**
  * Returns value's range (pmem::obj::slice<db::iterator::OutputIterator<char>>) to modify,
  * in pmem::kv::result.
@@ -1225,6 +1620,54 @@ struct comparator_config_entry : public unique_ptr_wrapper_base {
 	std::unique_ptr<pmemkv_comparator, decltype(pmemkv_comparator_delete) *> c_cmp;
 };
 
+class merge_operator_base {
+public:
+	virtual ~merge_operator_base()
+	{
+	}
+	virtual bool merge(string_view key, const string_view *existing_value,
+			   string_view operand, std::string &new_value) = 0;
+};
+
+template <typename MergeOperator>
+struct merge_operator_wrapper : public merge_operator_base {
+	merge_operator_wrapper(const MergeOperator &op) : op(op)
+	{
+	}
+
+	merge_operator_wrapper(MergeOperator &&op) : op(std::move(op))
+	{
+	}
+
+	bool merge(string_view key, const string_view *existing_value,
+		   string_view operand, std::string &new_value) override
+	{
+		return op.merge(key, existing_value, operand, new_value);
+	}
+
+	MergeOperator op;
+};
+
+struct merge_operator_config_entry : public unique_ptr_wrapper_base {
+	merge_operator_config_entry(
+		std::unique_ptr<merge_operator_base> ptr,
+		std::unique_ptr<pmemkv_merge_operator,
+				decltype(pmemkv_merge_operator_delete) *>
+			c_op)
+	    : ptr(std::move(ptr)), c_op(std::move(c_op))
+	{
+	}
+
+	void *get() override
+	{
+		return c_op.get();
+	}
+
+	std::unique_ptr<merge_operator_base> ptr;
+	std::unique_ptr<pmemkv_merge_operator, decltype(pmemkv_merge_operator_delete) *>
+		c_op;
+};
+
 /*
  * All functions which will be called by C code must be declared as extern "C"
  * to ensure they have C linkage. It is needed because it is possible that
@@ -1249,9 +1692,90 @@ static inline int call_comparator_function(const char *k1, size_t kb1, const cha
 	auto *cmp = static_cast<comparator_base *>(arg);
 	return cmp->compare(string_view(k1, kb1), string_view(k2, kb2));
 }
+
+static inline void call_assign_string(const char *value, size_t valuebytes, void *arg)
+{
+	static_cast<std::string *>(arg)->assign(value, valuebytes);
+}
+
+static inline int call_merge_function(const char *k, size_t kb, const char *ev,
+				      size_t evb, const char *op, size_t ob,
+				      pmemkv_get_v_callback *c, void *c_arg, void *arg)
+{
+	auto *merge_op = static_cast<merge_operator_base *>(arg);
+	string_view existing(ev, evb);
+	std::string new_value;
+
+	try {
+		if (!merge_op->merge(string_view(k, kb), ev ? &existing : nullptr,
+				     string_view(op, ob), new_value))
+			return 1;
+	} catch (...) {
+		return 1;
+	}
+
+	c(new_value.data(), new_value.size(), c_arg);
+
+	return 0;
+}
 } /* extern "C" */
 } /* namespace internal */
 
+/**
+ * Built-in merge operator (see config::put_merge_operator()), which adds
+ * the operand to the value of the record. Both are 8-byte unsigned integers in
+ * native byte order, a missing record is treated as 0. The sum wraps around on
+ * overflow.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ */
+class uint64_add_merge_operator {
+public:
+	bool merge(string_view key, const string_view *existing_value,
+		   string_view operand, std::string &new_value)
+	{
+		auto ret = pmemkv_merge_uint64_add(
+			key.data(), key.size(),
+			existing_value ? existing_value->data() : nullptr,
+			existing_value ? existing_value->size() : 0, operand.data(),
+			operand.size(), internal::call_assign_string, &new_value, nullptr);
+
+		return ret == 0;
+	}
+
+	std::string name()
+	{
+		return "__pmemkv_uint64_add";
+	}
+};
+
+/**
+ * Built-in merge operator (see config::put_merge_operator()), which appends
+ * the operand to the value of the record (a missing record is treated as
+ * an empty value).
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ */
+class append_merge_operator {
+public:
+	bool merge(string_view key, const string_view *existing_value,
+		   string_view operand, std::string &new_value)
+	{
+		auto ret = pmemkv_merge_append(
+			key.data(), key.size(),
+			existing_value ? existing_value->data() : nullptr,
+			existing_value ? existing_value->size() : 0, operand.data(),
+			operand.size(), internal::call_assign_string, &new_value, nullptr);
+
+		return ret == 0;
+	}
+
+	std::string name()
+	{
+		return "__pmemkv_append";
+	}
+};
+
 /**
  * Default constructor with uninitialized config.
  */
@@ -1426,6 +1950,87 @@ inline status config::put_comparator(Comparator &&comparator)
 		internal::call_up_destructor));
 }
 
+/**
+ * Puts merge operator object to a config. It is used by db::merge() to
+ * compute a new value of a record.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * Merge operator must:
+ * - implement `bool merge(pmem::kv::string_view key,
+ *   const pmem::kv::string_view *existing_value, pmem::kv::string_view operand,
+ *   std::string &new_value)`, which stores the result in *new_value* and
+ *   returns true on success (*existing_value* is nullptr if the record does
+ *   not exist)
+ * - implement `std::string name()`
+ * - be copy or move constructible
+ * - be thread-safe
+ *
+ * Built-in merge operators: pmem::kv::uint64_add_merge_operator and
+ * pmem::kv::append_merge_operator.
+ *
+ * @param[in] merge_operator forwarding reference to a merge operator
+ *
+ * @return pmem::kv::status
+ */
+template <typename MergeOperator>
+inline status config::put_merge_operator(MergeOperator &&merge_operator)
+{
+	static_assert(
+		std::is_same<decltype(std::declval<MergeOperator>().merge(
+				     std::declval<string_view>(),
+				     std::declval<const string_view *>(),
+				     std::declval<string_view>(),
+				     std::declval<std::string &>())),
+			     bool>::value,
+		"MergeOperator should implement `bool merge(pmem::kv::string_view, const pmem::kv::string_view *, pmem::kv::string_view, std::string &)` method");
+	static_assert(
+		std::is_convertible<decltype(std::declval<MergeOperator>().name()),
+				    std::string>::value,
+		"MergeOperator should implement `std::string name()` method");
+
+	if (init() != 0)
+		return status::UNKNOWN_ERROR;
+
+	using op_type = typename std::decay<MergeOperator>::type;
+	std::unique_ptr<internal::merge_operator_base> wrapper;
+	std::string name;
+
+	try {
+		name = merge_operator.name();
+		wrapper = std::unique_ptr<internal::merge_operator_base>(
+			new internal::merge_operator_wrapper<op_type>(
+				std::forward<MergeOperator>(merge_operator)));
+	} catch (std::bad_alloc &e) {
+		return status::OUT_OF_MEMORY;
+	} catch (...) {
+		return status::UNKNOWN_ERROR;
+	}
+
+	auto op = std::unique_ptr<pmemkv_merge_operator,
+				  decltype(pmemkv_merge_operator_delete) *>(
+		pmemkv_merge_operator_new(&internal::call_merge_function, name.c_str(),
+					  wrapper.get()),
+		&pmemkv_merge_operator_delete);
+	if (op == nullptr)
+		return status::UNKNOWN_ERROR;
+
+	internal::unique_ptr_wrapper_base *entry;
+
+	try {
+		entry = new internal::merge_operator_config_entry(std::move(wrapper),
+								  std::move(op));
+	} catch (std::bad_alloc &e) {
+		return status::OUT_OF_MEMORY;
+	} catch (...) {
+		return status::UNKNOWN_ERROR;
+	}
+
+	return static_cast<status>(pmemkv_config_put_object_cb(
+		this->config_.get(), "merge_operator", (void *)entry,
+		internal::call_up_get, internal::call_up_destructor));
+}
+
 /**
  * Puts std::uint64_t value to a config.
  *
@@ -1743,21 +2348,210 @@ inline void tx::abort() noexcept
 	pmemkv_tx_abort(tx_.get());
 }
 
-/*
- * All functions which will be called by C code must be declared as extern "C"
- * to ensure they have C linkage. It is needed because it is possible that
- * C and C++ functions use different calling conventions.
+/**
+ * Default constructor with uninitialized (empty) batch. Memory for the batch
+ * is allocated lazily, on first put() or remove().
  */
-extern "C" {
-static inline int call_get_kv_function(const char *key, size_t keybytes,
-				       const char *value, size_t valuebytes, void *arg)
+inline write_batch::write_batch() noexcept : batch_(nullptr, &pmemkv_write_batch_delete)
 {
-	return (*reinterpret_cast<std::function<get_kv_function> *>(arg))(
-		string_view(key, keybytes), string_view(value, valuebytes));
 }
 
-static inline void call_get_v_function(const char *value, size_t valuebytes, void *arg)
-{
+/**
+ * Initialization function for write_batch.
+ * It's lazy initialized and called within put() and remove().
+ *
+ * @return int initialization result; 0 on success
+ */
+inline int write_batch::init() noexcept
+{
+	if (this->batch_.get() == nullptr) {
+		this->batch_ = {pmemkv_write_batch_new(), &pmemkv_write_batch_delete};
+
+		if (this->batch_.get() == nullptr)
+			return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * Adds put operation to the batch. Both key and value are copied into
+ * the batch, so they don't have to outlive this call.
+ *
+ * @param[in] key record's key
+ * @param[in] value data to be inserted for specified key
+ *
+ * @return pmem::kv::status
+ */
+inline status write_batch::put(string_view key, string_view value) noexcept
+{
+	if (init() != 0)
+		return status::OUT_OF_MEMORY;
+
+	return static_cast<status>(pmemkv_write_batch_put(
+		batch_.get(), key.data(), key.size(), value.data(), value.size()));
+}
+
+/**
+ * Adds remove operation to the batch. Removing a key which does not exist
+ * (when the batch is applied) is not considered an error.
+ *
+ * @param[in] key record's key
+ *
+ * @return pmem::kv::status
+ */
+inline status write_batch::remove(string_view key) noexcept
+{
+	if (init() != 0)
+		return status::OUT_OF_MEMORY;
+
+	return static_cast<status>(
+		pmemkv_write_batch_remove(batch_.get(), key.data(), key.size()));
+}
+
+/**
+ * Returns number of operations in the batch.
+ *
+ * @return number of operations
+ */
+inline std::size_t write_batch::count() const noexcept
+{
+	std::size_t cnt = 0;
+	if (batch_.get() != nullptr)
+		pmemkv_write_batch_count(batch_.get(), &cnt);
+
+	return cnt;
+}
+
+/**
+ * Removes all operations from the batch, so it can be reused.
+ */
+inline void write_batch::clear() noexcept
+{
+	pmemkv_write_batch_clear(batch_.get());
+}
+
+/**
+ * Default constructor for scan_cursor. The C cursor is lazily initialized,
+ * by the first paginated scan.
+ *
+ * @param[in] max_count maximum number of records in a page (0 - no limit)
+ * @param[in] max_bytes maximum size of keys and values in a page (0 - no limit)
+ */
+inline scan_cursor::scan_cursor(std::size_t max_count, std::size_t max_bytes) noexcept
+    : max_count(max_count),
+      max_bytes(max_bytes),
+      cursor_(nullptr, &pmemkv_scan_cursor_delete)
+{
+}
+
+/**
+ * Initialization function for scan_cursor.
+ *
+ * @return int initialization result; 0 on success
+ */
+inline int scan_cursor::init() noexcept
+{
+	if (this->cursor_.get() == nullptr) {
+		this->cursor_ = std::unique_ptr<pmemkv_scan_cursor,
+						decltype(&pmemkv_scan_cursor_delete)>(
+			pmemkv_scan_cursor_new(max_count, max_bytes),
+			&pmemkv_scan_cursor_delete);
+	}
+
+	if (this->cursor_.get() == nullptr)
+		return 1;
+
+	return 0;
+}
+
+/**
+ * Checks if the range of the last paginated scan may contain more records.
+ *
+ * @return true if there is a next page to be read
+ */
+inline bool scan_cursor::has_more() const noexcept
+{
+	const char *k;
+	size_t kb;
+
+	return cursor_.get() != nullptr &&
+		pmemkv_scan_cursor_next_key(cursor_.get(), &k, &kb) == PMEMKV_STATUS_OK;
+}
+
+/**
+ * Returns the continuation key - key of the last record returned by the last
+ * paginated scan. It is valid until the next scan with this cursor.
+ *
+ * @return continuation key (empty if there are no more records)
+ */
+inline string_view scan_cursor::next_key() const noexcept
+{
+	const char *k;
+	size_t kb;
+
+	if (cursor_.get() == nullptr ||
+	    pmemkv_scan_cursor_next_key(cursor_.get(), &k, &kb) != PMEMKV_STATUS_OK)
+		return string_view();
+
+	return string_view(k, kb);
+}
+
+/**
+ * Constructs C++ pinned_value object from a C pmemkv_pinned_value pointer
+ */
+inline pinned_value::pinned_value(pmemkv_pinned_value *pv) noexcept
+    : pv_(pv, &pmemkv_pinned_value_delete)
+{
+	const char *data = nullptr;
+	size_t size = 0;
+	pmemkv_pinned_value_read(pv, &data, &size);
+
+	value_ = string_view(data, size);
+}
+
+/**
+ * Returns the pinned value. It is valid until release() is called or
+ * the object is destroyed.
+ *
+ * @return value of the record
+ */
+inline string_view pinned_value::value() const noexcept
+{
+	return value_;
+}
+
+/**
+ * Unpins the value (e.g. releases locks held on the record). Data
+ * previously returned by value() must not be accessed afterwards.
+ */
+inline void pinned_value::release() noexcept
+{
+	pv_.reset();
+	value_ = string_view();
+}
+
+/*
+ * All functions which will be called by C code must be declared as extern "C"
+ * to ensure they have C linkage. It is needed because it is possible that
+ * C and C++ functions use different calling conventions.
+ */
+extern "C" {
+static inline int call_get_kv_function(const char *key, size_t keybytes,
+				       const char *value, size_t valuebytes, void *arg)
+{
+	return (*reinterpret_cast<std::function<get_kv_function> *>(arg))(
+		string_view(key, keybytes), string_view(value, valuebytes));
+}
+
+static inline int call_get_k_function(const char *key, size_t keybytes, void *arg)
+{
+	return (*reinterpret_cast<std::function<get_k_function> *>(arg))(
+		string_view(key, keybytes));
+}
+
+static inline void call_get_v_function(const char *value, size_t valuebytes, void *arg)
+{
 	(*reinterpret_cast<std::function<get_v_function> *>(arg))(
 		string_view(value, valuebytes));
 }
@@ -1767,505 +2561,2090 @@ static inline void call_get_copy(const char *v, size_t vb, void *arg)
 	auto c = reinterpret_cast<std::string *>(arg);
 	c->assign(v, vb);
 }
+
+static inline int call_bulk_load_function(const char **k, size_t *kb, const char **v,
+					  size_t *vb, void *arg)
+{
+	string_view key, value;
+	if (!(*reinterpret_cast<std::function<bulk_load_function> *>(arg))(key, value))
+		return 1;
+
+	*k = key.data();
+	*kb = key.size();
+	*v = value.data();
+	*vb = value.size();
+	return 0;
+}
+
+static inline int call_slow_op_function(const pmemkv_slow_op *op, void *arg)
+{
+	return (*reinterpret_cast<std::function<slow_op_function> *>(arg))(*op);
+}
+
+static inline void call_append_key(const char *k, size_t kb, void *arg)
+{
+	auto keys = reinterpret_cast<std::vector<std::string> *>(arg);
+	keys->emplace_back(k, kb);
+}
+
+static inline void call_get_many_function(size_t idx, int s, const char *value,
+					  size_t valuebytes, void *arg)
+{
+	(*reinterpret_cast<std::function<get_many_function> *>(arg))(
+		idx, static_cast<status>(s), string_view(value, valuebytes));
+}
+
+static inline void call_put_async_promise(int s, const char *, size_t, void *arg)
+{
+	std::unique_ptr<std::promise<status>> p(
+		reinterpret_cast<std::promise<status> *>(arg));
+
+	try {
+		p->set_value(static_cast<status>(s));
+	} catch (...) {
+	}
+}
+
+static inline void call_get_async_promise(int s, const char *value, size_t valuebytes,
+					  void *arg)
+{
+	std::unique_ptr<std::promise<result<std::string>>> p(
+		reinterpret_cast<std::promise<result<std::string>> *>(arg));
+
+	try {
+		if (s == PMEMKV_STATUS_OK)
+			p->set_value(result<std::string>(std::string(value, valuebytes)));
+		else
+			p->set_value(result<std::string>(static_cast<status>(s)));
+	} catch (...) {
+		try {
+			p->set_exception(std::current_exception());
+		} catch (...) {
+		}
+	}
+}
 }
 
 /**
- * Default constructor with uninitialized database.
+ * Constructs C++ snapshot object from a C pmemkv_snapshot pointer
  */
-inline db::db() noexcept : db_(nullptr, &pmemkv_close)
+inline snapshot::snapshot(pmemkv_snapshot *sn) noexcept
+    : sn_(sn, &pmemkv_snapshot_delete)
 {
 }
 
 /**
- * Opens the pmemkv database with specified config.
+ * It returns number of records in the snapshot.
  *
- * @param[in] engine_name name of the engine to work with
- * @param[in] cfg pmem::kv::config with parameters specified for the engine
+ * @param[out] cnt number of records in the snapshot
  *
  * @return pmem::kv::status
  */
-inline status db::open(const std::string &engine_name, config &&cfg) noexcept
+inline status snapshot::count_all(std::size_t &cnt) noexcept
 {
-	pmemkv_db *db;
-	auto s =
-		static_cast<status>(pmemkv_open(engine_name.c_str(), cfg.release(), &db));
-	if (s == pmem::kv::status::OK)
-		this->db_.reset(db);
-	return s;
+	return static_cast<status>(pmemkv_snapshot_count_all(sn_.get(), &cnt));
 }
 
 /**
- * Closes pmemkv database.
+ * Executes (C-like) *callback* function for every record in the snapshot,
+ * in order of keys. Callback can stop iteration by returning non-zero value.
+ * In that case pmem::kv::status::STOPPED_BY_CB is returned.
+ *
+ * @param[in] callback function to be called for every record
+ * @param[in] arg additional arguments to be passed to callback
+ *
+ * @return pmem::kv::status
  */
-inline void db::close() noexcept
+inline status snapshot::get_all(get_kv_callback *callback, void *arg) noexcept
 {
-	this->db_.reset(nullptr);
+	return static_cast<status>(pmemkv_snapshot_get_all(sn_.get(), callback, arg));
 }
 
 /**
- * It returns number of currently stored elements in pmem::kv::db.
+ * Executes function for every record in the snapshot, in order of keys.
+ * Callback can stop iteration by returning non-zero value. In that case
+ * pmem::kv::status::STOPPED_BY_CB is returned.
  *
- * @param[out] cnt number of records stored in pmem::kv::db.
+ * @param[in] f function called for each record, with key and value
  *
  * @return pmem::kv::status
  */
-inline status db::count_all(std::size_t &cnt) noexcept
+inline status snapshot::get_all(std::function<get_kv_function> f) noexcept
 {
-	return static_cast<status>(pmemkv_count_all(this->db_.get(), &cnt));
+	return static_cast<status>(
+		pmemkv_snapshot_get_all(sn_.get(), call_get_kv_function, &f));
 }
 
 /**
- * It returns number of currently stored elements in pmem::kv::db, whose keys
- * are greater than the given *key*.
- * Keys are sorted in order specified by a comparator.
+ * Executes (C-like) *callback* function for every record in the snapshot,
+ * whose key is greater than the given *key*.
  *
- * @param[in] key sets the lower bound of counting
- * @param[out] cnt number of records in pmem::kv::db matching query
+ * @param[in] key sets the lower bound for querying
+ * @param[in] callback function to be called for each returned record
+ * @param[in] arg additional arguments to be passed to callback
  *
  * @return pmem::kv::status
  */
-inline status db::count_above(string_view key, std::size_t &cnt) noexcept
+inline status snapshot::get_above(string_view key, get_kv_callback *callback,
+				  void *arg) noexcept
 {
-	return static_cast<status>(
-		pmemkv_count_above(this->db_.get(), key.data(), key.size(), &cnt));
+	return static_cast<status>(pmemkv_snapshot_get_above(
+		sn_.get(), key.data(), key.size(), callback, arg));
 }
 
 /**
- * It returns number of currently stored elements in pmem::kv::db, whose keys
- * are greater than or equal to the given *key*.
- * Keys are sorted in order specified by a comparator.
+ * Executes function for every record in the snapshot, whose key is greater
+ * than the given *key*.
  *
- * @param[in] key sets the lower bound of counting
- * @param[out] cnt number of records in pmem::kv::db matching query
+ * @param[in] key sets the lower bound for querying
+ * @param[in] f function called for each returned record, with key and value
  *
  * @return pmem::kv::status
  */
-inline status db::count_equal_above(string_view key, std::size_t &cnt) noexcept
+inline status snapshot::get_above(string_view key,
+				  std::function<get_kv_function> f) noexcept
 {
-	return static_cast<status>(
-		pmemkv_count_equal_above(this->db_.get(), key.data(), key.size(), &cnt));
+	return static_cast<status>(pmemkv_snapshot_get_above(
+		sn_.get(), key.data(), key.size(), call_get_kv_function, &f));
 }
 
 /**
- * It returns number of currently stored elements in pmem::kv::db, whose keys
- * are lower than or equal to the given *key*.
- * Keys are sorted in order specified by a comparator.
+ * Executes (C-like) *callback* function for every record in the snapshot,
+ * whose key is greater than the *key1* and less than the *key2*.
  *
- * @param[in] key sets the lower bound of counting
- * @param[out] cnt number of records in pmem::kv::db matching query
+ * @param[in] key1 sets the lower bound for querying
+ * @param[in] key2 sets the upper bound for querying
+ * @param[in] callback function to be called for each returned record
+ * @param[in] arg additional arguments to be passed to callback
  *
  * @return pmem::kv::status
  */
-inline status db::count_equal_below(string_view key, std::size_t &cnt) noexcept
+inline status snapshot::get_between(string_view key1, string_view key2,
+				    get_kv_callback *callback, void *arg) noexcept
 {
 	return static_cast<status>(
-		pmemkv_count_equal_below(this->db_.get(), key.data(), key.size(), &cnt));
+		pmemkv_snapshot_get_between(sn_.get(), key1.data(), key1.size(),
+					    key2.data(), key2.size(), callback, arg));
 }
 
 /**
- * It returns number of currently stored elements in pmem::kv::db, whose keys
- * are less than the given *key*.
- * Keys are sorted in order specified by a comparator.
+ * Executes function for every record in the snapshot, whose key is greater
+ * than the *key1* and less than the *key2*.
  *
- * @param[in] key sets the upper bound of counting
- * @param[out] cnt number of records in pmem::kv::db matching query
+ * @param[in] key1 sets the lower bound for querying
+ * @param[in] key2 sets the upper bound for querying
+ * @param[in] f function called for each returned record, with key and value
  *
  * @return pmem::kv::status
  */
-inline status db::count_below(string_view key, std::size_t &cnt) noexcept
+inline status snapshot::get_between(string_view key1, string_view key2,
+				    std::function<get_kv_function> f) noexcept
 {
-	return static_cast<status>(
-		pmemkv_count_below(this->db_.get(), key.data(), key.size(), &cnt));
+	return static_cast<status>(pmemkv_snapshot_get_between(
+		sn_.get(), key1.data(), key1.size(), key2.data(), key2.size(),
+		call_get_kv_function, &f));
 }
 
 /**
- * It returns number of currently stored elements in pmem::kv::db, whose keys
- * are greater than the *key1* and less than the *key2*.
- * Keys are sorted in order specified by a comparator.
+ * Checks existence of record with given *key* in the snapshot.
  *
- * @param[in] key1 sets the lower bound of counting
- * @param[in] key2 sets the upper bound of counting
- * @param[out] cnt number of records in pmem::kv::db matching query
+ * @param[in] key record's key to query for
  *
- * @return pmem::kv::status
+ * @return pmem::kv::status::OK or pmem::kv::status::NOT_FOUND
  */
-inline status db::count_between(string_view key1, string_view key2,
-				std::size_t &cnt) noexcept
+inline status snapshot::exists(string_view key) noexcept
 {
-	return static_cast<status>(pmemkv_count_between(this->db_.get(), key1.data(),
-							key1.size(), key2.data(),
-							key2.size(), &cnt));
+	return static_cast<status>(
+		pmemkv_snapshot_exists(sn_.get(), key.data(), key.size()));
 }
 
 /**
- * Executes (C-like) *callback* function for every record stored in pmem::kv::db.
- * Arguments passed to the callback function are: pointer to a key, size of the
- * key, pointer to a value, size of the value and *arg* specified by the user.
- * Callback can stop iteration by returning non-zero value. In that case *get_all()*
- * returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues iteration.
+ * Executes (C-like) *callback* function for record with given *key*, as it
+ * was when the snapshot was created.
  *
- * @param[in] callback function to be called for every element stored in db
+ * @param[in] key record's key to query for
+ * @param[in] callback function to be called for returned value
  * @param[in] arg additional arguments to be passed to callback
  *
  * @return pmem::kv::status
  */
-inline status db::get_all(get_kv_callback *callback, void *arg) noexcept
+inline status snapshot::get(string_view key, get_v_callback *callback,
+			    void *arg) noexcept
 {
-	return static_cast<status>(pmemkv_get_all(this->db_.get(), callback, arg));
+	return static_cast<status>(pmemkv_snapshot_get(sn_.get(), key.data(),
+						       key.size(), callback, arg));
 }
 
 /**
- * Executes function for every record stored in pmem::kv::db.
- * Callback can stop iteration by returning non-zero value. In that case *get_all()*
- * returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues iteration.
+ * Executes function for record with given *key*, as it was when the snapshot
+ * was created.
  *
- * @param[in] f function called for each returned element, it is called with params:
- *				key and value
+ * @param[in] key record's key to query for
+ * @param[in] f function called with the value
  *
  * @return pmem::kv::status
  */
-inline status db::get_all(std::function<get_kv_function> f) noexcept
+inline status snapshot::get(string_view key, std::function<get_v_function> f) noexcept
 {
-	return static_cast<status>(
-		pmemkv_get_all(this->db_.get(), call_get_kv_function, &f));
+	return static_cast<status>(pmemkv_snapshot_get(
+		sn_.get(), key.data(), key.size(), call_get_v_function, &f));
 }
 
 /**
- * Executes (C-like) callback function for every record stored in pmem::kv::db,
- * whose keys are greater than the given *key*.
- * Arguments passed to the callback function are: pointer to a key, size of the
- * key, pointer to a value, size of the value and *arg* specified by the user.
- * Callback can stop iteration by returning non-zero value. In that case *get_above()*
- * returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues iteration.
+ * Gets value copy of record with given *key*, as it was when the snapshot
+ * was created.
  *
- * Keys are sorted in order specified by a comparator.
+ * @param[in] key record's key to query for
+ * @param[out] value stores returned copy of the data
  *
- * @param[in] key sets the lower bound for querying
- * @param[in] callback function to be called for each returned element
- * @param[in] arg additional arguments to be passed to callback
+ * @return pmem::kv::status
+ */
+inline status snapshot::get(string_view key, std::string *value) noexcept
+{
+	return static_cast<status>(pmemkv_snapshot_get(
+		sn_.get(), key.data(), key.size(), call_get_copy, value));
+}
+
+/**
+ * Releases the snapshot, so previous versions of records are not kept for
+ * it anymore. The snapshot must not be used afterwards.
+ */
+inline void snapshot::release() noexcept
+{
+	sn_.reset();
+}
+
+/**
+ * Default constructor with uninitialized database.
+ */
+inline db::db() noexcept : db_(nullptr, &pmemkv_close)
+{
+}
+
+/**
+ * Opens the pmemkv database with specified config.
+ *
+ * @param[in] engine_name name of the engine to work with
+ * @param[in] cfg pmem::kv::config with parameters specified for the engine
+ *
+ * @return pmem::kv::status
+ */
+inline status db::open(const std::string &engine_name, config &&cfg) noexcept
+{
+	pmemkv_db *db;
+	auto s =
+		static_cast<status>(pmemkv_open(engine_name.c_str(), cfg.release(), &db));
+	if (s == pmem::kv::status::OK)
+		this->db_.reset(db);
+	return s;
+}
+
+/**
+ * Closes pmemkv database.
+ */
+inline void db::close() noexcept
+{
+	this->db_.reset(nullptr);
+}
+
+/**
+ * It returns number of currently stored elements in pmem::kv::db.
+ *
+ * @param[out] cnt number of records stored in pmem::kv::db.
+ *
+ * @return pmem::kv::status
+ */
+inline status db::count_all(std::size_t &cnt) noexcept
+{
+	return static_cast<status>(pmemkv_count_all(this->db_.get(), &cnt));
+}
+
+/**
+ * It returns number of currently stored elements in pmem::kv::db, whose keys
+ * are greater than the given *key*.
+ * Keys are sorted in order specified by a comparator.
+ *
+ * @param[in] key sets the lower bound of counting
+ * @param[out] cnt number of records in pmem::kv::db matching query
+ *
+ * @return pmem::kv::status
+ */
+inline status db::count_above(string_view key, std::size_t &cnt) noexcept
+{
+	return static_cast<status>(
+		pmemkv_count_above(this->db_.get(), key.data(), key.size(), &cnt));
+}
+
+/**
+ * It returns number of currently stored elements in pmem::kv::db, whose keys
+ * are greater than or equal to the given *key*.
+ * Keys are sorted in order specified by a comparator.
+ *
+ * @param[in] key sets the lower bound of counting
+ * @param[out] cnt number of records in pmem::kv::db matching query
+ *
+ * @return pmem::kv::status
+ */
+inline status db::count_equal_above(string_view key, std::size_t &cnt) noexcept
+{
+	return static_cast<status>(
+		pmemkv_count_equal_above(this->db_.get(), key.data(), key.size(), &cnt));
+}
+
+/**
+ * It returns number of currently stored elements in pmem::kv::db, whose keys
+ * are lower than or equal to the given *key*.
+ * Keys are sorted in order specified by a comparator.
+ *
+ * @param[in] key sets the lower bound of counting
+ * @param[out] cnt number of records in pmem::kv::db matching query
+ *
+ * @return pmem::kv::status
+ */
+inline status db::count_equal_below(string_view key, std::size_t &cnt) noexcept
+{
+	return static_cast<status>(
+		pmemkv_count_equal_below(this->db_.get(), key.data(), key.size(), &cnt));
+}
+
+/**
+ * It returns number of currently stored elements in pmem::kv::db, whose keys
+ * are less than the given *key*.
+ * Keys are sorted in order specified by a comparator.
+ *
+ * @param[in] key sets the upper bound of counting
+ * @param[out] cnt number of records in pmem::kv::db matching query
+ *
+ * @return pmem::kv::status
+ */
+inline status db::count_below(string_view key, std::size_t &cnt) noexcept
+{
+	return static_cast<status>(
+		pmemkv_count_below(this->db_.get(), key.data(), key.size(), &cnt));
+}
+
+/**
+ * It returns number of currently stored elements in pmem::kv::db, whose keys
+ * are greater than the *key1* and less than the *key2*.
+ * Keys are sorted in order specified by a comparator.
+ *
+ * @param[in] key1 sets the lower bound of counting
+ * @param[in] key2 sets the upper bound of counting
+ * @param[out] cnt number of records in pmem::kv::db matching query
+ *
+ * @return pmem::kv::status
+ */
+inline status db::count_between(string_view key1, string_view key2,
+				std::size_t &cnt) noexcept
+{
+	return static_cast<status>(pmemkv_count_between(this->db_.get(), key1.data(),
+							key1.size(), key2.data(),
+							key2.size(), &cnt));
+}
+
+/**
+ * It returns number of currently stored elements in pmem::kv::db, whose keys
+ * start with the *prefix* (compared byte by byte, regardless of a comparator).
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] prefix prefix of counted keys
+ * @param[out] cnt number of records in pmem::kv::db matching query
+ *
+ * @return pmem::kv::status
+ */
+inline status db::count_prefix(string_view prefix, std::size_t &cnt) noexcept
+{
+	return static_cast<status>(pmemkv_count_prefix(this->db_.get(), prefix.data(),
+						       prefix.size(), &cnt));
+}
+
+/**
+ * Executes (C-like) *callback* function for every record stored in pmem::kv::db.
+ * Arguments passed to the callback function are: pointer to a key, size of the
+ * key, pointer to a value, size of the value and *arg* specified by the user.
+ * Callback can stop iteration by returning non-zero value. In that case *get_all()*
+ * returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues iteration.
+ *
+ * @param[in] callback function to be called for every element stored in db
+ * @param[in] arg additional arguments to be passed to callback
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_all(get_kv_callback *callback, void *arg) noexcept
+{
+	return static_cast<status>(pmemkv_get_all(this->db_.get(), callback, arg));
+}
+
+/**
+ * Executes function for every record stored in pmem::kv::db.
+ * Callback can stop iteration by returning non-zero value. In that case *get_all()*
+ * returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues iteration.
+ *
+ * @param[in] f function called for each returned element, it is called with params:
+ *				key and value
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_all(std::function<get_kv_function> f) noexcept
+{
+	return static_cast<status>(
+		pmemkv_get_all(this->db_.get(), call_get_kv_function, &f));
+}
+
+/**
+ * Returns (in *keys*, in ascending order) keys which split the keyspace of
+ * pmem::kv::db into at most *partitions* ranges of similar size: the first
+ * range contains keys below keys[0], range i keys from keys[i - 1] (inclusive)
+ * to keys[i] (exclusive) and the last one keys from the last split point up.
+ * Split points do not have to be present in the database. Fewer keys are
+ * returned if there are not enough records.
+ *
+ * Split points are supported by stree (taken from inner nodes of the tree),
+ * csmap and radix; other engines return pmem::kv::status::NOT_SUPPORTED.
+ * They can be used to scan ranges of the database concurrently, e.g.
+ * with db::get_between() called from separate threads.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] partitions requested number of ranges, must be greater than 0
+ * @param[out] keys split points
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_split_points(std::size_t partitions,
+				   std::vector<std::string> &keys) noexcept
+{
+	keys.clear();
+
+	return static_cast<status>(pmemkv_get_split_points(
+		this->db_.get(), partitions, call_append_key, &keys));
+}
+
+/**
+ * Executes (C-like) callback function for every record stored in pmem::kv::db,
+ * like db::get_all(), but the records are split into (at most) *partitions*
+ * partitions, which are scanned concurrently - each by a separate thread.
+ * Callback is called concurrently from these threads, so it has to be
+ * thread-safe; the order of records is unspecified.
+ *
+ * cmap, vcmap and robinhood split their buckets (or shards), sorted engines
+ * split their keyspace at db::get_split_points(). Engines which support neither
+ * scan all records in the caller's thread.
+ *
+ * Modifications done concurrently with the scan (also by the callback) are not
+ * allowed, the same as for db::get_all().
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * Callback can stop the scan by returning non-zero value - all partitions are
+ * then stopped (after the records currently being processed by other threads)
+ * and *get_all_parallel()* returns pmem::kv::status::STOPPED_BY_CB.
+ *
+ * @param[in] partitions number of partitions (threads), must be greater than 0
+ * @param[in] callback function to be called for each returned element
+ * @param[in] arg additional arguments to be passed to callback
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_all_parallel(std::size_t partitions, get_kv_callback *callback,
+				   void *arg) noexcept
+{
+	return static_cast<status>(
+		pmemkv_get_all_parallel(this->db_.get(), partitions, callback, arg));
+}
+
+/**
+ * Executes function for every record stored in pmem::kv::db, from *partitions*
+ * threads concurrently. See db::get_all_parallel() with C-like callback for
+ * details.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] partitions number of partitions (threads), must be greater than 0
+ * @param[in] f thread-safe function called for each returned element, it is
+ *				called with params: key and value
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_all_parallel(std::size_t partitions,
+				   std::function<get_kv_function> f) noexcept
+{
+	return static_cast<status>(pmemkv_get_all_parallel(
+		this->db_.get(), partitions, call_get_kv_function, &f));
+}
+
+/**
+ * Executes (C-like) callback function for records stored in pmem::kv::db,
+ * in ascending order of keys, starting from the record at position *n*
+ * (the first record has position 0). If *n* is not less than the number of
+ * records, callback is not called and pmem::kv::status::OK is returned.
+ * Callback can stop iteration by returning non-zero value. In that case
+ * *get_by_rank()* returns pmem::kv::status::STOPPED_BY_CB.
+ *
+ * It is supported by stree. If it was created with the "subtree_counts"
+ * config flag, it keeps the number of records in subtrees of inner nodes and
+ * finds the starting record with a single descent, otherwise it walks leaves
+ * from the first one. Other engines return pmem::kv::status::NOT_SUPPORTED.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] n position of the first returned record
+ * @param[in] callback function to be called for each returned element
+ * @param[in] arg additional arguments to be passed to callback
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_by_rank(std::size_t n, get_kv_callback *callback,
+			      void *arg) noexcept
+{
+	return static_cast<status>(pmemkv_get_by_rank(this->db_.get(), n, callback, arg));
+}
+
+/**
+ * Executes function for records stored in pmem::kv::db, starting from the
+ * record at position *n*. See db::get_by_rank() with C-like callback for
+ * details.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] n position of the first returned record
+ * @param[in] f function called for each returned element, it is called with params:
+ *				key and value
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_by_rank(std::size_t n, std::function<get_kv_function> f) noexcept
+{
+	return static_cast<status>(
+		pmemkv_get_by_rank(this->db_.get(), n, call_get_kv_function, &f));
+}
+
+/**
+ * Returns (in *rank*) position of the record with given *key*, i.e. the number
+ * of records with keys less than *key*. If record does not exist
+ * pmem::kv::status::NOT_FOUND is returned. Supported by stree only, other
+ * engines return pmem::kv::status::NOT_SUPPORTED.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] key record's key to query for
+ * @param[out] rank position of the record
+ *
+ * @return pmem::kv::status
+ */
+inline status db::rank_of(string_view key, std::size_t &rank) noexcept
+{
+	return static_cast<status>(
+		pmemkv_rank_of(this->db_.get(), key.data(), key.size(), &rank));
+}
+
+/**
+ * Executes (C-like) callback function for every record stored in pmem::kv::db,
+ * whose keys are greater than the given *key*.
+ * Arguments passed to the callback function are: pointer to a key, size of the
+ * key, pointer to a value, size of the value and *arg* specified by the user.
+ * Callback can stop iteration by returning non-zero value. In that case *get_above()*
+ * returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues iteration.
+ *
+ * Keys are sorted in order specified by a comparator.
+ *
+ * @param[in] key sets the lower bound for querying
+ * @param[in] callback function to be called for each returned element
+ * @param[in] arg additional arguments to be passed to callback
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_above(string_view key, get_kv_callback *callback,
+			    void *arg) noexcept
+{
+	return static_cast<status>(
+		pmemkv_get_above(this->db_.get(), key.data(), key.size(), callback, arg));
+}
+
+/**
+ * Executes function for every record stored in pmem::kv::db, whose keys are
+ * greater than the given *key*.
+ * Callback can stop iteration by returning non-zero value. In that case *get_above()*
+ * returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues iteration.
+ *
+ * Keys are sorted in order specified by a comparator.
+ *
+ * @param[in] key sets the lower bound for querying
+ * @param[in] f function called for each returned element, it is called with params:
+ *				key and value
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_above(string_view key, std::function<get_kv_function> f) noexcept
+{
+	return static_cast<status>(pmemkv_get_above(
+		this->db_.get(), key.data(), key.size(), call_get_kv_function, &f));
+}
+
+/**
+ * Executes (C-like) callback function for every record stored in pmem::kv::db,
+ * whose keys are greater than or equal to the given *key*.
+ * Arguments passed to the callback function are: pointer to a key, size of the
+ * key, pointer to a value, size of the value and *arg* specified by the user.
+ * Callback can stop iteration by returning non-zero value. In that case
+ * *get_equal_above()* returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues
+ * iteration.
+ *
+ * Keys are sorted in order specified by a comparator.
+ *
+ * @param[in] key sets the lower bound for querying
+ * @param[in] callback function to be called for each returned element
+ * @param[in] arg additional arguments to be passed to callback
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_equal_above(string_view key, get_kv_callback *callback,
+				  void *arg) noexcept
+{
+	return static_cast<status>(pmemkv_get_equal_above(this->db_.get(), key.data(),
+							  key.size(), callback, arg));
+}
+
+/**
+ * Executes function for every record stored in pmem::kv::db, whose keys are
+ * greater than or equal to the given *key*.
+ * Callback can stop iteration by returning non-zero value. In that case
+ **get_equal_above()* returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues
+ *iteration.
+ *
+ * Keys are sorted in order specified by a comparator.
+ *
+ * @param[in] key sets the lower bound for querying
+ * @param[in] f function called for each returned element, it is called with params:
+ *				key and value
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_equal_above(string_view key,
+				  std::function<get_kv_function> f) noexcept
+{
+	return static_cast<status>(pmemkv_get_equal_above(
+		this->db_.get(), key.data(), key.size(), call_get_kv_function, &f));
+}
+
+/**
+ * Executes (C-like) callback function for every record stored in pmem::kv::db,
+ * whose keys are lower than or equal to the given *key*.
+ * Arguments passed to the callback function are: pointer to a key, size of the
+ * key, pointer to a value, size of the value and *arg* specified by the user.
+ * Callback can stop iteration by returning non-zero value. In that case
+ * *get_equal_below()* returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues
+ * iteration.
+ *
+ * Keys are sorted in order specified by a comparator.
+ *
+ * @param[in] key sets the upper bound for querying
+ * @param[in] callback function to be called for each returned element
+ * @param[in] arg additional arguments to be passed to callback
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_equal_below(string_view key, get_kv_callback *callback,
+				  void *arg) noexcept
+{
+	return static_cast<status>(pmemkv_get_equal_below(this->db_.get(), key.data(),
+							  key.size(), callback, arg));
+}
+
+/**
+ * Executes function for every record stored in pmem::kv::db, whose keys are
+ * lower than or equal to the given *key*.
+ * Callback can stop iteration by returning non-zero value. In that case
+ **get_equal_below()* returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues
+ *iteration.
+ *
+ * Keys are sorted in order specified by a comparator.
+ *
+ * @param[in] key sets the upper bound for querying
+ * @param[in] f function called for each returned element, it is called with params:
+ *				key and value
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_equal_below(string_view key,
+				  std::function<get_kv_function> f) noexcept
+{
+	return static_cast<status>(pmemkv_get_equal_below(
+		this->db_.get(), key.data(), key.size(), call_get_kv_function, &f));
+}
+
+/**
+ * Executes (C-like) callback function for every record stored in pmem::kv::db,
+ * whose keys are lower than the given *key*.
+ * Arguments passed to the callback function are: pointer to a key, size of the
+ * key, pointer to a value, size of the value and *arg* specified by the user.
+ * Callback can stop iteration by returning non-zero value. In that case *get_below()*
+ * returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues iteration.
+ *
+ * Keys are sorted in order specified by a comparator.
+ *
+ * @param[in] key sets the upper bound for querying
+ * @param[in] callback function to be called for each returned element
+ * @param[in] arg additional arguments to be passed to callback
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_below(string_view key, get_kv_callback *callback,
+			    void *arg) noexcept
+{
+	return static_cast<status>(
+		pmemkv_get_below(this->db_.get(), key.data(), key.size(), callback, arg));
+}
+
+/**
+ * Executes function for every record stored in pmem::kv::db, whose keys are
+ * less than the given *key*.
+ * Callback can stop iteration by returning non-zero value. In that case *get_below()*
+ * returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues iteration.
+ *
+ * Keys are sorted in order specified by a comparator.
+ *
+ * @param[in] key sets the upper bound for querying
+ * @param[in] f function called for each returned element, it is called with params:
+ *				key and value
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_below(string_view key, std::function<get_kv_function> f) noexcept
+{
+	return static_cast<status>(pmemkv_get_below(
+		this->db_.get(), key.data(), key.size(), call_get_kv_function, &f));
+}
+
+/**
+ * Executes (C-like) callback function for every record stored in pmem::kv::db,
+ * whose keys are greater than the *key1* and less than the *key2*.
+ * Arguments passed to the callback function are: pointer to a key, size of the
+ * key, pointer to a value, size of the value and *arg* specified by the user.
+ * Callback can stop iteration by returning non-zero value. In that case *get_between()*
+ * returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues iteration.
+ *
+ * Keys are sorted in order specified by a comparator.
+ *
+ * @param[in] key1 sets the lower bound for querying
+ * @param[in] key2 sets the upper bound for querying
+ * @param[in] callback function to be called for each returned element
+ * @param[in] arg additional arguments to be passed to callback
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_between(string_view key1, string_view key2,
+			      get_kv_callback *callback, void *arg) noexcept
+{
+	return static_cast<status>(pmemkv_get_between(this->db_.get(), key1.data(),
+						      key1.size(), key2.data(),
+						      key2.size(), callback, arg));
+}
+/**
+ * Executes function for every record stored in pmem::kv::db, whose keys
+ * are greater than the *key1* and less than the *key2*.
+ * Callback can stop iteration by returning non-zero value. In that case *get_between()*
+ * returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues iteration.
+ *
+ * Keys are sorted in order specified by a comparator.
+ *
+ * @param[in] key1 sets the lower bound for querying
+ * @param[in] key2 sets the upper bound for querying
+ * @param[in] f function called for each returned element, it is called with params:
+ *				key and value
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_between(string_view key1, string_view key2,
+			      std::function<get_kv_function> f) noexcept
+{
+	return static_cast<status>(
+		pmemkv_get_between(this->db_.get(), key1.data(), key1.size(), key2.data(),
+				   key2.size(), call_get_kv_function, &f));
+}
+
+/**
+ * Executes (C-like) callback function for every record stored in pmem::kv::db,
+ * whose key starts with the *prefix* (compared byte by byte). Sorted engines
+ * find such records with a single lookup; if they use a custom comparator (or
+ * the engine is unsorted), keys with a common prefix may not be adjacent, so
+ * all records are checked.
+ * Arguments passed to the callback function are: pointer to a key, size of the
+ * key, pointer to a value, size of the value and *arg* specified by the user.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * Callback can stop iteration by returning non-zero value. In that case *get_prefix()*
+ * returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues iteration.
+ *
+ * @param[in] prefix prefix of keys of returned records
+ * @param[in] callback function to be called for each returned element
+ * @param[in] arg additional arguments to be passed to callback
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_prefix(string_view prefix, get_kv_callback *callback,
+			     void *arg) noexcept
+{
+	return static_cast<status>(pmemkv_get_prefix(this->db_.get(), prefix.data(),
+						     prefix.size(), callback, arg));
+}
+
+/**
+ * Executes function for every record stored in pmem::kv::db, whose key starts
+ * with the *prefix*. See db::get_prefix() with C-like callback for details.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] prefix prefix of keys of returned records
+ * @param[in] f function called for each returned element, it is called with params:
+ *				key and value
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_prefix(string_view prefix,
+			     std::function<get_kv_function> f) noexcept
+{
+	return static_cast<status>(pmemkv_get_prefix(this->db_.get(), prefix.data(),
+						     prefix.size(), call_get_kv_function,
+						     &f));
+}
+
+/**
+ * Executes (C-like) callback function for the key of every record stored in
+ * pmem::kv::db. Values are not passed to the callback, which allows engines to
+ * skip reading them: csmap, stree and radix do not access values (nor lock
+ * records) at all, cmap reads only keys from its buckets and tree3 takes keys
+ * from its volatile (DRAM) leaves. Other engines read records as db::get_all()
+ * does. Arguments passed to the callback function are: pointer to a key, size
+ * of the key and *arg* specified by the user.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * Callback can stop iteration by returning non-zero value. In that case *get_keys()*
+ * returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues iteration.
+ *
+ * Keys are returned in the same order as db::get_all() returns records.
+ *
+ * @param[in] callback function to be called for each returned key
+ * @param[in] arg additional arguments to be passed to callback
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_keys(get_k_callback *callback, void *arg) noexcept
+{
+	return static_cast<status>(pmemkv_get_keys(this->db_.get(), callback, arg));
+}
+
+/**
+ * Executes function for the key of every record stored in pmem::kv::db.
+ * See db::get_keys() with C-like callback for details.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] f function called for each returned key
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_keys(std::function<get_k_function> f) noexcept
+{
+	return static_cast<status>(
+		pmemkv_get_keys(this->db_.get(), call_get_k_function, &f));
+}
+
+/**
+ * Executes (C-like) callback function for every key stored in pmem::kv::db,
+ * which is greater than the given *key*, as db::get_above() does, but without
+ * values (see db::get_keys()).
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] key sets the lower bound for querying
+ * @param[in] callback function to be called for each returned key
+ * @param[in] arg additional arguments to be passed to callback
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_keys_above(string_view key, get_k_callback *callback,
+				 void *arg) noexcept
+{
+	return static_cast<status>(pmemkv_get_keys_above(this->db_.get(), key.data(),
+							 key.size(), callback, arg));
+}
+
+/**
+ * Executes function for every key stored in pmem::kv::db, which is greater
+ * than the given *key*. See db::get_keys_above() with C-like callback for
+ * details.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] key sets the lower bound for querying
+ * @param[in] f function called for each returned key
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_keys_above(string_view key,
+				 std::function<get_k_function> f) noexcept
+{
+	return static_cast<status>(pmemkv_get_keys_above(
+		this->db_.get(), key.data(), key.size(), call_get_k_function, &f));
+}
+
+/**
+ * Executes (C-like) callback function for every key stored in pmem::kv::db,
+ * which is lower than the given *key*, as db::get_below() does, but without
+ * values (see db::get_keys()).
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] key sets the upper bound for querying
+ * @param[in] callback function to be called for each returned key
+ * @param[in] arg additional arguments to be passed to callback
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_keys_below(string_view key, get_k_callback *callback,
+				 void *arg) noexcept
+{
+	return static_cast<status>(pmemkv_get_keys_below(this->db_.get(), key.data(),
+							 key.size(), callback, arg));
+}
+
+/**
+ * Executes function for every key stored in pmem::kv::db, which is lower
+ * than the given *key*. See db::get_keys_below() with C-like callback for
+ * details.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] key sets the upper bound for querying
+ * @param[in] f function called for each returned key
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_keys_below(string_view key,
+				 std::function<get_k_function> f) noexcept
+{
+	return static_cast<status>(pmemkv_get_keys_below(
+		this->db_.get(), key.data(), key.size(), call_get_k_function, &f));
+}
+
+/**
+ * Executes (C-like) callback function for every key stored in pmem::kv::db,
+ * which is greater than the *key1* and lower than the *key2*, as
+ * db::get_between() does, but without values (see db::get_keys()).
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] key1 sets the lower bound for querying
+ * @param[in] key2 sets the upper bound for querying
+ * @param[in] callback function to be called for each returned key
+ * @param[in] arg additional arguments to be passed to callback
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_keys_between(string_view key1, string_view key2,
+				   get_k_callback *callback, void *arg) noexcept
+{
+	return static_cast<status>(
+		pmemkv_get_keys_between(this->db_.get(), key1.data(), key1.size(),
+					key2.data(), key2.size(), callback, arg));
+}
+
+/**
+ * Executes function for every key stored in pmem::kv::db, which is greater
+ * than the *key1* and lower than the *key2*. See db::get_keys_between() with
+ * C-like callback for details.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] key1 sets the lower bound for querying
+ * @param[in] key2 sets the upper bound for querying
+ * @param[in] f function called for each returned key
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_keys_between(string_view key1, string_view key2,
+				   std::function<get_k_function> f) noexcept
+{
+	return static_cast<status>(pmemkv_get_keys_between(
+		this->db_.get(), key1.data(), key1.size(), key2.data(), key2.size(),
+		call_get_k_function, &f));
+}
+
+/**
+ * Executes (C-like) callback function for every record stored in pmem::kv::db,
+ * in descending order of keys (reversed order specified by a comparator).
+ * Arguments passed to the callback function are: pointer to a key, size of the
+ * key, pointer to a value, size of the value and *arg* specified by the user.
+ * Only sorted engines support descending scans (stree, radix, csmap, vsmap);
+ * other engines return pmem::kv::status::NOT_SUPPORTED. The records are
+ * visited starting from the greatest key, so e.g. the newest N records (with
+ * time-ordered keys) can be read by stopping the scan after N callbacks,
+ * without visiting the rest of the range.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * Callback can stop iteration by returning non-zero value. In that case
+ * *get_all_desc()* returns pmem::kv::status::STOPPED_BY_CB. Returning 0
+ * continues iteration.
+ *
+ * @param[in] callback function to be called for each returned element
+ * @param[in] arg additional arguments to be passed to callback
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_all_desc(get_kv_callback *callback, void *arg) noexcept
+{
+	return static_cast<status>(pmemkv_get_all_desc(this->db_.get(), callback, arg));
+}
+
+/**
+ * Executes function for every record stored in pmem::kv::db, in descending
+ * order of keys. See db::get_all_desc() with C-like callback for details.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] f function called for each returned element, it is called with params:
+ *				key and value
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_all_desc(std::function<get_kv_function> f) noexcept
+{
+	return static_cast<status>(
+		pmemkv_get_all_desc(this->db_.get(), call_get_kv_function, &f));
+}
+
+/**
+ * Executes (C-like) callback function for every record stored in pmem::kv::db,
+ * whose keys are greater than the *key*, in descending order.
+ * See db::get_all_desc() for details.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] key sets the lower bound for querying
+ * @param[in] callback function to be called for each returned element
+ * @param[in] arg additional arguments to be passed to callback
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_above_desc(string_view key, get_kv_callback *callback,
+				 void *arg) noexcept
+{
+	return static_cast<status>(pmemkv_get_above_desc(
+		this->db_.get(), key.data(), key.size(), callback, arg));
+}
+
+/**
+ * Executes function for every record stored in pmem::kv::db, whose keys are
+ * greater than the *key*, in descending order. See db::get_all_desc() for details.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] key sets the lower bound for querying
+ * @param[in] f function called for each returned element, it is called with params:
+ *				key and value
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_above_desc(string_view key,
+				 std::function<get_kv_function> f) noexcept
+{
+	return static_cast<status>(pmemkv_get_above_desc(
+		this->db_.get(), key.data(), key.size(), call_get_kv_function, &f));
+}
+
+/**
+ * Executes (C-like) callback function for every record stored in pmem::kv::db,
+ * whose keys are greater than or equal to the *key*, in descending order.
+ * See db::get_all_desc() for details.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] key sets the lower bound for querying
+ * @param[in] callback function to be called for each returned element
+ * @param[in] arg additional arguments to be passed to callback
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_equal_above_desc(string_view key, get_kv_callback *callback,
+				       void *arg) noexcept
+{
+	return static_cast<status>(pmemkv_get_equal_above_desc(
+		this->db_.get(), key.data(), key.size(), callback, arg));
+}
+
+/**
+ * Executes function for every record stored in pmem::kv::db, whose keys are
+ * greater than or equal to the *key*, in descending order.
+ * See db::get_all_desc() for details.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] key sets the lower bound for querying
+ * @param[in] f function called for each returned element, it is called with params:
+ *				key and value
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_equal_above_desc(string_view key,
+				       std::function<get_kv_function> f) noexcept
+{
+	return static_cast<status>(pmemkv_get_equal_above_desc(
+		this->db_.get(), key.data(), key.size(), call_get_kv_function, &f));
+}
+
+/**
+ * Executes (C-like) callback function for every record stored in pmem::kv::db,
+ * whose keys are lower than or equal to the *key*, in descending order.
+ * See db::get_all_desc() for details.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] key sets the upper bound for querying
+ * @param[in] callback function to be called for each returned element
+ * @param[in] arg additional arguments to be passed to callback
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_equal_below_desc(string_view key, get_kv_callback *callback,
+				       void *arg) noexcept
+{
+	return static_cast<status>(pmemkv_get_equal_below_desc(
+		this->db_.get(), key.data(), key.size(), callback, arg));
+}
+
+/**
+ * Executes function for every record stored in pmem::kv::db, whose keys are
+ * lower than or equal to the *key*, in descending order.
+ * See db::get_all_desc() for details.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] key sets the upper bound for querying
+ * @param[in] f function called for each returned element, it is called with params:
+ *				key and value
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_equal_below_desc(string_view key,
+				       std::function<get_kv_function> f) noexcept
+{
+	return static_cast<status>(pmemkv_get_equal_below_desc(
+		this->db_.get(), key.data(), key.size(), call_get_kv_function, &f));
+}
+
+/**
+ * Executes (C-like) callback function for every record stored in pmem::kv::db,
+ * whose keys are less than the *key*, in descending order.
+ * See db::get_all_desc() for details.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] key sets the upper bound for querying
+ * @param[in] callback function to be called for each returned element
+ * @param[in] arg additional arguments to be passed to callback
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_below_desc(string_view key, get_kv_callback *callback,
+				 void *arg) noexcept
+{
+	return static_cast<status>(pmemkv_get_below_desc(
+		this->db_.get(), key.data(), key.size(), callback, arg));
+}
+
+/**
+ * Executes function for every record stored in pmem::kv::db, whose keys are
+ * less than the *key*, in descending order. See db::get_all_desc() for details.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] key sets the upper bound for querying
+ * @param[in] f function called for each returned element, it is called with params:
+ *				key and value
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_below_desc(string_view key,
+				 std::function<get_kv_function> f) noexcept
+{
+	return static_cast<status>(pmemkv_get_below_desc(
+		this->db_.get(), key.data(), key.size(), call_get_kv_function, &f));
+}
+
+/**
+ * Executes (C-like) callback function for every record stored in pmem::kv::db,
+ * whose keys are greater than the *key1* and less than the *key2*, in
+ * descending order. See db::get_all_desc() for details.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] key1 sets the lower bound for querying
+ * @param[in] key2 sets the upper bound for querying
+ * @param[in] callback function to be called for each returned element
+ * @param[in] arg additional arguments to be passed to callback
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_between_desc(string_view key1, string_view key2,
+				   get_kv_callback *callback, void *arg) noexcept
+{
+	return static_cast<status>(pmemkv_get_between_desc(this->db_.get(), key1.data(),
+							   key1.size(), key2.data(),
+							   key2.size(), callback, arg));
+}
+
+/**
+ * Executes function for every record stored in pmem::kv::db, whose keys are
+ * greater than the *key1* and less than the *key2*, in descending order.
+ * See db::get_all_desc() for details.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] key1 sets the lower bound for querying
+ * @param[in] key2 sets the upper bound for querying
+ * @param[in] f function called for each returned element, it is called with params:
+ *				key and value
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_between_desc(string_view key1, string_view key2,
+				   std::function<get_kv_function> f) noexcept
+{
+	return static_cast<status>(pmemkv_get_between_desc(
+		this->db_.get(), key1.data(), key1.size(), key2.data(), key2.size(),
+		call_get_kv_function, &f));
+}
+
+/**
+ * Executes (C-like) callback function for a single page of records whose keys
+ * are greater than the *key*. The page is limited by the *cursor* (see
+ * pmem::kv::scan_cursor). When the page is returned, cursor.has_more() tells
+ * if there may be more records and cursor.next_key() returns the key to be
+ * passed as *key* to get the next page (with the same cursor). Engines which
+ * support it (stree, radix, csmap, vsmap) continue the scan from the position
+ * cached in the cursor, instead of seeking from the root again.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * Callback can stop iteration by returning non-zero value. In that case
+ * pmem::kv::status::STOPPED_BY_CB is returned and the cursor can still be used
+ * to continue after the last record passed to the callback. The continuation
+ * key is stored in the cursor, so it must not be modified when passed as *key*.
+ *
+ * @param[in] key sets the lower bound for querying
+ * @param[in] cursor limits of the page and state of the scan
+ * @param[in] callback function to be called for each returned element
+ * @param[in] arg additional arguments to be passed to callback
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_above_page(string_view key, scan_cursor &cursor,
+				 get_kv_callback *callback, void *arg) noexcept
+{
+	if (cursor.init() != 0)
+		return status::UNKNOWN_ERROR;
+
+	return static_cast<status>(pmemkv_get_above_page(this->db_.get(), key.data(),
+							 key.size(), cursor.cursor_.get(),
+							 callback, arg));
+}
+
+/**
+ * Executes function for a single page of records whose keys are greater than
+ * the *key*. See db::get_above_page() with C-like callback for details.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] key sets the lower bound for querying
+ * @param[in] cursor limits of the page and state of the scan
+ * @param[in] f function called for each returned element, it is called with params:
+ *				key and value
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_above_page(string_view key, scan_cursor &cursor,
+				 std::function<get_kv_function> f) noexcept
+{
+	return get_above_page(key, cursor, call_get_kv_function, &f);
+}
+
+/**
+ * Executes (C-like) callback function for a single page of records whose keys
+ * are greater than the *key1* and less than the *key2*. The page is limited by
+ * the *cursor*. To get the next page, pass cursor.next_key() as *key1*.
+ * See db::get_above_page() for details.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] key1 sets the lower bound for querying
+ * @param[in] key2 sets the upper bound for querying
+ * @param[in] cursor limits of the page and state of the scan
+ * @param[in] callback function to be called for each returned element
+ * @param[in] arg additional arguments to be passed to callback
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_between_page(string_view key1, string_view key2,
+				   scan_cursor &cursor, get_kv_callback *callback,
+				   void *arg) noexcept
+{
+	if (cursor.init() != 0)
+		return status::UNKNOWN_ERROR;
+
+	return static_cast<status>(pmemkv_get_between_page(
+		this->db_.get(), key1.data(), key1.size(), key2.data(), key2.size(),
+		cursor.cursor_.get(), callback, arg));
+}
+
+/**
+ * Executes function for a single page of records whose keys are greater than
+ * the *key1* and less than the *key2*. See db::get_between_page() with C-like
+ * callback for details.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] key1 sets the lower bound for querying
+ * @param[in] key2 sets the upper bound for querying
+ * @param[in] cursor limits of the page and state of the scan
+ * @param[in] f function called for each returned element, it is called with params:
+ *				key and value
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_between_page(string_view key1, string_view key2,
+				   scan_cursor &cursor,
+				   std::function<get_kv_function> f) noexcept
+{
+	return get_between_page(key1, key2, cursor, call_get_kv_function, &f);
+}
+
+/**
+ * Checks existence of record with given *key*. If record is present
+ * pmem::kv::status::OK is returned, otherwise pmem::kv::status::NOT_FOUND
+ * is returned. Other possible return values are described in pmem::kv::status.
+ *
+ * @param[in] key record's key to query for in database
+ *
+ * @return pmem::kv::status
+ */
+inline status db::exists(string_view key) noexcept
+{
+	return static_cast<status>(
+		pmemkv_exists(this->db_.get(), key.data(), key.size()));
+}
+
+/**
+ * Executes (C-like) *callback* function for record with given *key*. If
+ * record is present and no error occurred, the function returns
+ * pmem::kv::status::OK. If record does not exist pmem::kv::status::NOT_FOUND
+ * is returned. Other possible return values are described in pmem::kv::status.
+ * *Callback* is called with the following parameters:
+ * pointer to a value, size of the value and *arg* specified by the user.
+ * This function is guaranteed to be implemented by all engines.
+ *
+ * @param[in] key record's key to query for
+ * @param[in] callback function to be called for returned element
+ * @param[in] arg additional arguments to be passed to callback
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get(string_view key, get_v_callback *callback, void *arg) noexcept
+{
+	return static_cast<status>(
+		pmemkv_get(this->db_.get(), key.data(), key.size(), callback, arg));
+}
+
+/**
+ * Executes function for record with given *key*. If record is present and
+ * no error occurred the function returns pmem::kv::status::OK. If record does
+ * not exist pmem::kv::status::NOT_FOUND is returned.
+ *
+ * @param[in] key record's key to query for
+ * @param[in] f function called for returned element, it is called with only
+ *				one param - value (key is known)
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get(string_view key, std::function<get_v_function> f) noexcept
+{
+	return static_cast<status>(pmemkv_get(this->db_.get(), key.data(), key.size(),
+					      call_get_v_function, &f));
+}
+
+/**
+ * Gets value copy of record with given *key*. In absence of any errors,
+ * pmem::kv::status::OK is returned.
+ * This function is guaranteed to be implemented by all engines.
+ *
+ * @param[in] key record's key to query for
+ * @param[out] value stores returned copy of the data
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get(string_view key, std::string *value) noexcept
+{
+	return static_cast<status>(pmemkv_get(this->db_.get(), key.data(), key.size(),
+					      call_get_copy, value));
+}
+
+/**
+ * Gets value of record with given *key* without copying it. Returned
+ * pinned_value references the place where the value is stored and keeps
+ * the record protected until it's released, so - contrary to db::get() with
+ * a callback - the value can be used after this function returns. If record
+ * does not exist pmem::kv::status::NOT_FOUND is returned.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * For cmap the record's read lock is held (concurrent updates of the same
+ * key wait), for csmap the record's lock and the global lock are held in
+ * shared mode (updates of the key and all removes wait), for radix the value
+ * is valid until the record is modified or removed. Other engines return
+ * a copy of the value. This function is guaranteed to be implemented by
+ * all engines.
+ *
+ * @param[in] key record's key to query for
+ *
+ * @return pinned value or pmem::kv::status
+ */
+inline result<pinned_value> db::get_pinned(string_view key) noexcept
+{
+	pmemkv_pinned_value *pv;
+	auto s = static_cast<status>(
+		pmemkv_get_pinned(this->db_.get(), key.data(), key.size(), &pv));
+
+	if (s == status::OK)
+		return result<pinned_value>(pinned_value(pv));
+	else
+		return result<pinned_value>(s);
+}
+
+/**
+ * Gets size of the value of record with given *key*, without reading the
+ * value itself (engines read only the stored length: cmap, csmap, stree,
+ * radix, tree3, vsmap and vcmap; robinhood values have a fixed size).
+ * If record does not exist pmem::kv::status::NOT_FOUND is returned.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] key record's key to query for
+ * @param[out] size size of the value (in bytes)
+ *
+ * @return pmem::kv::status
+ */
+inline status db::value_size(string_view key, std::size_t &size) noexcept
+{
+	return static_cast<status>(
+		pmemkv_value_size(this->db_.get(), key.data(), key.size(), &size));
+}
+
+/**
+ * Creates a consistent, point-in-time read view of the database, see
+ * pmem::kv::snapshot. Creating a snapshot waits for modifications in progress
+ * (for csmap: also for iterators and pinned values held by other threads)
+ * to finish; reads from the snapshot do not block writers.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @return snapshot or pmem::kv::status
+ */
+inline result<snapshot> db::snapshot() noexcept
+{
+	pmemkv_snapshot *sn;
+	auto s = static_cast<status>(pmemkv_snapshot_new(this->db_.get(), &sn));
+
+	if (s == status::OK)
+		return result<pmem::kv::snapshot>(pmem::kv::snapshot(sn));
+	else
+		return result<pmem::kv::snapshot>(s);
+}
+
+/**
+ * Looks up all *keys* in a single call and executes (C-like) *callback*
+ * once for every key, in the order of *keys*. *Callback* is called with the
+ * following parameters: position of the key in *keys*, status of the lookup
+ * (PMEMKV_STATUS_OK or e.g. PMEMKV_STATUS_NOT_FOUND), pointer to a value
+ * (nullptr if key was not found), size of the value and *arg* specified by
+ * the user. Engines which support it resolve all keys before reading any
+ * value, so memory accesses of independent lookups can overlap.
+ *
+ * The function returns pmem::kv::status::OK if all keys were processed,
+ * even if some of them were not found. Data pointed by value is valid only
+ * inside the callback and the callback must not modify the database.
+ * This function is guaranteed to be implemented by all engines.
+ *
+ * @param[in] keys records' keys to query for
+ * @param[in] callback function to be called for every key
+ * @param[in] arg additional arguments to be passed to callback
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_many(const std::vector<string_view> &keys,
+			   get_many_callback *callback, void *arg) noexcept
+{
+	std::vector<const char *> ks;
+	std::vector<size_t> kbs;
+
+	try {
+		ks.reserve(keys.size());
+		kbs.reserve(keys.size());
+	} catch (std::bad_alloc &e) {
+		return status::OUT_OF_MEMORY;
+	} catch (...) {
+		return status::UNKNOWN_ERROR;
+	}
+
+	for (const auto &key : keys) {
+		ks.push_back(key.data());
+		kbs.push_back(key.size());
+	}
+
+	return static_cast<status>(pmemkv_get_many(this->db_.get(), keys.size(),
+						   ks.data(), kbs.data(), callback, arg));
+}
+
+/**
+ * Looks up all *keys* in a single call and executes function *f* once for
+ * every key, in the order of *keys*. See db::get_many() with C-like callback
+ * for details.
+ *
+ * @param[in] keys records' keys to query for
+ * @param[in] f function called for every key, with its position in *keys*,
+ *				lookup status and value
+ *
+ * @return pmem::kv::status
+ */
+inline status db::get_many(const std::vector<string_view> &keys,
+			   std::function<get_many_function> f) noexcept
+{
+	return get_many(keys, call_get_many_function, &f);
+}
+
+/**
+ * Inserts a key-value pair into pmemkv database.
+ * This function is guaranteed to be implemented by all engines.
+ *
+ * @param[in] key record's key; record will be put into database under its name
+ * @param[in] value data to be inserted into this new database record
+ *
+ * @return pmem::kv::status
+ */
+inline status db::put(string_view key, string_view value) noexcept
+{
+	return static_cast<status>(pmemkv_put(this->db_.get(), key.data(), key.size(),
+					      value.data(), value.size()));
+}
+
+/**
+ * Inserts a key-value pair into pmemkv database, which expires after *ttl*.
+ * An expired record is not returned by point lookups (db::get(), db::exists()
+ * and similar) and it's removed from the engine by a background reaper,
+ * which processes only records which have already expired. The rate of
+ * removals is limited by "ttl_reap_rate" config parameter.
+ *
+ * Overwriting the record with db::put() (or removing it) cancels the
+ * expiration. Deadlines are kept in DRAM only - a record which has not expired
+ * before the database is closed becomes a regular one after reopening it.
+ * Range scans, counts and iterators may return expired records which have not
+ * been removed yet.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * Supported by cmap and radix engines (radix, which is single-threaded,
+ * removes expired records during its write operations instead of using
+ * a background thread).
+ *
+ * @param[in] key record's key
+ * @param[in] value data to be inserted
+ * @param[in] ttl time-to-live of the record, must be greater than 0
+ *
+ * @return pmem::kv::status
+ */
+inline status db::put(string_view key, string_view value,
+		      std::chrono::milliseconds ttl) noexcept
+{
+	if (ttl.count() <= 0)
+		return status::INVALID_ARGUMENT;
+
+	return static_cast<status>(pmemkv_put_with_ttl(
+		this->db_.get(), key.data(), key.size(), value.data(), value.size(),
+		static_cast<uint64_t>(ttl.count())));
+}
+
+/**
+ * Merges the *operand* into the record with given *key*: the new value of
+ * the record is computed by the merge operator, set in the config (see
+ * config::put_merge_operator()), from the current value of the record (if it
+ * exists) and the *operand*. The whole read-modify-write takes a single lookup
+ * and is atomic with respect to other operations on the same key.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * Supported by cmap and csmap engines. If there is no merge operator in
+ * the config or the merge operator fails, the record is not modified and
+ * pmem::kv::status::INVALID_ARGUMENT is returned.
+ *
+ * @param[in] key record's key
+ * @param[in] operand data to be merged into the record
  *
  * @return pmem::kv::status
  */
-inline status db::get_above(string_view key, get_kv_callback *callback,
-			    void *arg) noexcept
+inline status db::merge(string_view key, string_view operand) noexcept
 {
-	return static_cast<status>(
-		pmemkv_get_above(this->db_.get(), key.data(), key.size(), callback, arg));
+	return static_cast<status>(pmemkv_merge(this->db_.get(), key.data(), key.size(),
+						operand.data(), operand.size()));
 }
 
 /**
- * Executes function for every record stored in pmem::kv::db, whose keys are
- * greater than the given *key*.
- * Callback can stop iteration by returning non-zero value. In that case *get_above()*
- * returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues iteration.
+ * Inserts a key-value pair into pmemkv database only if there is no record
+ * with given *key*. The check and the insertion are atomic with respect to
+ * other operations on the same key.
  *
- * Keys are sorted in order specified by a comparator.
+ * __This API is EXPERIMENTAL and might change.__
  *
- * @param[in] key sets the lower bound for querying
- * @param[in] f function called for each returned element, it is called with params:
- *				key and value
+ * Supported by cmap, csmap, robinhood and vcmap engines.
  *
- * @return pmem::kv::status
+ * @param[in] key record's key
+ * @param[in] value data to be inserted
+ *
+ * @return pmem::kv::status::OK if the record was inserted,
+ * pmem::kv::status::CONDITION_NOT_MET if the record already exists
+ * (it's not modified then) or other pmem::kv::status on error.
  */
-inline status db::get_above(string_view key, std::function<get_kv_function> f) noexcept
+inline status db::put_if_absent(string_view key, string_view value) noexcept
 {
-	return static_cast<status>(pmemkv_get_above(
-		this->db_.get(), key.data(), key.size(), call_get_kv_function, &f));
+	return static_cast<status>(pmemkv_put_if_absent(
+		this->db_.get(), key.data(), key.size(), value.data(), value.size()));
 }
 
 /**
- * Executes (C-like) callback function for every record stored in pmem::kv::db,
- * whose keys are greater than or equal to the given *key*.
- * Arguments passed to the callback function are: pointer to a key, size of the
- * key, pointer to a value, size of the value and *arg* specified by the user.
- * Callback can stop iteration by returning non-zero value. In that case
- * *get_equal_above()* returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues
- * iteration.
+ * Replaces the value of the record with given *key* by *desired*, only if its
+ * current value is equal to *expected*. The comparison and the update are
+ * atomic with respect to other operations on the same key.
  *
- * Keys are sorted in order specified by a comparator.
+ * __This API is EXPERIMENTAL and might change.__
  *
- * @param[in] key sets the lower bound for querying
- * @param[in] callback function to be called for each returned element
- * @param[in] arg additional arguments to be passed to callback
+ * Supported by cmap, csmap, robinhood and vcmap engines.
  *
- * @return pmem::kv::status
+ * @param[in] key record's key
+ * @param[in] expected value the record is expected to have
+ * @param[in] desired new value of the record
+ *
+ * @return pmem::kv::status::OK if the value was replaced,
+ * pmem::kv::status::NOT_FOUND if there is no record with given *key*,
+ * pmem::kv::status::CONDITION_NOT_MET if the current value differs from
+ * *expected* or other pmem::kv::status on error.
  */
-inline status db::get_equal_above(string_view key, get_kv_callback *callback,
-				  void *arg) noexcept
+inline status db::compare_and_swap(string_view key, string_view expected,
+				   string_view desired) noexcept
 {
-	return static_cast<status>(pmemkv_get_equal_above(this->db_.get(), key.data(),
-							  key.size(), callback, arg));
+	return static_cast<status>(pmemkv_compare_and_swap(
+		this->db_.get(), key.data(), key.size(), expected.data(),
+		expected.size(), desired.data(), desired.size()));
 }
 
 /**
- * Executes function for every record stored in pmem::kv::db, whose keys are
- * greater than or equal to the given *key*.
- * Callback can stop iteration by returning non-zero value. In that case
- **get_equal_above()* returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues
- *iteration.
+ * Removes the record with given *key*, only if its current value is equal to
+ * *expected*. The comparison and the removal are atomic with respect to other
+ * operations on the same key.
  *
- * Keys are sorted in order specified by a comparator.
+ * __This API is EXPERIMENTAL and might change.__
  *
- * @param[in] key sets the lower bound for querying
- * @param[in] f function called for each returned element, it is called with params:
- *				key and value
+ * Supported by csmap, robinhood and vcmap engines.
  *
- * @return pmem::kv::status
+ * @param[in] key record's key
+ * @param[in] expected value the record is expected to have
+ *
+ * @return pmem::kv::status::OK if the record was removed,
+ * pmem::kv::status::NOT_FOUND if there is no record with given *key*,
+ * pmem::kv::status::CONDITION_NOT_MET if the current value differs from
+ * *expected* or other pmem::kv::status on error.
  */
-inline status db::get_equal_above(string_view key,
-				  std::function<get_kv_function> f) noexcept
+inline status db::remove_if(string_view key, string_view expected) noexcept
 {
-	return static_cast<status>(pmemkv_get_equal_above(
-		this->db_.get(), key.data(), key.size(), call_get_kv_function, &f));
+	return static_cast<status>(pmemkv_remove_if(this->db_.get(), key.data(),
+						    key.size(), expected.data(),
+						    expected.size()));
 }
 
 /**
- * Executes (C-like) callback function for every record stored in pmem::kv::db,
- * whose keys are lower than or equal to the given *key*.
- * Arguments passed to the callback function are: pointer to a key, size of the
- * key, pointer to a value, size of the value and *arg* specified by the user.
- * Callback can stop iteration by returning non-zero value. In that case
- * *get_equal_below()* returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues
- * iteration.
- *
- * Keys are sorted in order specified by a comparator.
+ * Removes from database record with given *key*.
+ * This function is guaranteed to be implemented by all engines.
  *
- * @param[in] key sets the upper bound for querying
- * @param[in] callback function to be called for each returned element
- * @param[in] arg additional arguments to be passed to callback
+ * @param[in] key record's key to query for, to be removed
  *
  * @return pmem::kv::status
  */
-inline status db::get_equal_below(string_view key, get_kv_callback *callback,
-				  void *arg) noexcept
+inline status db::remove(string_view key) noexcept
 {
-	return static_cast<status>(pmemkv_get_equal_below(this->db_.get(), key.data(),
-							  key.size(), callback, arg));
+	return static_cast<status>(
+		pmemkv_remove(this->db_.get(), key.data(), key.size()));
 }
 
 /**
- * Executes function for every record stored in pmem::kv::db, whose keys are
- * lower than or equal to the given *key*.
- * Callback can stop iteration by returning non-zero value. In that case
- **get_equal_below()* returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues
- *iteration.
+ * Removes from database all records with keys from *key1* (inclusive) to
+ * *key2* (exclusive), in order specified by a comparator. Nothing is removed if
+ * *key1* is not lower than *key2*.
  *
- * Keys are sorted in order specified by a comparator.
+ * __This API is EXPERIMENTAL and might change.__
  *
- * @param[in] key sets the upper bound for querying
- * @param[in] f function called for each returned element, it is called with params:
- *				key and value
+ * Supported by sorted engines: csmap removes the whole range in a single pass,
+ * holding its global lock; stree and radix remove records in chunks, each
+ * in a single transaction, so if the operation is interrupted, only a part
+ * of the range may be removed; vsmap also supports it. Other engines return
+ * pmem::kv::status::NOT_SUPPORTED.
+ *
+ * @param[in] key1 lower bound of the range (inclusive)
+ * @param[in] key2 upper bound of the range (exclusive)
  *
  * @return pmem::kv::status
  */
-inline status db::get_equal_below(string_view key,
-				  std::function<get_kv_function> f) noexcept
+inline status db::remove_range(string_view key1, string_view key2) noexcept
 {
-	return static_cast<status>(pmemkv_get_equal_below(
-		this->db_.get(), key.data(), key.size(), call_get_kv_function, &f));
+	return static_cast<status>(pmemkv_remove_range(this->db_.get(), key1.data(),
+						       key1.size(), key2.data(),
+						       key2.size()));
 }
 
 /**
- * Executes (C-like) callback function for every record stored in pmem::kv::db,
- * whose keys are lower than the given *key*.
- * Arguments passed to the callback function are: pointer to a key, size of the
- * key, pointer to a value, size of the value and *arg* specified by the user.
- * Callback can stop iteration by returning non-zero value. In that case *get_below()*
- * returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues iteration.
+ * Removes from database all records whose key starts with the *prefix*
+ * (compared byte by byte).
  *
- * Keys are sorted in order specified by a comparator.
+ * __This API is EXPERIMENTAL and might change.__
  *
- * @param[in] key sets the upper bound for querying
- * @param[in] callback function to be called for each returned element
- * @param[in] arg additional arguments to be passed to callback
+ * Sorted engines using the default comparator (csmap, stree, radix) remove
+ * the range of such keys as db::remove_range() does. Other engines (or custom
+ * comparators) find the keys with db::get_prefix() first and remove them one
+ * by one.
+ *
+ * @param[in] prefix prefix of keys of removed records
  *
  * @return pmem::kv::status
  */
-inline status db::get_below(string_view key, get_kv_callback *callback,
-			    void *arg) noexcept
+inline status db::remove_prefix(string_view prefix) noexcept
 {
 	return static_cast<status>(
-		pmemkv_get_below(this->db_.get(), key.data(), key.size(), callback, arg));
+		pmemkv_remove_prefix(this->db_.get(), prefix.data(), prefix.size()));
 }
 
 /**
- * Executes function for every record stored in pmem::kv::db, whose keys are
- * less than the given *key*.
- * Callback can stop iteration by returning non-zero value. In that case *get_below()*
- * returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues iteration.
- *
- * Keys are sorted in order specified by a comparator.
- *
- * @param[in] key sets the upper bound for querying
- * @param[in] f function called for each returned element, it is called with params:
- *				key and value
+ * Inserts records read from (C-like) callback function, which sets the key and
+ * the value of the next record (through pointers given as its arguments) and
+ * returns 0, or returns non-zero value at the end of data. Key and value have
+ * to stay valid until the next call. Arguments passed to the callback function
+ * are: pointer to a key, pointer to a size of the key, pointer to a value,
+ * pointer to a size of the value and *arg* specified by the user.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * It is meant for the initial population of a database, with records sorted
+ * by key in ascending order (according to the comparator). If the database is
+ * empty, stree builds its tree directly from the records (filling up leaves
+ * one by one), radix inserts them in large transactions and csmap takes its
+ * global lock only once. If keys are not sorted, these engines stop the load
+ * and return pmem::kv::status::INVALID_ARGUMENT - records loaded up to that
+ * point (possibly except the last chunk of them) are kept. Other engines (or
+ * engines which are not empty) insert records one by one, as db::put() does.
+ *
+ * @param[in] callback function returning subsequent records
+ * @param[in] arg additional arguments to be passed to callback
  *
  * @return pmem::kv::status
  */
-inline status db::get_below(string_view key, std::function<get_kv_function> f) noexcept
+inline status db::bulk_load(bulk_load_callback *callback, void *arg) noexcept
 {
-	return static_cast<status>(pmemkv_get_below(
-		this->db_.get(), key.data(), key.size(), call_get_kv_function, &f));
+	return static_cast<status>(pmemkv_bulk_load(this->db_.get(), callback, arg));
 }
 
 /**
- * Executes (C-like) callback function for every record stored in pmem::kv::db,
- * whose keys are greater than the *key1* and less than the *key2*.
- * Arguments passed to the callback function are: pointer to a key, size of the
- * key, pointer to a value, size of the value and *arg* specified by the user.
- * Callback can stop iteration by returning non-zero value. In that case *get_between()*
- * returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues iteration.
+ * Inserts records read from function *f*, which sets the key and the value of
+ * the next record and returns true, or returns false at the end of data.
+ * See db::bulk_load() with C-like callback for details.
  *
- * Keys are sorted in order specified by a comparator.
+ * __This API is EXPERIMENTAL and might change.__
  *
- * @param[in] key1 sets the lower bound for querying
- * @param[in] key2 sets the upper bound for querying
- * @param[in] callback function to be called for each returned element
- * @param[in] arg additional arguments to be passed to callback
+ * @param[in] f function returning subsequent records
  *
  * @return pmem::kv::status
  */
-inline status db::get_between(string_view key1, string_view key2,
-			      get_kv_callback *callback, void *arg) noexcept
+inline status db::bulk_load(std::function<bulk_load_function> f) noexcept
 {
-	return static_cast<status>(pmemkv_get_between(this->db_.get(), key1.data(),
-						      key1.size(), key2.data(),
-						      key2.size(), callback, arg));
+	return static_cast<status>(
+		pmemkv_bulk_load(this->db_.get(), call_bulk_load_function, &f));
 }
+
 /**
- * Executes function for every record stored in pmem::kv::db, whose keys
- * are greater than the *key1* and less than the *key2*.
- * Callback can stop iteration by returning non-zero value. In that case *get_between()*
- * returns pmem::kv::status::STOPPED_BY_CB. Returning 0 continues iteration.
+ * Inserts records read from a file, as db::bulk_load() does. Each record in
+ * the file is stored as the size of its key and the size of its value (both as
+ * 8-byte unsigned integers, in native byte order), followed by the key and the
+ * value. The same file can be loaded when a database is opened, with
+ * "bulk_load_path" config parameter.
  *
- * Keys are sorted in order specified by a comparator.
+ * __This API is EXPERIMENTAL and might change.__
  *
- * @param[in] key1 sets the lower bound for querying
- * @param[in] key2 sets the upper bound for querying
- * @param[in] f function called for each returned element, it is called with params:
- *				key and value
+ * @param[in] path path to the file
  *
  * @return pmem::kv::status
  */
-inline status db::get_between(string_view key1, string_view key2,
-			      std::function<get_kv_function> f) noexcept
+inline status db::bulk_load_file(const std::string &path) noexcept
 {
-	return static_cast<status>(
-		pmemkv_get_between(this->db_.get(), key1.data(), key1.size(), key2.data(),
-				   key2.size(), call_get_kv_function, &f));
+	return static_cast<status>(pmemkv_bulk_load_file(this->db_.get(), path.c_str()));
 }
 
 /**
- * Checks existence of record with given *key*. If record is present
- * pmem::kv::status::OK is returned, otherwise pmem::kv::status::NOT_FOUND
- * is returned. Other possible return values are described in pmem::kv::status.
+ * Schedules insertion of a key-value pair into pmemkv database and returns
+ * without waiting for it. Both key and value are copied, so the caller is free
+ * to reuse the buffers when this function returns. When the operation
+ * completes, (C-like) *callback* is called with its status, nullptr as value,
+ * 0 as value size and *arg* specified by the user.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * Operations are executed by a pool of worker threads, created when
+ * the database is opened, if "async_workers" config item (uint64) is
+ * greater than 0. The callback is then called from one of the worker threads.
+ * Operations on the same key are executed in the order of submission and
+ * adjacent puts may be coalesced and applied as a single batch (see db::write()),
+ * up to "async_max_batch" (uint64, default 64) of them. Every worker queues up
+ * to "async_queue_size" (uint64, default 1024) operations - if the queue is
+ * full, this function blocks until there is space in it. If there are no
+ * workers (default), the operation is executed in the caller's thread and
+ * the callback is called before this function returns.
+ *
+ * The callback must not block and must not wait for completion of other
+ * asynchronous operations. All pending operations are completed (and their
+ * callbacks called) when the database is closed.
+ * This function is guaranteed to be implemented by all engines.
  *
- * @param[in] key record's key to query for in database
+ * @param[in] key record's key
+ * @param[in] value data to be inserted for specified key
+ * @param[in] callback function to be called when operation completes
+ * @param[in] arg additional arguments to be passed to callback
  *
- * @return pmem::kv::status
+ * @return pmem::kv::status::OK if operation was scheduled (callback will be
+ * called exactly once), other status otherwise (callback will not be called)
  */
-inline status db::exists(string_view key) noexcept
+inline status db::put_async(string_view key, string_view value,
+			    completion_callback *callback, void *arg) noexcept
 {
-	return static_cast<status>(
-		pmemkv_exists(this->db_.get(), key.data(), key.size()));
+	return static_cast<status>(pmemkv_put_async(this->db_.get(), key.data(),
+						    key.size(), value.data(),
+						    value.size(), callback, arg));
 }
 
 /**
- * Executes (C-like) *callback* function for record with given *key*. If
- * record is present and no error occurred, the function returns
- * pmem::kv::status::OK. If record does not exist pmem::kv::status::NOT_FOUND
- * is returned. Other possible return values are described in pmem::kv::status.
- * *Callback* is called with the following parameters:
- * pointer to a value, size of the value and *arg* specified by the user.
+ * Schedules insertion of a key-value pair into pmemkv database and returns
+ * a future which becomes ready, with the status of the operation, when it
+ * completes. See db::put_async() with C-like callback for details.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] key record's key
+ * @param[in] value data to be inserted for specified key
+ *
+ * @return std::future with pmem::kv::status of the operation
+ *
+ * @throw std::bad_alloc if memory for the future cannot be allocated
+ */
+inline std::future<status> db::put_async(string_view key, string_view value)
+{
+	std::unique_ptr<std::promise<status>> p(new std::promise<status>);
+	auto f = p->get_future();
+
+	auto s = put_async(key, value, call_put_async_promise, p.get());
+	if (s != status::OK)
+		p->set_value(s);
+	else
+		/* ownership was passed to the callback */
+		p.release();
+
+	return f;
+}
+
+/**
+ * Schedules reading of a value of the record with specified *key* and returns
+ * without waiting for it. When the operation completes, (C-like) *callback*
+ * is called with its status (pmem::kv::status::OK or e.g.
+ * pmem::kv::status::NOT_FOUND), pointer to the value (valid only inside
+ * the callback), size of the value and *arg* specified by the user.
+ * See db::put_async() for details on how operations are executed.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
  * This function is guaranteed to be implemented by all engines.
  *
  * @param[in] key record's key to query for
- * @param[in] callback function to be called for returned element
+ * @param[in] callback function to be called when operation completes
  * @param[in] arg additional arguments to be passed to callback
  *
- * @return pmem::kv::status
+ * @return pmem::kv::status::OK if operation was scheduled (callback will be
+ * called exactly once), other status otherwise (callback will not be called)
  */
-inline status db::get(string_view key, get_v_callback *callback, void *arg) noexcept
+inline status db::get_async(string_view key, completion_callback *callback,
+			    void *arg) noexcept
 {
 	return static_cast<status>(
-		pmemkv_get(this->db_.get(), key.data(), key.size(), callback, arg));
+		pmemkv_get_async(this->db_.get(), key.data(), key.size(), callback, arg));
 }
 
 /**
- * Executes function for record with given *key*. If record is present and
- * no error occurred the function returns pmem::kv::status::OK. If record does
- * not exist pmem::kv::status::NOT_FOUND is returned.
+ * Schedules reading of a value of the record with specified *key* and returns
+ * a future which becomes ready when the operation completes. The future holds
+ * a copy of the value or the status of the failed operation.
+ * See db::put_async() for details on how operations are executed.
+ *
+ * __This API is EXPERIMENTAL and might change.__
  *
  * @param[in] key record's key to query for
- * @param[in] f function called for returned element, it is called with only
- *				one param - value (key is known)
  *
- * @return pmem::kv::status
+ * @return std::future with result containing value or status
+ *
+ * @throw std::bad_alloc if memory for the future cannot be allocated
  */
-inline status db::get(string_view key, std::function<get_v_function> f) noexcept
+inline std::future<result<std::string>> db::get_async(string_view key)
 {
-	return static_cast<status>(pmemkv_get(this->db_.get(), key.data(), key.size(),
-					      call_get_v_function, &f));
+	std::unique_ptr<std::promise<result<std::string>>> p(
+		new std::promise<result<std::string>>);
+	auto f = p->get_future();
+
+	auto s = get_async(key, call_get_async_promise, p.get());
+	if (s != status::OK)
+		p->set_value(result<std::string>(s));
+	else
+		/* ownership was passed to the callback */
+		p.release();
+
+	return f;
 }
 
 /**
- * Gets value copy of record with given *key*. In absence of any errors,
- * pmem::kv::status::OK is returned.
- * This function is guaranteed to be implemented by all engines.
+ * Defragments approximately 'amount_percent' percent of elements
+ * in the database starting from 'start_percent' percent of elements.
  *
- * @param[in] key record's key to query for
- * @param[out] value stores returned copy of the data
+ * @param[in] start_percent starting percent of elements to defragment from
+ * @param[in] amount_percent amount percent of elements to defragment
  *
  * @return pmem::kv::status
  */
-inline status db::get(string_view key, std::string *value) noexcept
+inline status db::defrag(double start_percent, double amount_percent)
 {
-	return static_cast<status>(pmemkv_get(this->db_.get(), key.data(), key.size(),
-					      call_get_copy, value));
+	return static_cast<status>(
+		pmemkv_defrag(this->db_.get(), start_percent, amount_percent));
 }
 
 /**
- * Inserts a key-value pair into pmemkv database.
- * This function is guaranteed to be implemented by all engines.
+ * Gets operation statistics of the database as a JSON object. Statistics are
+ * gathered only if "stats" config flag was set when the database was opened,
+ * otherwise pmem::kv::status::NOT_SUPPORTED is returned.
  *
- * @param[in] key record's key; record will be put into database under its name
- * @param[in] value data to be inserted into this new database record
+ * For each of synchronous get, put, remove, exists, transaction commit and
+ * defrag, the object contains the number of calls (with numbers of calls which
+ * returned pmem::kv::status::NOT_FOUND and which failed), number of bytes
+ * read or written (sizes of values for get, of keys and values for put and
+ * commit) and latency (in nanoseconds): mean, min, p50, p90, p99, p999 and max.
+ * Percentiles are approximated with relative error below 2%. Engines may add
+ * their own counters, e.g. cmap reports number of buckets.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[out] json stores statistics
  *
  * @return pmem::kv::status
  */
-inline status db::put(string_view key, string_view value) noexcept
+inline status db::get_stats(std::string *json) noexcept
 {
-	return static_cast<status>(pmemkv_put(this->db_.get(), key.data(), key.size(),
-					      value.data(), value.size()));
+	return static_cast<status>(pmemkv_get_stats(this->db_.get(), call_get_copy, json));
 }
 
 /**
- * Removes from database record with given *key*.
- * This function is guaranteed to be implemented by all engines.
+ * Reports space usage of the pool: its size, numbers of allocated and free
+ * bytes, bytes used by keys, by values and by index and metadata (allocated
+ * bytes which are neither keys nor values), and an estimated fragmentation
+ * ratio - the part of memory reserved for small allocations which is unused.
+ * Fragmentation close to 1 means that db::defrag() can reclaim space.
+ *
+ * Supported by pmemobj-based engines opened with "heap_stats" config flag,
+ * which enables libpmemobj heap statistics; other engines return
+ * pmem::kv::status::NOT_SUPPORTED. Number of allocated bytes is persisted,
+ * but it's accurate only if statistics were enabled for the whole lifetime of
+ * the pool. Pool size is 0 if the pool was passed by "oid" or is a poolset
+ * or a device DAX (free bytes are also 0 then). Sizes of keys and values are
+ * summed up by iterating over all records on every call, so its cost is
+ * proportional to the number of records.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @return memory_usage_info or pmem::kv::status
+ */
+inline result<memory_usage_info> db::memory_usage() noexcept
+{
+	memory_usage_info usage;
+	auto s = static_cast<status>(pmemkv_get_memory_usage(this->db_.get(), &usage));
+
+	if (s == status::OK)
+		return result<memory_usage_info>(usage);
+	else
+		return result<memory_usage_info>(s);
+}
+
+/**
+ * Writes the last operations of every thread, recorded by the flight recorder,
+ * to a text file (overwriting it). For each synchronous get, put, remove,
+ * exists, transaction commit and defrag the file contains its start time (UTC),
+ * type, 64-bit hash of the key (0 for commit and defrag), latency in nanoseconds and status; operations are
+ * grouped by thread and ordered from the oldest.
  *
- * @param[in] key record's key to query for, to be removed
+ * The recorder is enabled by "flight_recorder" config item (uint64) - number of
+ * operations kept per thread; otherwise pmem::kv::status::NOT_SUPPORTED is
+ * returned. If "flight_recorder_path" config item (string) is set as well, the
+ * recorder dumps itself to that file when an operation fails with
+ * pmem::kv::status::UNKNOWN_ERROR, OUT_OF_MEMORY or TRANSACTION_SCOPE_ERROR
+ * (at most once per second).
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] path file to write operations to
  *
  * @return pmem::kv::status
  */
-inline status db::remove(string_view key) noexcept
+inline status db::flight_recorder_dump(const std::string &path) noexcept
 {
 	return static_cast<status>(
-		pmemkv_remove(this->db_.get(), key.data(), key.size()));
+		pmemkv_flight_recorder_dump(this->db_.get(), path.c_str()));
 }
 
 /**
- * Defragments approximately 'amount_percent' percent of elements
- * in the database starting from 'start_percent' percent of elements.
- *
- * @param[in] start_percent starting percent of elements to defragment from
- * @param[in] amount_percent amount percent of elements to defragment
+ * Executes function *f* for the last (at most 1024) operations which took
+ * longer than the threshold set by "slow_op_threshold_us" config item
+ * (uint64, in microseconds), oldest first; without it
+ * pmem::kv::status::NOT_SUPPORTED is returned. Get, put, remove, exists,
+ * transaction commit and defrag are measured.
+ *
+ * For each operation, pmem::kv::slow_op_info contains its name, up to 32
+ * first bytes of its key (and the key's size), start time (nanoseconds since
+ * the Epoch), latency, id of the thread (as shown by ps or perf) and status.
+ * It also contains the time spent in phases of the operation: lookup in the
+ * index, allocation, flushing data to the medium (including transaction
+ * commits) and waiting for locks or background threads. Engines measure only
+ * the phases they can tell apart, so phases do not have to sum up to the
+ * latency.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * @param[in] f function called for each slow operation; iteration stops if it
+ * returns non-zero value (pmem::kv::status::STOPPED_BY_CB is returned then)
  *
  * @return pmem::kv::status
  */
-inline status db::defrag(double start_percent, double amount_percent)
+inline status db::get_slow_ops(std::function<slow_op_function> f) noexcept
 {
 	return static_cast<status>(
-		pmemkv_defrag(this->db_.get(), start_percent, amount_percent));
+		pmemkv_get_slow_ops(this->db_.get(), call_slow_op_function, &f));
 }
 
 /**
@@ -2320,6 +4699,32 @@ static inline std::string errormsg()
 	return std::string(pmemkv_errormsg());
 }
 
+/**
+ * Applies all operations from the *batch* to the database, in the order
+ * in which they were added to the batch. Engines which support it apply
+ * the whole batch under a single lock acquisition or with a single
+ * flush/drain, which makes it much faster than separate put() and remove()
+ * calls for bulk ingestion.
+ *
+ * __This API is EXPERIMENTAL and might change.__
+ *
+ * The batch is NOT applied atomically - on error, operations preceding
+ * the failing one may already be applied. Removing a non-existing key is
+ * not an error. Applying an empty batch is a no-op.
+ * This function is guaranteed to be implemented by all engines.
+ *
+ * @param[in] batch operations to apply
+ *
+ * @return pmem::kv::status
+ */
+inline status db::write(const write_batch &batch) noexcept
+{
+	if (batch.batch_.get() == nullptr)
+		return status::OK;
+
+	return static_cast<status>(pmemkv_write(this->db_.get(), batch.batch_.get()));
+}
+
 /**
  * Starts a pmemkv transaction.
  *
@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#ifndef LIBPMEMKV_MERGE_OPERATOR_H
+#define LIBPMEMKV_MERGE_OPERATOR_H
+
+#include "config.h"
+#include "libpmemkv.h"
+#include "libpmemkv.hpp"
+
+#include <string>
+
+namespace pmem
+{
+namespace kv
+{
+namespace internal
+{
+
+/**
+ * merge_operator computes a new value of a record from its current value
+ * (if any) and an operand passed to engine_base::merge(). Engines supporting
+ * merge call it while holding the record's lock, so read-modify-write of a
+ * single record needs only one lookup and is atomic.
+ */
+class merge_operator {
+public:
+	merge_operator(pmemkv_merge_function *fn, std::string name, void *arg)
+	    : fn(fn), name_(name), arg(arg)
+	{
+	}
+
+	/*
+	 * existing_value is nullptr if there is no record with the key.
+	 * Returns false if the merge function failed (record must not be
+	 * modified then).
+	 */
+	bool merge(string_view key, const string_view *existing_value,
+		   string_view operand, std::string &new_value) const
+	{
+		new_value.clear();
+
+		auto ret = (*fn)(key.data(), key.size(),
+				 existing_value ? existing_value->data() : nullptr,
+				 existing_value ? existing_value->size() : 0,
+				 operand.data(), operand.size(), set_value, &new_value, arg);
+
+		return ret == 0;
+	}
+
+	std::string name() const
+	{
+		return name_;
+	}
+
+private:
+	static void set_value(const char *value, size_t valuebytes, void *arg)
+	{
+		static_cast<std::string *>(arg)->assign(value, valuebytes);
+	}
+
+	pmemkv_merge_function *fn;
+	std::string name_;
+	void *arg;
+};
+
+/* Returns merge operator set in the config or nullptr if there is none */
+static inline const merge_operator *extract_merge_operator(internal::config &cfg)
+{
+	merge_operator *op;
+
+	if (!cfg.get_object("merge_operator", (void **)&op))
+		return nullptr;
+
+	return op;
+}
+
+} /* namespace internal */
+} /* namespace kv */
+} /* namespace pmem */
+
+#endif /* LIBPMEMKV_MERGE_OPERATOR_H */
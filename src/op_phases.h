@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#ifndef LIBPMEMKV_OP_PHASES_H
+#define LIBPMEMKV_OP_PHASES_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace pmem
+{
+namespace kv
+{
+namespace internal
+{
+
+/* Phases of an operation, reported for slow operations (see slow_op_log) */
+enum class op_phase { lookup, allocation, flush, lock_wait, MAX };
+
+/**
+ * Time spent by the current thread in phases of its current operation.
+ * Phases are timed only while the operation is traced (if slow operation log
+ * is enabled), otherwise phase_timer costs a single thread-local read.
+ */
+struct op_phases {
+	static constexpr std::size_t PHASES = static_cast<std::size_t>(op_phase::MAX);
+
+	bool active;
+	uint64_t ns[PHASES];
+
+	/* zero-initialized, as it has static storage duration */
+	static op_phases &local()
+	{
+		static thread_local op_phases phases;
+		return phases;
+	}
+
+	void begin()
+	{
+		for (std::size_t i = 0; i < PHASES; i++)
+			ns[i] = 0;
+		active = true;
+	}
+};
+
+/**
+ * Adds the time from its creation until stop() (or destruction) to the given
+ * phase of the current operation. Engines place it around sections which may
+ * explain a latency tail: index lookups, allocations, persisting data and
+ * waiting for locks or for background threads.
+ */
+class phase_timer {
+public:
+	using clock_type = std::chrono::steady_clock;
+
+	explicit phase_timer(op_phase phase)
+	    : phase(phase),
+	      active(op_phases::local().active),
+	      start(active ? clock_type::now() : clock_type::time_point())
+	{
+	}
+
+	~phase_timer()
+	{
+		stop();
+	}
+
+	phase_timer(const phase_timer &) = delete;
+	phase_timer &operator=(const phase_timer &) = delete;
+
+	void stop()
+	{
+		if (!active)
+			return;
+
+		op_phases::local().ns[static_cast<std::size_t>(phase)] +=
+			static_cast<uint64_t>(
+				std::chrono::duration_cast<std::chrono::nanoseconds>(
+					clock_type::now() - start)
+					.count());
+		active = false;
+	}
+
+private:
+	op_phase phase;
+	bool active;
+	clock_type::time_point start;
+};
+
+} /* namespace internal */
+} /* namespace kv */
+} /* namespace pmem */
+
+#endif /* LIBPMEMKV_OP_PHASES_H */
@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "parallel_scan.h"
+
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+namespace pmem
+{
+namespace kv
+{
+namespace internal
+{
+
+parallel_scan::parallel_scan(get_kv_callback *callback, void *arg)
+    : user_callback(callback), user_arg(arg), stopped_(false)
+{
+}
+
+int parallel_scan::callback(const char *key, size_t kb, const char *value, size_t vb,
+			    void *arg)
+{
+	auto scan = static_cast<parallel_scan *>(arg);
+
+	/* other partitions are stopped at their next record */
+	if (scan->stopped())
+		return 1;
+
+	auto ret = scan->user_callback(key, kb, value, vb, scan->user_arg);
+	if (ret != 0)
+		scan->stopped_.store(true, std::memory_order_relaxed);
+
+	return ret;
+}
+
+/*
+ * Number of threads does not depend on number of partitions (which comes from
+ * the user) - at most hardware_concurrency() workers, including the caller's
+ * thread, take partitions one by one until all of them are scanned.
+ */
+status parallel_scan::run(std::size_t partitions,
+			  const std::function<status(std::size_t)> &scan)
+{
+	std::vector<status> statuses(partitions, status::OK);
+	std::exception_ptr error;
+	std::mutex error_mtx;
+	std::atomic<std::size_t> next_partition(0);
+
+	auto run_partitions = [&] {
+		while (!stopped()) {
+			auto i = next_partition.fetch_add(1, std::memory_order_relaxed);
+			if (i >= partitions)
+				return;
+
+			try {
+				statuses[i] = scan(i);
+			} catch (...) {
+				stopped_.store(true, std::memory_order_relaxed);
+
+				std::unique_lock<std::mutex> lock(error_mtx);
+				if (!error)
+					error = std::current_exception();
+			}
+		}
+	};
+
+	std::size_t workers = std::min<std::size_t>(
+		partitions, std::max(std::thread::hardware_concurrency(), 1U));
+
+	std::vector<std::thread> threads;
+	threads.reserve(workers);
+	for (std::size_t i = 1; i < workers; i++) {
+		try {
+			threads.emplace_back(run_partitions);
+		} catch (std::system_error &) {
+			/* out of threads - partitions are taken by running workers */
+			break;
+		}
+	}
+
+	run_partitions();
+
+	for (auto &t : threads)
+		t.join();
+
+	if (error)
+		std::rethrow_exception(error);
+
+	for (auto s : statuses) {
+		if (s != status::OK && s != status::STOPPED_BY_CB)
+			return s;
+	}
+
+	return stopped() ? status::STOPPED_BY_CB : status::OK;
+}
+
+} /* namespace internal */
+} /* namespace kv */
+} /* namespace pmem */
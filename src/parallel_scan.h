@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#ifndef LIBPMEMKV_PARALLEL_SCAN_H
+#define LIBPMEMKV_PARALLEL_SCAN_H
+
+#include <atomic>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+#include "libpmemkv.hpp"
+
+namespace pmem
+{
+namespace kv
+{
+namespace internal
+{
+
+/**
+ * parallel_scan runs partitions of a full scan (see
+ * engine_base::get_all_parallel()) concurrently, on a limited number of
+ * threads.
+ * Engine scans of partitions should be given callback() with the parallel_scan
+ * as its argument - it forwards records to the user's callback and stops all
+ * partitions as soon as the user's callback returns non-zero.
+ */
+class parallel_scan {
+public:
+	parallel_scan(get_kv_callback *callback, void *arg);
+
+	parallel_scan(const parallel_scan &) = delete;
+	parallel_scan &operator=(const parallel_scan &) = delete;
+
+	/*
+	 * Calls scan(i) for every i in [0, partitions), from the caller's thread
+	 * and at most hardware_concurrency() - 1 other ones. Returns the first error reported by any
+	 * partition, STOPPED_BY_CB if the scan was stopped or OK. Exceptions
+	 * thrown by partitions are rethrown after all threads are joined.
+	 */
+	status run(std::size_t partitions, const std::function<status(std::size_t)> &scan);
+
+	static int callback(const char *key, size_t kb, const char *value, size_t vb,
+			    void *arg);
+
+	bool stopped() const
+	{
+		return stopped_.load(std::memory_order_relaxed);
+	}
+
+private:
+	get_kv_callback *user_callback;
+	void *user_arg;
+	std::atomic<bool> stopped_;
+};
+
+/**
+ * Returns iterators splitting [first, last) (a range of size elements) into
+ * at most partitions subranges of similar size: subrange i is
+ * [bounds[i], bounds[i + 1]). Only increments iterators, so it is meant
+ * for containers which cannot be split in any better way.
+ */
+template <typename It>
+std::vector<It> split_range(It first, It last, std::size_t size, std::size_t partitions)
+{
+	std::vector<It> bounds;
+	bounds.push_back(first);
+
+	if (partitions > size)
+		partitions = size > 0 ? size : 1;
+
+	auto it = first;
+	std::size_t pos = 0;
+	for (std::size_t i = 1; i < partitions; i++) {
+		std::size_t next = i * size / partitions;
+		std::advance(it, next - pos);
+		pos = next;
+		bounds.push_back(it);
+	}
+	bounds.push_back(last);
+
+	return bounds;
+}
+
+} /* namespace internal */
+} /* namespace kv */
+} /* namespace pmem */
+
+#endif /* LIBPMEMKV_PARALLEL_SCAN_H */
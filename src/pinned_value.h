@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#ifndef LIBPMEMKV_PINNED_VALUE_H
+#define LIBPMEMKV_PINNED_VALUE_H
+
+#include "libpmemkv.hpp"
+
+#include <string>
+#include <utility>
+
+namespace pmem
+{
+
+namespace kv
+{
+
+namespace internal
+{
+
+/**
+ * pinned_value references a value of a single record, without copying it.
+ * The referenced memory stays valid until the object is destroyed.
+ * Concurrent engines derive from this class to keep whatever protects
+ * the record (an accessor, a lock) alive as long as the value is pinned.
+ */
+class pinned_value {
+public:
+	pinned_value(string_view value = string_view()) : val(value)
+	{
+	}
+
+	virtual ~pinned_value()
+	{
+	}
+
+	pinned_value(const pinned_value &) = delete;
+	pinned_value &operator=(const pinned_value &) = delete;
+
+	string_view value() const
+	{
+		return val;
+	}
+
+protected:
+	string_view val;
+};
+
+/**
+ * Holds a private copy of the value. Used by engines which cannot reference
+ * their storage directly, outside of the get() callback.
+ */
+class copied_pinned_value : public pinned_value {
+public:
+	copied_pinned_value(std::string &&value) : copy(std::move(value))
+	{
+		val = string_view(copy.data(), copy.size());
+	}
+
+private:
+	std::string copy;
+};
+
+/**
+ * Keeps the Guard object (e.g. a lock) alive as long as the value is pinned.
+ */
+template <typename Guard>
+class guarded_pinned_value : public pinned_value {
+public:
+	guarded_pinned_value(Guard &&guard, string_view value)
+	    : pinned_value(value), guard(std::move(guard))
+	{
+	}
+
+private:
+	Guard guard;
+};
+
+} /* namespace internal */
+} /* namespace kv */
+} /* namespace pmem */
+
+#endif /* LIBPMEMKV_PINNED_VALUE_H */
@@ -8,6 +8,10 @@
 #include "libpmemkv.h"
 #include <libpmemobj++/pool.hpp>
 
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+
 namespace pmem
 {
 
@@ -82,14 +86,28 @@ public:
 				}
 			}
 
-			root_oid = static_cast<pmem::obj::pool<Root>>(pmpool)
-					   .root()
-					   ->ptr.raw_ptr();
+			auto root = static_cast<pmem::obj::pool<Root>>(pmpool).root();
+			root_oid = root->ptr.raw_ptr();
+			deadlines_oid = &root->deadlines;
+			staging_oid = &root->staging;
+			pool_path = path;
 
 		} else if (is_oid) {
 			pmpool = pmem::obj::pool_base(pmemobj_pool_by_ptr(oid));
 			root_oid = oid;
 		}
+
+		/*
+		 * heap statistics are needed by memory_usage(), they are enabled
+		 * separately from operation statistics ("stats")
+		 */
+		uint64_t heap_stats = 0;
+		cfg->get_uint64("heap_stats", &heap_stats);
+		if (heap_stats) {
+			enum pobj_stats_enabled enabled = POBJ_STATS_ENABLED_BOTH;
+			/* older libpmemobj, memory_usage() will not be supported */
+			(void)pmemobj_ctl_set(pmpool.handle(), "stats.enabled", &enabled);
+		}
 	}
 
 	~pmemobj_engine_base()
@@ -103,17 +121,103 @@ public:
 		}
 	}
 
+	/*
+	 * Allocated bytes and fragmentation come from heap statistics, sizes of
+	 * keys and values are summed up by a full scan - engines do not keep
+	 * them, so the cost is O(n) per call.
+	 */
+	status memory_usage(pmemkv_memory_usage &usage) override
+	{
+		auto pop = pmpool.handle();
+
+		enum pobj_stats_enabled enabled;
+		if (pmemobj_ctl_get(pop, "stats.enabled", &enabled) != 0 ||
+		    enabled != POBJ_STATS_ENABLED_BOTH)
+			throw internal::not_supported(
+				"Heap statistics are not enabled, set \"heap_stats\" in config");
+
+		uint64_t allocated = 0, run_allocated = 0, run_active = 0;
+		if (pmemobj_ctl_get(pop, "stats.heap.curr_allocated", &allocated) != 0 ||
+		    pmemobj_ctl_get(pop, "stats.heap.run_allocated", &run_allocated) !=
+			    0 ||
+		    pmemobj_ctl_get(pop, "stats.heap.run_active", &run_active) != 0)
+			throw internal::not_supported("Cannot read heap statistics");
+
+		std::size_t keys = 0, values = 0;
+		auto sizes = std::make_pair(&keys, &values);
+		auto s = get_all(
+			[](const char *, size_t kb, const char *, size_t vb, void *arg) {
+				auto sizes = static_cast<
+					std::pair<std::size_t *, std::size_t *> *>(arg);
+				*sizes->first += kb;
+				*sizes->second += vb;
+				return 0;
+			},
+			&sizes);
+		if (s != status::OK)
+			return s;
+
+		usage.pool_size = pool_size();
+		usage.allocated = allocated;
+		usage.free = usage.pool_size > allocated ? usage.pool_size - allocated : 0;
+		usage.keys = keys;
+		usage.values = values;
+		usage.index = allocated > keys + values ? allocated - keys - values : 0;
+		/* part of memory taken by runs (of small allocations), which is unused */
+		usage.fragmentation = run_active
+			? 1 - static_cast<double>(run_allocated) /
+				static_cast<double>(run_active)
+			: 0;
+
+		return status::OK;
+	}
+
 protected:
+	/*
+	 * Root object is reallocated by libpmemobj if it is smaller than Root,
+	 * so fields can be appended to it without breaking existing pools.
+	 */
 	struct Root {
 		/* field ptr used when path is specified */
 		pmem::obj::persistent_ptr<EngineData> ptr;
+		/* deadlines of records put with TTL, used by engines without
+		 * space for them in EngineData */
+		PMEMoid deadlines;
+		/* records being inserted, used by cmap (see cmap::insert()) */
+		PMEMoid staging;
 	};
 
 	pmem::obj::pool_base pmpool;
 	PMEMoid *root_oid;
+	/* both nullptr if the engine was opened by oid */
+	PMEMoid *deadlines_oid = nullptr;
+	PMEMoid *staging_oid = nullptr;
 	bool cfg_by_path = false;
 
 private:
+	/*
+	 * Returns size of the pool file, or 0 if it's unknown: pool was passed by
+	 * oid, it's a poolset or a device DAX.
+	 */
+	std::size_t pool_size() const
+	{
+		struct stat st;
+		if (pool_path.empty() || stat(pool_path.c_str(), &st) != 0 ||
+		    !S_ISREG(st.st_mode))
+			return 0;
+
+		static const char poolset_sig[] = "PMEMPOOLSET";
+		char sig[sizeof(poolset_sig) - 1] = {};
+		std::ifstream file(pool_path, std::ios::binary);
+		file.read(sig, sizeof(sig));
+		if (std::memcmp(sig, poolset_sig, sizeof(sig)) == 0)
+			return 0;
+
+		return static_cast<std::size_t>(st.st_size);
+	}
+
+	std::string pool_path;
+
 	pmem::obj::pool<Root> create_or_fail(const char *path, const std::size_t size,
 					     const std::string &layout)
 	{
@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#ifndef LIBPMEMKV_PROBES_H
+#define LIBPMEMKV_PROBES_H
+
+/*
+ * Static tracepoints (USDT) of "pmemkv" provider, listed in libpmemkv(7).
+ *
+ * They are compiled in if USE_SDT is defined (see USE_SDT CMake option).
+ * Every probe is a single nop instruction (plus a note in .note.stapsdt
+ * section), which tracing tools like bpftrace or perf replace with a
+ * breakpoint when attached. Arguments are evaluated even if no tool is
+ * attached, so they should be cheap (pointers, sizes, statuses).
+ */
+
+#ifdef USE_SDT
+
+#include <sys/sdt.h>
+
+#define PMEMKV_PROBE(name) DTRACE_PROBE(pmemkv, name)
+#define PMEMKV_PROBE1(name, a1) DTRACE_PROBE1(pmemkv, name, a1)
+#define PMEMKV_PROBE2(name, a1, a2) DTRACE_PROBE2(pmemkv, name, a1, a2)
+#define PMEMKV_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(pmemkv, name, a1, a2, a3)
+
+#else
+
+/* arguments are "used", so variables computed only for probes don't cause warnings */
+#define PMEMKV_PROBE(name)                                                               \
+	do {                                                                             \
+	} while (0)
+#define PMEMKV_PROBE1(name, a1)                                                          \
+	do {                                                                             \
+		(void)(a1);                                                              \
+	} while (0)
+#define PMEMKV_PROBE2(name, a1, a2)                                                      \
+	do {                                                                             \
+		(void)(a1);                                                              \
+		(void)(a2);                                                              \
+	} while (0)
+#define PMEMKV_PROBE3(name, a1, a2, a3)                                                  \
+	do {                                                                             \
+		(void)(a1);                                                              \
+		(void)(a2);                                                              \
+		(void)(a3);                                                              \
+	} while (0)
+
+#endif /* USE_SDT */
+
+#endif /* LIBPMEMKV_PROBES_H */
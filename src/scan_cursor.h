@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#ifndef LIBPMEMKV_SCAN_CURSOR_H
+#define LIBPMEMKV_SCAN_CURSOR_H
+
+#include "libpmemkv.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace pmem
+{
+
+namespace kv
+{
+
+namespace internal
+{
+
+/**
+ * Engine specific position of the last element returned by a paginated scan.
+ */
+class scan_position {
+public:
+	virtual ~scan_position()
+	{
+	}
+};
+
+template <typename Iterator>
+class scan_position_holder : public scan_position {
+public:
+	scan_position_holder(const Iterator &it) : it(it)
+	{
+	}
+
+	Iterator it;
+};
+
+/**
+ * scan_cursor holds limits of a single page of a paginated scan
+ * (engine_base::get_above_page(), engine_base::get_between_page()) and
+ * the state needed to continue the scan: the continuation key (key of the
+ * last returned element) and, optionally, engine's position of this element.
+ *
+ * The cached position is tagged with the engine's scan version: unique id of
+ * the engine instance and a counter, which engines increment whenever cached
+ * positions may become invalid (e.g. an element is erased), so the next page
+ * is started with a regular seek.
+ */
+class scan_cursor {
+public:
+	using version_type = std::pair<uint64_t, uint64_t>;
+
+	/* 0 means no limit */
+	scan_cursor(std::size_t max_count, std::size_t max_bytes)
+	    : max_count(max_count), max_bytes(max_bytes)
+	{
+	}
+
+	bool has_more() const
+	{
+		return more;
+	}
+
+	string_view next_key() const
+	{
+		return string_view(key.data(), key.size());
+	}
+
+	/*
+	 * If key is the continuation key of this cursor and the position cached
+	 * by the previous page is still valid, sets it to the element following
+	 * that position and returns true.
+	 */
+	template <typename Iterator>
+	bool resume(string_view start, const version_type &engine_version,
+		    Iterator &it) const
+	{
+		if (!more || !position || version != engine_version ||
+		    start.compare(next_key()) != 0)
+			return false;
+
+		auto p = dynamic_cast<scan_position_holder<Iterator> *>(position.get());
+		if (!p)
+			return false;
+
+		it = p->it;
+		++it;
+
+		return true;
+	}
+
+	/*
+	 * Calls callback for consecutive elements, starting at it, until at_end(it)
+	 * returns true or the page is full. kv(it) returns a pair of key and value.
+	 * The position of the last returned element is cached, tagged with
+	 * engine_version.
+	 */
+	template <typename Iterator, typename AtEnd, typename KeyValue>
+	status fill(Iterator it, AtEnd &&at_end, KeyValue &&kv,
+		    const version_type &engine_version, get_kv_callback *callback,
+		    void *arg)
+	{
+		std::size_t count = 0;
+		std::size_t bytes = 0;
+		bool stopped = false;
+		Iterator last = it;
+
+		more = false;
+		while (!at_end(it)) {
+			auto e = kv(it);
+			auto size = e.first.size() + e.second.size();
+
+			if (count > 0 && !fits(count, bytes, size)) {
+				more = true;
+				break;
+			}
+
+			count++;
+			bytes += size;
+			last = it;
+
+			auto ret = callback(e.first.data(), e.first.size(), e.second.data(),
+					    e.second.size(), arg);
+			++it;
+
+			if (ret != 0) {
+				stopped = true;
+				more = !at_end(it);
+				break;
+			}
+		}
+
+		if (more) {
+			auto k = kv(last).first;
+			key.assign(k.data(), k.size());
+			position.reset(new scan_position_holder<Iterator>(last));
+			version = engine_version;
+		} else {
+			reset();
+		}
+
+		return stopped ? status::STOPPED_BY_CB : status::OK;
+	}
+
+	/* Returns true if an element of given size fits in the page */
+	bool fits(std::size_t count, std::size_t bytes, std::size_t size) const
+	{
+		if (max_count != 0 && count >= max_count)
+			return false;
+
+		if (max_bytes != 0 && bytes + size > max_bytes)
+			return false;
+
+		return true;
+	}
+
+	/* Sets the continuation key, without a cached position */
+	void set_next_key(std::string &&k)
+	{
+		key = std::move(k);
+		more = true;
+		position.reset();
+	}
+
+	void reset()
+	{
+		key.clear();
+		more = false;
+		position.reset();
+	}
+
+private:
+	std::size_t max_count;
+	std::size_t max_bytes;
+
+	std::string key;
+	bool more = false;
+
+	std::unique_ptr<scan_position> position;
+	version_type version;
+};
+
+} /* namespace internal */
+} /* namespace kv */
+} /* namespace pmem */
+
+#endif /* LIBPMEMKV_SCAN_CURSOR_H */
@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "slow_op_log.h"
+
+#include <algorithm>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+namespace pmem
+{
+namespace kv
+{
+namespace internal
+{
+
+constexpr std::size_t slow_op_log::CAPACITY;
+constexpr std::size_t slow_op_log::KEY_PREFIX_SIZE;
+
+static uint64_t to_ns(std::chrono::nanoseconds d)
+{
+	return static_cast<uint64_t>(d.count());
+}
+
+slow_op_log::slow_op_log(std::chrono::microseconds threshold) : threshold(threshold)
+{
+}
+
+void slow_op_log::record(op_type op, string_view key, clock_type::duration latency,
+			 const op_phases &phases, status s)
+{
+	if (latency < threshold)
+		return;
+
+	slow_op o;
+	o.op = op;
+	o.key_prefix.assign(key.data(), std::min(key.size(), KEY_PREFIX_SIZE));
+	o.key_size = key.size();
+	o.start_ns = to_ns(std::chrono::system_clock::now().time_since_epoch() -
+			   latency);
+	o.latency_ns = to_ns(latency);
+	for (std::size_t i = 0; i < op_phases::PHASES; i++)
+		o.phase_ns[i] = phases.ns[i];
+	o.thread_id = thread_id();
+	o.s = s;
+
+	std::lock_guard<std::mutex> guard(lock);
+	if (ops.size() == CAPACITY)
+		ops.pop_front();
+	ops.push_back(std::move(o));
+}
+
+status slow_op_log::get_all(pmemkv_slow_op_callback *callback, void *arg) const
+{
+	/* the callback may take long, don't block recording in the meantime */
+	std::vector<slow_op> copy;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		copy.assign(ops.begin(), ops.end());
+	}
+
+	for (auto &o : copy) {
+		pmemkv_slow_op op;
+		op.op = stats::op_name(o.op);
+		op.key_prefix = o.key_prefix.data();
+		op.key_prefix_size = o.key_prefix.size();
+		op.key_size = o.key_size;
+		op.start_ns = o.start_ns;
+		op.latency_ns = o.latency_ns;
+		op.lookup_ns = o.phase_ns[static_cast<std::size_t>(op_phase::lookup)];
+		op.allocation_ns =
+			o.phase_ns[static_cast<std::size_t>(op_phase::allocation)];
+		op.flush_ns = o.phase_ns[static_cast<std::size_t>(op_phase::flush)];
+		op.lock_wait_ns = o.phase_ns[static_cast<std::size_t>(op_phase::lock_wait)];
+		op.thread_id = o.thread_id;
+		op.status = static_cast<int>(o.s);
+
+		if (callback(&op, arg) != 0)
+			return status::STOPPED_BY_CB;
+	}
+
+	return status::OK;
+}
+
+/* Kernel's id of the thread, as shown by ps, top or perf */
+uint64_t slow_op_log::thread_id()
+{
+	thread_local uint64_t tid = static_cast<uint64_t>(syscall(SYS_gettid));
+	return tid;
+}
+
+} /* namespace internal */
+} /* namespace kv */
+} /* namespace pmem */
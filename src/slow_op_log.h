@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#ifndef LIBPMEMKV_SLOW_OP_LOG_H
+#define LIBPMEMKV_SLOW_OP_LOG_H
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+
+#include "libpmemkv.h"
+#include "libpmemkv.hpp"
+#include "op_phases.h"
+#include "stats.h"
+
+namespace pmem
+{
+namespace kv
+{
+namespace internal
+{
+
+/**
+ * slow_op_log keeps the last operations of a single engine instance which took
+ * longer than a threshold, with the thread which executed them, the beginning
+ * of their keys and the time spent in their phases (see op_phases). It's
+ * created by pmemkv_open() if "slow_op_threshold_us" config item is set.
+ *
+ * Slow operations are expected to be rare, so they are stored under a lock.
+ */
+class slow_op_log {
+public:
+	using op_type = stats::op_type;
+	using clock_type = stats::clock_type;
+
+	static constexpr std::size_t CAPACITY = 1024;
+	static constexpr std::size_t KEY_PREFIX_SIZE = 32;
+
+	explicit slow_op_log(std::chrono::microseconds threshold);
+
+	/* Stores the operation if it took at least the threshold */
+	void record(op_type op, string_view key, clock_type::duration latency,
+		    const op_phases &phases, status s);
+
+	/* Calls the callback for stored operations, oldest first */
+	status get_all(pmemkv_slow_op_callback *callback, void *arg) const;
+
+private:
+	struct slow_op {
+		op_type op;
+		std::string key_prefix;
+		std::size_t key_size;
+		uint64_t start_ns;
+		uint64_t latency_ns;
+		uint64_t phase_ns[op_phases::PHASES];
+		uint64_t thread_id;
+		status s;
+	};
+
+	static uint64_t thread_id();
+
+	const clock_type::duration threshold;
+
+	mutable std::mutex lock;
+	std::deque<slow_op> ops;
+};
+
+} /* namespace internal */
+} /* namespace kv */
+} /* namespace pmem */
+
+#endif /* LIBPMEMKV_SLOW_OP_LOG_H */
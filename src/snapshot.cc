@@ -0,0 +1,274 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "snapshot.h"
+
+namespace pmem
+{
+namespace kv
+{
+namespace internal
+{
+
+version_store::version_store(const comparator *cmp)
+    : cmp(cmp), versions(volatile_compare(cmp)), active_(false)
+{
+}
+
+version_store::sequence_type version_store::open()
+{
+	std::unique_lock<std::mutex> lock(mtx);
+
+	snapshots.insert(epoch);
+	active_.store(true, std::memory_order_release);
+
+	return epoch++;
+}
+
+/*
+ * Versions older than (or as old as) the oldest open snapshot are not visible
+ * in any snapshot anymore. They are at the front of every versions vector.
+ */
+void version_store::close(sequence_type seq)
+{
+	std::unique_lock<std::mutex> lock(mtx);
+
+	auto it = snapshots.find(seq);
+	if (it != snapshots.end())
+		snapshots.erase(it);
+
+	if (snapshots.empty()) {
+		active_.store(false, std::memory_order_release);
+		versions.clear();
+		return;
+	}
+
+	auto oldest = *snapshots.begin();
+	for (auto v = versions.begin(); v != versions.end();) {
+		auto &vs = v->second;
+		auto first_visible = vs.begin();
+		while (first_visible != vs.end() && first_visible->epoch <= oldest)
+			++first_visible;
+
+		vs.erase(vs.begin(), first_visible);
+		if (vs.empty())
+			v = versions.erase(v);
+		else
+			++v;
+	}
+}
+
+void version_store::preserve(string_view key, const string_view *value)
+{
+	if (!active())
+		return;
+
+	std::unique_lock<std::mutex> lock(mtx);
+
+	if (snapshots.empty())
+		return;
+
+	std::string k(key.data(), key.size());
+
+	auto it = versions.find(k);
+	if (it == versions.end())
+		it = versions.emplace(std::move(k), versions_type()).first;
+	else if (it->second.back().epoch == epoch)
+		return;
+
+	version v = {epoch, value != nullptr, std::string()};
+	if (value)
+		v.value.assign(value->data(), value->size());
+
+	it->second.push_back(std::move(v));
+}
+
+const version_store::version *version_store::visible(const versions_type &versions,
+						     sequence_type seq)
+{
+	for (auto &v : versions) {
+		if (v.epoch > seq)
+			return &v;
+	}
+
+	return nullptr;
+}
+
+bool version_store::find(sequence_type seq, string_view key, bool &exists,
+			 std::string &value)
+{
+	std::unique_lock<std::mutex> lock(mtx);
+
+	auto it = versions.find(std::string(key.data(), key.size()));
+	if (it == versions.end())
+		return false;
+
+	auto v = visible(it->second, seq);
+	if (!v)
+		return false;
+
+	exists = v->exists;
+	if (exists)
+		value = v->value;
+
+	return true;
+}
+
+/*
+ * Both sequences are sorted, so they are merged in a single pass. If a key is
+ * in both, its version (if any is visible) takes precedence over the current
+ * record. Keys which exist only in versions were removed after the snapshot
+ * was opened.
+ */
+void version_store::merge(sequence_type seq, const std::string *after,
+			  const std::string *upto, std::vector<record> &records)
+{
+	std::vector<record> merged;
+	merged.reserve(records.size());
+
+	std::unique_lock<std::mutex> lock(mtx);
+
+	auto it = after ? versions.upper_bound(*after) : versions.begin();
+	auto last = upto ? versions.upper_bound(*upto) : versions.end();
+	auto rec = records.begin();
+
+	while (rec != records.end() || it != last) {
+		if (it == last || (rec != records.end() && cmp(rec->key, it->first))) {
+			merged.push_back(std::move(*rec));
+			++rec;
+			continue;
+		}
+
+		bool current = rec != records.end() && !cmp(it->first, rec->key);
+
+		auto v = visible(it->second, seq);
+		if (v) {
+			if (v->exists)
+				merged.push_back({it->first, v->value});
+		} else if (current) {
+			merged.push_back(std::move(*rec));
+		}
+
+		if (current)
+			++rec;
+		++it;
+	}
+
+	records.swap(merged);
+}
+
+sorted_snapshot::sorted_snapshot(version_store &versions)
+    : versions(versions), seq(versions.open())
+{
+}
+
+sorted_snapshot::~sorted_snapshot()
+{
+	versions.close(seq);
+}
+
+bool sorted_snapshot::resolve(string_view key, bool found, std::string &value)
+{
+	bool exists;
+	if (versions.find(seq, key, exists, value))
+		return exists;
+
+	return found;
+}
+
+status sorted_snapshot::exists(string_view key)
+{
+	std::string value;
+
+	return read(key, value) ? status::OK : status::NOT_FOUND;
+}
+
+status sorted_snapshot::get(string_view key, get_v_callback *callback, void *arg)
+{
+	std::string value;
+	if (!read(key, value))
+		return status::NOT_FOUND;
+
+	callback(value.data(), value.size(), arg);
+
+	return status::OK;
+}
+
+static int count_callback(const char *, size_t, const char *, size_t, void *arg)
+{
+	++(*static_cast<std::size_t *>(arg));
+
+	return 0;
+}
+
+status sorted_snapshot::count_all(std::size_t &cnt)
+{
+	cnt = 0;
+
+	return get_all(count_callback, &cnt);
+}
+
+status sorted_snapshot::get_all(get_kv_callback *callback, void *arg)
+{
+	return scan(nullptr, nullptr, callback, arg);
+}
+
+status sorted_snapshot::get_above(string_view key, get_kv_callback *callback, void *arg)
+{
+	std::string after(key.data(), key.size());
+
+	return scan(&after, nullptr, callback, arg);
+}
+
+status sorted_snapshot::get_between(string_view key1, string_view key2,
+				    get_kv_callback *callback, void *arg)
+{
+	if (!versions.key_comp()(key1, key2))
+		return status::OK;
+
+	std::string after(key1.data(), key1.size());
+
+	return scan(&after, &key2, callback, arg);
+}
+
+/*
+ * Every chunk covers keys from after (exclusive) to the last record read from
+ * the engine (inclusive), or to the end if there are no more records.
+ * Versions are merged after the chunk is read, so records modified in the
+ * meantime are already preserved.
+ */
+status sorted_snapshot::scan(const std::string *after, const string_view *below,
+			     get_kv_callback *callback, void *arg)
+{
+	std::string last;
+	bool more = true;
+
+	while (more) {
+		std::vector<version_store::record> records;
+		more = read_chunk(after, chunk_size, records);
+
+		std::string upto;
+		if (more)
+			upto = records.back().key;
+
+		versions.merge(seq, after, more ? &upto : nullptr, records);
+
+		for (auto &r : records) {
+			if (below && !versions.key_comp()(r.key, *below))
+				return status::OK;
+
+			if (callback(r.key.data(), r.key.size(), r.value.data(),
+				     r.value.size(), arg) != 0)
+				return status::STOPPED_BY_CB;
+		}
+
+		last = std::move(upto);
+		after = &last;
+	}
+
+	return status::OK;
+}
+
+} /* namespace internal */
+} /* namespace kv */
+} /* namespace pmem */
@@ -0,0 +1,187 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#ifndef LIBPMEMKV_SNAPSHOT_H
+#define LIBPMEMKV_SNAPSHOT_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "comparator/volatile_comparator.h"
+#include "libpmemkv.hpp"
+
+namespace pmem
+{
+namespace kv
+{
+namespace internal
+{
+
+/**
+ * snapshot is a read-only view of an engine, which shows records as they were
+ * when the snapshot was created (see engine_base::new_snapshot()).
+ * Modifications done afterwards are not visible through the snapshot and
+ * reading from it does not block writers.
+ */
+class snapshot {
+public:
+	virtual ~snapshot() = default;
+
+	virtual status exists(string_view key) = 0;
+	virtual status get(string_view key, get_v_callback *callback, void *arg) = 0;
+
+	virtual status count_all(std::size_t &cnt) = 0;
+	virtual status get_all(get_kv_callback *callback, void *arg) = 0;
+	virtual status get_above(string_view key, get_kv_callback *callback,
+				 void *arg) = 0;
+	virtual status get_between(string_view key1, string_view key2,
+				   get_kv_callback *callback, void *arg) = 0;
+};
+
+/**
+ * version_store keeps previous versions of records modified while any snapshot
+ * is open. Engines call preserve() before a record is modified (inserted,
+ * updated or removed) and snapshots use versions newer than themselves to
+ * restore the state from the moment they were opened.
+ *
+ * Every open() starts a new epoch and versions are tagged with the epoch
+ * of the modification. Only the first modification of a key in an epoch is
+ * preserved - a snapshot needs only the oldest version newer than itself.
+ * Versions not needed by any open snapshot are dropped in close().
+ *
+ * open() must not run concurrently with modifications of the engine (e.g.
+ * concurrent engines call it under an exclusive lock), so every modification
+ * is either entirely visible in the snapshot or preserved. preserve() must be
+ * called with the modified record locked (before the modification becomes
+ * visible), so a reader which holds the same lock always finds either the old
+ * record or its preserved version. Nothing is locked while no snapshot is open.
+ */
+class version_store {
+public:
+	using sequence_type = uint64_t;
+
+	struct record {
+		std::string key;
+		std::string value;
+	};
+
+	version_store(const comparator *cmp);
+
+	version_store(const version_store &) = delete;
+	version_store &operator=(const version_store &) = delete;
+
+	/* Returns false if no snapshot is open */
+	bool active() const
+	{
+		return active_.load(std::memory_order_acquire);
+	}
+
+	sequence_type open();
+	void close(sequence_type seq);
+
+	/* value is nullptr if the key does not exist (is being inserted) */
+	void preserve(string_view key, const string_view *value);
+
+	/*
+	 * Returns true if the key was modified after the snapshot seq was opened;
+	 * exists and value are set to the state from the moment of opening.
+	 */
+	bool find(sequence_type seq, string_view key, bool &exists, std::string &value);
+
+	/*
+	 * Merges records read from the engine (sorted, with keys greater than
+	 * after and not greater than upto) with versions of keys from that
+	 * range (nullptr means no bound), as seen by the snapshot seq.
+	 */
+	void merge(sequence_type seq, const std::string *after, const std::string *upto,
+		   std::vector<record> &records);
+
+	const volatile_compare &key_comp() const
+	{
+		return cmp;
+	}
+
+private:
+	struct version {
+		sequence_type epoch;
+		bool exists;
+		std::string value;
+	};
+
+	using versions_type = std::vector<version>;
+	using map_type = std::map<std::string, versions_type, volatile_compare>;
+
+	/* the oldest version newer than the snapshot seq, or nullptr */
+	static const version *visible(const versions_type &versions, sequence_type seq);
+
+	volatile_compare cmp;
+	std::mutex mtx;
+	map_type versions;
+	std::multiset<sequence_type> snapshots;
+	sequence_type epoch = 0;
+	std::atomic<bool> active_;
+};
+
+/**
+ * sorted_snapshot implements snapshot for sorted engines, on top of
+ * a version_store. Engines provide only reads of their current records;
+ * scans read them in chunks, so no engine lock is held between chunks nor
+ * while callbacks are executed.
+ */
+class sorted_snapshot : public snapshot {
+public:
+	/* Must be created with modifications of the engine excluded */
+	sorted_snapshot(version_store &versions);
+	~sorted_snapshot();
+
+	sorted_snapshot(const sorted_snapshot &) = delete;
+	sorted_snapshot &operator=(const sorted_snapshot &) = delete;
+
+	status exists(string_view key) final;
+	status get(string_view key, get_v_callback *callback, void *arg) final;
+
+	status count_all(std::size_t &cnt) final;
+	status get_all(get_kv_callback *callback, void *arg) final;
+	status get_above(string_view key, get_kv_callback *callback, void *arg) final;
+	status get_between(string_view key1, string_view key2, get_kv_callback *callback,
+			   void *arg) final;
+
+protected:
+	static constexpr std::size_t chunk_size = 128;
+
+	/*
+	 * Copies the current value of the key and checks (with the record
+	 * still locked) whether the snapshot sees an older version of it.
+	 * Returns false if the key does not exist in the snapshot.
+	 */
+	virtual bool read(string_view key, std::string &value) = 0;
+
+	/*
+	 * Appends to records (in key order) at most max current records with
+	 * keys greater than after (from the first one if after is nullptr).
+	 * Returns false if there are no more records.
+	 */
+	virtual bool read_chunk(const std::string *after, std::size_t max,
+				std::vector<version_store::record> &records) = 0;
+
+	/* returns value of the key as seen by the snapshot, see read() */
+	bool resolve(string_view key, bool found, std::string &value);
+
+	version_store &versions;
+	const version_store::sequence_type seq;
+
+private:
+	status scan(const std::string *after, const string_view *below,
+		    get_kv_callback *callback, void *arg);
+};
+
+} /* namespace internal */
+} /* namespace kv */
+} /* namespace pmem */
+
+#endif /* LIBPMEMKV_SNAPSHOT_H */
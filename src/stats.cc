@@ -0,0 +1,278 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "stats.h"
+#include "fast_hash.h"
+#include "flight_recorder.h"
+#include "slow_op_log.h"
+
+#include <sstream>
+
+namespace pmem
+{
+namespace kv
+{
+namespace internal
+{
+
+constexpr std::size_t stats::OP_TYPES;
+constexpr std::size_t stats::SHARDS;
+constexpr std::size_t stats::SUB_BUCKET_BITS;
+constexpr std::size_t stats::SUB_BUCKETS;
+constexpr std::size_t stats::BUCKETS;
+
+stats::op_timer::op_timer(stats *s, flight_recorder *fr, slow_op_log *sl, op_type op,
+			 string_view key)
+    : s(s), fr(fr), sl(sl), op(op), key(key)
+{
+	if (sl)
+		op_phases::local().begin();
+	if (s || fr || sl)
+		start = clock_type::now();
+}
+
+stats::op_timer::~op_timer()
+{
+	/* finish() was not called - operation threw an exception */
+	record(status::UNKNOWN_ERROR, 0);
+}
+
+status stats::op_timer::finish(status st, std::size_t bytes)
+{
+	record(st, bytes);
+
+	return st;
+}
+
+void stats::op_timer::record(status st, std::size_t bytes)
+{
+	if (!s && !fr && !sl)
+		return;
+
+	auto latency = clock_type::now() - start;
+	if (s)
+		s->record(op, st, latency, bytes);
+	if (fr)
+		fr->record(op, key.size() ? fast_hash(key.size(), key.data()) : 0,
+			   start, latency, st);
+	if (sl) {
+		auto &phases = op_phases::local();
+		phases.active = false;
+		sl->record(op, key, latency, phases, st);
+	}
+
+	s = nullptr;
+	fr = nullptr;
+	sl = nullptr;
+}
+
+stats::stats() : shards(new shard[SHARDS]())
+{
+	/* value-initialization above zeroes all counters */
+}
+
+void stats::record(op_type op, status s, clock_type::duration latency,
+		   std::size_t bytes)
+{
+	auto &c = local_shard().ops[static_cast<std::size_t>(op)];
+	auto ns = static_cast<uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count());
+
+	c.count.fetch_add(1, std::memory_order_relaxed);
+	if (s == status::NOT_FOUND)
+		c.not_found.fetch_add(1, std::memory_order_relaxed);
+	else if (s != status::OK)
+		c.errors.fetch_add(1, std::memory_order_relaxed);
+	c.bytes.fetch_add(bytes, std::memory_order_relaxed);
+	c.latency_sum.fetch_add(ns, std::memory_order_relaxed);
+	c.latency[bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string stats::to_json(const std::string &engine_name,
+			   const engine_counters &counters) const
+{
+	static const double percentiles[] = {50, 90, 99, 99.9};
+	static const char *percentile_names[] = {"p50", "p90", "p99", "p999"};
+
+	std::ostringstream out;
+	out << "{\"engine\":\"" << engine_name << "\",\"operations\":{";
+
+	for (std::size_t op = 0; op < OP_TYPES; op++) {
+		uint64_t count = 0, not_found = 0, errors = 0, bytes = 0,
+			 latency_sum = 0;
+		std::vector<uint64_t> latency(BUCKETS, 0);
+
+		for (std::size_t i = 0; i < SHARDS; i++) {
+			auto &c = shards[i].ops[op];
+			count += c.count.load(std::memory_order_relaxed);
+			not_found += c.not_found.load(std::memory_order_relaxed);
+			errors += c.errors.load(std::memory_order_relaxed);
+			bytes += c.bytes.load(std::memory_order_relaxed);
+			latency_sum += c.latency_sum.load(std::memory_order_relaxed);
+			for (std::size_t b = 0; b < BUCKETS; b++)
+				latency[b] += c.latency[b].load(std::memory_order_relaxed);
+		}
+
+		/* counters are read one by one, so they might be off by a few
+		 * operations in progress; use histogram as the source of truth */
+		uint64_t recorded = 0;
+		std::size_t min_bucket = BUCKETS, max_bucket = 0;
+		for (std::size_t b = 0; b < BUCKETS; b++) {
+			if (latency[b] == 0)
+				continue;
+			recorded += latency[b];
+			if (min_bucket == BUCKETS)
+				min_bucket = b;
+			max_bucket = b;
+		}
+
+		if (op != 0)
+			out << ",";
+		out << "\"" << op_name(static_cast<op_type>(op)) << "\":{"
+		    << "\"count\":" << count << ",\"not_found\":" << not_found
+		    << ",\"errors\":" << errors << ",\"bytes\":" << bytes
+		    << ",\"latency_ns\":{";
+
+		if (recorded == 0) {
+			out << "}}";
+			continue;
+		}
+
+		out << "\"mean\":" << latency_sum / recorded
+		    << ",\"min\":" << bucket_lowest(min_bucket);
+
+		for (std::size_t p = 0; p < sizeof(percentiles) / sizeof(percentiles[0]);
+		     p++) {
+			auto rank = static_cast<uint64_t>(percentiles[p] / 100 *
+							  static_cast<double>(recorded));
+			if (rank == 0)
+				rank = 1;
+
+			uint64_t seen = 0;
+			std::size_t b = min_bucket;
+			for (; b < max_bucket; b++) {
+				seen += latency[b];
+				if (seen >= rank)
+					break;
+			}
+
+			/* middle of the bucket halves the maximum error */
+			out << ",\"" << percentile_names[p] << "\":"
+			    << bucket_lowest(b) + (bucket_highest(b) - bucket_lowest(b)) / 2;
+		}
+
+		out << ",\"max\":" << bucket_highest(max_bucket) << "}}";
+	}
+
+	out << "},\"engine_counters\":{";
+	for (std::size_t i = 0; i < counters.size(); i++) {
+		if (i != 0)
+			out << ",";
+		out << "\"" << counters[i].first << "\":" << counters[i].second;
+	}
+	out << "}}";
+
+	return out.str();
+}
+
+std::size_t stats::bucket(uint64_t ns)
+{
+	if (ns < SUB_BUCKETS)
+		return static_cast<std::size_t>(ns);
+
+	std::size_t msb = 63 - static_cast<std::size_t>(__builtin_clzll(ns));
+	std::size_t shift = msb - SUB_BUCKET_BITS;
+	std::size_t sub = static_cast<std::size_t>(ns >> shift) - SUB_BUCKETS;
+
+	return (shift + 1) * SUB_BUCKETS + sub;
+}
+
+uint64_t stats::bucket_lowest(std::size_t b)
+{
+	if (b < SUB_BUCKETS)
+		return b;
+
+	std::size_t shift = b / SUB_BUCKETS - 1;
+	std::size_t sub = b % SUB_BUCKETS;
+
+	return static_cast<uint64_t>(SUB_BUCKETS + sub) << shift;
+}
+
+uint64_t stats::bucket_highest(std::size_t b)
+{
+	if (b < SUB_BUCKETS)
+		return b;
+
+	std::size_t shift = b / SUB_BUCKETS - 1;
+
+	return bucket_lowest(b) + ((uint64_t(1) << shift) - 1);
+}
+
+const char *stats::op_name(op_type op)
+{
+	switch (op) {
+		case op_type::get:
+			return "get";
+		case op_type::put:
+			return "put";
+		case op_type::remove:
+			return "remove";
+		case op_type::exists:
+			return "exists";
+		case op_type::tx_commit:
+			return "tx_commit";
+		case op_type::defrag:
+			return "defrag";
+		default:
+			return "unknown";
+	}
+}
+
+stats::shard &stats::local_shard()
+{
+	static std::atomic<std::size_t> next_shard(0);
+	thread_local std::size_t shard_id =
+		next_shard.fetch_add(1, std::memory_order_relaxed);
+
+	return shards[shard_id % SHARDS];
+}
+
+stats_transaction::stats_transaction(std::unique_ptr<transaction> tx, stats *s,
+				     flight_recorder *fr, slow_op_log *sl)
+    : tx(std::move(tx)), s(s), fr(fr), sl(sl)
+{
+}
+
+status stats_transaction::put(string_view key, string_view value)
+{
+	auto st = tx->put(key, value);
+	if (st == status::OK)
+		bytes += key.size() + value.size();
+
+	return st;
+}
+
+status stats_transaction::remove(string_view key)
+{
+	return tx->remove(key);
+}
+
+status stats_transaction::commit()
+{
+	stats::op_timer timer(s, fr, sl, stats::op_type::tx_commit);
+	auto st = timer.finish(tx->commit(), bytes);
+	if (st == status::OK)
+		bytes = 0;
+
+	return st;
+}
+
+void stats_transaction::abort()
+{
+	tx->abort();
+	bytes = 0;
+}
+
+} /* namespace internal */
+} /* namespace kv */
+} /* namespace pmem */
@@ -0,0 +1,150 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#ifndef LIBPMEMKV_STATS_H
+#define LIBPMEMKV_STATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "libpmemkv.hpp"
+#include "transaction.h"
+
+namespace pmem
+{
+namespace kv
+{
+namespace internal
+{
+
+class flight_recorder;
+class slow_op_log;
+
+/* Engine-specific counters, reported by engine_base::get_engine_counters() */
+using engine_counters = std::vector<std::pair<std::string, uint64_t>>;
+
+/**
+ * stats gathers operation counters and latency histograms of a single engine
+ * instance. It's created by pmemkv_open() if "stats" config flag is set.
+ *
+ * Counters are sharded: every thread updates (with relaxed atomics) the shard
+ * it was assigned to on its first operation, so threads do not share cache
+ * lines unless there are more of them than shards. Shards are summed up only
+ * when statistics are read.
+ *
+ * Latencies are stored in log-linear (HDR-like) histograms: every power of two
+ * is split into SUB_BUCKETS buckets, so the relative error of a reported
+ * percentile is below 1/SUB_BUCKETS.
+ */
+class stats {
+public:
+	enum class op_type { get, put, remove, exists, tx_commit, defrag, MAX };
+
+	using clock_type = std::chrono::steady_clock;
+
+	/*
+	 * Measures latency of a single operation and records it in stats, in
+	 * flight recorder and in slow operation log, if they are enabled
+	 * (pointers are not null). With slow operation log, phases of the
+	 * operation are timed as well (see op_phases). Key must outlive the timer.
+	 */
+	class op_timer {
+	public:
+		op_timer(stats *s, flight_recorder *fr, slow_op_log *sl, op_type op,
+			 string_view key = string_view());
+		~op_timer();
+
+		op_timer(const op_timer &) = delete;
+		op_timer &operator=(const op_timer &) = delete;
+
+		/* Records the operation and passes its status through */
+		status finish(status s, std::size_t bytes);
+
+	private:
+		void record(status st, std::size_t bytes);
+
+		stats *s;
+		flight_recorder *fr;
+		slow_op_log *sl;
+		op_type op;
+		string_view key;
+		clock_type::time_point start;
+	};
+
+	stats();
+
+	void record(op_type op, status s, clock_type::duration latency,
+		    std::size_t bytes);
+
+	/* Returns all statistics as a JSON object */
+	std::string to_json(const std::string &engine_name,
+			    const engine_counters &counters) const;
+
+	static const char *op_name(op_type op);
+
+private:
+	static constexpr std::size_t OP_TYPES = static_cast<std::size_t>(op_type::MAX);
+	static constexpr std::size_t SHARDS = 16;
+	/* relative width of a bucket is at most 1 / SUB_BUCKETS (~3%) */
+	static constexpr std::size_t SUB_BUCKET_BITS = 5;
+	static constexpr std::size_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+	/* enough for any 64-bit number of nanoseconds */
+	static constexpr std::size_t BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+	struct op_counters {
+		std::atomic<uint64_t> count;
+		std::atomic<uint64_t> not_found;
+		std::atomic<uint64_t> errors;
+		std::atomic<uint64_t> bytes;
+		std::atomic<uint64_t> latency_sum;
+		std::atomic<uint64_t> latency[BUCKETS];
+	};
+
+	struct shard {
+		op_counters ops[OP_TYPES];
+		/* keeps counters of neighbouring shards in separate cache lines */
+		char padding[64];
+	};
+
+	static std::size_t bucket(uint64_t ns);
+	static uint64_t bucket_lowest(std::size_t b);
+	static uint64_t bucket_highest(std::size_t b);
+
+	shard &local_shard();
+
+	std::unique_ptr<shard[]> shards;
+};
+
+/**
+ * Wraps transaction of an engine with stats, flight recorder or slow operation
+ * log enabled, to measure commits. Number of bytes of a commit is the sum of
+ * sizes of all put keys and values.
+ */
+class stats_transaction : public transaction {
+public:
+	stats_transaction(std::unique_ptr<transaction> tx, stats *s, flight_recorder *fr,
+			  slow_op_log *sl);
+
+	status put(string_view key, string_view value) final;
+	status remove(string_view key) final;
+	status commit() final;
+	void abort() final;
+
+private:
+	std::unique_ptr<transaction> tx;
+	stats *s;
+	flight_recorder *fr;
+	slow_op_log *sl;
+	std::size_t bytes = 0;
+};
+
+} /* namespace internal */
+} /* namespace kv */
+} /* namespace pmem */
+
+#endif /* LIBPMEMKV_STATS_H */
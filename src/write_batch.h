@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#ifndef LIBPMEMKV_WRITE_BATCH_H
+#define LIBPMEMKV_WRITE_BATCH_H
+
+#include "libpmemkv.hpp"
+
+#include <cassert>
+#include <string>
+#include <vector>
+
+namespace pmem
+{
+
+namespace kv
+{
+
+namespace internal
+{
+
+/**
+ * write_batch holds a sequence of put and remove operations, which are applied
+ * by engine_base::apply_batch() in the order in which they were added.
+ *
+ * All keys and values are stored in a single, contiguous buffer (instead of
+ * a separate allocation per key and value) and are referenced by offsets,
+ * so adding an operation usually does not allocate.
+ */
+class write_batch {
+public:
+	enum class operation { put, remove };
+
+	struct entry {
+		operation op;
+		string_view key;
+		string_view value;
+	};
+
+	void put(string_view key, string_view value)
+	{
+		append(operation::put, key, value);
+	}
+
+	void remove(string_view key)
+	{
+		append(operation::remove, key, string_view());
+	}
+
+	void clear()
+	{
+		buffer.clear();
+		records.clear();
+	}
+
+	std::size_t size() const
+	{
+		return records.size();
+	}
+
+	bool empty() const
+	{
+		return records.empty();
+	}
+
+	entry operator[](std::size_t idx) const
+	{
+		assert(idx < records.size());
+
+		const auto &r = records[idx];
+		return {r.op, string_view(buffer.data() + r.offset, r.key_size),
+			string_view(buffer.data() + r.offset + r.key_size, r.value_size)};
+	}
+
+	/*
+	 * Calls f for every operation, in order. Stops and returns
+	 * the first status other than status::OK.
+	 */
+	template <typename F>
+	status foreach (F &&f) const
+	{
+		for (std::size_t i = 0; i < records.size(); i++) {
+			auto s = f((*this)[i]);
+			if (s != status::OK)
+				return s;
+		}
+
+		return status::OK;
+	}
+
+private:
+	struct record {
+		operation op;
+		std::size_t offset;
+		std::size_t key_size;
+		std::size_t value_size;
+	};
+
+	void append(operation op, string_view key, string_view value)
+	{
+		records.push_back({op, buffer.size(), key.size(), value.size()});
+		buffer.append(key.data(), key.size());
+		buffer.append(value.data(), value.size());
+	}
+
+	std::string buffer;
+	std::vector<record> records;
+};
+
+} /* namespace internal */
+} /* namespace kv */
+} /* namespace pmem */
+
+#endif /* LIBPMEMKV_WRITE_BATCH_H */
@@ -40,9 +40,31 @@ void null_db_all_funcs_test()
 	s = pmemkv_count_between(NULL, key1, strlen(key1), key2, strlen(key2), &cnt);
 	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
 
+	s = pmemkv_count_prefix(NULL, key1, strlen(key1), &cnt);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_count_prefix((pmemkv_db *)0x1, key1, strlen(key1), NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
 	s = pmemkv_get_all(NULL, NULL, NULL);
 	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
 
+	s = pmemkv_get_all_parallel(NULL, 4, NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_get_split_points(NULL, 4, NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_get_split_points((pmemkv_db *)0x1, 4, NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_get_by_rank(NULL, 0, NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	size_t rank;
+	s = pmemkv_rank_of(NULL, key1, strlen(key1), &rank);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
 	s = pmemkv_get_above(NULL, key1, strlen(key1), NULL, NULL);
 	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
 
@@ -58,6 +80,40 @@ void null_db_all_funcs_test()
 	s = pmemkv_get_between(NULL, key1, strlen(key1), key2, strlen(key2), NULL, NULL);
 	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
 
+	s = pmemkv_get_prefix(NULL, key1, strlen(key1), NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_get_keys(NULL, NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_get_keys_above(NULL, key1, strlen(key1), NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_get_keys_below(NULL, key1, strlen(key1), NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_get_keys_between(NULL, key1, strlen(key1), key2, strlen(key2), NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_get_all_desc(NULL, NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_get_above_desc(NULL, key1, strlen(key1), NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_get_equal_above_desc(NULL, key1, strlen(key1), NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_get_below_desc(NULL, key1, strlen(key1), NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_get_equal_below_desc(NULL, key1, strlen(key1), NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_get_between_desc(NULL, key1, strlen(key1), key2, strlen(key2), NULL,
+				    NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
 	s = pmemkv_exists(NULL, key1, strlen(key1));
 	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
 
@@ -67,21 +123,155 @@ void null_db_all_funcs_test()
 	s = pmemkv_get_copy(NULL, key1, strlen(key1), val, 10, &cnt);
 	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
 
+	const char *keys[] = {key1, key2};
+	size_t key_sizes[] = {strlen(key1), strlen(key2)};
+	s = pmemkv_get_many(NULL, 2, keys, key_sizes, NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_get_many((pmemkv_db *)0x1, 2, keys, key_sizes, NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_get_many((pmemkv_db *)0x1, 2, NULL, key_sizes, NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
 	s = pmemkv_put(NULL, key1, strlen(key1), value1, strlen(value1));
 	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
 
+	s = pmemkv_put_with_ttl(NULL, key1, strlen(key1), value1, strlen(value1), 1000);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_merge(NULL, key1, strlen(key1), value1, strlen(value1));
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_put_if_absent(NULL, key1, strlen(key1), value1, strlen(value1));
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_compare_and_swap(NULL, key1, strlen(key1), value1, strlen(value1),
+				    value1, strlen(value1));
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_remove_if(NULL, key1, strlen(key1), value1, strlen(value1));
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
 	s = pmemkv_remove(NULL, key1, strlen(key1));
 	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
 
+	s = pmemkv_remove_range(NULL, key1, strlen(key1), key1, strlen(key1));
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_remove_prefix(NULL, key1, strlen(key1));
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_bulk_load(NULL, NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_bulk_load_file(NULL, "path");
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	pmemkv_scan_cursor *cursor = pmemkv_scan_cursor_new(10, 0);
+	UT_ASSERT(cursor != NULL);
+
+	s = pmemkv_get_above_page(NULL, key1, strlen(key1), cursor, NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_get_above_page((pmemkv_db *)0x1, key1, strlen(key1), NULL, NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_get_between_page(NULL, key1, strlen(key1), key2, strlen(key2), cursor,
+				    NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	const char *next_key;
+	size_t next_key_size;
+	s = pmemkv_scan_cursor_next_key(NULL, &next_key, &next_key_size);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_scan_cursor_next_key(cursor, &next_key, &next_key_size);
+	UT_ASSERT(s == PMEMKV_STATUS_NOT_FOUND);
+
+	pmemkv_scan_cursor_delete(cursor);
+	pmemkv_scan_cursor_delete(NULL);
+
+	pmemkv_pinned_value *pv;
+	s = pmemkv_get_pinned(NULL, key1, strlen(key1), &pv);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_get_pinned((pmemkv_db *)0x1, key1, strlen(key1), NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	const char *pinned;
+	size_t pinned_size;
+	s = pmemkv_pinned_value_read(NULL, &pinned, &pinned_size);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	pmemkv_pinned_value_delete(NULL);
+
+	size_t value_size;
+	s = pmemkv_value_size(NULL, key1, strlen(key1), &value_size);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_value_size((pmemkv_db *)0x1, key1, strlen(key1), NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	pmemkv_snapshot *sn;
+	s = pmemkv_snapshot_new(NULL, &sn);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_snapshot_new((pmemkv_db *)0x1, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_put_async(NULL, key1, strlen(key1), value1, strlen(value1), NULL,
+			     NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_get_async(NULL, key1, strlen(key1), NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
 	s = pmemkv_defrag(NULL, 0, 100);
 	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
 
+	s = pmemkv_get_stats(NULL, NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_get_stats((pmemkv_db *)0x1, NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	pmemkv_memory_usage usage;
+	s = pmemkv_get_memory_usage(NULL, &usage);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_get_memory_usage((pmemkv_db *)0x1, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_flight_recorder_dump(NULL, "flight_recorder.log");
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_flight_recorder_dump((pmemkv_db *)0x1, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_get_slow_ops(NULL, NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_get_slow_ops((pmemkv_db *)0x1, NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
 	pmemkv_tx *tx;
 	s = pmemkv_tx_begin(NULL, &tx);
 	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
 
 	s = pmemkv_tx_begin((pmemkv_db *)0x1, NULL);
 	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	pmemkv_write_batch *batch = pmemkv_write_batch_new();
+	UT_ASSERTne(batch, NULL);
+
+	s = pmemkv_write(NULL, batch);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	pmemkv_write_batch_delete(batch);
+
+	s = pmemkv_write((pmemkv_db *)0x1, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
 }
 
 void null_config_test(const char *engine)
@@ -125,6 +315,55 @@ void null_tx_test(const char *engine)
 	pmemkv_tx_end(NULL);
 }
 
+void null_write_batch_test()
+{
+	const char *key1 = "key1";
+	size_t cnt;
+
+	int s = pmemkv_write_batch_put(NULL, key1, strlen(key1), key1, strlen(key1));
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_write_batch_remove(NULL, key1, strlen(key1));
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_write_batch_count(NULL, &cnt);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	/* returns void */
+	pmemkv_write_batch_clear(NULL);
+
+	/* returns void */
+	pmemkv_write_batch_delete(NULL);
+}
+
+void null_snapshot_test()
+{
+	const char *key1 = "key1";
+	size_t cnt;
+
+	int s = pmemkv_snapshot_count_all(NULL, &cnt);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_snapshot_get_all(NULL, NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_snapshot_get_above(NULL, key1, strlen(key1), NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_snapshot_get_between(NULL, key1, strlen(key1), key1, strlen(key1),
+					NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_snapshot_exists(NULL, key1, strlen(key1));
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	s = pmemkv_snapshot_get(NULL, key1, strlen(key1), NULL, NULL);
+	UT_ASSERT(s == PMEMKV_STATUS_INVALID_ARGUMENT);
+
+	/* returns void */
+	pmemkv_snapshot_delete(NULL);
+}
+
 void null_iterator_all_funcs_test()
 {
 	/**
@@ -158,6 +397,9 @@ void null_iterator_all_funcs_test()
 	s = pmemkv_iterator_seek_higher_eq(NULL, key1, strlen(key1));
 	UT_ASSERTeq(s, PMEMKV_STATUS_INVALID_ARGUMENT);
 
+	s = pmemkv_iterator_seek_prefix(NULL, key1, strlen(key1));
+	UT_ASSERTeq(s, PMEMKV_STATUS_INVALID_ARGUMENT);
+
 	s = pmemkv_iterator_seek_to_first(NULL);
 	UT_ASSERTeq(s, PMEMKV_STATUS_INVALID_ARGUMENT);
 
@@ -179,6 +421,10 @@ void null_iterator_all_funcs_test()
 	s = pmemkv_iterator_read_range(NULL, 0, 10, &val1, &cnt);
 	UT_ASSERTeq(s, PMEMKV_STATUS_INVALID_ARGUMENT);
 
+	pmemkv_iterator_entry entries[4];
+	s = pmemkv_iterator_read_batch(NULL, entries, 4, &cnt);
+	UT_ASSERTeq(s, PMEMKV_STATUS_INVALID_ARGUMENT);
+
 	s = pmemkv_write_iterator_write_range(NULL, 0, 10, &val2, &cnt);
 	UT_ASSERTeq(s, PMEMKV_STATUS_INVALID_ARGUMENT);
 
@@ -206,6 +452,8 @@ int main(int argc, char *argv[])
 	null_config_test(argv[1]);
 	null_db_test(argv[1]);
 	null_iterator_all_funcs_test();
+	null_write_batch_test();
+	null_snapshot_test();
 
 	return 0;
 }
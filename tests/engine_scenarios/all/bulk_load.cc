@@ -0,0 +1,176 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "unittest.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+/**
+ * Tests bulk_load (from a function and from a file): sorted engines build
+ * their structures directly from sorted records, other engines (and
+ * non-empty databases) insert records one by one.
+ */
+
+using namespace pmem::kv;
+
+using kv_list = std::vector<std::pair<std::string, std::string>>;
+
+/* more than a single chunk and a few levels of stree's inner nodes */
+static const size_t N = 3000;
+
+static kv_list sorted_records()
+{
+	kv_list records;
+	for (size_t i = 0; i < N; i++)
+		records.emplace_back(entry_from_number(i, "key"), entry_from_number(i, "val"));
+
+	std::sort(records.begin(), records.end());
+	return records;
+}
+
+static status load(pmem::kv::db &kv, const kv_list &records)
+{
+	size_t pos = 0;
+	return kv.bulk_load([&](string_view &key, string_view &value) {
+		if (pos == records.size())
+			return false;
+
+		key = records[pos].first;
+		value = records[pos].second;
+		pos++;
+		return true;
+	});
+}
+
+static void verify(pmem::kv::db &kv, const kv_list &records)
+{
+	size_t cnt;
+	ASSERT_STATUS(kv.count_all(cnt), status::OK);
+	UT_ASSERTeq(cnt, records.size());
+
+	for (auto &r : records) {
+		std::string value;
+		ASSERT_STATUS(kv.get(r.first, &value), status::OK);
+		UT_ASSERT(value == r.second);
+	}
+}
+
+static void EmptyLoadTest(pmem::kv::db &kv)
+{
+	ASSERT_STATUS(load(kv, kv_list()), status::OK);
+	verify(kv, kv_list());
+}
+
+static void SortedLoadTest(pmem::kv::db &kv)
+{
+	auto records = sorted_records();
+	ASSERT_STATUS(load(kv, records), status::OK);
+	verify(kv, records);
+
+	/* the database is fully usable after the load */
+	auto key = entry_from_string("key");
+	ASSERT_STATUS(kv.put(key, entry_from_string("new")), status::OK);
+	for (size_t i = 0; i < N; i += 2)
+		ASSERT_STATUS(kv.remove(records[i].first), status::OK);
+
+	kv_list expected;
+	for (size_t i = 1; i < N; i += 2)
+		expected.push_back(records[i]);
+	expected.emplace_back(key, entry_from_string("new"));
+
+	verify(kv, expected);
+}
+
+static void UnsortedLoadTest(pmem::kv::db &kv)
+{
+	auto records = sorted_records();
+	std::swap(records[N / 2], records[N / 2 + 1]);
+
+	/* engines which require sorted keys stop the load */
+	auto s = load(kv, records);
+	UT_ASSERT(s == status::OK || s == status::INVALID_ARGUMENT);
+
+	if (s == status::OK) {
+		verify(kv, records);
+		return;
+	}
+
+	/* records loaded before the unsorted key (in earlier chunks) are removed */
+	verify(kv, kv_list());
+
+	std::sort(records.begin(), records.end());
+	ASSERT_STATUS(load(kv, records), status::OK);
+	verify(kv, records);
+}
+
+static void NonEmptyLoadTest(pmem::kv::db &kv)
+{
+	auto records = sorted_records();
+	ASSERT_STATUS(kv.put(records.back().first, entry_from_string("old")), status::OK);
+
+	/* records are inserted one by one, in any order */
+	std::reverse(records.begin(), records.end());
+	ASSERT_STATUS(load(kv, records), status::OK);
+	verify(kv, records);
+}
+
+static void FileLoadTest(pmem::kv::db &kv)
+{
+	char path[] = "bulk_load_XXXXXX";
+	int fd = mkstemp(path);
+	UT_ASSERT(fd >= 0);
+	close(fd);
+
+	auto records = sorted_records();
+	{
+		std::ofstream file(path, std::ios::binary);
+		for (auto &r : records) {
+			uint64_t sizes[2] = {r.first.size(), r.second.size()};
+			file.write(reinterpret_cast<const char *>(sizes), sizeof(sizes));
+			file << r.first << r.second;
+		}
+	}
+
+	ASSERT_STATUS(kv.bulk_load_file(path), status::OK);
+	verify(kv, records);
+
+	CLEAR_KV(kv);
+
+	/* truncated record */
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::app);
+		uint64_t sizes[2] = {8, 8};
+		file.write(reinterpret_cast<const char *>(sizes), sizeof(sizes));
+	}
+	ASSERT_STATUS(kv.bulk_load_file(path), status::INVALID_ARGUMENT);
+
+	std::remove(path);
+	ASSERT_STATUS(kv.bulk_load_file(path), status::INVALID_ARGUMENT);
+}
+
+static void test(int argc, char *argv[])
+{
+	if (argc < 3)
+		UT_FATAL("usage: %s engine json_config", argv[0]);
+
+	run_engine_tests(argv[1], argv[2],
+			 {
+				 EmptyLoadTest,
+				 SortedLoadTest,
+				 UnsortedLoadTest,
+				 NonEmptyLoadTest,
+				 FileLoadTest,
+			 });
+}
+
+int main(int argc, char *argv[])
+{
+	return run_test([&] { test(argc, argv); });
+}
@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "unittest.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * Tests flight recorder (flight_recorder_dump) - last operations of every
+ * thread, kept if "flight_recorder" config item is set (tests use 8 operations
+ * per thread), otherwise flight_recorder_dump returns NOT_SUPPORTED.
+ */
+
+using namespace pmem::kv;
+
+static const size_t RECORDED = 8;
+static const size_t THREADS = 4;
+
+/* Dumps the recorder and returns recorded operations, grouped by threads */
+static bool dump(pmem::kv::db &kv, std::vector<std::vector<std::string>> &threads)
+{
+	char path[] = "flight_recorder_XXXXXX";
+	int fd = mkstemp(path);
+	UT_ASSERT(fd >= 0);
+	close(fd);
+
+	auto s = kv.flight_recorder_dump(path);
+	if (s == status::NOT_SUPPORTED) {
+		std::remove(path);
+		return false;
+	}
+	ASSERT_STATUS(s, status::OK);
+
+	threads.clear();
+	std::ifstream file(path);
+	std::string line;
+	while (std::getline(file, line)) {
+		if (line.empty() || line[0] == '#')
+			continue;
+		if (line.compare(0, 7, "thread ") == 0)
+			threads.emplace_back();
+		else
+			threads.back().push_back(line);
+	}
+
+	std::remove(path);
+	return true;
+}
+
+/* Returns n-th (0 - start time) space-separated field of a recorded operation */
+static std::string field(const std::string &op, size_t n)
+{
+	size_t pos = 0;
+	for (size_t i = 0; i < n; i++)
+		pos = op.find(' ', pos) + 1;
+
+	return op.substr(pos, op.find(' ', pos) - pos);
+}
+
+static void LastOperationsTest(pmem::kv::db &kv)
+{
+	std::vector<std::vector<std::string>> threads;
+	if (!dump(kv, threads))
+		return;
+
+	for (size_t i = 0; i < 2 * RECORDED; i++)
+		ASSERT_STATUS(kv.put(entry_from_number(i), entry_from_number(i)),
+			      status::OK);
+
+	std::string value;
+	ASSERT_STATUS(kv.get(entry_from_string("missing"), &value), status::NOT_FOUND);
+	ASSERT_STATUS(kv.exists(entry_from_number(0)), status::OK);
+	ASSERT_STATUS(kv.remove(entry_from_number(0)), status::OK);
+
+	UT_ASSERT(dump(kv, threads));
+	UT_ASSERTeq(threads.size(), 1);
+
+	/* older operations were overwritten */
+	auto &ops = threads[0];
+	UT_ASSERTeq(ops.size(), RECORDED);
+
+	for (size_t i = 0; i < RECORDED - 3; i++) {
+		UT_ASSERT(field(ops[i], 1) == "put");
+		UT_ASSERT(field(ops[i], 4) == "OK");
+		/* keys differ, so do their hashes */
+		if (i > 0)
+			UT_ASSERT(field(ops[i], 2) != field(ops[i - 1], 2));
+	}
+
+	UT_ASSERT(field(ops[RECORDED - 3], 1) == "get");
+	UT_ASSERT(field(ops[RECORDED - 3], 4) == "NOT_FOUND");
+	UT_ASSERT(field(ops[RECORDED - 2], 1) == "exists");
+	UT_ASSERT(field(ops[RECORDED - 2], 4) == "OK");
+	UT_ASSERT(field(ops[RECORDED - 1], 1) == "remove");
+	UT_ASSERT(field(ops[RECORDED - 1], 4) == "OK");
+	/* the same key */
+	UT_ASSERT(field(ops[RECORDED - 2], 2) == field(ops[RECORDED - 1], 2));
+
+	/* start times are ordered */
+	for (size_t i = 1; i < ops.size(); i++)
+		UT_ASSERT(field(ops[i - 1], 0) <= field(ops[i], 0));
+}
+
+static void ConcurrentDumpTest(pmem::kv::db &kv)
+{
+	std::vector<std::vector<std::string>> threads;
+	if (!dump(kv, threads))
+		return;
+
+	/* the first thread dumps while the others are recording */
+	parallel_exec(THREADS + 1, [&](size_t tid) {
+		std::vector<std::vector<std::string>> t;
+		for (size_t i = 0; i < 10 * RECORDED; i++) {
+			if (tid == 0)
+				UT_ASSERT(dump(kv, t));
+			else
+				ASSERT_STATUS(kv.exists(entry_from_string("missing")),
+					      status::NOT_FOUND);
+		}
+	});
+
+	UT_ASSERT(dump(kv, threads));
+	size_t full = 0;
+	for (auto &ops : threads) {
+		UT_ASSERT(ops.size() <= RECORDED);
+		if (ops.size() == RECORDED && field(ops.back(), 1) == "exists")
+			full++;
+	}
+	UT_ASSERT(full >= THREADS);
+}
+
+static void test(int argc, char *argv[])
+{
+	if (argc < 3)
+		UT_FATAL("usage: %s engine json_config", argv[0]);
+
+	run_engine_tests(argv[1], argv[2],
+			 {
+				 LastOperationsTest,
+				 ConcurrentDumpTest,
+			 });
+}
+
+int main(int argc, char *argv[])
+{
+	return run_test([&] { test(argc, argv); });
+}
@@ -0,0 +1,160 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "unittest.hpp"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Tests get_all_parallel (full scan split into partitions, scanned concurrently)
+ * and get_split_points (in engines which support it).
+ */
+
+using namespace pmem::kv;
+
+using kv_map = std::map<std::string, std::string>;
+
+static const size_t N = 1000;
+
+static void insert_keys(pmem::kv::db &kv)
+{
+	for (size_t i = 0; i < N; i++)
+		ASSERT_STATUS(kv.put(entry_from_number(i, "key"),
+				     entry_from_number(i, "val")),
+			      status::OK);
+}
+
+static kv_map scan_all(pmem::kv::db &kv)
+{
+	kv_map ret;
+	ASSERT_STATUS(kv.get_all([&](string_view k, string_view v) {
+		ret.emplace(std::string(k.data(), k.size()),
+			    std::string(v.data(), v.size()));
+		return 0;
+	}),
+		      status::OK);
+
+	return ret;
+}
+
+static kv_map scan_parallel(pmem::kv::db &kv, size_t partitions)
+{
+	kv_map ret;
+	size_t calls = 0;
+	std::mutex mtx;
+
+	auto s = kv.get_all_parallel(partitions, [&](string_view k, string_view v) {
+		std::unique_lock<std::mutex> lock(mtx);
+		ret.emplace(std::string(k.data(), k.size()),
+			    std::string(v.data(), v.size()));
+		calls++;
+
+		return 0;
+	});
+	ASSERT_STATUS(s, status::OK);
+
+	/* every record is visited exactly once */
+	UT_ASSERTeq(calls, ret.size());
+
+	return ret;
+}
+
+static void EmptyTest(pmem::kv::db &kv)
+{
+	for (size_t partitions : {1, 4})
+		UT_ASSERT(scan_parallel(kv, partitions).empty());
+
+	ASSERT_STATUS(kv.get_all_parallel(0, [&](string_view, string_view) { return 0; }),
+		      status::INVALID_ARGUMENT);
+}
+
+static void ParallelScanTest(pmem::kv::db &kv)
+{
+	insert_keys(kv);
+	auto expected = scan_all(kv);
+	UT_ASSERTeq(expected.size(), N);
+
+	for (size_t partitions : {1, 2, 3, 8, 64})
+		UT_ASSERT(scan_parallel(kv, partitions) == expected);
+}
+
+static void StopTest(pmem::kv::db &kv)
+{
+	insert_keys(kv);
+
+	const size_t partitions = 4;
+	std::atomic<size_t> calls(0);
+
+	auto s = kv.get_all_parallel(partitions, [&](string_view, string_view) {
+		calls++;
+		return 1;
+	});
+	ASSERT_STATUS(s, status::STOPPED_BY_CB);
+
+	/* at most one record per partition is processed after the scan is stopped */
+	UT_ASSERT(calls.load() >= 1);
+	UT_ASSERT(calls.load() <= partitions);
+}
+
+static void SplitPointsTest(pmem::kv::db &kv)
+{
+	insert_keys(kv);
+
+	std::vector<std::string> keys;
+	auto s = kv.get_split_points(4, keys);
+	if (s == status::NOT_SUPPORTED)
+		return;
+	ASSERT_STATUS(s, status::OK);
+
+	UT_ASSERT(keys.size() <= 3);
+	for (size_t i = 1; i < keys.size(); i++)
+		UT_ASSERT(keys[i - 1] < keys[i]);
+
+	/* ranges between split points cover all records */
+	size_t cnt = 0;
+	auto count = [&](string_view, string_view) {
+		cnt++;
+		return 0;
+	};
+
+	if (keys.empty()) {
+		ASSERT_STATUS(kv.get_all(count), status::OK);
+	} else {
+		ASSERT_STATUS(kv.get_below(keys.front(), count), status::OK);
+		for (size_t i = 1; i < keys.size(); i++)
+			ASSERT_STATUS(kv.get_equal_above(keys[i - 1], [&](string_view k,
+									  string_view v) {
+				if (k.compare(keys[i]) >= 0)
+					return 1;
+				return count(k, v);
+			}),
+				      status::STOPPED_BY_CB);
+		ASSERT_STATUS(kv.get_equal_above(keys.back(), count), status::OK);
+	}
+	UT_ASSERTeq(cnt, N);
+
+	ASSERT_STATUS(kv.get_split_points(0, keys), status::INVALID_ARGUMENT);
+}
+
+static void test(int argc, char *argv[])
+{
+	if (argc < 3)
+		UT_FATAL("usage: %s engine json_config", argv[0]);
+
+	run_engine_tests(argv[1], argv[2],
+			 {
+				 EmptyTest,
+				 ParallelScanTest,
+				 StopTest,
+				 SplitPointsTest,
+			 });
+}
+
+int main(int argc, char *argv[])
+{
+	return run_test([&] { test(argc, argv); });
+}
@@ -0,0 +1,174 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "unittest.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * Tests key-only scans (get_keys*), comparing them with keys returned by
+ * get_all/get_above/get_below/get_between. Ranged variants return
+ * NOT_SUPPORTED in unsorted engines, just like their key-value counterparts.
+ */
+
+using namespace pmem::kv;
+
+/* more than a few leaves of sorted engines */
+static const size_t N = 1000;
+
+static void insert_records(pmem::kv::db &kv)
+{
+	for (size_t i = 0; i < N; i++)
+		ASSERT_STATUS(kv.put(entry_from_number(i, "key"), entry_from_number(i, "val")),
+			      status::OK);
+}
+
+static std::function<int(string_view, string_view)>
+collect_kv(std::vector<std::string> &keys)
+{
+	return [&](string_view k, string_view) {
+		keys.emplace_back(k.data(), k.size());
+		return 0;
+	};
+}
+
+static std::function<int(string_view)> collect_k(std::vector<std::string> &keys)
+{
+	return [&](string_view k) {
+		keys.emplace_back(k.data(), k.size());
+		return 0;
+	};
+}
+
+static int stop_after_ten(const char *, size_t, void *arg)
+{
+	auto cnt = static_cast<size_t *>(arg);
+	return ++(*cnt) == 10;
+}
+
+static void GetKeysEmptyTest(pmem::kv::db &kv)
+{
+	std::vector<std::string> keys;
+	ASSERT_STATUS(kv.get_keys(collect_k(keys)), status::OK);
+	UT_ASSERT(keys.empty());
+}
+
+static void GetKeysTest(pmem::kv::db &kv)
+{
+	insert_records(kv);
+
+	std::vector<std::string> expected, keys;
+	ASSERT_STATUS(kv.get_all(collect_kv(expected)), status::OK);
+	ASSERT_STATUS(kv.get_keys(collect_k(keys)), status::OK);
+	UT_ASSERTeq(keys.size(), N);
+
+	/* tree3 takes keys from its volatile index, in a different order */
+	std::sort(expected.begin(), expected.end());
+	std::sort(keys.begin(), keys.end());
+	UT_ASSERT(keys == expected);
+
+	ASSERT_STATUS(kv.remove(entry_from_number(N / 2, "key")), status::OK);
+	keys.clear();
+	ASSERT_STATUS(kv.get_keys(collect_k(keys)), status::OK);
+	UT_ASSERTeq(keys.size(), N - 1);
+	UT_ASSERT(std::find(keys.begin(), keys.end(), entry_from_number(N / 2, "key")) ==
+		  keys.end());
+}
+
+static void GetKeysRangeTest(pmem::kv::db &kv)
+{
+	insert_records(kv);
+
+	std::vector<std::string> bounds = {
+		"", entry_from_number(0, "key"), entry_from_number(N / 3, "key"),
+		entry_from_number(N - 1, "key"), "zzz",
+	};
+
+	for (auto &b1 : bounds) {
+		std::vector<std::string> expected, keys;
+		auto s = kv.get_above(b1, collect_kv(expected));
+		ASSERT_STATUS(kv.get_keys_above(b1, collect_k(keys)), s);
+		UT_ASSERT(keys == expected);
+
+		expected.clear();
+		keys.clear();
+		s = kv.get_below(b1, collect_kv(expected));
+		ASSERT_STATUS(kv.get_keys_below(b1, collect_k(keys)), s);
+		UT_ASSERT(keys == expected);
+
+		for (auto &b2 : bounds) {
+			expected.clear();
+			keys.clear();
+			s = kv.get_between(b1, b2, collect_kv(expected));
+			ASSERT_STATUS(kv.get_keys_between(b1, b2, collect_k(keys)), s);
+			UT_ASSERT(keys == expected);
+		}
+	}
+}
+
+/* Missing bounds which sort right after a record (possibly the last of a leaf) */
+static void GetKeysGapBoundsTest(pmem::kv::db &kv)
+{
+	insert_records(kv);
+
+	std::vector<std::string> all;
+	ASSERT_STATUS(kv.get_keys(collect_k(all)), status::OK);
+	std::sort(all.begin(), all.end());
+
+	for (size_t i = 0; i < all.size(); i += 7) {
+		/* "!" sorts before digits, so the bound is not a prefix of the next key */
+		auto bound = all[i] + "!";
+		std::vector<std::string> expected(all.begin(),
+						  all.begin() + static_cast<long>(i) + 1);
+
+		std::vector<std::string> keys;
+		auto s = kv.get_keys_below(bound, collect_k(keys));
+		if (s == status::NOT_SUPPORTED)
+			return;
+		ASSERT_STATUS(s, status::OK);
+		UT_ASSERT(keys == expected);
+
+		keys.clear();
+		ASSERT_STATUS(kv.get_keys_between("", bound, collect_k(keys)), status::OK);
+		UT_ASSERT(keys == expected);
+	}
+}
+
+static void GetKeysStopTest(pmem::kv::db &kv)
+{
+	insert_records(kv);
+
+	size_t cnt = 0;
+	ASSERT_STATUS(kv.get_keys(stop_after_ten, &cnt), status::STOPPED_BY_CB);
+	UT_ASSERTeq(cnt, 10);
+
+	cnt = 0;
+	auto s = kv.get_keys_above("", stop_after_ten, &cnt);
+	if (s == status::NOT_SUPPORTED)
+		return;
+	ASSERT_STATUS(s, status::STOPPED_BY_CB);
+	UT_ASSERTeq(cnt, 10);
+}
+
+static void test(int argc, char *argv[])
+{
+	if (argc < 3)
+		UT_FATAL("usage: %s engine json_config", argv[0]);
+
+	run_engine_tests(argv[1], argv[2],
+			 {
+				 GetKeysEmptyTest,
+				 GetKeysTest,
+				 GetKeysRangeTest,
+				 GetKeysGapBoundsTest,
+				 GetKeysStopTest,
+			 });
+}
+
+int main(int argc, char *argv[])
+{
+	return run_test([&] { test(argc, argv); });
+}
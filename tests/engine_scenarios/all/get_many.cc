@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "unittest.hpp"
+
+#include <string>
+#include <vector>
+
+/**
+ * Tests get_many method (lookup of multiple keys in a single call)
+ */
+
+using namespace pmem::kv;
+
+static void GetManyEmptyTest(pmem::kv::db &kv)
+{
+	size_t calls = 0;
+	auto s = kv.get_many(std::vector<string_view>{},
+			     [&](size_t, status, string_view) { calls++; });
+	ASSERT_STATUS(s, status::OK);
+	UT_ASSERTeq(calls, 0);
+}
+
+static void GetManyTest(pmem::kv::db &kv)
+{
+	const size_t n = 100;
+
+	std::vector<std::string> keys;
+	for (size_t i = 0; i < n; i++) {
+		keys.emplace_back(entry_from_number(i, "key"));
+		if (i % 3 != 0)
+			ASSERT_STATUS(kv.put(keys.back(), entry_from_number(i, "val")),
+				      status::OK);
+	}
+
+	/* add duplicated key to check it is reported twice */
+	keys.emplace_back(entry_from_number(1, "key"));
+
+	std::vector<string_view> views(keys.begin(), keys.end());
+	std::vector<size_t> visited(keys.size(), 0);
+
+	auto s = kv.get_many(views, [&](size_t idx, status st, string_view value) {
+		UT_ASSERT(idx < keys.size());
+		visited[idx]++;
+
+		auto i = (idx == n) ? 1 : idx;
+		if (i % 3 == 0) {
+			UT_ASSERT(st == status::NOT_FOUND);
+			UT_ASSERTeq(value.size(), 0);
+		} else {
+			UT_ASSERT(st == status::OK);
+			UT_ASSERT(std::string(value.data(), value.size()) ==
+				  entry_from_number(i, "val"));
+		}
+	});
+	ASSERT_STATUS(s, status::OK);
+
+	for (auto v : visited)
+		UT_ASSERTeq(v, 1);
+}
+
+static void GetManyCTest(pmem::kv::db &kv)
+{
+	ASSERT_STATUS(kv.put(entry_from_string("abc"), entry_from_string("A1")),
+		      status::OK);
+	ASSERT_STATUS(kv.put(entry_from_string("def"), entry_from_string("B2")),
+		      status::OK);
+
+	std::vector<std::string> keys = {entry_from_string("def"),
+					 entry_from_string("nope"),
+					 entry_from_string("abc")};
+	std::vector<std::string> values(keys.size());
+	std::vector<status> statuses(keys.size(), status::UNKNOWN_ERROR);
+
+	struct context {
+		std::vector<std::string> *values;
+		std::vector<status> *statuses;
+	} ctx = {&values, &statuses};
+
+	std::vector<string_view> views(keys.begin(), keys.end());
+	auto s = kv.get_many(
+		views,
+		[](size_t idx, int st, const char *v, size_t vb, void *arg) {
+			auto c = reinterpret_cast<context *>(arg);
+			(*c->statuses)[idx] = static_cast<status>(st);
+			if (st == PMEMKV_STATUS_OK)
+				(*c->values)[idx].assign(v, vb);
+		},
+		&ctx);
+	ASSERT_STATUS(s, status::OK);
+
+	ASSERT_STATUS(statuses[0], status::OK);
+	UT_ASSERT(values[0] == entry_from_string("B2"));
+	ASSERT_STATUS(statuses[1], status::NOT_FOUND);
+	ASSERT_STATUS(statuses[2], status::OK);
+	UT_ASSERT(values[2] == entry_from_string("A1"));
+}
+
+static void test(int argc, char *argv[])
+{
+	if (argc < 3)
+		UT_FATAL("usage: %s engine json_config", argv[0]);
+
+	run_engine_tests(argv[1], argv[2],
+			 {
+				 GetManyEmptyTest,
+				 GetManyTest,
+				 GetManyCTest,
+			 });
+}
+
+int main(int argc, char *argv[])
+{
+	return run_test([&] { test(argc, argv); });
+}
@@ -0,0 +1,246 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "unittest.hpp"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Tests paginated scans: get_above_page and get_between_page methods
+ * (pages limited by number of records and/or their size, continued with
+ * the cursor's continuation key)
+ */
+
+using namespace pmem::kv;
+
+using records = std::vector<std::pair<std::string, std::string>>;
+
+static std::string to_string(string_view s)
+{
+	return std::string(s.data(), s.size());
+}
+
+static void insert(pmem::kv::db &kv, size_t n)
+{
+	for (size_t i = 0; i < n; i++)
+		ASSERT_STATUS(kv.put(entry_from_number(i, "key"), entry_from_number(i, "val")),
+			      status::OK);
+}
+
+/* Reads all pages above (or between) the given keys, checks page limits */
+static records read_pages(pmem::kv::db &kv, scan_cursor &cursor, std::string key1,
+			  const std::string *key2, size_t max_count, size_t max_bytes)
+{
+	records all;
+	size_t pages = 0;
+
+	do {
+		records page;
+		size_t bytes = 0;
+		auto f = [&](string_view k, string_view v) {
+			page.emplace_back(to_string(k), to_string(v));
+			bytes += k.size() + v.size();
+			return 0;
+		};
+
+		status s = key2 ? kv.get_between_page(key1, *key2, cursor, f)
+				: kv.get_above_page(key1, cursor, f);
+		ASSERT_STATUS(s, status::OK);
+
+		if (max_count)
+			UT_ASSERT(page.size() <= max_count);
+		if (max_bytes && page.size() > 1)
+			UT_ASSERT(bytes <= max_bytes);
+		if (cursor.has_more()) {
+			UT_ASSERT(page.size() > 0);
+			UT_ASSERT(to_string(cursor.next_key()) == page.back().first);
+		}
+
+		all.insert(all.end(), page.begin(), page.end());
+		key1 = to_string(cursor.next_key());
+		pages++;
+		UT_ASSERT(pages < 10000);
+	} while (cursor.has_more());
+
+	return all;
+}
+
+static records read_all(pmem::kv::db &kv)
+{
+	records all;
+	ASSERT_STATUS(kv.get_all([&](string_view k, string_view v) {
+		all.emplace_back(to_string(k), to_string(v));
+		return 0;
+	}),
+		      status::OK);
+	return all;
+}
+
+static void EmptyTest(pmem::kv::db &kv)
+{
+	scan_cursor cursor(10);
+	size_t cnt = 0;
+	auto f = [&](string_view, string_view) {
+		cnt++;
+		return 0;
+	};
+
+	ASSERT_STATUS(kv.get_above_page("", cursor, f), status::OK);
+	ASSERT_STATUS(kv.get_between_page("", entry_from_string("zzz"), cursor, f),
+		      status::OK);
+	UT_ASSERTeq(cnt, 0);
+	UT_ASSERT(!cursor.has_more());
+	UT_ASSERTeq(cursor.next_key().size(), 0);
+}
+
+static void PageCountTest(pmem::kv::db &kv)
+{
+	const size_t n = 250;
+	insert(kv, n);
+
+	auto expected = read_all(kv);
+	UT_ASSERTeq(expected.size(), n);
+
+	for (size_t max_count : {1, 7, 100, 250, 1000}) {
+		scan_cursor cursor(max_count);
+		auto all = read_pages(kv, cursor, "", nullptr, max_count, 0);
+		UT_ASSERT(all == expected);
+	}
+}
+
+static void PageBytesTest(pmem::kv::db &kv)
+{
+	const size_t n = 100;
+	insert(kv, n);
+
+	/* record bigger than the byte budget is still returned */
+	const std::string big_value(1000, 'x');
+	ASSERT_STATUS(kv.put(entry_from_string("big"), big_value), status::OK);
+
+	auto expected = read_all(kv);
+
+	for (size_t max_bytes : {1, 50, 333, 100000}) {
+		scan_cursor cursor(0, max_bytes);
+		auto all = read_pages(kv, cursor, "", nullptr, 0, max_bytes);
+		UT_ASSERT(all == expected);
+	}
+
+	scan_cursor cursor(5, 100);
+	auto all = read_pages(kv, cursor, "", nullptr, 5, 100);
+	UT_ASSERT(all == expected);
+}
+
+static void PageBetweenTest(pmem::kv::db &kv)
+{
+	const size_t n = 200;
+	insert(kv, n);
+
+	auto expected = read_all(kv);
+	std::string key1 = expected[10].first;
+	std::string key2 = expected[150].first;
+	records between(expected.begin() + 11, expected.begin() + 150);
+
+	scan_cursor cursor(13);
+	auto all = read_pages(kv, cursor, key1, &key2, 13, 0);
+	UT_ASSERT(all == between);
+
+	/* empty range */
+	all = read_pages(kv, cursor, key2, &key1, 13, 0);
+	UT_ASSERTeq(all.size(), 0);
+}
+
+static void ModifyBetweenPagesTest(pmem::kv::db &kv)
+{
+	const size_t n = 100;
+	insert(kv, n);
+
+	auto before = read_all(kv);
+
+	scan_cursor cursor(10);
+	records all;
+	std::string key = "";
+	size_t pages = 0;
+	auto f = [&](string_view k, string_view v) {
+		all.emplace_back(to_string(k), to_string(v));
+		return 0;
+	};
+
+	do {
+		ASSERT_STATUS(kv.get_above_page(key, cursor, f), status::OK);
+		key = to_string(cursor.next_key());
+
+		/* remove the last returned record and the one following it */
+		if (cursor.has_more() && pages % 2 == 0) {
+			ASSERT_STATUS(kv.remove(key), status::OK);
+			auto it = std::find_if(before.begin(), before.end(),
+					       [&](const records::value_type &r) {
+						       return r.first == key;
+					       });
+			UT_ASSERT(it != before.end());
+			if (++it != before.end())
+				ASSERT_STATUS(kv.remove(it->first), status::OK);
+		}
+		pages++;
+	} while (cursor.has_more());
+
+	/* every record which was not removed is returned exactly once */
+	auto after = read_all(kv);
+	records expected;
+	for (auto &r : before) {
+		bool returned = std::find(all.begin(), all.end(), r) != all.end();
+		bool present = std::find(after.begin(), after.end(), r) != after.end();
+		if (present)
+			UT_ASSERT(returned);
+		if (returned)
+			expected.push_back(r);
+	}
+	UT_ASSERT(all == expected);
+}
+
+static void StopByCallbackTest(pmem::kv::db &kv)
+{
+	const size_t n = 50;
+	insert(kv, n);
+
+	auto expected = read_all(kv);
+
+	scan_cursor cursor(20);
+	records all;
+	auto f = [&](string_view k, string_view v) {
+		all.emplace_back(to_string(k), to_string(v));
+		return all.size() % 3 == 0 ? 1 : 0;
+	};
+
+	std::string key = "";
+	do {
+		auto s = kv.get_above_page(key, cursor, f);
+		UT_ASSERT(s == status::OK || s == status::STOPPED_BY_CB);
+		key = to_string(cursor.next_key());
+	} while (cursor.has_more());
+
+	UT_ASSERT(all == expected);
+}
+
+static void test(int argc, char *argv[])
+{
+	if (argc < 3)
+		UT_FATAL("usage: %s engine json_config", argv[0]);
+
+	run_engine_tests(argv[1], argv[2],
+			 {
+				 EmptyTest,
+				 PageCountTest,
+				 PageBytesTest,
+				 PageBetweenTest,
+				 ModifyBetweenPagesTest,
+				 StopByCallbackTest,
+			 });
+}
+
+int main(int argc, char *argv[])
+{
+	return run_test([&] { test(argc, argv); });
+}
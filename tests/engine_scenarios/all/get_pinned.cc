@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "unittest.hpp"
+
+#include <string>
+#include <vector>
+
+/**
+ * Tests get_pinned method (value returned without a copy, valid until released)
+ */
+
+using namespace pmem::kv;
+
+static std::string value_of(const pinned_value &pv)
+{
+	return std::string(pv.value().data(), pv.value().size());
+}
+
+static void NotFoundTest(pmem::kv::db &kv)
+{
+	auto res = kv.get_pinned(entry_from_string("key1"));
+	ASSERT_STATUS(res.get_status(), status::NOT_FOUND);
+
+	ASSERT_STATUS(kv.put(entry_from_string("key1"), entry_from_string("value1")),
+		      status::OK);
+	res = kv.get_pinned(entry_from_string("key2"));
+	ASSERT_STATUS(res.get_status(), status::NOT_FOUND);
+}
+
+static void PinnedValueTest(pmem::kv::db &kv)
+{
+	const size_t n = 100;
+	const std::string big_value(8192, 'x');
+
+	for (size_t i = 0; i < n; i++)
+		ASSERT_STATUS(kv.put(entry_from_number(i), entry_from_number(i, "", "val")),
+			      status::OK);
+	ASSERT_STATUS(kv.put(entry_from_string("big"), big_value), status::OK);
+
+	/* many values can be pinned at the same time */
+	std::vector<pinned_value> pinned;
+	for (size_t i = 0; i < n; i++) {
+		auto res = kv.get_pinned(entry_from_number(i));
+		UT_ASSERT(res.is_ok());
+		pinned.emplace_back(std::move(res).get_value());
+	}
+
+	for (size_t i = 0; i < n; i++)
+		UT_ASSERT(value_of(pinned[i]) == entry_from_number(i, "", "val"));
+
+	auto res = kv.get_pinned(entry_from_string("big"));
+	UT_ASSERT(res.is_ok());
+	UT_ASSERT(value_of(res.get_value()) == big_value);
+
+	/* pinned value stays valid after it's moved */
+	auto big = std::move(res).get_value();
+	UT_ASSERT(value_of(big) == big_value);
+
+	big.release();
+	UT_ASSERTeq(big.value().size(), 0);
+	pinned.clear();
+
+	/* record can be modified after all pins are released */
+	ASSERT_STATUS(kv.put(entry_from_string("big"), entry_from_string("small")),
+		      status::OK);
+	res = kv.get_pinned(entry_from_string("big"));
+	UT_ASSERT(res.is_ok());
+	UT_ASSERT(value_of(res.get_value()) == entry_from_string("small"));
+}
+
+static void test(int argc, char *argv[])
+{
+	if (argc < 3)
+		UT_FATAL("usage: %s engine json_config", argv[0]);
+
+	run_engine_tests(argv[1], argv[2],
+			 {
+				 NotFoundTest,
+				 PinnedValueTest,
+			 });
+}
+
+int main(int argc, char *argv[])
+{
+	return run_test([&] { test(argc, argv); });
+}
@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "unittest.hpp"
+
+#include <atomic>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Tests put_async and get_async methods (executed in the caller's thread or by
+ * async workers, depending on "async_workers" config parameter)
+ */
+
+using namespace pmem::kv;
+
+static void PutGetFutureTest(pmem::kv::db &kv)
+{
+	const size_t n = 500;
+
+	std::vector<std::future<status>> puts;
+	for (size_t i = 0; i < n; i++)
+		puts.emplace_back(kv.put_async(entry_from_number(i, "key"),
+					       entry_from_number(i, "val")));
+
+	for (auto &f : puts)
+		ASSERT_STATUS(f.get(), status::OK);
+
+	std::vector<std::future<result<std::string>>> gets;
+	for (size_t i = 0; i < n; i++)
+		gets.emplace_back(kv.get_async(entry_from_number(i, "key")));
+
+	for (size_t i = 0; i < n; i++) {
+		auto res = gets[i].get();
+		UT_ASSERT(res.is_ok());
+		UT_ASSERT(res.get_value() == entry_from_number(i, "val"));
+	}
+
+	auto res = kv.get_async(entry_from_string("nope")).get();
+	ASSERT_STATUS(res.get_status(), status::NOT_FOUND);
+}
+
+static void SameKeyOrderTest(pmem::kv::db &kv)
+{
+	const size_t n = 200;
+
+	/* operations on the same key are executed in order of submission */
+	std::vector<std::future<status>> puts;
+	for (size_t i = 0; i < n; i++)
+		puts.emplace_back(
+			kv.put_async(entry_from_string("key"), entry_from_number(i)));
+
+	auto res = kv.get_async(entry_from_string("key")).get();
+	UT_ASSERT(res.is_ok());
+	UT_ASSERT(res.get_value() == entry_from_number(n - 1));
+
+	for (auto &f : puts)
+		ASSERT_STATUS(f.get(), status::OK);
+}
+
+struct callback_context {
+	std::atomic<size_t> completed;
+	std::atomic<size_t> failed;
+};
+
+static void CallbackTest(pmem::kv::db &kv)
+{
+	const size_t n = 500;
+
+	callback_context ctx;
+	ctx.completed = 0;
+	ctx.failed = 0;
+
+	auto cb = [](int s, const char *, size_t, void *arg) {
+		auto c = static_cast<callback_context *>(arg);
+		if (s != PMEMKV_STATUS_OK)
+			c->failed++;
+		c->completed++;
+	};
+
+	for (size_t i = 0; i < n; i++)
+		ASSERT_STATUS(kv.put_async(entry_from_number(i, "key"),
+					   entry_from_number(i, "val"), cb, &ctx),
+			      status::OK);
+
+	while (ctx.completed.load() != n)
+		std::this_thread::yield();
+	UT_ASSERTeq(ctx.failed.load(), 0);
+
+	std::size_t cnt = 0;
+	ASSERT_STATUS(kv.count_all(cnt), status::OK);
+	UT_ASSERTeq(cnt, n);
+}
+
+static void test(int argc, char *argv[])
+{
+	if (argc < 3)
+		UT_FATAL("usage: %s engine json_config", argv[0]);
+
+	run_engine_tests(argv[1], argv[2],
+			 {
+				 PutGetFutureTest,
+				 SameKeyOrderTest,
+				 CallbackTest,
+			 });
+}
+
+int main(int argc, char *argv[])
+{
+	return run_test([&] { test(argc, argv); });
+}
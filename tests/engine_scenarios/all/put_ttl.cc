@@ -0,0 +1,180 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "unittest.hpp"
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+/**
+ * Tests put with time-to-live: lazy expiry on point lookups and removal of
+ * expired records by the reaper.
+ */
+
+using namespace pmem::kv;
+
+static const auto short_ttl = std::chrono::milliseconds(1);
+static const auto long_ttl = std::chrono::hours(1);
+
+static bool ttl_supported(pmem::kv::db &kv)
+{
+	auto key = entry_from_string("ttl");
+	auto s = kv.put(key, entry_from_string("val"), long_ttl);
+	if (s == status::NOT_SUPPORTED)
+		return false;
+
+	ASSERT_STATUS(s, status::OK);
+	ASSERT_STATUS(kv.remove(key), status::OK);
+
+	return true;
+}
+
+static void wait_for_expiry()
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+}
+
+static void InvalidTtlTest(pmem::kv::db &kv)
+{
+	if (!ttl_supported(kv))
+		return;
+
+	auto key = entry_from_string("key");
+	auto val = entry_from_string("val");
+	ASSERT_STATUS(kv.put(key, val, std::chrono::milliseconds(0)),
+		      status::INVALID_ARGUMENT);
+	ASSERT_STATUS(kv.put(key, val, std::chrono::milliseconds(-1)),
+		      status::INVALID_ARGUMENT);
+	ASSERT_STATUS(kv.exists(key), status::NOT_FOUND);
+}
+
+static void LazyExpiryTest(pmem::kv::db &kv)
+{
+	if (!ttl_supported(kv))
+		return;
+
+	auto key1 = entry_from_string("key1");
+	auto key2 = entry_from_string("key2");
+	auto val = entry_from_string("val");
+	std::string value;
+
+	ASSERT_STATUS(kv.put(key1, val, long_ttl), status::OK);
+	ASSERT_STATUS(kv.put(key2, val, short_ttl), status::OK);
+	wait_for_expiry();
+
+	ASSERT_STATUS(kv.get(key1, &value), status::OK);
+	UT_ASSERT(value == val);
+
+	ASSERT_STATUS(kv.get(key2, &value), status::NOT_FOUND);
+	ASSERT_STATUS(kv.exists(key2), status::NOT_FOUND);
+	ASSERT_STATUS(kv.get_pinned(key2).get_status(), status::NOT_FOUND);
+
+	std::vector<status> statuses;
+	ASSERT_STATUS(kv.get_many({key1, key2},
+				  [&](size_t, status s, string_view) {
+					  statuses.push_back(s);
+				  }),
+		      status::OK);
+	UT_ASSERTeq(statuses.size(), 2);
+	ASSERT_STATUS(statuses[0], status::OK);
+	ASSERT_STATUS(statuses[1], status::NOT_FOUND);
+
+	/* expired record is not found by remove */
+	ASSERT_STATUS(kv.remove(key2), status::NOT_FOUND);
+
+	CLEAR_KV(kv);
+}
+
+static void OverwriteTest(pmem::kv::db &kv)
+{
+	if (!ttl_supported(kv))
+		return;
+
+	auto key = entry_from_string("key");
+	auto val1 = entry_from_string("val1");
+	auto val2 = entry_from_string("val2");
+	std::string value;
+
+	/* put without ttl cancels the expiration */
+	ASSERT_STATUS(kv.put(key, val1, short_ttl), status::OK);
+	ASSERT_STATUS(kv.put(key, val2), status::OK);
+	wait_for_expiry();
+
+	ASSERT_STATUS(kv.get(key, &value), status::OK);
+	UT_ASSERT(value == val2);
+
+	/* new ttl replaces the previous one */
+	ASSERT_STATUS(kv.put(key, val1, short_ttl), status::OK);
+	ASSERT_STATUS(kv.put(key, val2, long_ttl), status::OK);
+	wait_for_expiry();
+
+	ASSERT_STATUS(kv.get(key, &value), status::OK);
+	UT_ASSERT(value == val2);
+
+	/* expired record can be put again */
+	ASSERT_STATUS(kv.put(key, val1, short_ttl), status::OK);
+	wait_for_expiry();
+	ASSERT_STATUS(kv.exists(key), status::NOT_FOUND);
+
+	ASSERT_STATUS(kv.put(key, val2), status::OK);
+	ASSERT_STATUS(kv.get(key, &value), status::OK);
+	UT_ASSERT(value == val2);
+
+	CLEAR_KV(kv);
+}
+
+static void ReaperTest(pmem::kv::db &kv)
+{
+	if (!ttl_supported(kv))
+		return;
+
+	const size_t n = 1000;
+	for (size_t i = 0; i < n; i++) {
+		auto val = entry_from_number(i, "", "val");
+		ASSERT_STATUS(kv.put(entry_from_number(i), val, short_ttl), status::OK);
+	}
+	ASSERT_STATUS(kv.put(entry_from_string("persistent"), entry_from_string("val")),
+		      status::OK);
+
+	/*
+	 * Expired records are removed in the background (or, by single-threaded
+	 * engines, during write operations, so some writes are issued as well).
+	 */
+	auto dummy = entry_from_string("dummy");
+	size_t cnt = 0;
+	for (size_t retry = 0; retry < 600; retry++) {
+		ASSERT_STATUS(kv.put(dummy, dummy), status::OK);
+		ASSERT_STATUS(kv.remove(dummy), status::OK);
+
+		ASSERT_STATUS(kv.count_all(cnt), status::OK);
+		if (cnt == 1)
+			break;
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+
+	UT_ASSERTeq(cnt, 1);
+	ASSERT_STATUS(kv.exists(entry_from_string("persistent")), status::OK);
+
+	CLEAR_KV(kv);
+}
+
+static void test(int argc, char *argv[])
+{
+	if (argc < 3)
+		UT_FATAL("usage: %s engine json_config", argv[0]);
+
+	run_engine_tests(argv[1], argv[2],
+			 {
+				 InvalidTtlTest,
+				 LazyExpiryTest,
+				 OverwriteTest,
+				 ReaperTest,
+			 });
+}
+
+int main(int argc, char *argv[])
+{
+	return run_test([&] { test(argc, argv); });
+}
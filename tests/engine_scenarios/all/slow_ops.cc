@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "unittest.hpp"
+
+#include <string>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * Tests slow operation log (get_slow_ops) - operations which took longer than
+ * "slow_op_threshold_us" (tests use 1 microsecond), with their keys, threads
+ * and phases. Without the config item get_slow_ops returns NOT_SUPPORTED.
+ */
+
+using namespace pmem::kv;
+
+static const size_t N = 100;
+static const size_t VALUE_SIZE = 64 * 1024;
+
+static bool get_slow_ops(pmem::kv::db &kv, std::vector<slow_op_info> &ops,
+			 std::vector<std::string> &key_prefixes)
+{
+	ops.clear();
+	key_prefixes.clear();
+	auto s = kv.get_slow_ops([&](const slow_op_info &op) {
+		ops.push_back(op);
+		key_prefixes.emplace_back(op.key_prefix, op.key_prefix_size);
+		return 0;
+	});
+	if (s == status::NOT_SUPPORTED)
+		return false;
+
+	ASSERT_STATUS(s, status::OK);
+	return true;
+}
+
+static void SlowPutsTest(pmem::kv::db &kv)
+{
+	std::vector<slow_op_info> ops;
+	std::vector<std::string> prefixes;
+	if (!get_slow_ops(kv, ops, prefixes))
+		return;
+
+	/* long keys, to check that only their beginning is kept */
+	std::vector<std::string> keys;
+	for (size_t i = 0; i < N; i++) {
+		keys.push_back(entry_from_number(i, std::string(40, 'k')));
+		ASSERT_STATUS(kv.put(keys.back(), std::string(VALUE_SIZE, 'v')),
+			      status::OK);
+	}
+
+	UT_ASSERT(get_slow_ops(kv, ops, prefixes));
+
+	auto tid = static_cast<uint64_t>(syscall(SYS_gettid));
+	size_t puts = 0;
+	for (size_t i = 0; i < ops.size(); i++) {
+		auto &op = ops[i];
+		UT_ASSERT(op.latency_ns >= 1000);
+		UT_ASSERT(op.lookup_ns + op.allocation_ns + op.flush_ns +
+				  op.lock_wait_ns <=
+			  op.latency_ns);
+		UT_ASSERTeq(op.thread_id, tid);
+		if (i > 0)
+			UT_ASSERT(ops[i - 1].start_ns <= op.start_ns);
+
+		if (std::string(op.op) != "put")
+			continue;
+
+		puts++;
+		UT_ASSERTeq(op.status, static_cast<int>(status::OK));
+		UT_ASSERTeq(op.key_size, keys[0].size());
+		UT_ASSERTeq(op.key_prefix_size, 32);
+		UT_ASSERT(keys[0].compare(0, 32, prefixes[i]) == 0);
+	}
+
+	/* writing 64 KiB values takes more than 1 us */
+	UT_ASSERT(puts > 0);
+}
+
+static void StoppedByCallbackTest(pmem::kv::db &kv)
+{
+	std::vector<slow_op_info> ops;
+	std::vector<std::string> prefixes;
+	if (!get_slow_ops(kv, ops, prefixes))
+		return;
+
+	ASSERT_STATUS(kv.put(entry_from_string("key"), std::string(VALUE_SIZE, 'v')),
+		      status::OK);
+	ASSERT_STATUS(kv.put(entry_from_string("key"), std::string(VALUE_SIZE, 'w')),
+		      status::OK);
+
+	UT_ASSERT(get_slow_ops(kv, ops, prefixes));
+	UT_ASSERT(ops.size() >= 1);
+	UT_ASSERT(ops.size() <= 1024);
+
+	size_t calls = 0;
+	auto s = kv.get_slow_ops([&](const slow_op_info &) {
+		calls++;
+		return 1;
+	});
+	ASSERT_STATUS(s, status::STOPPED_BY_CB);
+	UT_ASSERTeq(calls, 1);
+}
+
+static void test(int argc, char *argv[])
+{
+	if (argc < 3)
+		UT_FATAL("usage: %s engine json_config", argv[0]);
+
+	run_engine_tests(argv[1], argv[2],
+			 {
+				 SlowPutsTest,
+				 StoppedByCallbackTest,
+			 });
+}
+
+int main(int argc, char *argv[])
+{
+	return run_test([&] { test(argc, argv); });
+}
@@ -0,0 +1,197 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "unittest.hpp"
+
+#include <string>
+#include <vector>
+
+/**
+ * Tests operation statistics (get_stats) - counters of get, put, remove, exists
+ * and tx commit and their latencies. Statistics are gathered only if "stats"
+ * config flag is set, otherwise get_stats returns NOT_SUPPORTED.
+ */
+
+using namespace pmem::kv;
+
+static const size_t N = 10;
+
+static bool get_stats(pmem::kv::db &kv, std::string &json)
+{
+	json = "unchanged";
+	auto s = kv.get_stats(&json);
+	if (s == status::NOT_SUPPORTED) {
+		UT_ASSERT(json == "unchanged");
+		return false;
+	}
+
+	ASSERT_STATUS(s, status::OK);
+	UT_ASSERT(json.find("\"engine_counters\":{") != std::string::npos);
+	return true;
+}
+
+static uint64_t counter(const std::string &json, const std::string &op,
+			const std::string &name)
+{
+	auto pos = json.find("\"" + op + "\":{");
+	UT_ASSERT(pos != std::string::npos);
+
+	pos = json.find("\"" + name + "\":", pos);
+	UT_ASSERT(pos != std::string::npos);
+
+	return std::stoull(json.substr(pos + name.size() + 3));
+}
+
+static uint64_t delta(const std::string &before, const std::string &after,
+		      const std::string &op, const std::string &name)
+{
+	return counter(after, op, name) - counter(before, op, name);
+}
+
+static void OpCountersTest(pmem::kv::db &kv)
+{
+	std::string before, after;
+	if (!get_stats(kv, before))
+		return;
+
+	size_t put_bytes = 0;
+	for (size_t i = 0; i < N; i++) {
+		auto key = entry_from_number(i, "key");
+		auto value = entry_from_string(std::string(i + 1, 'v'));
+		ASSERT_STATUS(kv.put(key, value), status::OK);
+		put_bytes += key.size() + value.size();
+	}
+
+	size_t get_bytes = 0;
+	for (size_t i = 0; i < N; i++) {
+		std::string value;
+		ASSERT_STATUS(kv.get(entry_from_number(i, "key"), &value), status::OK);
+		get_bytes += value.size();
+	}
+	std::string value;
+	ASSERT_STATUS(kv.get(entry_from_string("missing1"), &value), status::NOT_FOUND);
+	ASSERT_STATUS(kv.get(entry_from_string("missing2"), &value), status::NOT_FOUND);
+
+	ASSERT_STATUS(kv.exists(entry_from_number(0, "key")), status::OK);
+	ASSERT_STATUS(kv.exists(entry_from_string("missing1")), status::NOT_FOUND);
+
+	ASSERT_STATUS(kv.remove(entry_from_number(0, "key")), status::OK);
+	ASSERT_STATUS(kv.remove(entry_from_number(0, "key")), status::NOT_FOUND);
+
+	UT_ASSERT(get_stats(kv, after));
+
+	UT_ASSERTeq(delta(before, after, "put", "count"), N);
+	UT_ASSERTeq(delta(before, after, "put", "not_found"), 0);
+	UT_ASSERTeq(delta(before, after, "put", "errors"), 0);
+	UT_ASSERTeq(delta(before, after, "put", "bytes"), put_bytes);
+
+	UT_ASSERTeq(delta(before, after, "get", "count"), N + 2);
+	UT_ASSERTeq(delta(before, after, "get", "not_found"), 2);
+	UT_ASSERTeq(delta(before, after, "get", "errors"), 0);
+	UT_ASSERTeq(delta(before, after, "get", "bytes"), get_bytes);
+
+	UT_ASSERTeq(delta(before, after, "exists", "count"), 2);
+	UT_ASSERTeq(delta(before, after, "exists", "not_found"), 1);
+
+	UT_ASSERTeq(delta(before, after, "remove", "count"), 2);
+	UT_ASSERTeq(delta(before, after, "remove", "not_found"), 1);
+	UT_ASSERTeq(delta(before, after, "remove", "errors"), 0);
+}
+
+static void LatencyTest(pmem::kv::db &kv)
+{
+	std::string json;
+	if (!get_stats(kv, json))
+		return;
+
+	for (size_t i = 0; i < N; i++)
+		ASSERT_STATUS(kv.put(entry_from_number(i), entry_from_number(i)),
+			      status::OK);
+
+	UT_ASSERT(get_stats(kv, json));
+
+	std::vector<std::string> names = {"min", "p50", "p90", "p99", "p999", "max"};
+	for (size_t i = 1; i < names.size(); i++)
+		UT_ASSERT(counter(json, "put", names[i - 1]) <=
+			  counter(json, "put", names[i]));
+
+	auto mean = counter(json, "put", "mean");
+	UT_ASSERT(mean >= counter(json, "put", "min"));
+	UT_ASSERT(mean <= counter(json, "put", "max"));
+}
+
+static void TxCommitTest(pmem::kv::db &kv)
+{
+	std::string before, after;
+	if (!get_stats(kv, before))
+		return;
+
+	auto tx = kv.tx_begin();
+	if (!tx.is_ok()) {
+		ASSERT_STATUS(tx.get_status(), status::NOT_SUPPORTED);
+		return;
+	}
+
+	auto k1 = entry_from_string("key1"), v1 = entry_from_string("value1");
+	auto k2 = entry_from_string("key2"), v2 = entry_from_string("value22");
+	ASSERT_STATUS(tx.get_value().put(k1, v1), status::OK);
+	ASSERT_STATUS(tx.get_value().put(k2, v2), status::OK);
+	ASSERT_STATUS(tx.get_value().commit(), status::OK);
+
+	UT_ASSERT(get_stats(kv, after));
+
+	UT_ASSERTeq(delta(before, after, "tx_commit", "count"), 1);
+	UT_ASSERTeq(delta(before, after, "tx_commit", "errors"), 0);
+	UT_ASSERTeq(delta(before, after, "tx_commit", "bytes"),
+		    k1.size() + v1.size() + k2.size() + v2.size());
+	/* puts in a transaction are not counted as puts */
+	UT_ASSERTeq(delta(before, after, "put", "count"), 0);
+}
+
+/* Engine counters of radix with DRAM caching */
+static void CacheCountersTest(pmem::kv::db &kv)
+{
+	std::string before, after;
+	if (!get_stats(kv, before))
+		return;
+	if (before.find("\"cache_hits\":") == std::string::npos)
+		return;
+
+	for (size_t i = 0; i < N; i++)
+		ASSERT_STATUS(kv.put(entry_from_number(i, "cached"), entry_from_number(i)),
+			      status::OK);
+
+	/* all of them fit in the cache */
+	std::string value;
+	for (size_t i = 0; i < N; i++)
+		ASSERT_STATUS(kv.get(entry_from_number(i, "cached"), &value), status::OK);
+	ASSERT_STATUS(kv.get(entry_from_string("missing"), &value), status::NOT_FOUND);
+
+	UT_ASSERT(get_stats(kv, after));
+
+	UT_ASSERTeq(delta(before, after, "engine_counters", "cache_hits"), N);
+	UT_ASSERTeq(delta(before, after, "engine_counters", "cache_misses"), 1);
+	UT_ASSERTeq(delta(before, after, "engine_counters", "queue_produced"), N);
+	UT_ASSERT(counter(after, "engine_counters", "log_fill_percent") <= 100);
+	UT_ASSERT(counter(after, "engine_counters", "queue_bytes") <=
+		  counter(after, "engine_counters", "log_size"));
+}
+
+static void test(int argc, char *argv[])
+{
+	if (argc < 3)
+		UT_FATAL("usage: %s engine json_config", argv[0]);
+
+	run_engine_tests(argv[1], argv[2],
+			 {
+				 OpCountersTest,
+				 LatencyTest,
+				 TxCommitTest,
+				 CacheCountersTest,
+			 });
+}
+
+int main(int argc, char *argv[])
+{
+	return run_test([&] { test(argc, argv); });
+}
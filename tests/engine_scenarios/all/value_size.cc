@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "unittest.hpp"
+
+#include <string>
+#include <vector>
+
+/**
+ * Tests value_size method - it has to return the same size as get does.
+ */
+
+using namespace pmem::kv;
+
+/* engines with fixed-size entries (robinhood) pad all of them */
+static bool fixed_size_entries()
+{
+	return !entry_from_string("").empty();
+}
+
+static void check_value_size(pmem::kv::db &kv, const std::string &key)
+{
+	std::string value;
+	ASSERT_STATUS(kv.get(key, &value), status::OK);
+
+	std::size_t size;
+	ASSERT_STATUS(kv.value_size(key, size), status::OK);
+	UT_ASSERTeq(size, value.size());
+}
+
+static void ValueSizeTest(pmem::kv::db &kv)
+{
+	std::vector<std::string> values = {
+		entry_from_string(""),
+		entry_from_string("a"),
+		entry_from_string("value"),
+	};
+	if (!fixed_size_entries()) {
+		values.emplace_back(100, 'x');
+		values.emplace_back(10000, 'y');
+	}
+
+	for (size_t i = 0; i < values.size(); i++) {
+		auto key = entry_from_number(i);
+		ASSERT_STATUS(kv.put(key, values[i]), status::OK);
+
+		std::size_t size;
+		ASSERT_STATUS(kv.value_size(key, size), status::OK);
+		UT_ASSERTeq(size, values[i].size());
+	}
+
+	for (size_t i = 0; i < values.size(); i++)
+		check_value_size(kv, entry_from_number(i));
+}
+
+static void ValueSizeOverwriteTest(pmem::kv::db &kv)
+{
+	auto key = entry_from_string("key");
+
+	ASSERT_STATUS(kv.put(key, entry_from_string("aaaa")), status::OK);
+	check_value_size(kv, key);
+
+	ASSERT_STATUS(kv.put(key, entry_from_string("b")), status::OK);
+	check_value_size(kv, key);
+
+	if (fixed_size_entries())
+		return;
+
+	ASSERT_STATUS(kv.put(key, std::string(1000, 'c')), status::OK);
+	check_value_size(kv, key);
+
+	ASSERT_STATUS(kv.put(key, ""), status::OK);
+	check_value_size(kv, key);
+}
+
+static void ValueSizeNotFoundTest(pmem::kv::db &kv)
+{
+	auto key = entry_from_string("key");
+	std::size_t size = 1;
+
+	ASSERT_STATUS(kv.value_size(key, size), status::NOT_FOUND);
+	UT_ASSERTeq(size, 1);
+
+	ASSERT_STATUS(kv.put(key, entry_from_string("value")), status::OK);
+	check_value_size(kv, key);
+
+	ASSERT_STATUS(kv.remove(key), status::OK);
+	ASSERT_STATUS(kv.value_size(key, size), status::NOT_FOUND);
+	ASSERT_STATUS(kv.value_size(entry_from_string("other"), size), status::NOT_FOUND);
+}
+
+static void test(int argc, char *argv[])
+{
+	if (argc < 3)
+		UT_FATAL("usage: %s engine json_config", argv[0]);
+
+	run_engine_tests(argv[1], argv[2],
+			 {
+				 ValueSizeTest,
+				 ValueSizeOverwriteTest,
+				 ValueSizeNotFoundTest,
+			 });
+}
+
+int main(int argc, char *argv[])
+{
+	return run_test([&] { test(argc, argv); });
+}
@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "unittest.hpp"
+
+#include <limits>
+#include <string>
+
+/**
+ * Tests write_batch (non-atomic batch of puts and removes)
+ */
+
+using namespace pmem::kv;
+
+static void check_value(pmem::kv::db &kv, const std::string &key,
+			const std::string &expected)
+{
+	std::string value;
+	ASSERT_STATUS(kv.get(key, &value), status::OK);
+	UT_ASSERT(value == expected);
+}
+
+static void EmptyBatchTest(pmem::kv::db &kv)
+{
+	write_batch batch;
+	UT_ASSERTeq(batch.count(), 0);
+	ASSERT_STATUS(kv.write(batch), status::OK);
+
+	std::size_t cnt = std::numeric_limits<std::size_t>::max();
+	ASSERT_STATUS(kv.count_all(cnt), status::OK);
+	UT_ASSERTeq(cnt, 0);
+}
+
+static void PutBatchTest(pmem::kv::db &kv)
+{
+	const size_t n = 1000;
+
+	write_batch batch;
+	for (size_t i = 0; i < n; i++)
+		ASSERT_STATUS(batch.put(entry_from_number(i, "key"),
+					entry_from_number(i, "val")),
+			      status::OK);
+	UT_ASSERTeq(batch.count(), n);
+
+	ASSERT_STATUS(kv.write(batch), status::OK);
+
+	std::size_t cnt = std::numeric_limits<std::size_t>::max();
+	ASSERT_STATUS(kv.count_all(cnt), status::OK);
+	UT_ASSERTeq(cnt, n);
+
+	for (size_t i = 0; i < n; i++)
+		check_value(kv, entry_from_number(i, "key"), entry_from_number(i, "val"));
+}
+
+static void MixedBatchTest(pmem::kv::db &kv)
+{
+	ASSERT_STATUS(kv.put(entry_from_string("a"), entry_from_string("1")), status::OK);
+	ASSERT_STATUS(kv.put(entry_from_string("b"), entry_from_string("2")), status::OK);
+
+	write_batch batch;
+	/* overwrite existing key */
+	ASSERT_STATUS(batch.put(entry_from_string("a"), entry_from_string("11")),
+		      status::OK);
+	/* remove existing key */
+	ASSERT_STATUS(batch.remove(entry_from_string("b")), status::OK);
+	/* remove non-existing key is not an error */
+	ASSERT_STATUS(batch.remove(entry_from_string("nope")), status::OK);
+	/* put, remove and put again the same key - order must be preserved */
+	ASSERT_STATUS(batch.put(entry_from_string("c"), entry_from_string("3")),
+		      status::OK);
+	ASSERT_STATUS(batch.remove(entry_from_string("c")), status::OK);
+	ASSERT_STATUS(batch.put(entry_from_string("c"), entry_from_string("33")),
+		      status::OK);
+	/* put and remove the same key */
+	ASSERT_STATUS(batch.put(entry_from_string("d"), entry_from_string("4")),
+		      status::OK);
+	ASSERT_STATUS(batch.remove(entry_from_string("d")), status::OK);
+	UT_ASSERTeq(batch.count(), 8);
+
+	ASSERT_STATUS(kv.write(batch), status::OK);
+
+	std::size_t cnt = std::numeric_limits<std::size_t>::max();
+	ASSERT_STATUS(kv.count_all(cnt), status::OK);
+	UT_ASSERTeq(cnt, 2);
+
+	check_value(kv, entry_from_string("a"), entry_from_string("11"));
+	check_value(kv, entry_from_string("c"), entry_from_string("33"));
+	ASSERT_STATUS(kv.exists(entry_from_string("b")), status::NOT_FOUND);
+	ASSERT_STATUS(kv.exists(entry_from_string("d")), status::NOT_FOUND);
+
+	/* batch is not modified by write and can be reused after clear */
+	UT_ASSERTeq(batch.count(), 8);
+	batch.clear();
+	UT_ASSERTeq(batch.count(), 0);
+
+	ASSERT_STATUS(batch.remove(entry_from_string("a")), status::OK);
+	ASSERT_STATUS(kv.write(batch), status::OK);
+	ASSERT_STATUS(kv.exists(entry_from_string("a")), status::NOT_FOUND);
+}
+
+static void test(int argc, char *argv[])
+{
+	if (argc < 3)
+		UT_FATAL("usage: %s engine json_config", argv[0]);
+
+	run_engine_tests(argv[1], argv[2],
+			 {
+				 EmptyBatchTest,
+				 PutBatchTest,
+				 MixedBatchTest,
+			 });
+}
+
+int main(int argc, char *argv[])
+{
+	return run_test([&] { test(argc, argv); });
+}
@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "unittest.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * Tests conditional writes (put_if_absent, compare_and_swap and remove_if),
+ * executed concurrently from multiple threads on the same keys.
+ */
+
+using namespace pmem::kv;
+
+static std::string uint64_to_string(uint64_t v)
+{
+	return std::string(reinterpret_cast<const char *>(&v), sizeof(v));
+}
+
+static uint64_t string_to_uint64(const std::string &s)
+{
+	UT_ASSERTeq(s.size(), sizeof(uint64_t));
+
+	uint64_t v;
+	std::memcpy(&v, s.data(), sizeof(v));
+	return v;
+}
+
+static bool remove_if_supported(pmem::kv::db &kv)
+{
+	return kv.remove_if(entry_from_string("key"), entry_from_string("val")) !=
+		status::NOT_SUPPORTED;
+}
+
+static void SimpleTest(const size_t, const size_t, pmem::kv::db &kv)
+{
+	auto key = entry_from_string("key");
+	auto val1 = entry_from_string("val1");
+	auto val2 = entry_from_string("val2");
+	std::string value;
+
+	ASSERT_STATUS(kv.compare_and_swap(key, val1, val2), status::NOT_FOUND);
+	ASSERT_STATUS(kv.exists(key), status::NOT_FOUND);
+
+	ASSERT_STATUS(kv.put_if_absent(key, val1), status::OK);
+	ASSERT_STATUS(kv.put_if_absent(key, val2), status::CONDITION_NOT_MET);
+	ASSERT_STATUS(kv.get(key, &value), status::OK);
+	UT_ASSERT(value == val1);
+
+	ASSERT_STATUS(kv.compare_and_swap(key, val2, val1), status::CONDITION_NOT_MET);
+	ASSERT_STATUS(kv.get(key, &value), status::OK);
+	UT_ASSERT(value == val1);
+
+	ASSERT_STATUS(kv.compare_and_swap(key, val1, val2), status::OK);
+	ASSERT_STATUS(kv.get(key, &value), status::OK);
+	UT_ASSERT(value == val2);
+
+	if (remove_if_supported(kv)) {
+		ASSERT_STATUS(kv.remove_if(key, val1), status::CONDITION_NOT_MET);
+		ASSERT_STATUS(kv.exists(key), status::OK);
+
+		ASSERT_STATUS(kv.remove_if(key, val2), status::OK);
+		ASSERT_STATUS(kv.exists(key), status::NOT_FOUND);
+		ASSERT_STATUS(kv.remove_if(key, val2), status::NOT_FOUND);
+	}
+
+	CLEAR_KV(kv);
+}
+
+/* every key is inserted by exactly one of the threads */
+static void PutIfAbsentTest(const size_t threads_number, const size_t thread_items,
+			    pmem::kv::db &kv)
+{
+	std::vector<std::atomic<size_t>> winners(thread_items);
+	std::vector<std::atomic<size_t>> winner_ids(thread_items);
+
+	parallel_exec(threads_number, [&](size_t thread_id) {
+		auto val = entry_from_number(thread_id, "v");
+		for (size_t i = 0; i < thread_items; i++) {
+			auto s = kv.put_if_absent(entry_from_number(i), val);
+			if (s == status::OK) {
+				winners[i]++;
+				winner_ids[i] = thread_id;
+			} else {
+				ASSERT_STATUS(s, status::CONDITION_NOT_MET);
+			}
+		}
+	});
+
+	ASSERT_SIZE(kv, thread_items);
+	for (size_t i = 0; i < thread_items; i++) {
+		UT_ASSERTeq(winners[i].load(), 1);
+
+		std::string value;
+		ASSERT_STATUS(kv.get(entry_from_number(i), &value), status::OK);
+		UT_ASSERT(value == entry_from_number(winner_ids[i].load(), "v"));
+	}
+
+	CLEAR_KV(kv);
+}
+
+/* counter incremented with compare_and_swap does not lose any update */
+static void CompareAndSwapTest(const size_t threads_number, const size_t thread_items,
+			       pmem::kv::db &kv)
+{
+	auto key = entry_from_string("counter");
+	ASSERT_STATUS(kv.put(key, uint64_to_string(0)), status::OK);
+
+	parallel_exec(threads_number, [&](size_t) {
+		for (size_t i = 0; i < thread_items; i++) {
+			status s;
+			do {
+				std::string value;
+				ASSERT_STATUS(kv.get(key, &value), status::OK);
+
+				auto next = uint64_to_string(string_to_uint64(value) + 1);
+				s = kv.compare_and_swap(key, value, next);
+			} while (s == status::CONDITION_NOT_MET);
+
+			ASSERT_STATUS(s, status::OK);
+		}
+	});
+
+	std::string value;
+	ASSERT_STATUS(kv.get(key, &value), status::OK);
+	UT_ASSERTeq(string_to_uint64(value), threads_number * thread_items);
+
+	CLEAR_KV(kv);
+}
+
+/* every key is removed by exactly one of the threads */
+static void RemoveIfTest(const size_t threads_number, const size_t thread_items,
+			 pmem::kv::db &kv)
+{
+	if (!remove_if_supported(kv))
+		return;
+
+	for (size_t i = 0; i < thread_items; i++)
+		ASSERT_STATUS(kv.put(entry_from_number(i), entry_from_number(i, "", "!")),
+			      status::OK);
+
+	std::vector<std::atomic<size_t>> winners(thread_items);
+
+	parallel_exec(threads_number, [&](size_t thread_id) {
+		for (size_t i = 0; i < thread_items; i++) {
+			auto key = entry_from_number(i);
+
+			/* half of the threads expect a wrong value */
+			if (thread_id % 2) {
+				auto s = kv.remove_if(key, entry_from_number(i, "", "?"));
+				UT_ASSERT(s == status::CONDITION_NOT_MET ||
+					  s == status::NOT_FOUND);
+				continue;
+			}
+
+			auto s = kv.remove_if(key, entry_from_number(i, "", "!"));
+			if (s == status::OK)
+				winners[i]++;
+			else
+				ASSERT_STATUS(s, status::NOT_FOUND);
+		}
+	});
+
+	ASSERT_SIZE(kv, 0);
+	for (size_t i = 0; i < thread_items; i++)
+		UT_ASSERTeq(winners[i].load(), 1);
+}
+
+static void test(int argc, char *argv[])
+{
+	using namespace std::placeholders;
+
+	if (argc < 5)
+		UT_FATAL("usage: %s engine json_config threads items", argv[0]);
+
+	size_t threads_number = std::stoull(argv[3]);
+	size_t thread_items = std::stoull(argv[4]);
+	run_engine_tests(argv[1], argv[2],
+			 {
+				 std::bind(SimpleTest, threads_number, thread_items, _1),
+				 std::bind(PutIfAbsentTest, threads_number, thread_items,
+					   _1),
+				 std::bind(CompareAndSwapTest, threads_number,
+					   thread_items, _1),
+				 std::bind(RemoveIfTest, threads_number, thread_items,
+					   _1),
+			 });
+}
+
+int main(int argc, char *argv[])
+{
+	return run_test([&] { test(argc, argv); });
+}
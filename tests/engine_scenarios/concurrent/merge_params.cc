@@ -0,0 +1,230 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "unittest.hpp"
+
+#include <cstring>
+#include <string>
+
+/**
+ * Tests merge method with built-in (uint64 add, append) and custom merge
+ * operators, executed concurrently from multiple threads.
+ */
+
+using namespace pmem::kv;
+
+static std::string uint64_to_string(uint64_t v)
+{
+	return std::string(reinterpret_cast<const char *>(&v), sizeof(v));
+}
+
+static uint64_t get_uint64(pmem::kv::db &kv, const std::string &key)
+{
+	std::string value;
+	ASSERT_STATUS(kv.get(key, &value), status::OK);
+	UT_ASSERTeq(value.size(), sizeof(uint64_t));
+
+	uint64_t v;
+	std::memcpy(&v, value.data(), sizeof(v));
+	return v;
+}
+
+template <typename MergeOperator>
+static pmem::kv::db open_with(std::string engine, std::string json, MergeOperator &&op)
+{
+	auto cfg = CONFIG_FROM_JSON(json);
+	ASSERT_STATUS(cfg.put_merge_operator(std::forward<MergeOperator>(op)),
+		      status::OK);
+
+	return INITIALIZE_KV(engine, std::move(cfg));
+}
+
+/* keeps the greater (in binary order) of the current value and the operand */
+class max_merge_operator {
+public:
+	bool merge(string_view, const string_view *existing_value, string_view operand,
+		   std::string &new_value)
+	{
+		if (existing_value && existing_value->compare(operand) > 0)
+			new_value.assign(existing_value->data(), existing_value->size());
+		else
+			new_value.assign(operand.data(), operand.size());
+
+		return true;
+	}
+
+	std::string name()
+	{
+		return "max";
+	}
+};
+
+class failing_merge_operator {
+public:
+	bool merge(string_view, const string_view *, string_view, std::string &)
+	{
+		return false;
+	}
+
+	std::string name()
+	{
+		return "failing";
+	}
+};
+
+static void NoMergeOperatorTest(std::string engine, std::string json)
+{
+	auto kv = INITIALIZE_KV(engine, CONFIG_FROM_JSON(json));
+
+	ASSERT_STATUS(kv.merge("key", "value"), status::INVALID_ARGUMENT);
+	ASSERT_STATUS(kv.exists("key"), status::NOT_FOUND);
+
+	kv.close();
+}
+
+static void Uint64AddTest(std::string engine, std::string json, size_t threads,
+			  size_t n)
+{
+	auto kv = open_with(engine, json, uint64_add_merge_operator{});
+
+	/* missing record is treated as 0 */
+	ASSERT_STATUS(kv.merge("counter", uint64_to_string(5)), status::OK);
+	UT_ASSERTeq(get_uint64(kv, "counter"), 5);
+
+	parallel_exec(threads, [&](size_t) {
+		for (size_t i = 0; i < n; i++) {
+			ASSERT_STATUS(kv.merge("counter", uint64_to_string(1)),
+				      status::OK);
+			ASSERT_STATUS(kv.merge(entry_from_number(i, "counter_"),
+					       uint64_to_string(2)),
+				      status::OK);
+		}
+	});
+
+	UT_ASSERTeq(get_uint64(kv, "counter"), 5 + threads * n);
+	for (size_t i = 0; i < n; i++) {
+		auto v = get_uint64(kv, entry_from_number(i, "counter_"));
+		UT_ASSERTeq(v, 2 * threads);
+	}
+
+	/* operands and values of a wrong size are rejected */
+	ASSERT_STATUS(kv.merge("counter", "1"), status::INVALID_ARGUMENT);
+	UT_ASSERTeq(get_uint64(kv, "counter"), 5 + threads * n);
+
+	ASSERT_STATUS(kv.put("string", "abc"), status::OK);
+	ASSERT_STATUS(kv.merge("string", uint64_to_string(1)), status::INVALID_ARGUMENT);
+
+	std::string value;
+	ASSERT_STATUS(kv.get("string", &value), status::OK);
+	UT_ASSERT(value == "abc");
+
+	CLEAR_KV(kv);
+	kv.close();
+}
+
+static void AppendTest(std::string engine, std::string json, size_t threads, size_t n)
+{
+	auto kv = open_with(engine, json, append_merge_operator{});
+
+	ASSERT_STATUS(kv.put("list", "head:"), status::OK);
+
+	parallel_exec(threads, [&](size_t thread_id) {
+		auto item = std::string(1, static_cast<char>('a' + thread_id % 26));
+		for (size_t i = 0; i < n; i++)
+			ASSERT_STATUS(kv.merge("list", item), status::OK);
+	});
+
+	std::string value;
+	ASSERT_STATUS(kv.get("list", &value), status::OK);
+	UT_ASSERTeq(value.size(), 5 + threads * n);
+	UT_ASSERT(value.compare(0, 5, "head:") == 0);
+
+	/* no appended item was lost */
+	for (size_t t = 0; t < threads; t++) {
+		auto c = static_cast<char>('a' + t % 26);
+		size_t expected = 0;
+		for (size_t u = 0; u < threads; u++)
+			if (static_cast<char>('a' + u % 26) == c)
+				expected += n;
+
+		size_t cnt = 0;
+		for (auto ch : value)
+			if (ch == c)
+				cnt++;
+		UT_ASSERTeq(cnt, expected);
+	}
+
+	ASSERT_STATUS(kv.merge("new_list", "x"), status::OK);
+	ASSERT_STATUS(kv.get("new_list", &value), status::OK);
+	UT_ASSERT(value == "x");
+
+	CLEAR_KV(kv);
+	kv.close();
+}
+
+static void CustomMergeTest(std::string engine, std::string json, size_t threads,
+			    size_t n)
+{
+	auto kv = open_with(engine, json, max_merge_operator{});
+
+	parallel_exec(threads, [&](size_t thread_id) {
+		for (size_t i = 0; i < n; i++) {
+			auto v = entry_from_number(thread_id * n + i, "", "_val");
+			ASSERT_STATUS(kv.merge("max", v), status::OK);
+		}
+	});
+
+	std::string expected;
+	for (size_t i = 0; i < threads * n; i++) {
+		auto v = entry_from_number(i, "", "_val");
+		if (v > expected)
+			expected = v;
+	}
+
+	std::string value;
+	ASSERT_STATUS(kv.get("max", &value), status::OK);
+	UT_ASSERT(value == expected);
+
+	CLEAR_KV(kv);
+	kv.close();
+}
+
+static void FailingMergeTest(std::string engine, std::string json)
+{
+	auto kv = open_with(engine, json, failing_merge_operator{});
+
+	ASSERT_STATUS(kv.merge("key", "value"), status::INVALID_ARGUMENT);
+	ASSERT_STATUS(kv.exists("key"), status::NOT_FOUND);
+
+	ASSERT_STATUS(kv.put("key", "value"), status::OK);
+	ASSERT_STATUS(kv.merge("key", "other"), status::INVALID_ARGUMENT);
+
+	std::string value;
+	ASSERT_STATUS(kv.get("key", &value), status::OK);
+	UT_ASSERT(value == "value");
+
+	CLEAR_KV(kv);
+	kv.close();
+}
+
+static void test(int argc, char *argv[])
+{
+	if (argc < 5)
+		UT_FATAL("usage: %s engine json_config threads ops_per_thread", argv[0]);
+
+	std::string engine = argv[1];
+	std::string json = argv[2];
+	size_t threads = std::stoull(argv[3]);
+	size_t n = std::stoull(argv[4]);
+
+	NoMergeOperatorTest(engine, json);
+	Uint64AddTest(engine, json, threads, n);
+	AppendTest(engine, json, threads, n);
+	CustomMergeTest(engine, json, threads, n);
+	FailingMergeTest(engine, json);
+}
+
+int main(int argc, char *argv[])
+{
+	return run_test([&] { test(argc, argv); });
+}
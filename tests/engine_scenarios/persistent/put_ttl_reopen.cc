@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "unittest.hpp"
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+/**
+ * Tests if deadlines of records put with time-to-live are kept after the
+ * database is reopened.
+ */
+
+using namespace pmem::kv;
+
+static const auto ttl = std::chrono::milliseconds(200);
+static const auto long_ttl = std::chrono::hours(1);
+
+static void test(int argc, char *argv[])
+{
+	if (argc < 3)
+		UT_FATAL("usage: %s engine json_config", argv[0]);
+
+	auto kv = INITIALIZE_KV(argv[1], CONFIG_FROM_JSON(argv[2]));
+
+	auto expiring = entry_from_string("expiring");
+	auto overwritten = entry_from_string("overwritten");
+	auto removed = entry_from_string("removed");
+	auto lasting = entry_from_string("lasting");
+	auto val = entry_from_string("val");
+
+	auto s = kv.put(expiring, val, ttl);
+	if (s == status::NOT_SUPPORTED) {
+		kv.close();
+		return;
+	}
+	ASSERT_STATUS(s, status::OK);
+
+	/* overwriting and removing the record cancels its expiration */
+	ASSERT_STATUS(kv.put(overwritten, val, ttl), status::OK);
+	ASSERT_STATUS(kv.put(overwritten, val), status::OK);
+	ASSERT_STATUS(kv.put(removed, val, ttl), status::OK);
+	ASSERT_STATUS(kv.remove(removed), status::OK);
+	ASSERT_STATUS(kv.put(removed, val), status::OK);
+	ASSERT_STATUS(kv.put(lasting, val, long_ttl), status::OK);
+
+	kv.close();
+	kv = INITIALIZE_KV(argv[1], CONFIG_FROM_JSON(argv[2]));
+
+	std::this_thread::sleep_for(2 * ttl);
+
+	ASSERT_STATUS(kv.exists(expiring), status::NOT_FOUND);
+	ASSERT_STATUS(kv.exists(overwritten), status::OK);
+	ASSERT_STATUS(kv.exists(removed), status::OK);
+	ASSERT_STATUS(kv.exists(lasting), status::OK);
+
+	kv.close();
+	kv = INITIALIZE_KV(argv[1], CONFIG_FROM_JSON(argv[2]));
+
+	/* expired record may have been removed by the reaper before closing */
+	ASSERT_STATUS(kv.exists(expiring), status::NOT_FOUND);
+	ASSERT_STATUS(kv.exists(lasting), status::OK);
+
+	kv.close();
+}
+
+int main(int argc, char *argv[])
+{
+	return run_test([&] { test(argc, argv); });
+}
@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "unittest.hpp"
+
+#include <string>
+
+/**
+ * Tests memory_usage method of pmemobj-based engines. It's supported only if
+ * "heap_stats" config flag is set (heap statistics are enabled).
+ */
+
+using namespace pmem::kv;
+
+static const size_t N = 1000;
+
+static bool memory_usage(pmem::kv::db &kv, memory_usage_info &usage)
+{
+	auto res = kv.memory_usage();
+	if (res.get_status() == status::NOT_SUPPORTED)
+		return false;
+
+	UT_ASSERT(res.is_ok());
+	usage = res.get_value();
+
+	/* tests use pools created from a file */
+	UT_ASSERT(usage.pool_size > 0);
+	UT_ASSERT(usage.allocated <= usage.pool_size);
+	UT_ASSERTeq(usage.free, usage.pool_size - usage.allocated);
+	/* radix with dram_caching keeps new records in the log, allocated earlier */
+	if (usage.allocated >= usage.keys + usage.values)
+		UT_ASSERTeq(usage.index, usage.allocated - usage.keys - usage.values);
+	else
+		UT_ASSERTeq(usage.index, 0);
+	UT_ASSERT(usage.fragmentation >= 0 && usage.fragmentation <= 1);
+
+	return true;
+}
+
+static void MemoryUsageEmptyTest(pmem::kv::db &kv)
+{
+	memory_usage_info usage;
+	if (!memory_usage(kv, usage))
+		return;
+
+	UT_ASSERTeq(usage.keys, 0);
+	UT_ASSERTeq(usage.values, 0);
+}
+
+static void MemoryUsageInsertRemoveTest(pmem::kv::db &kv)
+{
+	memory_usage_info usage;
+	if (!memory_usage(kv, usage))
+		return;
+
+	size_t keys = 0, values = 0;
+	for (size_t i = 0; i < N; i++) {
+		auto key = entry_from_number(i, "key");
+		auto value = entry_from_number(i, "value", std::string(i % 100, 'v'));
+		ASSERT_STATUS(kv.put(key, value), status::OK);
+		keys += key.size();
+		values += value.size();
+	}
+
+	UT_ASSERT(memory_usage(kv, usage));
+	UT_ASSERTeq(usage.keys, keys);
+	UT_ASSERTeq(usage.values, values);
+
+	for (size_t i = 0; i < N; i += 2) {
+		auto key = entry_from_number(i, "key");
+		auto value = entry_from_number(i, "value", std::string(i % 100, 'v'));
+		ASSERT_STATUS(kv.remove(key), status::OK);
+		keys -= key.size();
+		values -= value.size();
+	}
+
+	UT_ASSERT(memory_usage(kv, usage));
+	UT_ASSERTeq(usage.keys, keys);
+	UT_ASSERTeq(usage.values, values);
+}
+
+static void test(int argc, char *argv[])
+{
+	if (argc < 3)
+		UT_FATAL("usage: %s engine json_config", argv[0]);
+
+	run_engine_tests(argv[1], argv[2],
+			 {
+				 MemoryUsageEmptyTest,
+				 MemoryUsageInsertRemoveTest,
+			 });
+}
+
+int main(int argc, char *argv[])
+{
+	return run_test([&] { test(argc, argv); });
+}
@@ -0,0 +1,225 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "unittest.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Tests descending scans (get_*_desc methods), comparing their results with
+ * reversed results of corresponding ascending scans.
+ */
+
+using namespace pmem::kv;
+
+using kv_list = std::vector<std::pair<std::string, std::string>>;
+using scan_function = std::function<status(std::function<get_kv_function>)>;
+
+static const size_t N = 1000;
+
+static kv_list scan(scan_function f, status expected = status::OK)
+{
+	kv_list ret;
+	ASSERT_STATUS(f([&](string_view k, string_view v) {
+			      ret.emplace_back(std::string(k.data(), k.size()),
+					       std::string(v.data(), v.size()));
+			      return 0;
+		      }),
+		      expected);
+
+	return ret;
+}
+
+static kv_list reversed(kv_list l)
+{
+	std::reverse(l.begin(), l.end());
+	return l;
+}
+
+static bool desc_supported(pmem::kv::db &kv)
+{
+	return kv.get_all_desc([](string_view, string_view) { return 0; }) !=
+		status::NOT_SUPPORTED;
+}
+
+static void insert_keys(pmem::kv::db &kv)
+{
+	for (size_t i = 0; i < N; i += 2)
+		ASSERT_STATUS(kv.put(entry_from_number(i, "key"),
+				     entry_from_number(i, "val")),
+			      status::OK);
+}
+
+static std::vector<std::string> bounds()
+{
+	/* existing and non-existing keys, lower and greater than all keys */
+	std::vector<std::string> ret = {entry_from_string(""), entry_from_string("a"),
+					entry_from_string("key"), entry_from_string("z")};
+	for (size_t i = 0; i < N; i += 37)
+		ret.push_back(entry_from_number(i, "key"));
+
+	return ret;
+}
+
+static void EmptyTest(pmem::kv::db &kv)
+{
+	if (!desc_supported(kv))
+		return;
+
+	UT_ASSERT(scan([&](std::function<get_kv_function> f) {
+			  return kv.get_all_desc(f);
+		  }).empty());
+
+	auto key = entry_from_string("key");
+	UT_ASSERT(scan([&](std::function<get_kv_function> f) {
+			  return kv.get_below_desc(key, f);
+		  }).empty());
+	UT_ASSERT(scan([&](std::function<get_kv_function> f) {
+			  return kv.get_equal_above_desc(key, f);
+		  }).empty());
+}
+
+static void GetAllDescTest(pmem::kv::db &kv)
+{
+	if (!desc_supported(kv))
+		return;
+
+	insert_keys(kv);
+
+	auto asc = scan([&](std::function<get_kv_function> f) { return kv.get_all(f); });
+	UT_ASSERTeq(asc.size(), N / 2);
+
+	auto desc = scan(
+		[&](std::function<get_kv_function> f) { return kv.get_all_desc(f); });
+	UT_ASSERT(desc == reversed(asc));
+}
+
+static void GetRangeDescTest(pmem::kv::db &kv)
+{
+	if (!desc_supported(kv))
+		return;
+
+	insert_keys(kv);
+
+	for (auto &key : bounds()) {
+		UT_ASSERT(scan([&](std::function<get_kv_function> f) {
+				  return kv.get_above_desc(key, f);
+			  }) == reversed(scan([&](std::function<get_kv_function> f) {
+				  return kv.get_above(key, f);
+			  })));
+		UT_ASSERT(scan([&](std::function<get_kv_function> f) {
+				  return kv.get_equal_above_desc(key, f);
+			  }) == reversed(scan([&](std::function<get_kv_function> f) {
+				  return kv.get_equal_above(key, f);
+			  })));
+		UT_ASSERT(scan([&](std::function<get_kv_function> f) {
+				  return kv.get_equal_below_desc(key, f);
+			  }) == reversed(scan([&](std::function<get_kv_function> f) {
+				  return kv.get_equal_below(key, f);
+			  })));
+		UT_ASSERT(scan([&](std::function<get_kv_function> f) {
+				  return kv.get_below_desc(key, f);
+			  }) == reversed(scan([&](std::function<get_kv_function> f) {
+				  return kv.get_below(key, f);
+			  })));
+
+		/* also covers empty (key1 == key2) and inverted ranges */
+		for (auto &key2 : bounds()) {
+			UT_ASSERT(scan([&](std::function<get_kv_function> f) {
+					  return kv.get_between_desc(key, key2, f);
+				  }) ==
+				  reversed(scan([&](std::function<get_kv_function> f) {
+					  return kv.get_between(key, key2, f);
+				  })));
+		}
+	}
+}
+
+/*
+ * Bounds which are missing and sort right after a record (possibly the last
+ * one of a leaf), checked against the expected records, not other scans.
+ */
+static void GapBoundsDescTest(pmem::kv::db &kv)
+{
+	if (!desc_supported(kv))
+		return;
+
+	insert_keys(kv);
+
+	auto all = scan([&](std::function<get_kv_function> f) { return kv.get_all(f); });
+	UT_ASSERTeq(all.size(), N / 2);
+
+	for (size_t i = 0; i < all.size(); i += 3) {
+		/* "!" sorts before digits, so the bound is not a prefix of the next key */
+		auto bound = all[i].first + "!";
+
+		kv_list expected(all.begin(), all.begin() + static_cast<long>(i) + 1);
+		UT_ASSERT(scan([&](std::function<get_kv_function> f) {
+				  return kv.get_below_desc(bound, f);
+			  }) == reversed(expected));
+		UT_ASSERT(scan([&](std::function<get_kv_function> f) {
+				  return kv.get_between_desc("", bound, f);
+			  }) == reversed(expected));
+
+		expected.assign(all.begin() + static_cast<long>(i) + 1, all.end());
+		UT_ASSERT(scan([&](std::function<get_kv_function> f) {
+				  return kv.get_above_desc(bound, f);
+			  }) == reversed(expected));
+	}
+}
+
+static void StopByCallbackTest(pmem::kv::db &kv)
+{
+	if (!desc_supported(kv))
+		return;
+
+	insert_keys(kv);
+
+	const size_t limit = 10;
+	auto expected = reversed(
+		scan([&](std::function<get_kv_function> f) { return kv.get_all(f); }));
+	expected.resize(limit);
+
+	/* the newest (greatest) N records */
+	kv_list result;
+	auto s = kv.get_all_desc([&](string_view k, string_view v) {
+		result.emplace_back(std::string(k.data(), k.size()),
+				    std::string(v.data(), v.size()));
+		return result.size() == limit ? 1 : 0;
+	});
+	ASSERT_STATUS(s, status::STOPPED_BY_CB);
+	UT_ASSERT(result == expected);
+
+	auto key = entry_from_number(N / 2, "key");
+	size_t calls = 0;
+	s = kv.get_below_desc(key, [&](string_view, string_view) {
+		calls++;
+		return calls == limit ? 1 : 0;
+	});
+	ASSERT_STATUS(s, status::STOPPED_BY_CB);
+	UT_ASSERTeq(calls, limit);
+}
+
+static void test(int argc, char *argv[])
+{
+	if (argc < 3)
+		UT_FATAL("usage: %s engine json_config", argv[0]);
+
+	run_engine_tests(argv[1], argv[2],
+			 {
+				 EmptyTest,
+				 GetAllDescTest,
+				 GetRangeDescTest,
+				 GapBoundsDescTest,
+				 StopByCallbackTest,
+			 });
+}
+
+int main(int argc, char *argv[])
+{
+	return run_test([&] { test(argc, argv); });
+}
@@ -0,0 +1,302 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "unittest.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * Tests get_prefix and count_prefix methods and iterator's seek_prefix
+ * (in sorted engines, with the default comparator).
+ */
+
+using namespace pmem::kv;
+
+static std::string to_string(string_view s)
+{
+	return std::string(s.data(), s.size());
+}
+
+static const std::vector<std::string> keys = {
+	"a",
+	"ab",
+	"ab/",
+	"ab/c",
+	"ab/c/d",
+	"ab/cd",
+	"ab/d",
+	"abc",
+	"b",
+	"tenant1/obj1/a",
+	"tenant1/obj1/b",
+	"tenant1/obj2/a",
+	"tenant10/obj1/a",
+	"tenant2/obj1/a",
+	std::string("x\xff", 2),
+	std::string("x\xff\xff", 3),
+	std::string("x\xff\xff\x01", 4),
+	std::string("y\x00", 2),
+	std::string("y\x00\x00", 3),
+};
+
+static const std::vector<std::string> prefixes = {
+	"",
+	"a",
+	"ab",
+	"ab/",
+	"ab/c",
+	"abc",
+	"abcd",
+	"b",
+	"c",
+	"tenant1",
+	"tenant1/",
+	"tenant1/obj1/",
+	"tenant2/obj1/a",
+	"tenant3",
+	"z",
+	std::string("x\xff", 2),
+	std::string("x\xff\xff", 3),
+	std::string("y\x00", 2),
+};
+
+static bool has_prefix(const std::string &key, const std::string &prefix)
+{
+	return key.compare(0, prefix.size(), prefix) == 0;
+}
+
+static std::vector<std::string> expected_keys(const std::string &prefix)
+{
+	std::vector<std::string> ret;
+	for (auto &k : keys)
+		if (has_prefix(k, prefix))
+			ret.push_back(k);
+
+	std::sort(ret.begin(), ret.end());
+	return ret;
+}
+
+static void insert_keys(pmem::kv::db &kv)
+{
+	for (auto &k : keys)
+		ASSERT_STATUS(kv.put(k, "val_" + k), status::OK);
+}
+
+static void EmptyTest(pmem::kv::db &kv)
+{
+	for (auto &p : prefixes) {
+		std::size_t cnt = 1;
+		ASSERT_STATUS(kv.count_prefix(p, cnt), status::OK);
+		UT_ASSERTeq(cnt, 0);
+
+		ASSERT_STATUS(kv.get_prefix(p,
+					    [&](string_view, string_view) {
+						    UT_ASSERT(false);
+						    return 0;
+					    }),
+			      status::OK);
+	}
+}
+
+static void GetPrefixTest(pmem::kv::db &kv)
+{
+	insert_keys(kv);
+
+	for (auto &p : prefixes) {
+		auto expected = expected_keys(p);
+
+		std::vector<std::string> result;
+		ASSERT_STATUS(kv.get_prefix(p,
+					    [&](string_view k, string_view v) {
+						    result.push_back(to_string(k));
+						    UT_ASSERT(to_string(v) ==
+							      "val_" + to_string(k));
+						    return 0;
+					    }),
+			      status::OK);
+		UT_ASSERT(result == expected);
+
+		std::size_t cnt;
+		ASSERT_STATUS(kv.count_prefix(p, cnt), status::OK);
+		UT_ASSERTeq(cnt, expected.size());
+	}
+}
+
+static void StopByCallbackTest(pmem::kv::db &kv)
+{
+	insert_keys(kv);
+
+	std::size_t calls = 0;
+	auto s = kv.get_prefix("ab", [&](string_view, string_view) {
+		calls++;
+		return calls == 2 ? 1 : 0;
+	});
+	ASSERT_STATUS(s, status::STOPPED_BY_CB);
+	UT_ASSERTeq(calls, 2);
+}
+
+template <typename Iterator>
+static std::vector<std::string> iterate_prefix(Iterator &it, const std::string &prefix)
+{
+	std::vector<std::string> ret;
+
+	auto s = it.seek_prefix(prefix);
+	if (s == status::NOT_FOUND)
+		return ret;
+	ASSERT_STATUS(s, status::OK);
+
+	while (true) {
+		auto k = it.key();
+		UT_ASSERT(k.is_ok());
+		ret.push_back(to_string(k.get_value()));
+		UT_ASSERT(ret.size() <= keys.size());
+
+		auto is_next = it.is_next();
+		auto next = it.next();
+		ASSERT_STATUS(next, is_next);
+		if (next == status::NOT_FOUND)
+			break;
+		ASSERT_STATUS(next, status::OK);
+	}
+
+	return ret;
+}
+
+template <typename Iterator>
+static void seek_prefix_test(pmem::kv::db &kv, Iterator &it)
+{
+	insert_keys(kv);
+
+	for (auto &p : prefixes)
+		UT_ASSERT(iterate_prefix(it, p) == expected_keys(p));
+
+	/* prev() does not cross the prefix boundary either */
+	ASSERT_STATUS(it.seek_prefix("ab/c"), status::OK);
+	auto s = it.prev();
+	if (s != status::NOT_SUPPORTED) {
+		ASSERT_STATUS(s, status::NOT_FOUND);
+		ASSERT_STATUS(it.next(), status::OK);
+		ASSERT_STATUS(it.prev(), status::OK);
+		UT_ASSERT(to_string(it.key().get_value()) == "ab/c");
+	}
+
+	/* other seek functions remove the bound */
+	ASSERT_STATUS(it.seek_prefix("ab/"), status::OK);
+	ASSERT_STATUS(it.seek_higher_eq("ab/d"), status::OK);
+	ASSERT_STATUS(it.is_next(), status::OK);
+	ASSERT_STATUS(it.next(), status::OK);
+	UT_ASSERT(to_string(it.key().get_value()) == "abc");
+}
+
+static void SeekPrefixReadTest(pmem::kv::db &kv)
+{
+	auto res = kv.new_read_iterator();
+	if (res.get_status() == status::NOT_SUPPORTED)
+		return;
+
+	UT_ASSERT(res.is_ok());
+	seek_prefix_test(kv, res.get_value());
+}
+
+static void SeekPrefixWriteTest(pmem::kv::db &kv)
+{
+	auto res = kv.new_write_iterator();
+	if (res.get_status() == status::NOT_SUPPORTED)
+		return;
+
+	UT_ASSERT(res.is_ok());
+	auto &it = res.get_value();
+	seek_prefix_test(kv, it);
+
+	/* modify all records with a prefix */
+	ASSERT_STATUS(it.seek_prefix("tenant1/"), status::OK);
+	do {
+		auto range = it.write_range(0, 1);
+		UT_ASSERT(range.is_ok());
+		for (auto &c : range.get_value())
+			c = 'V';
+		ASSERT_STATUS(it.commit(), status::OK);
+	} while (it.next() == status::OK);
+
+	for (auto &k : keys) {
+		std::string value;
+		ASSERT_STATUS(kv.get(k, &value), status::OK);
+		UT_ASSERT(value[0] == (has_prefix(k, "tenant1/") ? 'V' : 'v'));
+	}
+}
+
+static std::string padded_number(size_t number)
+{
+	char buf[32];
+	snprintf(buf, sizeof(buf), "k%04zu", number);
+
+	return buf;
+}
+
+/*
+ * Records span many leaves of tree-based engines. Every prefix "k<number>" lies
+ * in the gap after the previous record, which may be the last one of a leaf.
+ */
+static void MultiLeafPrefixTest(pmem::kv::db &kv)
+{
+	const size_t n = 400;
+	for (size_t i = 0; i < n; i += 2)
+		ASSERT_STATUS(kv.put(padded_number(i) + "/v", "val"), status::OK);
+
+	auto read_it = kv.new_read_iterator();
+
+	for (size_t i = 0; i < n; i += 2) {
+		auto prefix = padded_number(i);
+
+		std::vector<std::string> result;
+		ASSERT_STATUS(kv.get_prefix(prefix,
+					    [&](string_view k, string_view) {
+						    result.push_back(to_string(k));
+						    return 0;
+					    }),
+			      status::OK);
+		UT_ASSERTeq(result.size(), 1);
+		UT_ASSERT(result[0] == prefix + "/v");
+
+		std::size_t cnt;
+		ASSERT_STATUS(kv.count_prefix(prefix, cnt), status::OK);
+		UT_ASSERTeq(cnt, 1);
+
+		if (read_it.is_ok()) {
+			auto keys = iterate_prefix(read_it.get_value(), prefix);
+			UT_ASSERTeq(keys.size(), 1);
+			UT_ASSERT(keys[0] == prefix + "/v");
+		}
+	}
+
+	/* prefixes of many records, crossing leaves */
+	std::size_t cnt;
+	ASSERT_STATUS(kv.count_prefix("k01", cnt), status::OK);
+	UT_ASSERTeq(cnt, 50);
+	ASSERT_STATUS(kv.count_prefix("k0", cnt), status::OK);
+	UT_ASSERTeq(cnt, n / 2);
+}
+
+static void test(int argc, char *argv[])
+{
+	if (argc < 3)
+		UT_FATAL("usage: %s engine json_config", argv[0]);
+
+	run_engine_tests(argv[1], argv[2],
+			 {
+				 EmptyTest,
+				 GetPrefixTest,
+				 StopByCallbackTest,
+				 SeekPrefixReadTest,
+				 SeekPrefixWriteTest,
+				 MultiLeafPrefixTest,
+			 });
+}
+
+int main(int argc, char *argv[])
+{
+	return run_test([&] { test(argc, argv); });
+}
@@ -185,6 +185,59 @@ static void seek_to_last_test(pmem::kv::db &kv)
 	});
 }
 
+template <bool IsConst>
+static void read_batch_test(pmem::kv::db &kv)
+{
+	auto it = new_iterator<IsConst>(kv);
+
+	insert_keys(kv);
+
+	/* iterator which is not positioned yet reads nothing */
+	std::vector<std::pair<pmem::kv::string_view, pmem::kv::string_view>> batch;
+	ASSERT_STATUS(it.read_batch(batch, 2), pmem::kv::status::NOT_FOUND);
+	UT_ASSERT(batch.empty());
+
+	/* batches of every size, up to larger than number of records */
+	for (size_t n = 1; n <= keys.size() + 1; n++) {
+		ASSERT_STATUS(it.seek_to_first(), pmem::kv::status::OK);
+
+		size_t read = 0, calls = 0;
+		auto s = pmem::kv::status::OK;
+		while (s == pmem::kv::status::OK) {
+			s = it.read_batch(batch, n);
+			calls++;
+
+			UT_ASSERT(batch.size() <= n);
+			for (auto &e : batch) {
+				UT_ASSERTeq(e.first.compare(keys[read].first), 0);
+				UT_ASSERTeq(e.second.compare(keys[read].second), 0);
+				read++;
+			}
+		}
+
+		ASSERT_STATUS(s, pmem::kv::status::NOT_FOUND);
+		UT_ASSERTeq(read, keys.size());
+		UT_ASSERTeq(calls, (keys.size() + n - 1) / n);
+
+		/* nothing more to read past the last record */
+		ASSERT_STATUS(it.read_batch(batch, n), pmem::kv::status::NOT_FOUND);
+		UT_ASSERT(batch.empty());
+	}
+
+	/* the iterator is moved to the record following the batch */
+	ASSERT_STATUS(it.seek(keys[1].first), pmem::kv::status::OK);
+	ASSERT_STATUS(it.read_batch(batch, 2), pmem::kv::status::OK);
+	UT_ASSERTeq(batch.size(), 2);
+	UT_ASSERTeq(batch[0].first.compare(keys[1].first), 0);
+	UT_ASSERTeq(batch[1].first.compare(keys[2].first), 0);
+	verify_key<IsConst>(it, keys[3].first);
+	verify_value<IsConst>(it, keys[3].second);
+
+	ASSERT_STATUS(it.read_batch(batch, 0), pmem::kv::status::OK);
+	UT_ASSERT(batch.empty());
+	verify_key<IsConst>(it, keys[3].first);
+}
+
 static void seek_to_first_write_test(pmem::kv::db &kv)
 {
 	auto it = new_iterator<false>(kv);
@@ -265,6 +318,8 @@ static void test(int argc, char *argv[])
 				 seek_to_first_test<true>,
 				 seek_to_first_test<false>,
 				 seek_to_first_write_test,
+				 read_batch_test<true>,
+				 read_batch_test<false>,
 			 });
 
 	/* check if iterator supports prev and seek_to_last methods */
@@ -0,0 +1,172 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "unittest.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+/**
+ * Tests count_* methods, get_by_rank and rank_of against positions of keys
+ * returned by get_all, after inserts and removals which split and merge nodes.
+ * get_by_rank and rank_of return NOT_SUPPORTED in engines other than stree.
+ */
+
+using namespace pmem::kv;
+
+/* more than a few levels of stree's inner nodes */
+static const size_t N = 3000;
+
+static std::vector<std::string> all_keys(pmem::kv::db &kv)
+{
+	std::vector<std::string> keys;
+	ASSERT_STATUS(kv.get_all([&](string_view k, string_view) {
+		keys.emplace_back(k.data(), k.size());
+		return 0;
+	}),
+		      status::OK);
+	return keys;
+}
+
+static size_t expected_rank(const std::vector<std::string> &keys, const std::string &key,
+			    bool inclusive)
+{
+	auto it = inclusive ? std::upper_bound(keys.begin(), keys.end(), key)
+			    : std::lower_bound(keys.begin(), keys.end(), key);
+	return static_cast<size_t>(it - keys.begin());
+}
+
+static void verify_counts(pmem::kv::db &kv, const std::vector<std::string> &keys,
+			  const std::string &key)
+{
+	size_t cnt;
+
+	ASSERT_STATUS(kv.count_below(key, cnt), status::OK);
+	UT_ASSERTeq(cnt, expected_rank(keys, key, false));
+
+	ASSERT_STATUS(kv.count_equal_below(key, cnt), status::OK);
+	UT_ASSERTeq(cnt, expected_rank(keys, key, true));
+
+	ASSERT_STATUS(kv.count_above(key, cnt), status::OK);
+	UT_ASSERTeq(cnt, keys.size() - expected_rank(keys, key, true));
+
+	ASSERT_STATUS(kv.count_equal_above(key, cnt), status::OK);
+	UT_ASSERTeq(cnt, keys.size() - expected_rank(keys, key, false));
+
+	ASSERT_STATUS(kv.count_between("", key, cnt), status::OK);
+	UT_ASSERTeq(cnt, expected_rank(keys, key, false));
+
+	ASSERT_STATUS(kv.count_between(key, "", cnt), status::OK);
+	UT_ASSERTeq(cnt, 0);
+}
+
+static void verify_ranks(pmem::kv::db &kv)
+{
+	auto keys = all_keys(kv);
+
+	size_t cnt;
+	ASSERT_STATUS(kv.count_all(cnt), status::OK);
+	UT_ASSERTeq(cnt, keys.size());
+
+	for (size_t i = 0; i < keys.size(); i += 97) {
+		verify_counts(kv, keys, keys[i]);
+		verify_counts(kv, keys, keys[i] + '\0');
+	}
+	verify_counts(kv, keys, "");
+	verify_counts(kv, keys, "\xff");
+
+	size_t rank;
+	auto s = kv.rank_of(entry_from_string("missing"), rank);
+	if (s == status::NOT_SUPPORTED)
+		return;
+	ASSERT_STATUS(s, status::NOT_FOUND);
+
+	for (size_t i = 0; i < keys.size(); i += 31) {
+		ASSERT_STATUS(kv.rank_of(keys[i], rank), status::OK);
+		UT_ASSERTeq(rank, i);
+
+		std::vector<std::string> tail;
+		ASSERT_STATUS(kv.get_by_rank(i,
+					     [&](string_view k, string_view) {
+						     tail.emplace_back(k.data(), k.size());
+						     return 0;
+					     }),
+			      status::OK);
+		UT_ASSERT(std::equal(tail.begin(), tail.end(), keys.begin() + i));
+		UT_ASSERTeq(tail.size(), keys.size() - i);
+	}
+
+	size_t calls = 0;
+	ASSERT_STATUS(kv.get_by_rank(keys.size(),
+				     [&](string_view, string_view) {
+					     calls++;
+					     return 0;
+				     }),
+		      status::OK);
+	UT_ASSERTeq(calls, 0);
+
+	if (keys.empty())
+		return;
+
+	std::string first;
+	ASSERT_STATUS(kv.get_by_rank(keys.size() - 1,
+				     [&](string_view k, string_view) {
+					     first = std::string(k.data(), k.size());
+					     return 1;
+				     }),
+		      status::STOPPED_BY_CB);
+	UT_ASSERT(first == keys.back());
+}
+
+static void EmptyRankTest(pmem::kv::db &kv)
+{
+	verify_ranks(kv);
+}
+
+static void InsertRemoveRankTest(pmem::kv::db &kv)
+{
+	/* inserted in an order which is not sorted */
+	for (size_t i = 0; i < N; i++) {
+		auto n = (i * 7919) % N;
+		ASSERT_STATUS(kv.put(entry_from_number(n, "key"), entry_from_number(n)),
+			      status::OK);
+	}
+	verify_ranks(kv);
+
+	/* overwrites do not change counts */
+	for (size_t i = 0; i < N; i += 10)
+		ASSERT_STATUS(kv.put(entry_from_number(i, "key"), entry_from_string("new")),
+			      status::OK);
+	verify_ranks(kv);
+
+	for (size_t i = 0; i < N; i += 3)
+		ASSERT_STATUS(kv.remove(entry_from_number(i, "key")), status::OK);
+	verify_ranks(kv);
+
+	auto s = kv.remove_range(entry_from_number(N / 4, "key"),
+				 entry_from_number(N / 2, "key"));
+	UT_ASSERT(s == status::OK || s == status::NOT_SUPPORTED);
+	verify_ranks(kv);
+
+	for (size_t i = 0; i < N; i++)
+		kv.remove(entry_from_number(i, "key"));
+	verify_ranks(kv);
+}
+
+static void test(int argc, char *argv[])
+{
+	if (argc < 3)
+		UT_FATAL("usage: %s engine json_config", argv[0]);
+
+	run_engine_tests(argv[1], argv[2],
+			 {
+				 EmptyRankTest,
+				 InsertRemoveRankTest,
+			 });
+}
+
+int main(int argc, char *argv[])
+{
+	return run_test([&] { test(argc, argv); });
+}
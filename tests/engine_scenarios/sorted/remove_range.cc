@@ -0,0 +1,221 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "unittest.hpp"
+
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Tests remove_range and remove_prefix methods (in sorted engines, with
+ * the default comparator).
+ */
+
+using namespace pmem::kv;
+
+static const std::vector<std::string> keys = {
+	"a",
+	"ab",
+	"ab/",
+	"ab/c",
+	"ab/cd",
+	"abc",
+	"b",
+	"tenant1/obj1/a",
+	"tenant1/obj2/a",
+	"tenant10/obj1/a",
+	"tenant2/obj1/a",
+	std::string("x\xff", 2),
+	std::string("x\xff\xff", 3),
+	std::string("y\x00", 2),
+};
+
+static const std::vector<std::string> prefixes = {
+	"",
+	"a",
+	"ab/",
+	"abcd",
+	"tenant1",
+	"tenant1/",
+	"z",
+	std::string("x\xff", 2),
+	std::string("y\x00", 2),
+};
+
+static const std::vector<std::pair<std::string, std::string>> ranges = {
+	{"a", "b"},   {"ab", "ab/cd"}, {"", "tenant1"}, {"tenant1/", "tenant2"},
+	{"aa", "ab"}, {"b", "z"},      {"0", "\xff"},
+};
+
+static void insert_keys(pmem::kv::db &kv)
+{
+	for (auto &key : keys)
+		ASSERT_STATUS(kv.put(key, "val_" + key), status::OK);
+}
+
+static std::vector<std::string> remaining_keys(pmem::kv::db &kv)
+{
+	std::vector<std::string> result;
+	ASSERT_STATUS(kv.get_all([&](string_view k, string_view v) {
+		result.emplace_back(k.data(), k.size());
+		UT_ASSERT(std::string(v.data(), v.size()) == "val_" + result.back());
+		return 0;
+	}),
+		      status::OK);
+
+	return result;
+}
+
+static void RemoveRangeTest(pmem::kv::db &kv)
+{
+	for (auto &r : ranges) {
+		insert_keys(kv);
+
+		auto s = kv.remove_range(r.first, r.second);
+		if (s == status::NOT_SUPPORTED)
+			return;
+		ASSERT_STATUS(s, status::OK);
+
+		std::vector<std::string> expected;
+		for (auto &key : keys) {
+			if (key < r.first || key >= r.second)
+				expected.push_back(key);
+		}
+
+		UT_ASSERT(remaining_keys(kv) == expected);
+
+		CLEAR_KV(kv);
+	}
+}
+
+static void RemoveEmptyRangeTest(pmem::kv::db &kv)
+{
+	insert_keys(kv);
+
+	auto s = kv.remove_range("b", "a");
+	if (s == status::NOT_SUPPORTED)
+		return;
+	ASSERT_STATUS(s, status::OK);
+	ASSERT_STATUS(kv.remove_range("ab", "ab"), status::OK);
+
+	UT_ASSERT(remaining_keys(kv) == keys);
+
+	CLEAR_KV(kv);
+}
+
+/* more records than removed in a single chunk */
+static void RemoveLargeRangeTest(pmem::kv::db &kv)
+{
+	const size_t n = 5000;
+	for (size_t i = 0; i < n; i++)
+		ASSERT_STATUS(kv.put(entry_from_number(i + n, "key"), "val"), status::OK);
+
+	auto s = kv.remove_range(entry_from_number(n + 1000, "key"),
+				 entry_from_number(n + 4500, "key"));
+	if (s == status::NOT_SUPPORTED)
+		return;
+	ASSERT_STATUS(s, status::OK);
+
+	size_t cnt;
+	ASSERT_STATUS(kv.count_all(cnt), status::OK);
+	UT_ASSERTeq(cnt, n - 3500);
+	ASSERT_STATUS(kv.exists(entry_from_number(n + 999, "key")), status::OK);
+	ASSERT_STATUS(kv.exists(entry_from_number(n + 1000, "key")), status::NOT_FOUND);
+	ASSERT_STATUS(kv.exists(entry_from_number(n + 4499, "key")), status::NOT_FOUND);
+	ASSERT_STATUS(kv.exists(entry_from_number(n + 4500, "key")), status::OK);
+
+	ASSERT_STATUS(kv.remove_prefix("key"), status::OK);
+	ASSERT_STATUS(kv.count_all(cnt), status::OK);
+	UT_ASSERTeq(cnt, 0);
+}
+
+/* "k<number>/v" for even numbers (records), "k<number>" for odd ones (missing
+ * keys, which sort between two consecutive records) */
+static std::string padded_key(size_t number)
+{
+	char buf[32];
+	snprintf(buf, sizeof(buf), "k%04zu", number);
+
+	return number % 2 ? std::string(buf) : std::string(buf) + "/v";
+}
+
+/*
+ * Bounds which are missing and sort after the last key of a leaf (or other
+ * node) must not extend the range to the end of the database.
+ */
+static void RemoveMultiLeafTest(pmem::kv::db &kv)
+{
+	const size_t n = 400;
+	for (size_t i = 0; i < n; i += 2)
+		ASSERT_STATUS(kv.put(padded_key(i), "val"), status::OK);
+
+	/* every gap between records is used as the end of a range */
+	for (size_t i = 0; i < n; i += 2) {
+		auto s = kv.remove_range(padded_key(i), padded_key(i + 1));
+		if (s == status::NOT_SUPPORTED)
+			return;
+		ASSERT_STATUS(s, status::OK);
+
+		size_t cnt;
+		ASSERT_STATUS(kv.count_all(cnt), status::OK);
+		UT_ASSERTeq(cnt, n / 2 - 1);
+		ASSERT_STATUS(kv.exists(padded_key(i)), status::NOT_FOUND);
+
+		ASSERT_STATUS(kv.put(padded_key(i), "val"), status::OK);
+	}
+
+	/* prefixes without the "/v" suffix match a single record each */
+	for (size_t i = 0; i < n; i += 2) {
+		ASSERT_STATUS(kv.remove_prefix(padded_key(i).substr(0, 5)), status::OK);
+
+		size_t cnt;
+		ASSERT_STATUS(kv.count_all(cnt), status::OK);
+		UT_ASSERTeq(cnt, n / 2 - 1);
+		ASSERT_STATUS(kv.exists(padded_key(i)), status::NOT_FOUND);
+
+		ASSERT_STATUS(kv.put(padded_key(i), "val"), status::OK);
+	}
+
+	CLEAR_KV(kv);
+}
+
+static void RemovePrefixTest(pmem::kv::db &kv)
+{
+	for (auto &prefix : prefixes) {
+		insert_keys(kv);
+
+		ASSERT_STATUS(kv.remove_prefix(prefix), status::OK);
+
+		std::vector<std::string> expected;
+		for (auto &key : keys) {
+			if (key.compare(0, prefix.size(), prefix) != 0)
+				expected.push_back(key);
+		}
+
+		UT_ASSERT(remaining_keys(kv) == expected);
+
+		CLEAR_KV(kv);
+	}
+}
+
+static void test(int argc, char *argv[])
+{
+	if (argc < 3)
+		UT_FATAL("usage: %s engine json_config", argv[0]);
+
+	run_engine_tests(argv[1], argv[2],
+			 {
+				 RemoveRangeTest,
+				 RemoveEmptyRangeTest,
+				 RemoveLargeRangeTest,
+				 RemoveMultiLeafTest,
+				 RemovePrefixTest,
+			 });
+}
+
+int main(int argc, char *argv[])
+{
+	return run_test([&] { test(argc, argv); });
+}
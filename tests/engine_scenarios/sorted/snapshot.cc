@@ -0,0 +1,252 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/* Copyright 2021, Intel Corporation */
+
+#include "unittest.hpp"
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Tests snapshots (db::snapshot()): reads from a snapshot return the state
+ * of the database from the moment the snapshot was created, regardless of
+ * modifications done afterwards (also in the middle of a scan).
+ */
+
+using namespace pmem::kv;
+
+using kv_list = std::vector<std::pair<std::string, std::string>>;
+
+/* more than a single chunk of a snapshot scan */
+static const size_t N = 1000;
+
+static kv_list scan_all(pmem::kv::snapshot &sn)
+{
+	kv_list ret;
+	ASSERT_STATUS(sn.get_all([&](string_view k, string_view v) {
+		ret.emplace_back(std::string(k.data(), k.size()),
+				 std::string(v.data(), v.size()));
+		return 0;
+	}),
+		      status::OK);
+
+	return ret;
+}
+
+static kv_list scan_all(pmem::kv::db &kv)
+{
+	kv_list ret;
+	ASSERT_STATUS(kv.get_all([&](string_view k, string_view v) {
+		ret.emplace_back(std::string(k.data(), k.size()),
+				 std::string(v.data(), v.size()));
+		return 0;
+	}),
+		      status::OK);
+
+	return ret;
+}
+
+static void insert_keys(pmem::kv::db &kv)
+{
+	for (size_t i = 0; i < N; i += 2)
+		ASSERT_STATUS(kv.put(entry_from_number(i, "key"),
+				     entry_from_number(i, "val")),
+			      status::OK);
+}
+
+static void PointReadTest(pmem::kv::db &kv)
+{
+	auto key1 = entry_from_string("key1");
+	auto key2 = entry_from_string("key2");
+	auto key3 = entry_from_string("key3");
+	auto val1 = entry_from_string("val1");
+	auto val2 = entry_from_string("val2");
+
+	ASSERT_STATUS(kv.put(key1, val1), status::OK);
+	ASSERT_STATUS(kv.put(key2, val1), status::OK);
+
+	auto sn = kv.snapshot();
+	ASSERT_STATUS(sn.get_status(), status::OK);
+	auto &s = sn.get_value();
+
+	ASSERT_STATUS(kv.put(key1, val2), status::OK);
+	ASSERT_STATUS(kv.remove(key2), status::OK);
+	ASSERT_STATUS(kv.put(key3, val2), status::OK);
+
+	std::string value;
+	ASSERT_STATUS(s.get(key1, &value), status::OK);
+	UT_ASSERT(value == val1);
+	ASSERT_STATUS(s.get(key2, &value), status::OK);
+	UT_ASSERT(value == val1);
+	ASSERT_STATUS(s.exists(key2), status::OK);
+	ASSERT_STATUS(s.get(key3, &value), status::NOT_FOUND);
+	ASSERT_STATUS(s.exists(key3), status::NOT_FOUND);
+
+	std::size_t cnt;
+	ASSERT_STATUS(s.count_all(cnt), status::OK);
+	UT_ASSERTeq(cnt, 2);
+
+	ASSERT_STATUS(kv.get(key1, &value), status::OK);
+	UT_ASSERT(value == val2);
+	ASSERT_STATUS(kv.exists(key2), status::NOT_FOUND);
+
+	s.release();
+
+	CLEAR_KV(kv);
+}
+
+static void ScanTest(pmem::kv::db &kv)
+{
+	insert_keys(kv);
+	auto expected = scan_all(kv);
+
+	auto sn = kv.snapshot();
+	ASSERT_STATUS(sn.get_status(), status::OK);
+	auto &s = sn.get_value();
+
+	/* update, remove and insert keys (odd numbers) all over the range */
+	for (size_t i = 0; i < N; i++) {
+		if (i % 3 == 0)
+			ASSERT_STATUS(kv.put(entry_from_number(i, "key"),
+					     entry_from_string("new")),
+				      status::OK);
+		else if (i % 2 == 0)
+			ASSERT_STATUS(kv.remove(entry_from_number(i, "key")),
+				      status::OK);
+	}
+
+	UT_ASSERT(scan_all(s) == expected);
+	UT_ASSERT(scan_all(kv) != expected);
+
+	CLEAR_KV(kv);
+}
+
+/* snapshot scan callbacks may modify the database, as no lock is held */
+static void ModifyDuringScanTest(pmem::kv::db &kv)
+{
+	insert_keys(kv);
+	auto expected = scan_all(kv);
+
+	auto sn = kv.snapshot();
+	ASSERT_STATUS(sn.get_status(), status::OK);
+	auto &s = sn.get_value();
+
+	kv_list result;
+	size_t i = 0;
+	auto ret = s.get_all([&](string_view k, string_view v) {
+		result.emplace_back(std::string(k.data(), k.size()),
+				    std::string(v.data(), v.size()));
+
+		/* modify records which were not read yet */
+		auto next = entry_from_number(2 * (++i), "key");
+		if (i % 2)
+			kv.remove(next);
+		else
+			kv.put(next, entry_from_string("new"));
+		kv.put(entry_from_number(2 * i + 1, "key"), entry_from_string("new"));
+
+		return 0;
+	});
+	ASSERT_STATUS(ret, status::OK);
+	UT_ASSERT(result == expected);
+
+	CLEAR_KV(kv);
+}
+
+static void RangeTest(pmem::kv::db &kv)
+{
+	insert_keys(kv);
+
+	auto key1 = entry_from_number(100, "key");
+	auto key2 = entry_from_number(800, "key");
+
+	std::map<std::string, std::string> above, between;
+	for (auto &p : scan_all(kv)) {
+		if (p.first > key1)
+			above.insert(p);
+		if (p.first > key1 && p.first < key2)
+			between.insert(p);
+	}
+
+	auto sn = kv.snapshot();
+	ASSERT_STATUS(sn.get_status(), status::OK);
+	auto &s = sn.get_value();
+
+	for (size_t i = 0; i < N; i++)
+		ASSERT_STATUS(kv.put(entry_from_number(i, "key"), entry_from_string("new")),
+			      status::OK);
+
+	std::map<std::string, std::string> result;
+	auto collect = [&](string_view k, string_view v) {
+		result.emplace(std::string(k.data(), k.size()),
+			       std::string(v.data(), v.size()));
+		return 0;
+	};
+
+	ASSERT_STATUS(s.get_above(key1, collect), status::OK);
+	UT_ASSERT(result == above);
+
+	result.clear();
+	ASSERT_STATUS(s.get_between(key1, key2, collect), status::OK);
+	UT_ASSERT(result == between);
+
+	result.clear();
+	ASSERT_STATUS(s.get_between(key2, key1, collect), status::OK);
+	UT_ASSERT(result.empty());
+
+	CLEAR_KV(kv);
+}
+
+static void MultipleSnapshotsTest(pmem::kv::db &kv)
+{
+	auto key = entry_from_string("key");
+	std::vector<pmem::kv::snapshot> snapshots;
+
+	for (size_t i = 0; i < 5; i++) {
+		ASSERT_STATUS(kv.put(key, entry_from_number(i)), status::OK);
+
+		auto sn = kv.snapshot();
+		ASSERT_STATUS(sn.get_status(), status::OK);
+		snapshots.push_back(std::move(sn.get_value()));
+	}
+	ASSERT_STATUS(kv.remove(key), status::OK);
+
+	/* releasing the oldest snapshot must not drop versions of newer ones */
+	snapshots.front().release();
+
+	for (size_t i = 1; i < snapshots.size(); i++) {
+		std::string value;
+		ASSERT_STATUS(snapshots[i].get(key, &value), status::OK);
+		UT_ASSERT(value == entry_from_number(i));
+	}
+
+	snapshots.clear();
+
+	auto sn = kv.snapshot();
+	ASSERT_STATUS(sn.get_status(), status::OK);
+	ASSERT_STATUS(sn.get_value().exists(key), status::NOT_FOUND);
+	sn.get_value().release();
+
+	CLEAR_KV(kv);
+}
+
+static void test(int argc, char *argv[])
+{
+	if (argc < 3)
+		UT_FATAL("usage: %s engine json_config", argv[0]);
+
+	run_engine_tests(argv[1], argv[2],
+			 {
+				 PointReadTest,
+				 ScanTest,
+				 ModifyDuringScanTest,
+				 RangeTest,
+				 MultipleSnapshotsTest,
+			 });
+}
+
+int main(int argc, char *argv[])
+{
+	return run_test([&] { test(argc, argv); });
+}
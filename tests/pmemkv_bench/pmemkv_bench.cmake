@@ -0,0 +1,13 @@
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright 2021, Intel Corporation
+
+include(${PARENT_SRC_DIR}/helpers.cmake)
+
+setup()
+
+# short runs of all benchmarks supported by cmap, with a thread count sweep
+execute(${TEST_EXECUTABLE} --engine=cmap --path=${DIR}/testfile --size=104857600
+	--benchmarks=fillseq,fillrandom,readrandom,ycsb_a,ycsb_b,ycsb_c,ycsb_d,ycsb_f
+	--threads=1,2 --num=1000 --warmup=100 --key_size=16-32 --value_size=1-200)
+
+finish()